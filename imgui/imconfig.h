@@ -64,6 +64,17 @@
 //---- Use 32-bit vertex indices (default is 16-bit) to allow meshes with more than 64K vertices. Render function needs to support it.
 //#define ImDrawIdx unsigned int
 
+//---- Use a 12 bytes ImDrawVert instead of 20: fixed-point positions (+/-4095 pixels in 1/8 steps) and 16-bit UVs (see imgui.h). Render function needs to support it.
+//     Positions past +/-4095 are clamped, not clipped: a triangle crossing that edge is distorted. Keep draw lists within range.
+//#define IMGUI_USE_COMPACT_DRAWVERT
+
+//---- Assert in ImGui::Render() that draw lists stay within the compact ImDrawVert position range. Scans every triangle of every list, every frame.
+//#define IMGUI_DEBUG_COMPACT_DRAWVERT
+
+//---- Pick the function ImHash() uses for IDs instead of the fastest one available (see imgui_internal.h).
+// e.g. ImHashCrc32Table gives the same IDs as upstream dear imgui, if something depends on their values.
+//#define IMGUI_HASH_DEFAULT_FUNCTION   ImHashCrc32Table
+
 //---- Tip: You can add extra functions within the ImGui:: namespace, here or in your own headers files.
 /*
 namespace ImGui
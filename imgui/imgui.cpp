@@ -1191,6 +1191,58 @@ ImVec2 ImTriangleClosestPoint(const ImVec2& a, const ImVec2& b, const ImVec2& c,
     return proj_ca;
 }
 
+// Packed values go 16 at a time through 4 independent pairs of SSE registers. _mm_min_ps(a, b)/_mm_max_ps(a, b) return b when either is a NaN,
+// same as ImMin(a, b)/ImMax(a, b), so both paths agree.
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define IMGUI_MINMAX_SSE
+#include <xmmintrin.h>
+#endif
+
+void ImMinMax(const float* values, int values_count, int stride, float* in_out_min, float* in_out_max)
+{
+    float v_min = *in_out_min;
+    float v_max = *in_out_max;
+    if (stride == sizeof(float))
+    {
+#ifdef IMGUI_MINMAX_SSE
+        if (values_count >= 16)
+        {
+            __m128 min0 = _mm_set1_ps(v_min), min1 = min0, min2 = min0, min3 = min0;
+            __m128 max0 = _mm_set1_ps(v_max), max1 = max0, max2 = max0, max3 = max0;
+            for (; values_count >= 16; values_count -= 16, values += 16)
+            {
+                const __m128 v0 = _mm_loadu_ps(values), v1 = _mm_loadu_ps(values + 4), v2 = _mm_loadu_ps(values + 8), v3 = _mm_loadu_ps(values + 12);
+                min0 = _mm_min_ps(min0, v0); max0 = _mm_max_ps(max0, v0);
+                min1 = _mm_min_ps(min1, v1); max1 = _mm_max_ps(max1, v1);
+                min2 = _mm_min_ps(min2, v2); max2 = _mm_max_ps(max2, v2);
+                min3 = _mm_min_ps(min3, v3); max3 = _mm_max_ps(max3, v3);
+            }
+            float mins[4], maxs[4];
+            _mm_storeu_ps(mins, _mm_min_ps(_mm_min_ps(min0, min1), _mm_min_ps(min2, min3)));
+            _mm_storeu_ps(maxs, _mm_max_ps(_mm_max_ps(max0, max1), _mm_max_ps(max2, max3)));
+            v_min = ImMin(ImMin(mins[0], mins[1]), ImMin(mins[2], mins[3]));
+            v_max = ImMax(ImMax(maxs[0], maxs[1]), ImMax(maxs[2], maxs[3]));
+        }
+#endif
+        for (; values_count > 0; values_count--, values++)
+        {
+            v_min = ImMin(v_min, *values);
+            v_max = ImMax(v_max, *values);
+        }
+    }
+    else
+    {
+        for (const unsigned char* p = (const unsigned char*)values; values_count > 0; values_count--, p += stride)
+        {
+            const float v = *(const float*)(const void*)p;
+            v_min = ImMin(v_min, v);
+            v_max = ImMax(v_max, v);
+        }
+    }
+    *in_out_min = v_min;
+    *in_out_max = v_max;
+}
+
 int ImStricmp(const char* str1, const char* str2)
 {
     int d;
@@ -1320,48 +1372,242 @@ int ImFormatStringV(char* buf, size_t buf_size, const char* fmt, va_list args)
 }
 #endif // #ifdef IMGUI_DISABLE_FORMAT_STRING_FUNCTIONS
 
-// Pass data_size==0 for zero-terminated strings
-// FIXME-OPT: Replace with e.g. FNV1a hash? CRC32 pretty much randomly access 1KB. Need to do proper measurements.
-ImU32 ImHash(const void* data, int data_size, ImU32 seed)
+// ImHash() is split in two: finding out what to hash (the "label###id" syntax, zero-terminated strings) and hashing
+// a known number of bytes, which goes through a replaceable function. Three are provided, see ImHashSetFunction().
+#if (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)) && (defined(__GNUC__) || defined(_MSC_VER))
+#define IMGUI_HASH_X86
+#include <nmmintrin.h>  // SSE4.2 crc32, SSE2
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>     // __cpuid, _BitScanForward
+#endif
+#endif
+#if defined(IMGUI_HASH_X86) && defined(__GNUC__)
+#define IMGUI_HASH_TARGET_SSE42     __attribute__((target("sse4.2")))
+#define IMGUI_HASH_NO_SANITIZE      __attribute__((no_sanitize_address))   // We deliberately read whole aligned blocks past the terminator
+#else
+#define IMGUI_HASH_TARGET_SSE42
+#define IMGUI_HASH_NO_SANITIZE
+#endif
+
+static ImHashFunction GImHashFunction = NULL;
+
+static void ImHashBuildCrcTable(ImU32* lut, ImU32 polynomial)
+{
+    for (ImU32 i = 0; i < 256; i++)
+    {
+        ImU32 crc = i;
+        for (ImU32 j = 0; j < 8; j++)
+            crc = (crc >> 1) ^ (ImU32(-int(crc & 1)) & polynomial);
+        lut[i] = crc;
+    }
+}
+
+// Portable, byte at a time through a 1KB table. This is what ImHash() always used to be: same IDs as upstream dear imgui.
+ImU32 ImHashCrc32Table(const void* data, int data_size, ImU32 seed)
 {
     static ImU32 crc32_lut[256] = { 0 };
     if (!crc32_lut[1])
+        ImHashBuildCrcTable(crc32_lut, 0xEDB88320);
+
+    ImU32 crc = ~seed;
+    const unsigned char* current = (const unsigned char*)data;
+    while (data_size--)
+        crc = (crc >> 8) ^ crc32_lut[(crc & 0xFF) ^ *current++];
+    return ~crc;
+}
+
+bool ImHashCrc32cSupported()
+{
+#if defined(IMGUI_HASH_X86) && defined(__GNUC__)
+    static const bool supported = __builtin_cpu_supports("sse4.2") != 0;
+    return supported;
+#elif defined(IMGUI_HASH_X86)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    return false;
+#endif
+}
+
+#ifdef IMGUI_HASH_X86
+IMGUI_HASH_TARGET_SSE42 static ImU32 ImHashCrc32cHardware(const unsigned char* current, int data_size, ImU32 crc)
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    ImU64 crc64 = crc;
+    for (; data_size >= 8; data_size -= 8, current += 8)
     {
-        const ImU32 polynomial = 0xEDB88320;
-        for (ImU32 i = 0; i < 256; i++)
-        {
-            ImU32 crc = i;
-            for (ImU32 j = 0; j < 8; j++)
-                crc = (crc >> 1) ^ (ImU32(-int(crc & 1)) & polynomial);
-            crc32_lut[i] = crc;
-        }
+        ImU64 word;
+        memcpy(&word, current, 8);
+        crc64 = _mm_crc32_u64(crc64, word);
     }
+    crc = (ImU32)crc64;
+#endif
+    for (; data_size >= 4; data_size -= 4, current += 4)
+    {
+        ImU32 word;
+        memcpy(&word, current, 4);
+        crc = _mm_crc32_u32(crc, word);
+    }
+    while (data_size--)
+        crc = _mm_crc32_u8(crc, *current++);
+    return crc;
+}
+#endif
 
-    seed = ~seed;
-    ImU32 crc = seed;
+// CRC32C (Castagnoli), 8 bytes per instruction with SSE4.2 and through a table otherwise. Both give the same result.
+ImU32 ImHashCrc32c(const void* data, int data_size, ImU32 seed)
+{
     const unsigned char* current = (const unsigned char*)data;
+    ImU32 crc = ~seed;
+#ifdef IMGUI_HASH_X86
+    if (ImHashCrc32cSupported())
+        return ~ImHashCrc32cHardware(current, data_size, crc);
+#endif
+    static ImU32 crc32c_lut[256] = { 0 };
+    if (!crc32c_lut[1])
+        ImHashBuildCrcTable(crc32c_lut, 0x82F63B78);
+    while (data_size--)
+        crc = (crc >> 8) ^ crc32c_lut[(crc & 0xFF) ^ *current++];
+    return ~crc;
+}
+
+static inline ImU64 ImHashRotl64(ImU64 v, int r) { return (v << r) | (v >> (64 - r)); }
 
-    if (data_size > 0)
+// Portable, 8 bytes at a time with multiply/rotate rounds (the XXH64 ones for short inputs). The length is mixed in first.
+ImU32 ImHashWords(const void* data, int data_size, ImU32 seed)
+{
+    const ImU64 PRIME1 = 0x9E3779B185EBCA87ULL, PRIME2 = 0xC2B2AE3D27D4EB4FULL, PRIME3 = 0x165667B19E3779F9ULL;
+    const ImU64 PRIME4 = 0x85EBCA77C2B2AE63ULL, PRIME5 = 0x27D4EB2F165667C5ULL;
+    const unsigned char* current = (const unsigned char*)data;
+    ImU64 h = (ImU64)seed + PRIME5 + (ImU64)data_size;
+    for (; data_size >= 8; data_size -= 8, current += 8)
     {
-        // Known size
-        while (data_size--)
-            crc = (crc >> 8) ^ crc32_lut[(crc & 0xFF) ^ *current++];
+        ImU64 word;
+        memcpy(&word, current, 8);
+        h ^= ImHashRotl64(word * PRIME2, 31) * PRIME1;
+        h = ImHashRotl64(h, 27) * PRIME1 + PRIME4;
     }
-    else
+    if (data_size >= 4)
+    {
+        ImU32 word;
+        memcpy(&word, current, 4);
+        h ^= (ImU64)word * PRIME1;
+        h = ImHashRotl64(h, 23) * PRIME2 + PRIME3;
+        data_size -= 4;
+        current += 4;
+    }
+    while (data_size--)
+    {
+        h ^= (*current++) * PRIME5;
+        h = ImHashRotl64(h, 11) * PRIME1;
+    }
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    h *= PRIME3;
+    h ^= h >> 32;
+    return (ImU32)h;
+}
+
+ImHashFunction ImHashGetDefaultFunction()
+{
+#ifdef IMGUI_HASH_DEFAULT_FUNCTION
+    return IMGUI_HASH_DEFAULT_FUNCTION;
+#else
+    return ImHashCrc32cSupported() ? ImHashCrc32c : ImHashWords;
+#endif
+}
+
+void ImHashSetFunction(ImHashFunction fn)
+{
+    GImHashFunction = fn ? fn : ImHashGetDefaultFunction();
+}
+
+ImHashFunction ImHashGetFunction()
+{
+    if (GImHashFunction == NULL)
+        GImHashFunction = ImHashGetDefaultFunction();
+    return GImHashFunction;
+}
+
+// Zero-terminated string: find its end and where the ID starts. We support a syntax of "label###id" where only "###id"
+// is included in the hash, and only "label" gets displayed. Every ### resets the hash, so only what follows the last one counts.
+IMGUI_HASH_NO_SANITIZE static const char* ImHashFindIdRange(const char* str, const char** out_str_end)
+{
+    const char* id_begin = str;
+#ifdef IMGUI_HASH_X86
+    // 16 bytes at a time, looking for the terminator and '#' at once. Aligned loads never straddle a page boundary, so
+    // reading past the terminator can't fault. '#' is rare enough for the ### check to be done by hand.
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i sharp = _mm_set1_epi8('#');
+    const int misalign = (int)((intptr_t)str & 15);
+    const char* block = str - misalign;
+    unsigned int valid = 0xFFFFu << misalign;
+    for (;;)
     {
-        // Zero-terminated string
-        while (unsigned char c = *current++)
+        __m128i chars = _mm_load_si128((const __m128i*)block);
+        unsigned int zeros = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(chars, zero)) & valid;
+        unsigned int sharps = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(chars, sharp)) & valid;
+        if (zeros)
+            sharps &= (zeros & (0u - zeros)) - 1;   // Only those before the terminator
+        if (sharps)
         {
-            // We support a syntax of "label###id" where only "###id" is included in the hash, and only "label" gets displayed.
-            // Because this syntax is rarely used we are optimizing for the common case.
-            // - If we reach ### in the string we discard the hash so far and reset to the seed.
-            // - We don't do 'current += 2; continue;' after handling ### to keep the code smaller.
-            if (c == '#' && current[0] == '#' && current[1] == '#')
-                crc = seed;
-            crc = (crc >> 8) ^ crc32_lut[(crc & 0xFF) ^ c];
+            // Three '#' in a row within the block are three bits in a row. The last two bytes may start one running
+            // into the next block, check those by hand.
+            unsigned int triples = sharps & (sharps >> 1) & (sharps >> 2);
+            for (int bit = 14; bit < 16; bit++)
+                if ((sharps >> bit) & 1)
+                    if (block[bit + 1] == '#' && block[bit + 2] == '#')
+                        triples |= 1u << bit;
+            if (triples)
+            {
+#if defined(_MSC_VER) && !defined(__clang__)
+                unsigned long bit;
+                _BitScanReverse(&bit, triples);
+#else
+                const int bit = 31 - __builtin_clz(triples);
+#endif
+                id_begin = block + bit;
+            }
         }
+        if (zeros)
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long bit;
+            _BitScanForward(&bit, zeros);
+#else
+            const int bit = __builtin_ctz(zeros);
+#endif
+            *out_str_end = block + bit;
+            return id_begin;
+        }
+        block += 16;
+        valid = 0xFFFF;
     }
-    return ~crc;
+#else
+    const char* p = str;
+    for (; *p; p++)
+        if (p[0] == '#' && p[1] == '#' && p[2] == '#')
+            id_begin = p;
+    *out_str_end = p;
+    return id_begin;
+#endif
+}
+
+// Pass data_size==0 for zero-terminated strings
+ImU32 ImHash(const void* data, int data_size, ImU32 seed)
+{
+    if (data_size == 0)
+    {
+        const char* str_end;
+        data = ImHashFindIdRange((const char*)data, &str_end);
+        data_size = (int)(str_end - (const char*)data);
+        if (data_size == 0)
+            return seed;
+    }
+    ImHashFunction fn = GImHashFunction ? GImHashFunction : ImHashGetFunction();
+    return fn(data, data_size, seed);
 }
 
 FILE* ImFileOpen(const char* filename, const char* mode)
@@ -1605,6 +1851,280 @@ int ImTextCountUtf8BytesFromStr(const ImWchar* in_text, const ImWchar* in_text_e
     return bytes_count;
 }
 
+static int ImTextCountNewlines(const ImWchar* text, const ImWchar* text_end)
+{
+    int count = 0;
+    for (const ImWchar* p = text; p < text_end; p++)
+        if (*p == '\n')
+            count++;
+    return count;
+}
+
+void ImTextRope::Clear()
+{
+    for (int n = 0; n < Chunks.Size; n++)
+        ImGui::MemFree(Chunks[n]);
+    Chunks.clear();
+    LenTree.Clear();
+    LenUtf8Tree.Clear();
+    NewlinesTree.Clear();
+    Len = LenUtf8 = Newlines = 0;
+    CacheChunk = -1;
+}
+
+void ImTextRope::SetFromUtf8(const char* text, const char* text_end)
+{
+    Clear();
+    ClearEdits();
+    const int chunk_fill = IM_TEXT_ROPE_CHUNK_SIZE * 3 / 4;    // Room for typing without splitting right away
+    ImTextRopeChunk* chunk = NULL;
+    while ((!text_end || text < text_end) && *text)
+    {
+        unsigned int c = (unsigned char)*text;
+        if (c < 0x80)
+        {
+            text++;
+        }
+        else
+        {
+            text += ImTextCharFromUtf8(&c, text, text_end);
+            if (c == 0)
+                break;
+            if (c >= 0x10000)
+                continue;
+        }
+        if (chunk == NULL || chunk->Len == chunk_fill)
+        {
+            chunk = (ImTextRopeChunk*)ImGui::MemAlloc(sizeof(ImTextRopeChunk));
+            chunk->Len = chunk->LenUtf8 = chunk->Newlines = 0;
+            Chunks.push_back(chunk);
+        }
+        chunk->Text[chunk->Len++] = (ImWchar)c;
+        chunk->LenUtf8 += ImTextCountUtf8BytesFromChar(c);
+        chunk->Newlines += (c == '\n') ? 1 : 0;
+    }
+    RebuildTrees();
+}
+
+void ImTextRope::RebuildTrees()
+{
+    ImVector<int> values;
+    values.resize(Chunks.Size);
+    Len = LenUtf8 = Newlines = 0;
+    for (int n = 0; n < Chunks.Size; n++) { values[n] = Chunks[n]->Len; Len += values[n]; }
+    LenTree.Build(values.Data, values.Size);
+    for (int n = 0; n < Chunks.Size; n++) { values[n] = Chunks[n]->LenUtf8; LenUtf8 += values[n]; }
+    LenUtf8Tree.Build(values.Data, values.Size);
+    for (int n = 0; n < Chunks.Size; n++) { values[n] = Chunks[n]->Newlines; Newlines += values[n]; }
+    NewlinesTree.Build(values.Data, values.Size);
+    CacheChunk = -1;
+}
+
+void ImTextRope::UpdateChunk(int chunk_idx, int len_delta, int len_utf8_delta, int newlines_delta)
+{
+    ImTextRopeChunk* chunk = Chunks[chunk_idx];
+    chunk->Len += len_delta;
+    chunk->LenUtf8 += len_utf8_delta;
+    chunk->Newlines += newlines_delta;
+    Len += len_delta;
+    LenUtf8 += len_utf8_delta;
+    Newlines += newlines_delta;
+    LenTree.Add(chunk_idx, len_delta);
+    LenUtf8Tree.Add(chunk_idx, len_utf8_delta);
+    NewlinesTree.Add(chunk_idx, newlines_delta);
+}
+
+// Replace chunks [chunk_idx, chunk_idx+chunk_count) with new ones holding a, b then c, 3/4 full. The sources may point into the replaced chunks.
+void ImTextRope::ReplaceChunks(int chunk_idx, int chunk_count, const ImWchar* a, int a_len, const ImWchar* b, int b_len, const ImWchar* c, int c_len)
+{
+    const int total_len = a_len + b_len + c_len;
+    const int chunk_fill = IM_TEXT_ROPE_CHUNK_SIZE * 3 / 4;
+    const int new_count = (total_len + chunk_fill - 1) / chunk_fill;
+
+    ImVector<ImTextRopeChunk*> new_chunks;
+    new_chunks.resize(new_count);
+    const ImWchar* src[3] = { a, b, c };
+    const int src_len[3] = { a_len, b_len, c_len };
+    int src_idx = 0, src_pos = 0;
+    for (int n = 0; n < new_count; n++)
+    {
+        ImTextRopeChunk* chunk = new_chunks[n] = (ImTextRopeChunk*)ImGui::MemAlloc(sizeof(ImTextRopeChunk));
+        chunk->Len = total_len / new_count + ((n < total_len % new_count) ? 1 : 0);     // Spread evenly
+        for (int dst_pos = 0; dst_pos < chunk->Len; )
+        {
+            while (src_pos == src_len[src_idx])
+                src_idx++, src_pos = 0;
+            const int copy_len = ImMin(chunk->Len - dst_pos, src_len[src_idx] - src_pos);
+            memcpy(chunk->Text + dst_pos, src[src_idx] + src_pos, (size_t)copy_len * sizeof(ImWchar));
+            dst_pos += copy_len;
+            src_pos += copy_len;
+        }
+        chunk->LenUtf8 = ImTextCountUtf8BytesFromStr(chunk->Text, chunk->Text + chunk->Len);
+        chunk->Newlines = ImTextCountNewlines(chunk->Text, chunk->Text + chunk->Len);
+    }
+
+    for (int n = chunk_idx; n < chunk_idx + chunk_count; n++)
+        ImGui::MemFree(Chunks[n]);
+    const int old_size = Chunks.Size;
+    const int new_size = old_size - chunk_count + new_count;
+    if (new_size > old_size)
+        Chunks.resize(new_size);
+    memmove(Chunks.Data + chunk_idx + new_count, Chunks.Data + chunk_idx + chunk_count, (size_t)(old_size - chunk_idx - chunk_count) * sizeof(ImTextRopeChunk*));
+    if (new_count > 0)
+        memcpy(Chunks.Data + chunk_idx, new_chunks.Data, (size_t)new_count * sizeof(ImTextRopeChunk*));
+    Chunks.resize(new_size);
+    RebuildTrees();
+}
+
+int ImTextRope::FindChunk(int pos, int* out_chunk_begin) const
+{
+    IM_ASSERT(pos >= 0 && pos <= Len && Chunks.Size > 0);
+    if (pos >= Len)
+    {
+        *out_chunk_begin = Len - Chunks.back()->Len;
+        return Chunks.Size - 1;
+    }
+    return LenTree.Find(pos, out_chunk_begin);
+}
+
+void ImTextRope::Insert(int pos, const ImWchar* text, int text_len)
+{
+    IM_ASSERT(pos >= 0 && pos <= Len);
+    if (text_len <= 0)
+        return;
+    EditEnd = HasEdits() ? ImMax(EditEnd >= pos ? EditEnd + text_len : EditEnd, pos + text_len) : pos + text_len;
+    EditBegin = ImMin(EditBegin, pos);
+    CacheChunk = -1;
+
+    if (Chunks.Size == 0)
+    {
+        ReplaceChunks(0, 0, text, text_len, NULL, 0, NULL, 0);
+        return;
+    }
+    int chunk_begin;
+    const int chunk_idx = FindChunk(pos, &chunk_begin);
+    ImTextRopeChunk* chunk = Chunks[chunk_idx];
+    const int offset = pos - chunk_begin;
+    if (chunk->Len + text_len > IM_TEXT_ROPE_CHUNK_SIZE)
+    {
+        ReplaceChunks(chunk_idx, 1, chunk->Text, offset, text, text_len, chunk->Text + offset, chunk->Len - offset);
+        return;
+    }
+    memmove(chunk->Text + offset + text_len, chunk->Text + offset, (size_t)(chunk->Len - offset) * sizeof(ImWchar));
+    memcpy(chunk->Text + offset, text, (size_t)text_len * sizeof(ImWchar));
+    UpdateChunk(chunk_idx, text_len, ImTextCountUtf8BytesFromStr(text, text + text_len), ImTextCountNewlines(text, text + text_len));
+}
+
+void ImTextRope::Delete(int pos, int count)
+{
+    IM_ASSERT(pos >= 0 && count >= 0 && pos + count <= Len);
+    if (count <= 0)
+        return;
+    EditEnd = HasEdits() ? ImMax(EditEnd >= pos + count ? EditEnd - count : ImMin(EditEnd, pos), pos) : pos;
+    EditBegin = ImMin(EditBegin, pos);
+    CacheChunk = -1;
+
+    int first_begin, last_begin;
+    const int first_idx = FindChunk(pos, &first_begin);
+    const int last_idx = FindChunk(pos + count - 1, &last_begin);
+    ImTextRopeChunk* first = Chunks[first_idx];
+    ImTextRopeChunk* last = Chunks[last_idx];
+    const int first_offset = pos - first_begin;
+    const int last_offset = pos + count - last_begin;
+    if (first_idx != last_idx)
+    {
+        ReplaceChunks(first_idx, last_idx - first_idx + 1, first->Text, first_offset, last->Text + last_offset, last->Len - last_offset, NULL, 0);
+        return;
+    }
+
+    const ImWchar* deleted = first->Text + first_offset;
+    const int len_utf8_delta = -ImTextCountUtf8BytesFromStr(deleted, deleted + count);
+    const int newlines_delta = -ImTextCountNewlines(deleted, deleted + count);
+    memmove(first->Text + first_offset, first->Text + first_offset + count, (size_t)(first->Len - first_offset - count) * sizeof(ImWchar));
+    UpdateChunk(first_idx, -count, len_utf8_delta, newlines_delta);
+
+    // Merge with the next chunk once both are mostly empty, so deleting a character at a time doesn't leave a trail of small chunks
+    if (first->Len == 0 || (first_idx + 1 < Chunks.Size && first->Len + Chunks[first_idx + 1]->Len <= IM_TEXT_ROPE_CHUNK_SIZE / 2))
+    {
+        ImTextRopeChunk* next = (first_idx + 1 < Chunks.Size) ? Chunks[first_idx + 1] : NULL;
+        ReplaceChunks(first_idx, next ? 2 : 1, first->Text, first->Len, next ? next->Text : NULL, next ? next->Len : 0, NULL, 0);
+    }
+}
+
+int ImTextRope::GetLineStart(int line) const
+{
+    if (line <= 0)
+        return 0;
+    if (line > Newlines)
+        return Len;
+    int newlines_before;
+    const int chunk_idx = NewlinesTree.Find(line - 1, &newlines_before);
+    const ImTextRopeChunk* chunk = Chunks[chunk_idx];
+    int remaining = line - newlines_before;
+    for (int n = 0; n < chunk->Len; n++)
+        if (chunk->Text[n] == '\n' && --remaining == 0)
+            return LenTree.PrefixSum(chunk_idx) + n + 1;
+    IM_ASSERT(0);
+    return Len;
+}
+
+int ImTextRope::GetLineFromPos(int pos) const
+{
+    if (pos >= Len)
+        return Newlines;
+    int chunk_begin;
+    const int chunk_idx = FindChunk(pos, &chunk_begin);
+    const ImTextRopeChunk* chunk = Chunks[chunk_idx];
+    return NewlinesTree.PrefixSum(chunk_idx) + ImTextCountNewlines(chunk->Text, chunk->Text + pos - chunk_begin);
+}
+
+int ImTextRope::GetUtf8Offset(int pos) const
+{
+    if (pos >= Len)
+        return LenUtf8;
+    int chunk_begin;
+    const int chunk_idx = FindChunk(pos, &chunk_begin);
+    const ImTextRopeChunk* chunk = Chunks[chunk_idx];
+    return LenUtf8Tree.PrefixSum(chunk_idx) + ImTextCountUtf8BytesFromStr(chunk->Text, chunk->Text + pos - chunk_begin);
+}
+
+int ImTextRope::GetPosFromUtf8Offset(int offset) const
+{
+    if (offset <= 0)
+        return 0;
+    if (offset >= LenUtf8)
+        return Len;
+    int bytes;
+    const int chunk_idx = LenUtf8Tree.Find(offset, &bytes);
+    const ImTextRopeChunk* chunk = Chunks[chunk_idx];
+    int n = 0;
+    while (bytes < offset && n < chunk->Len)
+        bytes += ImTextCountUtf8BytesFromChar(chunk->Text[n++]);
+    return LenTree.PrefixSum(chunk_idx) + n;
+}
+
+int ImTextRope::CopyUtf8(char* buf, int begin, int end) const
+{
+    char* buf_out = buf;
+    if (begin >= end)
+        return 0;
+    int chunk_begin;
+    for (int chunk_idx = FindChunk(begin, &chunk_begin); chunk_idx < Chunks.Size && chunk_begin < end; chunk_begin += Chunks[chunk_idx++]->Len)
+    {
+        const ImTextRopeChunk* chunk = Chunks[chunk_idx];
+        const ImWchar* p_end = chunk->Text + ImMin(chunk->Len, end - chunk_begin);
+        for (const ImWchar* p = chunk->Text + ImMax(begin - chunk_begin, 0); p < p_end; p++)
+        {
+            unsigned int c = (unsigned int)*p;
+            if (c < 0x80)
+                *buf_out++ = (char)c;
+            else
+                buf_out += ImTextCharToUtf8(buf_out, 4, c);
+        }
+    }
+    return (int)(buf_out - buf);
+}
+
 //-----------------------------------------------------------------------------
 // [SECTION] MISC HELPER/UTILTIES (Color functions)
 // Note: The Convert functions are early design which are not consistent with other API.
@@ -1718,52 +2238,122 @@ ImU32 ImGui::GetColorU32(ImU32 col)
 // Helper: Key->value storage
 //-----------------------------------------------------------------------------
 
-// std::lower_bound but without the bullshit
-static ImVector<ImGuiStorage::Pair>::iterator LowerBound(ImVector<ImGuiStorage::Pair>& data, ImGuiID key)
+// Keys are IDs which are already hashes, but users also store small or sequential keys: Fibonacci hashing spreads those,
+// folding the high bits down since we index with the low ones.
+static inline int ImGuiStorageFirstGroup(ImGuiID key, int group_mask)
 {
-    ImVector<ImGuiStorage::Pair>::iterator first = data.begin();
-    ImVector<ImGuiStorage::Pair>::iterator last = data.end();
-    size_t count = (size_t)(last - first);
-    while (count > 0)
+    ImU32 h = key * 2654435769u;
+    return (int)((h ^ (h >> 16)) & (ImU32)group_mask);
+}
+
+// Bit n set if group[n] == key
+static inline int ImGuiStorageGroupMatch(const ImGuiID* group, ImGuiID key)
+{
+#ifdef IMGUI_HASH_X86
+    __m128i keys = _mm_loadu_si128((const __m128i*)group);
+    return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(keys, _mm_set1_epi32((int)key))));
+#else
+    return (group[0] == key ? 1 : 0) | (group[1] == key ? 2 : 0) | (group[2] == key ? 4 : 0) | (group[3] == key ? 8 : 0);
+#endif
+}
+
+static inline int ImGuiStorageFirstBit(int mask)
+{
+    return (mask & 1) ? 0 : (mask & 2) ? 1 : (mask & 4) ? 2 : 3;
+}
+
+// Slot holding 'key', or the empty slot where it goes. Since nothing is ever removed, a group with an empty slot ends the probe:
+// the key would have been put there. Requires key != 0 and a table that isn't full (the load factor is kept under 3/4).
+static int ImGuiStorageFindSlot(const ImVector<ImGuiID>& keys, ImGuiID key)
+{
+    const int group_mask = (keys.Size >> 2) - 1;
+    for (int group = ImGuiStorageFirstGroup(key, group_mask); ; group = (group + 1) & group_mask)
     {
-        size_t count2 = count >> 1;
-        ImVector<ImGuiStorage::Pair>::iterator mid = first + count2;
-        if (mid->key < key)
-        {
-            first = ++mid;
-            count -= count2 + 1;
-        }
-        else
-        {
-            count = count2;
-        }
+        const ImGuiID* group_keys = keys.Data + group * 4;
+        if (int match = ImGuiStorageGroupMatch(group_keys, key))
+            return group * 4 + ImGuiStorageFirstBit(match);
+        if (int empty = ImGuiStorageGroupMatch(group_keys, 0))
+            return group * 4 + ImGuiStorageFirstBit(empty);
     }
-    return first;
 }
 
-// For quicker full rebuild of a storage (instead of an incremental one), you may add all your contents and then sort once.
-void ImGuiStorage::BuildSortByKey()
+static void ImGuiStorageRehash(ImGuiStorage* storage, int capacity)
 {
-    struct StaticFunc
+    IM_ASSERT(capacity >= 16 && (capacity & (capacity - 1)) == 0);
+    ImVector<ImGuiID> keys;
+    ImVector<ImGuiStorage::Value> values;
+    ImGuiStorage::Value zero_value;
+    zero_value.val_p = NULL;
+    keys.resize(capacity, 0);
+    values.resize(capacity + 1, zero_value);    // Slots are only ever claimed once, so new values start zeroed
+    const int old_capacity = storage->Keys.Size;
+    for (int i = 0; i < old_capacity; i++)
     {
-        static int IMGUI_CDECL PairCompareByID(const void* lhs, const void* rhs)
-        {
-            // We can't just do a subtraction because qsort uses signed integers and subtracting our ID doesn't play well with that.
-            if (((const Pair*)lhs)->key > ((const Pair*)rhs)->key) return +1;
-            if (((const Pair*)lhs)->key < ((const Pair*)rhs)->key) return -1;
-            return 0;
-        }
-    };
-    if (Data.Size > 1)
-        ImQsort(Data.Data, (size_t)Data.Size, sizeof(Pair), StaticFunc::PairCompareByID);
+        ImGuiID key = storage->Keys.Data[i];
+        if (key == 0)
+            continue;
+        int slot = ImGuiStorageFindSlot(keys, key);
+        keys.Data[slot] = key;
+        values.Data[slot] = storage->Values.Data[i];
+    }
+    if (storage->HasZeroKey)
+        values.Data[capacity] = storage->Values.Data[old_capacity];
+    storage->Keys.swap(keys);
+    storage->Values.swap(values);
+}
+
+void ImGuiStorage::Reserve(int count)
+{
+    int capacity = Keys.Size > 16 ? Keys.Size : 16;
+    while (capacity * 3 < count * 4)
+        capacity *= 2;
+    if (capacity > Keys.Size)
+        ImGuiStorageRehash(this, capacity);
+}
+
+const ImGuiStorage::Value* ImGuiStorage::FindValue(ImGuiID key) const
+{
+    if (key == 0)
+        return HasZeroKey ? &Values.Data[Keys.Size] : NULL;
+    if (Keys.Size == 0)
+        return NULL;
+    int slot = ImGuiStorageFindSlot(Keys, key);
+    return Keys.Data[slot] == key ? &Values.Data[slot] : NULL;
+}
+
+ImGuiStorage::Value* ImGuiStorage::FindOrInsertValue(ImGuiID key, bool* inserted)
+{
+    *inserted = false;
+    if (key != 0 && Keys.Size > 0)
+    {
+        int slot = ImGuiStorageFindSlot(Keys, key);
+        if (Keys.Data[slot] == key)
+            return &Values.Data[slot];
+    }
+    else if (key == 0 && HasZeroKey)
+    {
+        return &Values.Data[Keys.Size];
+    }
+
+    // Grow before inserting so FindSlot always has an empty slot to stop at
+    if ((Count + 1) * 4 > Keys.Size * 3)
+        ImGuiStorageRehash(this, Keys.Size > 0 ? Keys.Size * 2 : 16);
+    *inserted = true;
+    Count++;
+    if (key == 0)
+    {
+        HasZeroKey = true;
+        return &Values.Data[Keys.Size];
+    }
+    int slot = ImGuiStorageFindSlot(Keys, key);
+    Keys.Data[slot] = key;
+    return &Values.Data[slot];
 }
 
 int ImGuiStorage::GetInt(ImGuiID key, int default_val) const
 {
-    ImVector<Pair>::iterator it = LowerBound(const_cast<ImVector<ImGuiStorage::Pair>&>(Data), key);
-    if (it == Data.end() || it->key != key)
-        return default_val;
-    return it->val_i;
+    const Value* value = FindValue(key);
+    return value ? value->val_i : default_val;
 }
 
 bool ImGuiStorage::GetBool(ImGuiID key, bool default_val) const
@@ -1773,27 +2363,24 @@ bool ImGuiStorage::GetBool(ImGuiID key, bool default_val) const
 
 float ImGuiStorage::GetFloat(ImGuiID key, float default_val) const
 {
-    ImVector<Pair>::iterator it = LowerBound(const_cast<ImVector<ImGuiStorage::Pair>&>(Data), key);
-    if (it == Data.end() || it->key != key)
-        return default_val;
-    return it->val_f;
+    const Value* value = FindValue(key);
+    return value ? value->val_f : default_val;
 }
 
 void* ImGuiStorage::GetVoidPtr(ImGuiID key) const
 {
-    ImVector<Pair>::iterator it = LowerBound(const_cast<ImVector<ImGuiStorage::Pair>&>(Data), key);
-    if (it == Data.end() || it->key != key)
-        return NULL;
-    return it->val_p;
+    const Value* value = FindValue(key);
+    return value ? value->val_p : NULL;
 }
 
 // References are only valid until a new value is added to the storage. Calling a Set***() function or a Get***Ref() function invalidates the pointer.
 int* ImGuiStorage::GetIntRef(ImGuiID key, int default_val)
 {
-    ImVector<Pair>::iterator it = LowerBound(Data, key);
-    if (it == Data.end() || it->key != key)
-        it = Data.insert(it, Pair(key, default_val));
-    return &it->val_i;
+    bool inserted;
+    Value* value = FindOrInsertValue(key, &inserted);
+    if (inserted)
+        value->val_i = default_val;
+    return &value->val_i;
 }
 
 bool* ImGuiStorage::GetBoolRef(ImGuiID key, bool default_val)
@@ -1803,30 +2390,27 @@ bool* ImGuiStorage::GetBoolRef(ImGuiID key, bool default_val)
 
 float* ImGuiStorage::GetFloatRef(ImGuiID key, float default_val)
 {
-    ImVector<Pair>::iterator it = LowerBound(Data, key);
-    if (it == Data.end() || it->key != key)
-        it = Data.insert(it, Pair(key, default_val));
-    return &it->val_f;
+    bool inserted;
+    Value* value = FindOrInsertValue(key, &inserted);
+    if (inserted)
+        value->val_f = default_val;
+    return &value->val_f;
 }
 
 void** ImGuiStorage::GetVoidPtrRef(ImGuiID key, void* default_val)
 {
-    ImVector<Pair>::iterator it = LowerBound(Data, key);
-    if (it == Data.end() || it->key != key)
-        it = Data.insert(it, Pair(key, default_val));
-    return &it->val_p;
+    bool inserted;
+    Value* value = FindOrInsertValue(key, &inserted);
+    if (inserted)
+        value->val_p = default_val;
+    return &value->val_p;
 }
 
-// FIXME-OPT: Need a way to reuse the result of lower_bound when doing GetInt()/SetInt() - not too bad because it only happens on explicit interaction (maximum one a frame)
 void ImGuiStorage::SetInt(ImGuiID key, int val)
 {
-    ImVector<Pair>::iterator it = LowerBound(Data, key);
-    if (it == Data.end() || it->key != key)
-    {
-        Data.insert(it, Pair(key, val));
-        return;
-    }
-    it->val_i = val;
+    bool inserted;
+    Value* value = FindOrInsertValue(key, &inserted);
+    value->val_i = val;
 }
 
 void ImGuiStorage::SetBool(ImGuiID key, bool val)
@@ -1836,30 +2420,26 @@ void ImGuiStorage::SetBool(ImGuiID key, bool val)
 
 void ImGuiStorage::SetFloat(ImGuiID key, float val)
 {
-    ImVector<Pair>::iterator it = LowerBound(Data, key);
-    if (it == Data.end() || it->key != key)
-    {
-        Data.insert(it, Pair(key, val));
-        return;
-    }
-    it->val_f = val;
+    bool inserted;
+    Value* value = FindOrInsertValue(key, &inserted);
+    value->val_f = val;
 }
 
 void ImGuiStorage::SetVoidPtr(ImGuiID key, void* val)
 {
-    ImVector<Pair>::iterator it = LowerBound(Data, key);
-    if (it == Data.end() || it->key != key)
-    {
-        Data.insert(it, Pair(key, val));
-        return;
-    }
-    it->val_p = val;
+    bool inserted;
+    Value* value = FindOrInsertValue(key, &inserted);
+    value->val_p = val;
 }
 
+// Slot order only depends on the keys and the order they went in, never on addresses
 void ImGuiStorage::SetAllInt(int v)
 {
-    for (int i = 0; i < Data.Size; i++)
-        Data[i].val_i = v;
+    for (int i = 0; i < Keys.Size; i++)
+        if (Keys.Data[i] != 0)
+            Values.Data[i].val_i = v;
+    if (HasZeroKey)
+        Values.Data[Keys.Size].val_i = v;
 }
 
 //-----------------------------------------------------------------------------
@@ -2102,6 +2682,151 @@ bool ImGuiListClipper::Step()
     return false;
 }
 
+// Entries only move at the first lookup of a frame in the window, when no clipper holds an index into them. That is when the ones not used the
+// last time the window ran its clippers get dropped: with an ID per row, nested lists would otherwise pile up as rows scroll by.
+static int FindOrAddListClipperHeights(ImGuiWindow* window, ImGuiID id)
+{
+    ImGuiContext& g = *GImGui;
+    ImVector<ImGuiListClipperHeights>& storage = window->ListClipperHeightsStorage;
+    int last_frame_used = -1;
+    for (int n = 0; n < storage.Size; n++)
+        last_frame_used = ImMax(last_frame_used, storage[n].LastFrameUsed);
+    if (last_frame_used != g.FrameCount)
+    {
+        int kept = 0;
+        for (int n = 0; n < storage.Size; n++)
+        {
+            if (storage[n].LastFrameUsed != last_frame_used)
+                storage[n].~ImGuiListClipperHeights();
+            else if (kept++ != n)
+                memcpy((void*)&storage[kept - 1], (const void*)&storage[n], sizeof(ImGuiListClipperHeights)); // ImVector moves as plain bytes
+        }
+        storage.resize(kept);
+    }
+
+    for (int n = 0; n < storage.Size; n++)
+        if (storage[n].ID == id)
+        {
+            storage[n].LastFrameUsed = g.FrameCount;
+            return n;
+        }
+
+    storage.push_back(ImGuiListClipperHeights());
+    storage.back().ID = id;
+    storage.back().LastFrameUsed = g.FrameCount;
+    return storage.Size - 1;
+}
+
+void ImGuiVariableListClipper::Begin(const char* str_id, int items_count, float items_height)
+{
+    ImGuiContext& g = *GImGui;
+    ImGuiWindow* window = g.CurrentWindow;
+    HeightsIndex = FindOrAddListClipperHeights(window, window->GetID(str_id));
+    if (items_height <= 0.0f)
+        items_height = g.FontSize + g.Style.ItemSpacing.y;
+
+    // Items added since last frame start out estimated, removed ones are forgotten
+    ImGuiListClipperHeights* heights = &window->ListClipperHeightsStorage[HeightsIndex];
+    if (heights->Heights.Size > items_count)
+    {
+        heights->Heights.resize(items_count);
+        heights->Offsets.Shrink(items_count);
+    }
+    else if (heights->Heights.Size < items_count)
+    {
+        heights->Heights.reserve(items_count);
+        heights->Offsets.Data.reserve(items_count);
+        while (heights->Heights.Size < items_count)
+        {
+            heights->Heights.push_back(items_height);
+            heights->Offsets.Push(items_height);
+        }
+    }
+
+    StartPosY = ImGui::GetCursorPosY();
+    ItemStartY = ClipMaxY = 0.0f;
+    ItemsCount = items_count;
+    DisplayStart = DisplayEnd = -1;
+    ExtraItems = 0;
+}
+
+void ImGuiVariableListClipper::End()
+{
+    if (ItemsCount < 0)
+        return;
+    // Unless the last item was displayed, seek to where it would have left the cursor. SetCursorPosY() extends the contents to the cursor,
+    // spacing after the last item included where ItemSize() wouldn't: take it back out, so the scroll range is the same as with every item.
+    if (DisplayStart != ItemsCount - 1)
+    {
+        ImGuiWindow* window = GImGui->CurrentWindow;
+        const ImGuiListClipperHeights& heights = window->ListClipperHeightsStorage[HeightsIndex];
+        SetCursorPosYAndSetupDummyPrevLine(StartPosY + (float)heights.Offsets.PrefixSum(ItemsCount), heights.Heights[ItemsCount - 1]); // advance cursor
+        window->DC.CursorMaxPos.y -= GImGui->Style.ItemSpacing.y;
+    }
+    ItemsCount = -1;
+}
+
+bool ImGuiVariableListClipper::Step()
+{
+    ImGuiContext& g = *GImGui;
+    ImGuiWindow* window = g.CurrentWindow;
+    if (ItemsCount <= 0 || window->SkipItems)
+    {
+        ItemsCount = -1;
+        return false;
+    }
+
+    // Looked up again every step, the rows may have run clippers of their own
+    ImGuiListClipperHeights* heights = &window->ListClipperHeightsStorage[HeightsIndex];
+    if (DisplayStart < 0)
+    {
+        // First step: find the first visible item, as CalcListClipping() does for evenly spaced ones
+        ImRect unclipped_rect = window->ClipRect;
+        if (g.NavMoveRequest)
+            unclipped_rect.Add(g.NavScoringRectScreen);
+        double offset = 0.0;
+        int start = g.LogEnabled ? 0 : heights->Offsets.Find(unclipped_rect.Min.y - window->DC.CursorPos.y, &offset);
+        if (g.NavMoveRequest && g.NavMoveClipDir == ImGuiDir_Up && start > 0 && start < ItemsCount)
+            offset -= heights->Heights[--start];
+        if (start >= ItemsCount)
+        {
+            End();
+            return false;
+        }
+        ClipMaxY = g.LogEnabled ? FLT_MAX : unclipped_rect.Max.y;
+        ExtraItems = (g.NavMoveRequest && g.NavMoveClipDir == ImGuiDir_Down) ? 1 : 0;
+        if (start > 0)
+            SetCursorPosYAndSetupDummyPrevLine(StartPosY + (float)offset, heights->Heights[start - 1]); // advance cursor
+        DisplayStart = start;
+    }
+    else
+    {
+        // Measure the item just displayed, then go on until past the bottom of the clip rect
+        float height = window->DC.CursorPos.y - ItemStartY;
+        if (height != heights->Heights[DisplayStart])
+        {
+            heights->Offsets.Add(DisplayStart, (double)height - heights->Heights[DisplayStart]);
+            heights->Heights[DisplayStart] = height;
+        }
+        int next = DisplayStart + 1;
+        bool past_clip_rect = window->DC.CursorPos.y >= ClipMaxY;
+        if (past_clip_rect && ExtraItems > 0)
+        {
+            ExtraItems--;
+            past_clip_rect = false;
+        }
+        if (next >= ItemsCount || past_clip_rect)
+        {
+            End();
+            return false;
+        }
+        DisplayStart = next;
+    }
+    DisplayEnd = DisplayStart + 1;
+    ItemStartY = window->DC.CursorPos.y;
+    return true;
+}
+
 //-----------------------------------------------------------------------------
 // [SECTION] RENDER HELPERS
 // Those (internal) functions are currently quite a legacy mess - their signature and behavior will change.
@@ -2328,7 +3053,7 @@ void ImGui::RenderNavHighlight(const ImRect& bb, ImGuiID id, ImGuiNavHighlightFl
 
 // ImGuiWindow is mostly a dumb struct. It merely has a constructor and a few helper methods
 ImGuiWindow::ImGuiWindow(ImGuiContext* context, const char* name)
-    : DrawListInst(&context->DrawListSharedData)
+    : DrawListInst(&context->DrawListSharedData), DrawListBack(&context->DrawListSharedData)
 {
     Name = ImStrdup(name);
     ID = ImHash(name, 0);
@@ -2374,6 +3099,11 @@ ImGuiWindow::ImGuiWindow(ImGuiContext* context, const char* name)
 
     DrawList = &DrawListInst;
     DrawList->_OwnerName = Name;
+    DrawListBack._OwnerName = Name;
+    Retained = RetainedValid = false;
+    RetainedKey = 0;
+    RetainedScroll = RetainedCursorMaxPos = ImVec2(0.0f, 0.0f);
+    RetainedDecoVtxCount = RetainedDecoIdxCount = RetainedDecoCmdCount = 0;
     ParentWindow = NULL;
     RootWindow = NULL;
     RootWindowForTitleBarHighlight = NULL;
@@ -2394,6 +3124,8 @@ ImGuiWindow::~ImGuiWindow()
     IM_DELETE(Name);
     for (int i = 0; i != ColumnsStorage.Size; i++)
         ColumnsStorage[i].~ImGuiColumnsSet();
+    for (int i = 0; i != ListClipperHeightsStorage.Size; i++)
+        ListClipperHeightsStorage[i].~ImGuiListClipperHeights();
 }
 
 ImGuiID ImGuiWindow::GetID(const char* str, const char* str_end)
@@ -2792,6 +3524,16 @@ void ImGui::MemFree(void* ptr)
     return GImAllocatorFreeFunc(ptr, GImAllocatorUserData);
 }
 
+void* ImGui::MemAllocNoMetrics(size_t size)
+{
+    return GImAllocatorAllocFunc(size, GImAllocatorUserData);
+}
+
+void ImGui::MemFreeNoMetrics(void* ptr)
+{
+    GImAllocatorFreeFunc(ptr, GImAllocatorUserData);
+}
+
 const char* ImGui::GetClipboardText()
 {
     return GImGui->IO.GetClipboardTextFn ? GImGui->IO.GetClipboardTextFn(GImGui->IO.ClipboardUserData) : "";
@@ -3178,6 +3920,8 @@ void ImGui::NewFrame()
     g.WindowsActiveCount = 0;
 
     // Setup current font and draw list
+    ImFontAtlasDynamicNewFrame(g.IO.Fonts);
+    g.TextCache.NewFrame();
     g.IO.Fonts->Locked = true;
     SetCurrentFont(GetDefaultFont());
     IM_ASSERT(g.Font->IsLoaded());
@@ -3185,7 +3929,7 @@ void ImGui::NewFrame()
     g.DrawListSharedData.CurveTessellationTol = g.Style.CurveTessellationTol;
 
     g.OverlayDrawList.Clear();
-    g.OverlayDrawList.PushTextureID(g.IO.Fonts->TexID);
+    g.OverlayDrawList.PushTextureID(g.IO.Fonts->TexID, g.Font->IsDistanceField());
     g.OverlayDrawList.PushClipRectFullScreen();
     g.OverlayDrawList.Flags = (g.Style.AntiAliasedLines ? ImDrawListFlags_AntiAliasedLines : 0) | (g.Style.AntiAliasedFill ? ImDrawListFlags_AntiAliasedFill : 0);
 
@@ -3365,8 +4109,9 @@ void ImGui::Shutdown(ImGuiContext* context)
     g.CurrentPopupStack.clear();
     g.DrawDataBuilder.ClearFreeMemory();
     g.OverlayDrawList.ClearFreeMemory();
+    g.TextCache.Clear();
     g.PrivateClipboard.clear();
-    g.InputTextState.TextW.clear();
+    g.InputTextState.Text.Clear();
     g.InputTextState.InitialText.clear();
     g.InputTextState.TempBuffer.clear();
 
@@ -3414,6 +4159,31 @@ static void AddWindowToSortBuffer(ImVector<ImGuiWindow*>* out_sorted_windows, Im
     }
 }
 
+#if defined(IMGUI_USE_COMPACT_DRAWVERT) && defined(IMGUI_DEBUG_COMPACT_DRAWVERT)
+// Whether every triangle of draw_list fits in the compact ImDrawVert position range. A triangle with some of its corners
+// clamped to the edge of the range and some not is distorted, rather than clipped. Triangles lying entirely past the edge
+// only collapse onto it, which stays out of sight.
+static bool DrawListFitsCompactDrawVert(const ImDrawList* draw_list)
+{
+    const ImDrawVert* vtx = draw_list->VtxBuffer.Data;
+    for (int i = 0; i + 2 < draw_list->IdxBuffer.Size; i += 3)
+    {
+        const ImDrawVertPos& a = vtx[draw_list->IdxBuffer[i]].pos;
+        const ImDrawVertPos& b = vtx[draw_list->IdxBuffer[i + 1]].pos;
+        const ImDrawVertPos& c = vtx[draw_list->IdxBuffer[i + 2]].pos;
+        const short xs[3] = { a.x, b.x, c.x }, ys[3] = { a.y, b.y, c.y };
+        for (int axis = 0; axis < 2; axis++)
+        {
+            const short* v = axis ? ys : xs;
+            for (int n = 0; n < 3; n++)
+                if ((v[n] == -32768 || v[n] == 32767) && !(v[0] == v[n] && v[1] == v[n] && v[2] == v[n]))
+                    return false;
+        }
+    }
+    return true;
+}
+#endif
+
 static void AddDrawListToDrawData(ImVector<ImDrawList*>* out_list, ImDrawList* draw_list)
 {
     if (draw_list->CmdBuffer.empty())
@@ -3444,6 +4214,15 @@ static void AddDrawListToDrawData(ImVector<ImDrawList*>* out_list, ImDrawList* d
     if (sizeof(ImDrawIdx) == 2)
         IM_ASSERT(draw_list->_VtxCurrentIdx < (1 << 16) && "Too many vertices in ImDrawList using 16-bit indices. Read comment above");
 
+#if defined(IMGUI_USE_COMPACT_DRAWVERT) && defined(IMGUI_DEBUG_COMPACT_DRAWVERT)
+    // Check that draw_list stays within the +/-32767/IM_DRAWVERT_POS_SCALE pixels (+/-4095 by default) compact ImDrawVert can hold.
+    // Positions past it are clamped, which distorts a triangle crossing the edge, e.g. a long line in a child scrolled far away.
+    // A) Coarse clip what you draw yourself, the GPU scissor only clips what is left after clamping.
+    // B) Lower IM_DRAWVERT_POS_SCALE in imconfig.h for more range and less sub-pixel precision, or drop IMGUI_USE_COMPACT_DRAWVERT.
+    // This reads every index of every list, so only with IMGUI_DEBUG_COMPACT_DRAWVERT (see imconfig.h).
+    IM_ASSERT(DrawListFitsCompactDrawVert(draw_list) && "ImDrawList goes past the compact ImDrawVert position range. Read comment above");
+#endif
+
     out_list->push_back(draw_list);
 }
 
@@ -3605,6 +4384,7 @@ void ImGui::EndFrame()
     for (int i = 0; i != g.Windows.Size; i++)
     {
         ImGuiWindow* window = g.Windows[i];
+        window->DrawList = &window->DrawListInst;   // Back from DrawListBack if Retained
         if (window->Active && (window->Flags & ImGuiWindowFlags_ChildWindow))       // if a child is active its parent will add it
             continue;
         AddWindowToSortBuffer(&g.WindowsSortBuffer, window);
@@ -3687,7 +4467,7 @@ ImVec2 ImGui::CalcTextSize(const char* text, const char* text_end, bool hide_tex
     const float font_size = g.FontSize;
     if (text == text_display_end)
         return ImVec2(0.0f, font_size);
-    ImVec2 text_size = font->CalcTextSizeA(font_size, FLT_MAX, wrap_width, text, text_display_end, NULL);
+    ImVec2 text_size = g.TextCache.CalcTextSize(font, font_size, wrap_width, text, text_display_end);
 
     // Cancel out character spacing for the last character of a line (it is baked into glyph->AdvanceX field)
     const float font_scale = font_size / font->FontSize;
@@ -4563,6 +5343,61 @@ void ImGui::UpdateWindowParentAndRootLinks(ImGuiWindow* window, ImGuiWindowFlags
         window->RootWindowForNav = window->RootWindowForNav->ParentWindow;
 }
 
+// Swaps what the lists hold, not who owns them
+static void SwapDrawLists(ImDrawList* a, ImDrawList* b)
+{
+    a->CmdBuffer.swap(b->CmdBuffer);
+    a->IdxBuffer.swap(b->IdxBuffer);
+    a->VtxBuffer.swap(b->VtxBuffer);
+    ImSwap(a->Flags, b->Flags);
+    ImSwap(a->Version, b->Version);
+    ImSwap(a->_VtxCurrentIdx, b->_VtxCurrentIdx);
+    ImSwap(a->_VtxWritePtr, b->_VtxWritePtr);
+    ImSwap(a->_IdxWritePtr, b->_IdxWritePtr);
+    a->_ClipRectStack.swap(b->_ClipRectStack);
+    a->_TextureIdStack.swap(b->_TextureIdStack);
+    a->_DistanceFieldStack.swap(b->_DistanceFieldStack);
+    a->_Path.swap(b->_Path);
+    ImSwap(a->_ChannelsCurrent, b->_ChannelsCurrent);
+    ImSwap(a->_ChannelsCount, b->_ChannelsCount);
+    a->_Channels.swap(b->_Channels);
+}
+
+// Whether the title bar, background etc. just drawn into DrawListBack are the ones last frame's DrawListInst starts with
+static bool IsRetainedDrawListCurrent(ImGuiWindow* window)
+{
+    const ImDrawList& deco = window->DrawListBack;
+    const ImDrawList& kept = window->DrawListInst;
+    const int vtx_count = deco.VtxBuffer.Size, idx_count = deco.IdxBuffer.Size, cmd_count = deco.CmdBuffer.Size;
+    if (vtx_count != window->RetainedDecoVtxCount || idx_count != window->RetainedDecoIdxCount || cmd_count != window->RetainedDecoCmdCount || cmd_count == 0)
+        return false;
+    if (kept.VtxBuffer.Size < vtx_count || kept.IdxBuffer.Size < idx_count || kept.CmdBuffer.Size < cmd_count)
+        return false;
+    for (int n = 0; n < cmd_count; n++)
+    {
+        // Field by field, ImDrawCmd has padding. The last command goes on with the contents in 'kept', the indices tell its count apart.
+        const ImDrawCmd& a = deco.CmdBuffer[n];
+        const ImDrawCmd& b = kept.CmdBuffer[n];
+        if ((n < cmd_count - 1 && a.ElemCount != b.ElemCount) || a.TextureId != b.TextureId || a.DistanceField != b.DistanceField || a.UserCallback != NULL || b.UserCallback != NULL)
+            return false;
+        if (a.ClipRect.x != b.ClipRect.x || a.ClipRect.y != b.ClipRect.y || a.ClipRect.z != b.ClipRect.z || a.ClipRect.w != b.ClipRect.w)
+            return false;
+    }
+    return (vtx_count == 0 || memcmp(deco.VtxBuffer.Data, kept.VtxBuffer.Data, (size_t)vtx_count * sizeof(ImDrawVert)) == 0) &&
+           (idx_count == 0 || memcmp(deco.IdxBuffer.Data, kept.IdxBuffer.Data, (size_t)idx_count * sizeof(ImDrawIdx)) == 0);
+}
+
+// Hash the fields of a style, not its bytes: assigning a style (e.g. 'ImGui::GetStyle() = saved_style') needn't copy the padding after the bools
+IM_STATIC_ASSERT(IM_OFFSETOF(ImGuiStyle, AntiAliasedLines) == IM_OFFSETOF(ImGuiStyle, MouseCursorScale) + sizeof(float));
+static ImU32 HashStyle(const ImGuiStyle& style, ImU32 seed)
+{
+    seed = ImHash(&style, (int)IM_OFFSETOF(ImGuiStyle, AntiAliasedLines), seed);     // Alpha..MouseCursorScale, floats and ImVec2 only
+    seed = ImHash(&style.AntiAliasedLines, sizeof(bool), seed);
+    seed = ImHash(&style.AntiAliasedFill, sizeof(bool), seed);
+    seed = ImHash(&style.CurveTessellationTol, sizeof(float), seed);
+    return ImHash(style.Colors, sizeof(style.Colors), seed);
+}
+
 // Push a new ImGui window to add widgets to.
 // - A default window called "Debug" is automatically stacked at the beginning of every frame so you can use widgets without explicitly calling a Begin/End pair.
 // - Begin/End can be called multiple times during the frame with the same window name to append content.
@@ -4679,6 +5514,8 @@ bool ImGui::Begin(const char* name, bool* p_open, ImGuiWindowFlags flags)
         SetWindowConditionAllowFlags(window, ImGuiCond_Appearing, false);
 
     // When reusing window again multiple times a frame, just append content (don't need to setup again)
+    bool retain_allowed = false, retain_candidate = false;
+    ImU32 retain_key = 0;
     if (first_begin_of_the_frame)
     {
         // Initialize
@@ -4870,12 +5707,33 @@ bool ImGui::Begin(const char* name, bool* p_open, ImGuiWindowFlags flags)
         else
             window->ItemWidthDefault = (float)(int)(g.FontSize * 16.0f);
 
+        // Retained contents: with a content version that didn't change, a window idle now and when it was built keeps last frame's
+        // draw list, as long as the title bar, background etc. come out the same. Those go to DrawListBack first, to compare.
+        window->Retained = false;
+        if (g.NextWindowData.ContentVersionCond)
+        {
+            retain_allowed = !(flags & ImGuiWindowFlags_ChildWindow) && window->DC.ChildWindows.Size == 0 && g.HoveredWindow != window && g.ActiveIdWindow != window &&
+                !(g.NavWindow && g.NavWindow->RootWindow == window) && !g.NavWindowingTarget && !g.LogEnabled;
+            for (int n = 0; n < g.OpenPopupStack.Size && retain_allowed; n++)
+                retain_allowed = (g.OpenPopupStack[n].ParentWindow != window);
+            retain_key = HashStyle(g.Style, g.NextWindowData.ContentVersionVal);
+            retain_key = ImHash(&g.Font, sizeof(g.Font), retain_key);
+            retain_key = ImHash(&g.FontSize, sizeof(g.FontSize), retain_key);
+            for (int n = 0; n < g.IO.Fonts->Fonts.Size; n++)
+                retain_key = ImHash(&g.IO.Fonts->Fonts[n]->Generation, sizeof(int), retain_key);  // Dynamic glyphs moved: the kept UVs are stale
+            retain_candidate = retain_allowed && window->RetainedValid && window->RetainedKey == retain_key && !window_just_activated_by_user && !window->Appearing &&
+                window->HiddenFramesRegular <= 0 && window->HiddenFramesForResize <= 0 && window->AutoFitFramesX <= 0 && window->AutoFitFramesY <= 0 &&
+                window->Scroll.x == window->RetainedScroll.x && window->Scroll.y == window->RetainedScroll.y;
+        }
+        if (retain_candidate)
+            window->DrawList = &window->DrawListBack;
+
         // DRAWING
 
         // Setup draw list and outer clipping rectangle
         window->DrawList->Clear();
         window->DrawList->Flags = (g.Style.AntiAliasedLines ? ImDrawListFlags_AntiAliasedLines : 0) | (g.Style.AntiAliasedFill ? ImDrawListFlags_AntiAliasedFill : 0);
-        window->DrawList->PushTextureID(g.Font->ContainerAtlas->TexID);
+        window->DrawList->PushTextureID(g.Font->ContainerAtlas->TexID, g.Font->IsDistanceField());
         ImRect viewport_rect(GetViewportRect());
         if ((flags & ImGuiWindowFlags_ChildWindow) && !(flags & ImGuiWindowFlags_Popup) && !window_is_child_tooltip)
             PushClipRect(parent_window->ClipRect.Min, parent_window->ClipRect.Max, true);
@@ -5131,6 +5989,31 @@ bool ImGui::Begin(const char* name, bool* p_open, ImGuiWindowFlags flags)
     if (first_begin_of_the_frame)
         window->WriteAccessed = false;
 
+    // Keep last frame's draw list, or build on the title bar etc. just drawn
+    if (first_begin_of_the_frame && retain_allowed)
+    {
+        if (retain_candidate && IsRetainedDrawListCurrent(window))
+        {
+            window->Retained = true;    // DrawList stays on DrawListBack until EndFrame(), so nothing touches the kept one
+            window->DC.CursorMaxPos = window->RetainedCursorMaxPos;
+        }
+        else
+        {
+            if (retain_candidate)
+            {
+                SwapDrawLists(&window->DrawListInst, &window->DrawListBack);
+                window->DrawList = &window->DrawListInst;
+            }
+            window->RetainedKey = retain_key;
+            window->RetainedScroll = window->Scroll;
+            window->RetainedDecoVtxCount = window->DrawList->VtxBuffer.Size;
+            window->RetainedDecoIdxCount = window->DrawList->IdxBuffer.Size;
+            window->RetainedDecoCmdCount = window->DrawList->CmdBuffer.Size;
+        }
+    }
+    if (first_begin_of_the_frame && !window->Retained)
+        window->RetainedValid = retain_allowed;
+
     window->BeginCount++;
     g.NextWindowData.Clear();
 
@@ -5157,7 +6040,7 @@ bool ImGui::Begin(const char* name, bool* p_open, ImGuiWindowFlags flags)
     window->Hidden = (window->HiddenFramesRegular > 0) || (window->HiddenFramesForResize);
 
     // Return false if we don't intend to display anything to allow user to perform an early out optimization
-    window->SkipItems = (window->Collapsed || !window->Active || window->Hidden) && window->AutoFitFramesX <= 0 && window->AutoFitFramesY <= 0 && window->HiddenFramesForResize <= 0;
+    window->SkipItems = window->Retained || ((window->Collapsed || !window->Active || window->Hidden) && window->AutoFitFramesX <= 0 && window->AutoFitFramesY <= 0 && window->HiddenFramesForResize <= 0);
 
     return !window->SkipItems;
 }
@@ -5186,6 +6069,7 @@ void ImGui::End()
     if (window->DC.ColumnsSet != NULL)
         EndColumns();
     PopClipRect();   // Inner window clip rectangle
+    window->RetainedCursorMaxPos = window->DC.CursorMaxPos;
 
     // Stop logging
     if (!(window->Flags & ImGuiWindowFlags_ChildWindow))    // FIXME: add more options for scope of logging
@@ -5357,7 +6241,7 @@ void ImGui::PushFont(ImFont* font)
         font = GetDefaultFont();
     SetCurrentFont(font);
     g.FontStack.push_back(font);
-    g.CurrentWindow->DrawList->PushTextureID(font->ContainerAtlas->TexID);
+    g.CurrentWindow->DrawList->PushTextureID(font->ContainerAtlas->TexID, font->IsDistanceField());
 }
 
 void  ImGui::PopFont()
@@ -5888,6 +6772,13 @@ void ImGui::SetNextWindowBgAlpha(float alpha)
     g.NextWindowData.BgAlphaCond = ImGuiCond_Always; // Using a Cond member for consistency (may transition all of them to single flag set for fast Clear() op)
 }
 
+void ImGui::SetNextWindowContentVersion(ImU32 version)
+{
+    ImGuiContext& g = *GImGui;
+    g.NextWindowData.ContentVersionVal = version;
+    g.NextWindowData.ContentVersionCond = ImGuiCond_Always;
+}
+
 // In window space (not screen space!)
 ImVec2 ImGui::GetContentRegionMax()
 {
@@ -8932,8 +9823,9 @@ void ImGui::ShowMetricsWindow(bool* p_open)
                         for (int n = 0; n < 3; n++, vtx_i++)
                         {
                             ImDrawVert& v = draw_list->VtxBuffer[idx_buffer ? idx_buffer[vtx_i] : vtx_i];
-                            triangles_pos[n] = v.pos;
-                            buf_p += ImFormatString(buf_p, (int)(buf_end - buf_p), "%s %04d: pos (%8.2f,%8.2f), uv (%.6f,%.6f), col %08X\n", (n == 0) ? "vtx" : "   ", vtx_i, v.pos.x, v.pos.y, v.uv.x, v.uv.y, v.col);
+                            const ImVec2 v_pos = v.pos, v_uv = v.uv;
+                            triangles_pos[n] = v_pos;
+                            buf_p += ImFormatString(buf_p, (int)(buf_end - buf_p), "%s %04d: pos (%8.2f,%8.2f), uv (%.6f,%.6f), col %08X\n", (n == 0) ? "vtx" : "   ", vtx_i, v_pos.x, v_pos.y, v_uv.x, v_uv.y, v.col);
                         }
                         ImGui::Selectable(buf, false);
                         if (ImGui::IsItemHovered())
@@ -8963,7 +9855,9 @@ void ImGui::ShowMetricsWindow(bool* p_open)
             if (!ImGui::TreeNode(window, "%s '%s', %d @ 0x%p", label, window->Name, window->Active || window->WasActive, window))
                 return;
             ImGuiWindowFlags flags = window->Flags;
-            NodeDrawList(window, window->DrawList, "DrawList");
+            NodeDrawList(window, &window->DrawListInst, "DrawList");
+            if (window->RetainedValid)
+                ImGui::BulletText("Retained: %s", window->Retained ? "yes, kept last frame's DrawList" : "no, built this frame");
             ImGui::BulletText("Pos: (%.1f,%.1f), Size: (%.1f,%.1f), SizeContents (%.1f,%.1f)", window->Pos.x, window->Pos.y, window->Size.x, window->Size.y, window->SizeContents.x, window->SizeContents.y);
             ImGui::BulletText("Flags: 0x%08X (%s%s%s%s%s%s%s%s%s..)", flags,
                 (flags & ImGuiWindowFlags_ChildWindow)  ? "Child " : "",      (flags & ImGuiWindowFlags_Tooltip)     ? "Tooltip "   : "",  (flags & ImGuiWindowFlags_Popup) ? "Popup " : "",
@@ -8996,7 +9890,7 @@ void ImGui::ShowMetricsWindow(bool* p_open)
                 }
                 ImGui::TreePop();
             }
-            ImGui::BulletText("Storage: %d bytes", window->StateStorage.Data.Size * (int)sizeof(ImGuiStorage::Pair));
+            ImGui::BulletText("Storage: %d bytes", window->StateStorage.GetMemoryUsage());
             ImGui::TreePop();
         }
     };
@@ -9019,6 +9913,23 @@ void ImGui::ShowMetricsWindow(bool* p_open)
         }
         ImGui::TreePop();
     }
+    if (ImGui::TreeNode("Text layout cache"))
+    {
+        ImFontTextCache& cache = g.TextCache;
+        ImGui::Checkbox("Enabled", &cache.Enabled);
+        const int lookups = cache.LastFrameHits + cache.LastFrameMisses;
+        ImGui::Text("Last frame: %d hits, %d misses (%.1f%% hit rate)", cache.LastFrameHits, cache.LastFrameMisses, lookups > 0 ? 100.0f * cache.LastFrameHits / lookups : 0.0f);
+        int used = 0, with_vertices = 0;
+        for (int i = 0; i < cache.Entries.Size; i++)
+        {
+            used += cache.Entries[i].Hash != 0;
+            with_vertices += cache.Entries[i].HasVertices;
+        }
+        ImGui::Text("Entries: %d/%d used, %d with quads, %d bytes", used, IM_FONT_TEXT_CACHE_SETS * IM_FONT_TEXT_CACHE_WAYS, with_vertices, cache.GetMemoryUsage());
+        if (ImGui::Button("Clear"))
+            cache.Clear();
+        ImGui::TreePop();
+    }
     if (ImGui::TreeNode("Internal state"))
     {
         const char* input_source_names[] = { "None", "Mouse", "Nav", "NavKeyboard", "NavGamepad" }; IM_ASSERT(IM_ARRAYSIZE(input_source_names) == ImGuiInputSource_COUNT);
@@ -65,7 +65,8 @@ struct ImDrawCmd;                   // A single draw command within a parent ImD
 struct ImDrawData;                  // All draw command lists required to render the frame
 struct ImDrawList;                  // A single draw command list (generally one per window, conceptually you may see this as a dynamic "mesh" builder)
 struct ImDrawListSharedData;        // Data shared among multiple draw lists (typically owned by parent ImGui context, but you may create one yourself)
-struct ImDrawVert;                  // A single vertex (20 bytes by default, override layout with IMGUI_OVERRIDE_DRAWVERT_STRUCT_LAYOUT)
+struct ImDrawListArcCache;          // Arcs a draw list already computed in PathArcTo() (internal)
+struct ImDrawVert;                  // A single vertex (20 bytes by default, 12 with IMGUI_USE_COMPACT_DRAWVERT, override layout with IMGUI_OVERRIDE_DRAWVERT_STRUCT_LAYOUT)
 struct ImFont;                      // Runtime data for a single font within a parent ImFontAtlas
 struct ImFontAtlas;                 // Runtime data for multiple fonts, bake multiple fonts into a single texture, TTF/OTF font loader
 struct ImFontConfig;                // Configuration data when adding a font or merging fonts
@@ -79,6 +80,7 @@ struct ImGuiInputTextCallbackData;  // Shared state of InputText() when using cu
 struct ImGuiListClipper;            // Helper to manually clip large list of items
 struct ImGuiOnceUponAFrame;         // Helper for running a block of code not more than once a frame, used by IMGUI_ONCE_UPON_A_FRAME macro
 struct ImGuiPayload;                // User data payload for drag and drop operations
+struct ImGuiPlotHistory;            // Helper to keep a long history of floats for PlotLines()/PlotHistogram(), with a min/max pyramid to draw it fast
 struct ImGuiSizeCallbackData;       // Callback data when using SetNextWindowSizeConstraints() (rare/advanced use)
 struct ImGuiStorage;                // Helper for key->value storage
 struct ImGuiStyle;                  // Runtime data for styling/colors
@@ -230,6 +232,7 @@ namespace ImGui
     IMGUI_API void          SetNextWindowCollapsed(bool collapsed, ImGuiCond cond = 0);                 // set next window collapsed state. call before Begin()
     IMGUI_API void          SetNextWindowFocus();                                                       // set next window to be focused / front-most. call before Begin()
     IMGUI_API void          SetNextWindowBgAlpha(float alpha);                                          // set next window background color alpha. helper to easily modify ImGuiCol_WindowBg/ChildBg/PopupBg. you may also use ImGuiWindowFlags_NoBackground.
+    IMGUI_API void          SetNextWindowContentVersion(ImU32 version);                                 // set next window content version, to change whenever what you submit would draw differently. while it stays the same and the window is idle (not hovered, focused or active, same position, size, scroll and style), Begin() returns false and keeps last frame's ImDrawList: skip the contents then. call before Begin()
     IMGUI_API void          SetWindowPos(const ImVec2& pos, ImGuiCond cond = 0);                        // (not recommended) set current window position - call within Begin()/End(). prefer using SetNextWindowPos(), as this may incur tearing and side-effects.
     IMGUI_API void          SetWindowSize(const ImVec2& size, ImGuiCond cond = 0);                      // (not recommended) set current window size - call within Begin()/End(). set to ImVec2(0,0) to force an auto-fit. prefer using SetNextWindowSize(), as this may incur tearing and minor side-effects.
     IMGUI_API void          SetWindowCollapsed(bool collapsed, ImGuiCond cond = 0);                     // (not recommended) set current window collapsed state. prefer using SetNextWindowCollapsed().
@@ -453,6 +456,8 @@ namespace ImGui
     IMGUI_API void          PlotLines(const char* label, float(*values_getter)(void* data, int idx), void* data, int values_count, int values_offset = 0, const char* overlay_text = NULL, float scale_min = FLT_MAX, float scale_max = FLT_MAX, ImVec2 graph_size = ImVec2(0, 0));
     IMGUI_API void          PlotHistogram(const char* label, const float* values, int values_count, int values_offset = 0, const char* overlay_text = NULL, float scale_min = FLT_MAX, float scale_max = FLT_MAX, ImVec2 graph_size = ImVec2(0, 0), int stride = sizeof(float));
     IMGUI_API void          PlotHistogram(const char* label, float(*values_getter)(void* data, int idx), void* data, int values_count, int values_offset = 0, const char* overlay_text = NULL, float scale_min = FLT_MAX, float scale_max = FLT_MAX, ImVec2 graph_size = ImVec2(0, 0));
+    IMGUI_API void          PlotLines(const char* label, const ImGuiPlotHistory& history, const char* overlay_text = NULL, float scale_min = FLT_MAX, float scale_max = FLT_MAX, ImVec2 graph_size = ImVec2(0, 0));     // oldest to newest value, about the same cost for a thousand values or ten million
+    IMGUI_API void          PlotHistogram(const char* label, const ImGuiPlotHistory& history, const char* overlay_text = NULL, float scale_min = FLT_MAX, float scale_max = FLT_MAX, ImVec2 graph_size = ImVec2(0, 0)); // "
 
     // Widgets: Value() Helpers. Output single value in "name: value" format (tip: freely declare more in your code to handle your types. you can add functions to the ImGui namespace)
     IMGUI_API void          Value(const char* prefix, bool b);
@@ -650,6 +655,9 @@ enum ImGuiWindowFlags_
 };
 
 // Flags for ImGui::InputText()
+// Note: while an InputTextMultiline() is active it owns 'buf'. Edits only copy back the bytes that changed, so text written to 'buf'
+// by the application in the meantime (at the same length) would partly stay, out of sync with what the widget shows. Change the text
+// from a callback (ImGuiInputTextCallbackData::DeleteChars/InsertChars) or call ClearActiveID() before writing to 'buf' yourself.
 enum ImGuiInputTextFlags_
 {
     ImGuiInputTextFlags_None                = 0,
@@ -1399,20 +1407,19 @@ struct ImGuiTextBuffer
 // Types are NOT stored, so it is up to you to make sure your Key don't collide with different types.
 struct ImGuiStorage
 {
-    struct Pair
-    {
-        ImGuiID key;
-        union { int val_i; float val_f; void* val_p; };
-        Pair(ImGuiID _key, int _val_i)   { key = _key; val_i = _val_i; }
-        Pair(ImGuiID _key, float _val_f) { key = _key; val_f = _val_f; }
-        Pair(ImGuiID _key, void* _val_p) { key = _key; val_p = _val_p; }
-    };
-    ImVector<Pair>      Data;
-
-    // - Get***() functions find pair, never add/allocate. Pairs are sorted so a query is O(log N)
-    // - Set***() functions find pair, insertion on demand if missing.
-    // - Sorted insertion is costly, paid once. A typical frame shouldn't need to insert any new pair.
-    void                Clear() { Data.clear(); }
+    // Open addressing: keys in groups of 4 (one 16 bytes compare per probe), values in a parallel array, no tombstones since
+    // nothing is ever removed. Key 0 marks empty slots, so it gets the extra value slot at the end instead.
+    union Value { int val_i; float val_f; void* val_p; };
+    ImVector<ImGuiID>   Keys;           // Capacity slots, power of two, 0 == empty
+    ImVector<Value>     Values;         // Capacity + 1 slots, the last one holds key 0
+    int                 Count;          // Keys stored, including key 0
+    bool                HasZeroKey;
+
+    ImGuiStorage()      { Count = 0; HasZeroKey = false; }
+
+    // - Get***() functions find the value, never add/allocate. O(1)
+    // - Set***() functions find the value, insertion on demand if missing. Growing rehashes everything, a typical frame shouldn't need to insert anything.
+    void                Clear() { Keys.clear(); Values.clear(); Count = 0; HasZeroKey = false; }
     IMGUI_API int       GetInt(ImGuiID key, int default_val = 0) const;
     IMGUI_API void      SetInt(ImGuiID key, int val);
     IMGUI_API bool      GetBool(ImGuiID key, bool default_val = false) const;
@@ -1431,11 +1438,17 @@ struct ImGuiStorage
     IMGUI_API float*    GetFloatRef(ImGuiID key, float default_val = 0.0f);
     IMGUI_API void**    GetVoidPtrRef(ImGuiID key, void* default_val = NULL);
 
-    // Use on your own storage if you know only integer are being stored (open/close all tree nodes)
+    // Use on your own storage if you know only integer are being stored (open/close all tree nodes). Visits slots in order:
+    // the same keys inserted in the same order always give the same layout.
     IMGUI_API void      SetAllInt(int val);
 
-    // For quicker full rebuild of a storage (instead of an incremental one), you may add all your contents and then sort once.
-    IMGUI_API void      BuildSortByKey();
+    // For a quicker full rebuild of a storage, reserve room for all your contents first so the table never has to grow.
+    IMGUI_API void      Reserve(int count);
+    void                BuildSortByKey() {} // Obsolete: there's nothing to sort anymore
+
+    IMGUI_API const Value* FindValue(ImGuiID key) const;                    // NULL if missing
+    IMGUI_API Value*    FindOrInsertValue(ImGuiID key, bool* inserted);     // *inserted tells whether the value needs initializing
+    int                 GetMemoryUsage() const { return Keys.Size * (int)sizeof(ImGuiID) + Values.Size * (int)sizeof(Value); }
 };
 
 // Shared state of InputText(), passed as an argument to your callback when a ImGuiInputTextFlags_Callback* flag is used.
@@ -1580,6 +1593,59 @@ struct ImGuiListClipper
     IMGUI_API void End();                                               // Automatically called on the last call of Step() that returns false.
 };
 
+// Same as ImGuiListClipper for items of different heights (tree nodes, wrapped text, rows of mixed widgets), which ImGuiListClipper can't skip.
+// The height of each item is measured whenever it is displayed and kept in the window under 'str_id', items never displayed so far count as
+// 'items_height' (default: GetTextLineHeightWithSpacing()). The first visible item is found from the running sum of the heights in O(log N),
+// so a frame costs about as much as the visible items. Heights belong to indices: if items get inserted or removed, they get re-measured as
+// they scroll into view. Heights of lists not displayed the last time the window ran its clippers are dropped.
+// Step() hands out one item at a time so it can measure each, the loop is the same as with ImGuiListClipper:
+//     ImGuiVariableListClipper clipper("##entries", 100000);
+//     while (clipper.Step())
+//         for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+//             DrawEntry(i);
+struct ImGuiVariableListClipper
+{
+    int     HeightsIndex;               // Into the window's ListClipperHeightsStorage, which nested clippers may grow while this one runs
+    float   StartPosY;                  // Window-local, as ImGuiListClipper::StartPosY
+    float   ItemStartY;                 // Screen position of item DisplayStart
+    float   ClipMaxY;                   // Stop once past this screen position
+    int     ItemsCount, DisplayStart, DisplayEnd, ExtraItems;
+
+    ImGuiVariableListClipper(const char* str_id, int items_count, float items_height = -1.0f) { Begin(str_id, items_count, items_height); }
+    ~ImGuiVariableListClipper()                                                                { IM_ASSERT(ItemsCount == -1); }  // Assert if user forgot to call End() or Step() until false.
+
+    IMGUI_API bool Step();                                              // Call until it returns false. DisplayStart/DisplayEnd hold a single item to process/draw.
+    IMGUI_API void Begin(const char* str_id, int items_count, float items_height = -1.0f);
+    IMGUI_API void End();                                               // Automatically called on the last call of Step() that returns false.
+};
+
+// Helper: ring buffer of floats for PlotLines()/PlotHistogram() over long histories (frame times since startup, millions of samples).
+// Alongside the values it keeps the min/max of every block of 16 values, of every block of 16 such blocks, and so on up. Push() updates
+// one block per level. When there are more values than pixels the plot reduces each pixel column to the min/max of its values, reading
+// them a few blocks per level instead of one value at a time, so a spike one value wide still shows and a frame costs about the same
+// for a thousand values or ten million.
+//     static ImGuiPlotHistory frame_ms(1 << 20);
+//     frame_ms.Push(ImGui::GetIO().DeltaTime * 1000.0f);
+//     ImGui::PlotLines("Frame", frame_ms);
+struct ImGuiPlotHistory
+{
+    ImVector<float>     Values;                 // Ring buffer, Values.Size is the capacity
+    ImVector<ImVec2>    Blocks;                 // Min (x) and max (y) of blocks of 16 values at level 1, of 16 level 1 blocks at level 2, etc.
+    int                 LevelOffset[8];         // Start of each level >= 1 in Blocks (level 0 is Values)
+    int                 LevelsCount;            // Including level 0, the last level has 16 entries or less
+    int                 Count;                  // Values pushed so far, up to Values.Size
+    int                 Offset;                 // Index of the oldest value in Values
+
+    ImGuiPlotHistory(int capacity = 0)          { LevelsCount = Count = Offset = 0; Init(capacity); }
+
+    IMGUI_API void      Init(int capacity);     // (Re)allocate and clear
+    IMGUI_API void      Clear();
+    IMGUI_API void      Push(float v);          // Overwrites the oldest value once full
+    IMGUI_API void      Push(const float* values, int values_count);    // Faster than one at a time, each block is updated once
+    IMGUI_API void      GetMinMax(int idx_begin, int idx_end, float* in_out_min, float* in_out_max) const;  // Widen [*in_out_min, *in_out_max] to Values[idx_begin, idx_end)
+    float               GetLast() const         { IM_ASSERT(Count > 0); return Values[(Offset + Count - 1) % Values.Size]; }
+};
+
 //-----------------------------------------------------------------------------
 // Draw List
 // Hold a series of drawing commands. The user provides a renderer for ImDrawData which essentially contains an array of ImDrawList.
@@ -1597,10 +1663,11 @@ struct ImDrawCmd
     unsigned int    ElemCount;              // Number of indices (multiple of 3) to be rendered as triangles. Vertices are stored in the callee ImDrawList's vtx_buffer[] array, indices in idx_buffer[].
     ImVec4          ClipRect;               // Clipping rectangle (x1, y1, x2, y2). Subtract ImDrawData->DisplayPos to get clipping rectangle in "viewport" coordinates
     ImTextureID     TextureId;              // User-provided texture ID. Set by user in ImfontAtlas::SetTexID() for fonts or passed to Image*() functions. Ignore if never using images or multiple fonts atlas.
+    bool            DistanceField;          // Text of a font built with ImFontConfig::SignedDistanceField: sample TextureId with a distance field shader. Renderers without one may ignore it, the text then looks soft.
     ImDrawCallback  UserCallback;           // If != NULL, call the function instead of rendering the vertices. clip_rect and texture_id will be set normally.
     void*           UserCallbackData;       // The draw callback code can access this.
 
-    ImDrawCmd() { ElemCount = 0; ClipRect.x = ClipRect.y = ClipRect.z = ClipRect.w = 0.0f; TextureId = (ImTextureID)NULL; UserCallback = NULL; UserCallbackData = NULL; }
+    ImDrawCmd() { ElemCount = 0; ClipRect.x = ClipRect.y = ClipRect.z = ClipRect.w = 0.0f; TextureId = (ImTextureID)NULL; DistanceField = false; UserCallback = NULL; UserCallbackData = NULL; }
 };
 
 // Vertex index (override with '#define ImDrawIdx unsigned int' inside in imconfig.h)
@@ -1609,7 +1676,38 @@ typedef unsigned short ImDrawIdx;
 #endif
 
 // Vertex layout
-#ifndef IMGUI_OVERRIDE_DRAWVERT_STRUCT_LAYOUT
+#if defined(IMGUI_USE_COMPACT_DRAWVERT)
+// 12 bytes instead of 20 (enable in imconfig.h): fixed-point positions and 16-bit normalized UVs. Both are written from and read
+// back as ImVec2, so the code building vertices doesn't change. Positions are clamped to +/-32767/IM_DRAWVERT_POS_SCALE pixels
+// (+/-4095 by default) and UVs to 0..1, so no repeating textures. The render function needs to support it: scale positions
+// by 1/IM_DRAWVERT_POS_SCALE (e.g. in the projection matrix) and read UVs as normalized unsigned shorts.
+// Clamping is not clipping: a triangle with corners on both sides of the position range is distorted on screen. Draw lists
+// must stay within it, which ImGui::Render() asserts with IMGUI_DEBUG_COMPACT_DRAWVERT (see DrawListFitsCompactDrawVert() in imgui.cpp).
+#ifndef IM_DRAWVERT_POS_SCALE
+#define IM_DRAWVERT_POS_SCALE   8       // Units per pixel
+#endif
+struct ImDrawVertPos
+{
+    short   x, y;
+    ImDrawVertPos& operator=(const ImVec2& p)  { x = Quantize(p.x); y = Quantize(p.y); return *this; }
+    operator ImVec2() const                     { return ImVec2(x * (1.0f / IM_DRAWVERT_POS_SCALE), y * (1.0f / IM_DRAWVERT_POS_SCALE)); }
+    // Rounds half up, so moving by whole pixels before or after quantizing gives the same result
+    static short Quantize(float v)              { v *= IM_DRAWVERT_POS_SCALE; v = (v < -32768.0f) ? -32768.0f : (v > 32767.0f) ? 32767.0f : v; return (short)((int)(v + 32768.5f) - 32768); }
+};
+struct ImDrawVertUV
+{
+    unsigned short  u, v;
+    ImDrawVertUV& operator=(const ImVec2& uv)   { u = Quantize(uv.x); v = Quantize(uv.y); return *this; }
+    operator ImVec2() const                     { return ImVec2(u * (1.0f / 65535.0f), v * (1.0f / 65535.0f)); }
+    static unsigned short Quantize(float t)     { t = (t < 0.0f) ? 0.0f : (t > 1.0f) ? 1.0f : t; return (unsigned short)(t * 65535.0f + 0.5f); }
+};
+struct ImDrawVert
+{
+    ImDrawVertPos   pos;
+    ImDrawVertUV    uv;
+    ImU32           col;
+};
+#elif !defined(IMGUI_OVERRIDE_DRAWVERT_STRUCT_LAYOUT)
 struct ImDrawVert
 {
     ImVec2  pos;
@@ -1664,6 +1762,7 @@ struct ImDrawList
     ImVector<ImDrawIdx>     IdxBuffer;          // Index buffer. Each command consume ImDrawCmd::ElemCount of those
     ImVector<ImDrawVert>    VtxBuffer;          // Vertex buffer.
     ImDrawListFlags         Flags;              // Flags, you may poke into these to adjust anti-aliasing settings per-primitive.
+    unsigned int            Version;            // New on every Clear(). The same as last frame means the same contents (see SetNextWindowContentVersion()), so a renderer may keep its copy. Render functions must then leave the list alone, e.g. scale clip rectangles as they draw rather than with ImDrawData::ScaleClipRects().
 
     // [Internal, used while building lists]
     const ImDrawListSharedData* _Data;          // Pointer to shared draw data (you can use ImGui::GetDrawListSharedData() to get the one from current ImGui context)
@@ -1673,18 +1772,20 @@ struct ImDrawList
     ImDrawIdx*              _IdxWritePtr;       // [Internal] point within IdxBuffer.Data after each add command (to avoid using the ImVector<> operators too much)
     ImVector<ImVec4>        _ClipRectStack;     // [Internal]
     ImVector<ImTextureID>   _TextureIdStack;    // [Internal]
+    ImVector<bool>          _DistanceFieldStack;// [Internal] Alongside _TextureIdStack
     ImVector<ImVec2>        _Path;              // [Internal] current path building
     int                     _ChannelsCurrent;   // [Internal] current channel number (0)
     int                     _ChannelsCount;     // [Internal] number of active channels (1+)
     ImVector<ImDrawChannel> _Channels;          // [Internal] draw channels for columns API (not resized down so _ChannelsCount may be smaller than _Channels.Size)
+    ImDrawListArcCache*     _ArcCache;          // [Internal] unit circle points for PathArcTo(), allocated on first use. Per list, so lists can be built on different threads
 
     // If you want to create ImDrawList instances, pass them ImGui::GetDrawListSharedData() or create and use your own ImDrawListSharedData (so you can use ImDrawList without ImGui)
-    ImDrawList(const ImDrawListSharedData* shared_data) { _Data = shared_data; _OwnerName = NULL; Clear(); }
+    ImDrawList(const ImDrawListSharedData* shared_data) { _Data = shared_data; _OwnerName = NULL; _ArcCache = NULL; Clear(); }
     ~ImDrawList() { ClearFreeMemory(); }
     IMGUI_API void  PushClipRect(ImVec2 clip_rect_min, ImVec2 clip_rect_max, bool intersect_with_current_clip_rect = false);  // Render-level scissoring. This is passed down to your render function but not used for CPU-side coarse clipping. Prefer using higher-level ImGui::PushClipRect() to affect logic (hit-testing and widget culling)
     IMGUI_API void  PushClipRectFullScreen();
     IMGUI_API void  PopClipRect();
-    IMGUI_API void  PushTextureID(ImTextureID texture_id);
+    IMGUI_API void  PushTextureID(ImTextureID texture_id, bool distance_field = false);                                     // 'distance_field' for the text of a font built with ImFontConfig::SignedDistanceField, see ImFont::IsDistanceField()
     IMGUI_API void  PopTextureID();
     inline ImVec2   GetClipRectMin() const { const ImVec4& cr = _ClipRectStack.back(); return ImVec2(cr.x, cr.y); }
     inline ImVec2   GetClipRectMax() const { const ImVec4& cr = _ClipRectStack.back(); return ImVec2(cr.z, cr.w); }
@@ -1785,6 +1886,8 @@ struct ImFontConfig
     bool            MergeMode;              // false    // Merge into previous ImFont, so you can combine multiple inputs font into one ImFont (e.g. ASCII font + icons + Japanese glyphs). You may want to use GlyphOffset.y when merge font of different heights.
     unsigned int    RasterizerFlags;        // 0x00     // Settings for custom font rasterizer (e.g. ImGuiFreeType). Leave as zero if you aren't using one.
     float           RasterizerMultiply;     // 1.0f     // Brighten (>1.0f) or darken (<1.0f) font output. Brightening small fonts may be a good workaround to make them more readable.
+    bool            SignedDistanceField;    // false    // Store a signed distance field instead of coverage, to draw at any size from one atlas with a distance field shader (see ImDrawCmd::DistanceField). SizePixels is the size it is sampled at, OversampleH/V and RasterizerMultiply are ignored. All sources merged into a font must agree.
+    int             SdfPadding;             // 4        // Distance in pixels covered by the field on each side of the outline, beyond which it clamps. Larger keeps edges smooth further down in size, and costs atlas space.
 
     // [Internal]
     char            Name[40];               // Name (strictly to ease debugging)
@@ -1805,7 +1908,8 @@ enum ImFontAtlasFlags_
 {
     ImFontAtlasFlags_None               = 0,
     ImFontAtlasFlags_NoPowerOfTwoHeight = 1 << 0,   // Don't round the height to next power of two
-    ImFontAtlasFlags_NoMouseCursors     = 1 << 1    // Don't build software mouse cursors into the atlas
+    ImFontAtlasFlags_NoMouseCursors     = 1 << 1,   // Don't build software mouse cursors into the atlas
+    ImFontAtlasFlags_DynamicGlyphs      = 1 << 2    // Rasterize glyphs missing from the glyph ranges on first use, into rows kept free below the baked ones (see "Dynamic glyphs" below)
 };
 
 // Load and rasterize multiple TTF/OTF fonts into a same texture. The font atlas will build a single texture holding:
@@ -1825,6 +1929,20 @@ enum ImFontAtlasFlags_
 //   You can set font_cfg->FontDataOwnedByAtlas=false to keep ownership of your data and it won't be freed, 
 // - Even though many functions are suffixed with "TTF", OTF data is supported just as well.
 // - This is an old API and it is currently awkward for those and and various other reasons! We will address them in the future!
+// Multi-threaded build:
+// - Rects are gathered and packed on the calling thread, then every glyph is rasterized into its own rect. Set 'ParallelFor' to spread that
+//   second part over your threads: call task(begin, end, task_data) on sub-ranges covering [0, count) exactly once, in any order and on any thread,
+//   and return once all of them are done. The output is the same whichever thread renders which glyph.
+// - Tasks allocate through the functions given to SetAllocatorFunctions(), which need to be thread-safe (the default malloc/free are).
+// Dynamic glyphs (ImFontAtlasFlags_DynamicGlyphs):
+// - Build() bakes the glyph ranges as usual and keeps 'TexDynamicHeight' more rows free. A character outside the ranges is rasterized the first
+//   time FindGlyph() or CalcTextSizeA() looks for it, from the first source of the font which has it. Bake small ranges and let the rest come on demand.
+// - FindGlyphNoFallback() only sees glyphs already rasterized. A glyph pointer is only good until the next lookup, since the glyphs array can grow.
+// - Call TakeTexDirtyRect() before rendering and upload that sub-rectangle of the texture (imgui_impl_opengl3.cpp does).
+// - When the free rows are full, new glyphs show as the fallback character for the rest of the frame. The next NewFrame() then repacks the most
+//   recently used half of the dynamic glyphs and evicts the others. Glyphs never move in between, so draw lists built during a frame stay valid.
+struct ImFontAtlasDynamic;
+typedef void (*ImFontAtlasParallelForFunc)(int count, void (*task)(int begin, int end, void* task_data), void* task_data);
 struct ImFontAtlas
 {
     IMGUI_API ImFontAtlas();
@@ -1849,6 +1967,7 @@ struct ImFontAtlas
     IMGUI_API bool              IsBuilt()                   { return Fonts.Size > 0 && (TexPixelsAlpha8 != NULL || TexPixelsRGBA32 != NULL); }
     IMGUI_API void              GetTexDataAsAlpha8(unsigned char** out_pixels, int* out_width, int* out_height, int* out_bytes_per_pixel = NULL);  // 1 byte per-pixel
     IMGUI_API void              GetTexDataAsRGBA32(unsigned char** out_pixels, int* out_width, int* out_height, int* out_bytes_per_pixel = NULL);  // 4 bytes-per-pixel
+    IMGUI_API bool              TakeTexDirtyRect(int* out_x, int* out_y, int* out_w, int* out_h);  // Area changed by dynamic glyphs since the last call. Returns false if there is none.
     void                        SetTexID(ImTextureID id)    { TexID = id; }
 
     //-------------------------------------------
@@ -1914,6 +2033,8 @@ struct ImFontAtlas
     ImTextureID                 TexID;              // User data to refer to the texture once it has been uploaded to user's graphic systems. It is passed back to you during rendering via the ImDrawCmd structure.
     int                         TexDesiredWidth;    // Texture width desired by user before Build(). Must be a power-of-two. If have many glyphs your graphics API have texture size restrictions you may want to increase texture width to decrease height.
     int                         TexGlyphPadding;    // Padding between glyphs within texture in pixels. Defaults to 1.
+    ImFontAtlasParallelForFunc  ParallelFor;        // Rasterize glyphs on your own threads during Build() (see above). Defaults to NULL = on the calling thread.
+    int                         TexDynamicHeight;   // Rows kept free for dynamic glyphs below the baked ones, with ImFontAtlasFlags_DynamicGlyphs. Defaults to 512.
 
     // [Internal]
     // NB: Access texture data via GetTexData*() calls! Which will setup a default font for you.
@@ -1927,6 +2048,7 @@ struct ImFontAtlas
     ImVector<CustomRect>        CustomRects;        // Rectangles for packing custom texture data into the atlas.
     ImVector<ImFontConfig>      ConfigData;         // Internal data
     int                         CustomRectIds[1];   // Identifiers of custom texture rectangle used by ImFontAtlas/ImDrawList
+    ImFontAtlasDynamic*         Dynamic;            // Packer and glyph list for ImFontAtlasFlags_DynamicGlyphs, NULL otherwise
 };
 
 // Font runtime data and rendering
@@ -1951,6 +2073,9 @@ struct ImFont
     float                       Ascent, Descent;    //              // Ascent: distance from top to bottom of e.g. 'A' [0..FontSize]
     bool                        DirtyLookupTables;
     int                         MetricsTotalSurface;//              // Total surface in pixels to get an idea of the font rasterization/texture cost (not exact, we approximate the cost of padding between glyphs)
+    int                         Generation;         //              // Changes whenever the glyphs do (ClearOutputData(), BuildLookupTable(), dynamic glyph eviction), unique across fonts. Cached text layouts check it. Call BuildLookupTable() after editing metrics by hand.
+    int                         DynamicGlyphsBegin; //              // Glyphs from there on were rasterized on demand (ImFontAtlasFlags_DynamicGlyphs). 0xFFFF when the atlas isn't dynamic.
+    ImVector<int>               DynamicGlyphsLastUsed;//            // Frame each dynamic glyph was last looked up, for eviction
 
     // Methods
     IMGUI_API ImFont();
@@ -1960,9 +2085,10 @@ struct ImFont
     IMGUI_API const ImFontGlyph*FindGlyph(ImWchar c) const;
     IMGUI_API const ImFontGlyph*FindGlyphNoFallback(ImWchar c) const;
     IMGUI_API void              SetFallbackChar(ImWchar c);
-    float                       GetCharAdvance(ImWchar c) const     { return ((int)c < IndexAdvanceX.Size) ? IndexAdvanceX[(int)c] : FallbackAdvanceX; }
+    float                       GetCharAdvance(ImWchar c) const     { float advance_x = ((int)c < IndexAdvanceX.Size) ? IndexAdvanceX[(int)c] : -1.0f; return (advance_x >= 0.0f) ? advance_x : GetCharAdvanceMissing(c); }
     bool                        IsLoaded() const                    { return ContainerAtlas != NULL; }
     const char*                 GetDebugName() const                { return ConfigData ? ConfigData->Name : "<unknown>"; }
+    bool                        IsDistanceField() const             { return ConfigData && ConfigData->SignedDistanceField; }
 
     // 'max_width' stops rendering after a certain width (could be turned into a 2d size). FLT_MAX to disable.
     // 'wrap_width' enable automatic word-wrapping across multiple lines to fit into given width. 0.0f to disable.
@@ -1975,6 +2101,8 @@ struct ImFont
     IMGUI_API void              GrowIndex(int new_size);
     IMGUI_API void              AddGlyph(ImWchar c, float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1, float advance_x);
     IMGUI_API void              AddRemapChar(ImWchar dst, ImWchar src, bool overwrite_dst = true); // Makes 'dst' character/glyph points to 'src' character/glyph. Currently needs to be called AFTER fonts have been built.
+    IMGUI_API const ImFontGlyph*FindGlyphMissing(ImWchar c) const;      // For FindGlyph(), not in the lookup tables yet: rasterize it if the atlas is dynamic. NULL if the font doesn't have it.
+    IMGUI_API float             GetCharAdvanceMissing(ImWchar c) const; // Same, for the advance (FallbackAdvanceX if the font doesn't have it)
 
 #ifndef IMGUI_DISABLE_OBSOLETE_FUNCTIONS
     typedef ImFontGlyph Glyph; // OBSOLETE 1.52+
@@ -13,7 +13,9 @@ Index of this file:
 // [SECTION] ImFontConfig
 // [SECTION] ImFontAtlas
 // [SECTION] ImFontAtlas glyph ranges helpers + GlyphRangesBuilder
+// [SECTION] ImFontAtlas dynamic glyphs
 // [SECTION] ImFont
+// [SECTION] ImFontTextCache
 // [SECTION] Internal Render Helpers
 // [SECTION] Decompression code
 // [SECTION] Default font data (ProggyClean.ttf)
@@ -31,6 +33,13 @@ Index of this file:
 #include "imgui_internal.h"
 
 #include <stdio.h>      // vsnprintf, sscanf, printf
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMGUI_TESSELLATE_SSE2   // AddPolyline()/AddConvexPolyFilled() compute edge normals and miters 4 points at a time
+#include <emmintrin.h>
+#if !defined(IMGUI_OVERRIDE_DRAWVERT_STRUCT_LAYOUT)
+#define IMGUI_RENDER_TEXT_SSE2  // ImFont::RenderText() writes the {pos, uv} half of each vertex in one store, which needs the default or compact ImDrawVert layout
+#endif
+#endif
 #if !defined(alloca)
 #if defined(__GLIBC__) || defined(__sun) || defined(__CYGWIN__)
 #include <alloca.h>     // alloca (glibc uses <alloca.h>. Note that Cygwin may have _WIN32 defined, so the order matters here)
@@ -125,8 +134,8 @@ namespace IMGUI_STB_NAMESPACE
 
 #ifndef STB_TRUETYPE_IMPLEMENTATION                         // in case the user already have an implementation in the _same_ compilation unit (e.g. unity builds)
 #ifndef IMGUI_DISABLE_STB_TRUETYPE_IMPLEMENTATION
-#define STBTT_malloc(x,u)   ((void)(u), ImGui::MemAlloc(x))
-#define STBTT_free(x,u)     ((void)(u), ImGui::MemFree(x))
+#define STBTT_malloc(x,u)   ((u) ? ImGui::MemAllocNoMetrics(x) : ImGui::MemAlloc(x))    // Non-NULL userdata: rasterizing on an ImFontAtlas::ParallelFor task
+#define STBTT_free(x,u)     ((u) ? ImGui::MemFreeNoMetrics(x) : ImGui::MemFree(x))
 #define STBTT_assert(x)     IM_ASSERT(x)
 #define STBTT_fmod(x,y)     ImFmod(x,y)
 #define STBTT_sqrt(x)       ImSqrt(x)
@@ -328,6 +337,7 @@ ImDrawListSharedData::ImDrawListSharedData()
     FontSize = 0.0f;
     CurveTessellationTol = 0.0f;
     ClipRectFullscreen = ImVec4(-8192.0f, -8192.0f, +8192.0f, +8192.0f);
+    TextCache = NULL;
 
     // Const data
     for (int i = 0; i < IM_ARRAYSIZE(CircleVtx12); i++)
@@ -337,17 +347,48 @@ ImDrawListSharedData::ImDrawListSharedData()
     }
 }
 
+// Same points as PathArcTo() computes without the cache, the angles are computed the same way
+const ImVec2* ImDrawListArcCache::GetUnitPoints(float a_min, float a_max, int num_segments)
+{
+    if (num_segments <= 0 || num_segments > IM_DRAWLIST_ARC_CACHE_MAX_SEGMENTS)
+        return NULL;
+    ImU32 a_min_bits, a_max_bits;
+    memcpy(&a_min_bits, &a_min, sizeof(a_min_bits));
+    memcpy(&a_max_bits, &a_max, sizeof(a_max_bits));
+    ImU32 hash = (a_min_bits * 0x9E3779B1u) ^ (a_max_bits * 0x85EBCA77u) ^ ((ImU32)num_segments * 0xC2B2AE3Du);
+    hash ^= hash >> 16;
+    ImDrawListArcCacheEntry& entry = Entries[hash % IM_DRAWLIST_ARC_CACHE_SIZE];
+    if (entry.NumSegments != num_segments || entry.AMin != a_min || entry.AMax != a_max)
+    {
+        entry.AMin = a_min;
+        entry.AMax = a_max;
+        entry.NumSegments = num_segments;
+        entry.UnitPoints.resize(num_segments + 1);
+        for (int i = 0; i <= num_segments; i++)
+        {
+            const float a = a_min + ((float)i / (float)num_segments) * (a_max - a_min);
+            entry.UnitPoints[i] = ImVec2(ImCos(a), ImSin(a));
+        }
+    }
+    return entry.UnitPoints.Data;
+}
+
+// Shared by all lists (of all contexts), so a version is never seen twice, even on another list at the same address
+static unsigned int GDrawListVersion = 0;
+
 void ImDrawList::Clear()
 {
     CmdBuffer.resize(0);
     IdxBuffer.resize(0);
     VtxBuffer.resize(0);
+    Version = ++GDrawListVersion;
     Flags = ImDrawListFlags_AntiAliasedLines | ImDrawListFlags_AntiAliasedFill;
     _VtxCurrentIdx = 0;
     _VtxWritePtr = NULL;
     _IdxWritePtr = NULL;
     _ClipRectStack.resize(0);
     _TextureIdStack.resize(0);
+    _DistanceFieldStack.resize(0);
     _Path.resize(0);
     _ChannelsCurrent = 0;
     _ChannelsCount = 1;
@@ -359,11 +400,13 @@ void ImDrawList::ClearFreeMemory()
     CmdBuffer.clear();
     IdxBuffer.clear();
     VtxBuffer.clear();
+    Version = ++GDrawListVersion;
     _VtxCurrentIdx = 0;
     _VtxWritePtr = NULL;
     _IdxWritePtr = NULL;
     _ClipRectStack.clear();
     _TextureIdStack.clear();
+    _DistanceFieldStack.clear();
     _Path.clear();
     _ChannelsCurrent = 0;
     _ChannelsCount = 1;
@@ -374,6 +417,8 @@ void ImDrawList::ClearFreeMemory()
         _Channels[i].IdxBuffer.clear();
     }
     _Channels.clear();
+    IM_DELETE(_ArcCache);
+    _ArcCache = NULL;
 }
 
 ImDrawList* ImDrawList::CloneOutput() const
@@ -389,12 +434,14 @@ ImDrawList* ImDrawList::CloneOutput() const
 // Using macros because C++ is a terrible language, we want guaranteed inline, no code in header, and no overhead in Debug builds
 #define GetCurrentClipRect()    (_ClipRectStack.Size ? _ClipRectStack.Data[_ClipRectStack.Size-1]  : _Data->ClipRectFullscreen)
 #define GetCurrentTextureId()   (_TextureIdStack.Size ? _TextureIdStack.Data[_TextureIdStack.Size-1] : NULL)
+#define GetCurrentDistanceField() (_DistanceFieldStack.Size ? _DistanceFieldStack.Data[_DistanceFieldStack.Size-1] : false)
 
 void ImDrawList::AddDrawCmd()
 {
     ImDrawCmd draw_cmd;
     draw_cmd.ClipRect = GetCurrentClipRect();
     draw_cmd.TextureId = GetCurrentTextureId();
+    draw_cmd.DistanceField = GetCurrentDistanceField();
 
     IM_ASSERT(draw_cmd.ClipRect.x <= draw_cmd.ClipRect.z && draw_cmd.ClipRect.y <= draw_cmd.ClipRect.w);
     CmdBuffer.push_back(draw_cmd);
@@ -429,7 +476,7 @@ void ImDrawList::UpdateClipRect()
 
     // Try to merge with previous command if it matches, else use current command
     ImDrawCmd* prev_cmd = CmdBuffer.Size > 1 ? curr_cmd - 1 : NULL;
-    if (curr_cmd->ElemCount == 0 && prev_cmd && memcmp(&prev_cmd->ClipRect, &curr_clip_rect, sizeof(ImVec4)) == 0 && prev_cmd->TextureId == GetCurrentTextureId() && prev_cmd->UserCallback == NULL)
+    if (curr_cmd->ElemCount == 0 && prev_cmd && memcmp(&prev_cmd->ClipRect, &curr_clip_rect, sizeof(ImVec4)) == 0 && prev_cmd->TextureId == GetCurrentTextureId() && prev_cmd->DistanceField == GetCurrentDistanceField() && prev_cmd->UserCallback == NULL)
         CmdBuffer.pop_back();
     else
         curr_cmd->ClipRect = curr_clip_rect;
@@ -439,8 +486,9 @@ void ImDrawList::UpdateTextureID()
 {
     // If current command is used with different settings we need to add a new command
     const ImTextureID curr_texture_id = GetCurrentTextureId();
+    const bool curr_distance_field = GetCurrentDistanceField();
     ImDrawCmd* curr_cmd = CmdBuffer.Size ? &CmdBuffer.back() : NULL;
-    if (!curr_cmd || (curr_cmd->ElemCount != 0 && curr_cmd->TextureId != curr_texture_id) || curr_cmd->UserCallback != NULL)
+    if (!curr_cmd || (curr_cmd->ElemCount != 0 && (curr_cmd->TextureId != curr_texture_id || curr_cmd->DistanceField != curr_distance_field)) || curr_cmd->UserCallback != NULL)
     {
         AddDrawCmd();
         return;
@@ -448,14 +496,18 @@ void ImDrawList::UpdateTextureID()
 
     // Try to merge with previous command if it matches, else use current command
     ImDrawCmd* prev_cmd = CmdBuffer.Size > 1 ? curr_cmd - 1 : NULL;
-    if (curr_cmd->ElemCount == 0 && prev_cmd && prev_cmd->TextureId == curr_texture_id && memcmp(&prev_cmd->ClipRect, &GetCurrentClipRect(), sizeof(ImVec4)) == 0 && prev_cmd->UserCallback == NULL)
+    if (curr_cmd->ElemCount == 0 && prev_cmd && prev_cmd->TextureId == curr_texture_id && prev_cmd->DistanceField == curr_distance_field && memcmp(&prev_cmd->ClipRect, &GetCurrentClipRect(), sizeof(ImVec4)) == 0 && prev_cmd->UserCallback == NULL)
         CmdBuffer.pop_back();
     else
+    {
         curr_cmd->TextureId = curr_texture_id;
+        curr_cmd->DistanceField = curr_distance_field;
+    }
 }
 
 #undef GetCurrentClipRect
 #undef GetCurrentTextureId
+#undef GetCurrentDistanceField
 
 // Render-level scissoring. This is passed down to your render function but not used for CPU-side coarse clipping. Prefer using higher-level ImGui::PushClipRect() to affect logic (hit-testing and widget culling)
 void ImDrawList::PushClipRect(ImVec2 cr_min, ImVec2 cr_max, bool intersect_with_current_clip_rect)
@@ -488,9 +540,10 @@ void ImDrawList::PopClipRect()
     UpdateClipRect();
 }
 
-void ImDrawList::PushTextureID(ImTextureID texture_id)
+void ImDrawList::PushTextureID(ImTextureID texture_id, bool distance_field)
 {
     _TextureIdStack.push_back(texture_id);
+    _DistanceFieldStack.push_back(distance_field);
     UpdateTextureID();
 }
 
@@ -498,6 +551,7 @@ void ImDrawList::PopTextureID()
 {
     IM_ASSERT(_TextureIdStack.Size > 0);
     _TextureIdStack.pop_back();
+    _DistanceFieldStack.pop_back();
     UpdateTextureID();
 }
 
@@ -529,6 +583,7 @@ void ImDrawList::ChannelsSplit(int channels_count)
             ImDrawCmd draw_cmd;
             draw_cmd.ClipRect = _ClipRectStack.back();
             draw_cmd.TextureId = _TextureIdStack.back();
+            draw_cmd.DistanceField = _DistanceFieldStack.back();
             _Channels[i].CmdBuffer.push_back(draw_cmd);
         }
     }
@@ -596,8 +651,16 @@ void ImDrawList::PrimReserve(int idx_count, int vtx_count)
 }
 
 // Fully unrolled with inline call to keep our debug builds decently fast.
-void ImDrawList::PrimRect(const ImVec2& a, const ImVec2& c, ImU32 col)
+void ImDrawList::PrimRect(const ImVec2& a_in, const ImVec2& c_in, ImU32 col)
 {
+#if defined(IMGUI_USE_COMPACT_DRAWVERT)
+    // Clip to the compact position range here, where a rectangle stays one: clamped corners would skew its two triangles
+    const ImVec2 pos_min(-(float)(32767 / IM_DRAWVERT_POS_SCALE), -(float)(32767 / IM_DRAWVERT_POS_SCALE));
+    const ImVec2 pos_max(+(float)(32767 / IM_DRAWVERT_POS_SCALE), +(float)(32767 / IM_DRAWVERT_POS_SCALE));
+    ImVec2 a = ImClamp(a_in, pos_min, pos_max), c = ImClamp(c_in, pos_min, pos_max);
+#else
+    const ImVec2& a = a_in; const ImVec2& c = c_in;
+#endif
     ImVec2 b(c.x, a.y), d(a.x, c.y), uv(_Data->TexUvWhitePixel);
     ImDrawIdx idx = (ImDrawIdx)_VtxCurrentIdx;
     _IdxWritePtr[0] = idx; _IdxWritePtr[1] = (ImDrawIdx)(idx+1); _IdxWritePtr[2] = (ImDrawIdx)(idx+2);
@@ -640,6 +703,82 @@ void ImDrawList::PrimQuadUV(const ImVec2& a, const ImVec2& b, const ImVec2& c, c
     _IdxWritePtr += 6;
 }
 
+// Tessellation helpers for AddPolyline()/AddConvexPolyFilled(): the unit normal of each edge, then for each point the offset to the
+// left side of the stroke, i.e. the normals of the two edges meeting there averaged and scaled up to keep the width through the corner
+// (capped at 10x for sharp corners). Both go 4 points at a time with SSE2, with the same operations in the same order as the scalar
+// loops that finish the job, so the vertices don't depend on where the split falls.
+
+// Normal of the edge from points[i] to points[i+1], or to points[0] for the last point, for i in [0, edges_count)
+static void TessellateEdgeNormals(const ImVec2* points, int points_count, int edges_count, ImVec2* out_normals)
+{
+    int i = 0;
+#ifdef IMGUI_TESSELLATE_SSE2
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 sign_bit = _mm_set1_ps(-0.0f);
+    for (; i + 4 < points_count && i + 4 <= edges_count; i += 4)
+    {
+        // Edges as {x0 y0 x1 y1} {x2 y2 x3 y3}, then split into x and y lanes
+        const __m128 d01 = _mm_sub_ps(_mm_loadu_ps(&points[i + 1].x), _mm_loadu_ps(&points[i].x));
+        const __m128 d23 = _mm_sub_ps(_mm_loadu_ps(&points[i + 3].x), _mm_loadu_ps(&points[i + 2].x));
+        const __m128 dx = _mm_shuffle_ps(d01, d23, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 dy = _mm_shuffle_ps(d01, d23, _MM_SHUFFLE(3, 1, 3, 1));
+        const __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        const __m128 nonzero = _mm_cmpgt_ps(d2, _mm_setzero_ps());
+        const __m128 inv_length = _mm_or_ps(_mm_and_ps(nonzero, _mm_div_ps(one, _mm_sqrt_ps(d2))), _mm_andnot_ps(nonzero, one));   // ImInvLength(d, 1.0f)
+        const __m128 nx = _mm_mul_ps(dy, inv_length);
+        const __m128 ny = _mm_xor_ps(_mm_mul_ps(dx, inv_length), sign_bit);
+        _mm_storeu_ps(&out_normals[i].x, _mm_unpacklo_ps(nx, ny));
+        _mm_storeu_ps(&out_normals[i + 2].x, _mm_unpackhi_ps(nx, ny));
+    }
+#endif
+    for (; i < edges_count; i++)
+    {
+        const int i2 = (i + 1) == points_count ? 0 : i + 1;
+        ImVec2 diff = points[i2] - points[i];
+        diff *= ImInvLength(diff, 1.0f);
+        out_normals[i].x = diff.y;
+        out_normals[i].y = -diff.x;
+    }
+}
+
+// Offset of a point between the edges with normals normals_prev[i] and normals_next[i], for i in [0, count)
+static void TessellateMiters(const ImVec2* normals_prev, const ImVec2* normals_next, int count, ImVec2* out_miters)
+{
+    int i = 0;
+#ifdef IMGUI_TESSELLATE_SSE2
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 min_length_sqr = _mm_set1_ps(0.000001f);
+    const __m128 max_scale = _mm_set1_ps(100.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 dm01 = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&normals_prev[i].x), _mm_loadu_ps(&normals_next[i].x)), half);
+        __m128 dm23 = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&normals_prev[i + 2].x), _mm_loadu_ps(&normals_next[i + 2].x)), half);
+        const __m128 sqr01 = _mm_mul_ps(dm01, dm01);
+        const __m128 sqr23 = _mm_mul_ps(dm23, dm23);
+        const __m128 dmr2 = _mm_add_ps(_mm_shuffle_ps(sqr01, sqr23, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(sqr01, sqr23, _MM_SHUFFLE(3, 1, 3, 1)));
+        const __m128 scaled = _mm_cmpgt_ps(dmr2, min_length_sqr);
+        const __m128 scale = _mm_or_ps(_mm_and_ps(scaled, _mm_min_ps(_mm_div_ps(one, dmr2), max_scale)), _mm_andnot_ps(scaled, one));
+        dm01 = _mm_mul_ps(dm01, _mm_unpacklo_ps(scale, scale));
+        dm23 = _mm_mul_ps(dm23, _mm_unpackhi_ps(scale, scale));
+        _mm_storeu_ps(&out_miters[i].x, dm01);
+        _mm_storeu_ps(&out_miters[i + 2].x, dm23);
+    }
+#endif
+    for (; i < count; i++)
+    {
+        ImVec2 dm = (normals_prev[i] + normals_next[i]) * 0.5f;
+        float dmr2 = dm.x*dm.x + dm.y*dm.y;
+        if (dmr2 > 0.000001f)
+        {
+            float scale = 1.0f / dmr2;
+            if (scale > 100.0f) scale = 100.0f;
+            dm *= scale;
+        }
+        out_miters[i] = dm;
+    }
+}
+
 // TODO: Thickness anti-aliased lines cap are missing their AA fringe.
 void ImDrawList::AddPolyline(const ImVec2* points, const int points_count, ImU32 col, bool closed, float thickness)
 {
@@ -663,109 +802,39 @@ void ImDrawList::AddPolyline(const ImVec2* points, const int points_count, ImU32
         const int vtx_count = thick_line ? points_count*4 : points_count*3;
         PrimReserve(idx_count, vtx_count);
 
-        // Temporary buffer
-        ImVec2* temp_normals = (ImVec2*)alloca(points_count * (thick_line ? 5 : 3) * sizeof(ImVec2));
-        ImVec2* temp_points = temp_normals + points_count;
-
-        for (int i1 = 0; i1 < count; i1++)
-        {
-            const int i2 = (i1+1) == points_count ? 0 : i1+1;
-            ImVec2 diff = points[i2] - points[i1];
-            diff *= ImInvLength(diff, 1.0f);
-            temp_normals[i1].x = diff.y;
-            temp_normals[i1].y = -diff.x;
-        }
+        // Temporary buffer: the normal of each edge, then the miter of each point. points[i] sits between edges i-1 and i, an open
+        // polyline starts and ends square.
+        ImVec2* temp_normals = (ImVec2*)alloca(points_count * 2 * sizeof(ImVec2));
+        ImVec2* temp_miters = temp_normals + points_count;
+        TessellateEdgeNormals(points, points_count, count, temp_normals);
         if (!closed)
             temp_normals[points_count-1] = temp_normals[points_count-2];
+        TessellateMiters(temp_normals, temp_normals + 1, points_count - 1, temp_miters + 1);
+        if (closed)
+            TessellateMiters(temp_normals + points_count - 1, temp_normals, 1, temp_miters);
+        else
+            temp_miters[0] = temp_normals[0];
 
+        // Add indexes, the edge closing the loop goes back to the first point's vertices
         if (!thick_line)
         {
-            if (!closed)
-            {
-                temp_points[0] = points[0] + temp_normals[0] * AA_SIZE;
-                temp_points[1] = points[0] - temp_normals[0] * AA_SIZE;
-                temp_points[(points_count-1)*2+0] = points[points_count-1] + temp_normals[points_count-1] * AA_SIZE;
-                temp_points[(points_count-1)*2+1] = points[points_count-1] - temp_normals[points_count-1] * AA_SIZE;
-            }
-
-            // FIXME-OPT: Merge the different loops, possibly remove the temporary buffer.
-            unsigned int idx1 = _VtxCurrentIdx;
             for (int i1 = 0; i1 < count; i1++)
             {
-                const int i2 = (i1+1) == points_count ? 0 : i1+1;
-                unsigned int idx2 = (i1+1) == points_count ? _VtxCurrentIdx : idx1+3;
-
-                // Average normals
-                ImVec2 dm = (temp_normals[i1] + temp_normals[i2]) * 0.5f;
-                float dmr2 = dm.x*dm.x + dm.y*dm.y;
-                if (dmr2 > 0.000001f)
-                {
-                    float scale = 1.0f / dmr2;
-                    if (scale > 100.0f) scale = 100.0f;
-                    dm *= scale;
-                }
-                dm *= AA_SIZE;
-                temp_points[i2*2+0] = points[i2] + dm;
-                temp_points[i2*2+1] = points[i2] - dm;
-
-                // Add indexes
+                const unsigned int idx1 = _VtxCurrentIdx + i1*3;
+                const unsigned int idx2 = (i1+1) == points_count ? _VtxCurrentIdx : idx1+3;
                 _IdxWritePtr[0] = (ImDrawIdx)(idx2+0); _IdxWritePtr[1] = (ImDrawIdx)(idx1+0); _IdxWritePtr[2] = (ImDrawIdx)(idx1+2);
                 _IdxWritePtr[3] = (ImDrawIdx)(idx1+2); _IdxWritePtr[4] = (ImDrawIdx)(idx2+2); _IdxWritePtr[5] = (ImDrawIdx)(idx2+0);
                 _IdxWritePtr[6] = (ImDrawIdx)(idx2+1); _IdxWritePtr[7] = (ImDrawIdx)(idx1+1); _IdxWritePtr[8] = (ImDrawIdx)(idx1+0);
                 _IdxWritePtr[9] = (ImDrawIdx)(idx1+0); _IdxWritePtr[10]= (ImDrawIdx)(idx2+0); _IdxWritePtr[11]= (ImDrawIdx)(idx2+1);
                 _IdxWritePtr += 12;
-
-                idx1 = idx2;
-            }
-
-            // Add vertexes
-            for (int i = 0; i < points_count; i++)
-            {
-                _VtxWritePtr[0].pos = points[i];          _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = col;
-                _VtxWritePtr[1].pos = temp_points[i*2+0]; _VtxWritePtr[1].uv = uv; _VtxWritePtr[1].col = col_trans;
-                _VtxWritePtr[2].pos = temp_points[i*2+1]; _VtxWritePtr[2].uv = uv; _VtxWritePtr[2].col = col_trans;
-                _VtxWritePtr += 3;
             }
         }
         else
         {
-            const float half_inner_thickness = (thickness - AA_SIZE) * 0.5f;
-            if (!closed)
-            {
-                temp_points[0] = points[0] + temp_normals[0] * (half_inner_thickness + AA_SIZE);
-                temp_points[1] = points[0] + temp_normals[0] * (half_inner_thickness);
-                temp_points[2] = points[0] - temp_normals[0] * (half_inner_thickness);
-                temp_points[3] = points[0] - temp_normals[0] * (half_inner_thickness + AA_SIZE);
-                temp_points[(points_count-1)*4+0] = points[points_count-1] + temp_normals[points_count-1] * (half_inner_thickness + AA_SIZE);
-                temp_points[(points_count-1)*4+1] = points[points_count-1] + temp_normals[points_count-1] * (half_inner_thickness);
-                temp_points[(points_count-1)*4+2] = points[points_count-1] - temp_normals[points_count-1] * (half_inner_thickness);
-                temp_points[(points_count-1)*4+3] = points[points_count-1] - temp_normals[points_count-1] * (half_inner_thickness + AA_SIZE);
-            }
-
-            // FIXME-OPT: Merge the different loops, possibly remove the temporary buffer.
-            unsigned int idx1 = _VtxCurrentIdx;
             for (int i1 = 0; i1 < count; i1++)
             {
-                const int i2 = (i1+1) == points_count ? 0 : i1+1;
-                unsigned int idx2 = (i1+1) == points_count ? _VtxCurrentIdx : idx1+4;
-
-                // Average normals
-                ImVec2 dm = (temp_normals[i1] + temp_normals[i2]) * 0.5f;
-                float dmr2 = dm.x*dm.x + dm.y*dm.y;
-                if (dmr2 > 0.000001f)
-                {
-                    float scale = 1.0f / dmr2;
-                    if (scale > 100.0f) scale = 100.0f;
-                    dm *= scale;
-                }
-                ImVec2 dm_out = dm * (half_inner_thickness + AA_SIZE);
-                ImVec2 dm_in = dm * half_inner_thickness;
-                temp_points[i2*4+0] = points[i2] + dm_out;
-                temp_points[i2*4+1] = points[i2] + dm_in;
-                temp_points[i2*4+2] = points[i2] - dm_in;
-                temp_points[i2*4+3] = points[i2] - dm_out;
-
-                // Add indexes
+                const unsigned int idx1 = _VtxCurrentIdx + i1*4;
+                const unsigned int idx2 = (i1+1) == points_count ? _VtxCurrentIdx : idx1+4;
                 _IdxWritePtr[0]  = (ImDrawIdx)(idx2+1); _IdxWritePtr[1]  = (ImDrawIdx)(idx1+1); _IdxWritePtr[2]  = (ImDrawIdx)(idx1+2);
                 _IdxWritePtr[3]  = (ImDrawIdx)(idx1+2); _IdxWritePtr[4]  = (ImDrawIdx)(idx2+2); _IdxWritePtr[5]  = (ImDrawIdx)(idx2+1);
                 _IdxWritePtr[6]  = (ImDrawIdx)(idx2+1); _IdxWritePtr[7]  = (ImDrawIdx)(idx1+1); _IdxWritePtr[8]  = (ImDrawIdx)(idx1+0);
@@ -773,17 +842,32 @@ void ImDrawList::AddPolyline(const ImVec2* points, const int points_count, ImU32
                 _IdxWritePtr[12] = (ImDrawIdx)(idx2+2); _IdxWritePtr[13] = (ImDrawIdx)(idx1+2); _IdxWritePtr[14] = (ImDrawIdx)(idx1+3);
                 _IdxWritePtr[15] = (ImDrawIdx)(idx1+3); _IdxWritePtr[16] = (ImDrawIdx)(idx2+3); _IdxWritePtr[17] = (ImDrawIdx)(idx2+2);
                 _IdxWritePtr += 18;
-
-                idx1 = idx2;
             }
+        }
 
-            // Add vertexes
+        // Add vertexes
+        if (!thick_line)
+        {
+            for (int i = 0; i < points_count; i++)
+            {
+                const ImVec2 dm = temp_miters[i] * AA_SIZE;
+                _VtxWritePtr[0].pos = points[i];      _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = col;
+                _VtxWritePtr[1].pos = points[i] + dm; _VtxWritePtr[1].uv = uv; _VtxWritePtr[1].col = col_trans;
+                _VtxWritePtr[2].pos = points[i] - dm; _VtxWritePtr[2].uv = uv; _VtxWritePtr[2].col = col_trans;
+                _VtxWritePtr += 3;
+            }
+        }
+        else
+        {
+            const float half_inner_thickness = (thickness - AA_SIZE) * 0.5f;
             for (int i = 0; i < points_count; i++)
             {
-                _VtxWritePtr[0].pos = temp_points[i*4+0]; _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = col_trans;
-                _VtxWritePtr[1].pos = temp_points[i*4+1]; _VtxWritePtr[1].uv = uv; _VtxWritePtr[1].col = col;
-                _VtxWritePtr[2].pos = temp_points[i*4+2]; _VtxWritePtr[2].uv = uv; _VtxWritePtr[2].col = col;
-                _VtxWritePtr[3].pos = temp_points[i*4+3]; _VtxWritePtr[3].uv = uv; _VtxWritePtr[3].col = col_trans;
+                const ImVec2 dm_out = temp_miters[i] * (half_inner_thickness + AA_SIZE);
+                const ImVec2 dm_in = temp_miters[i] * half_inner_thickness;
+                _VtxWritePtr[0].pos = points[i] + dm_out; _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = col_trans;
+                _VtxWritePtr[1].pos = points[i] + dm_in;  _VtxWritePtr[1].uv = uv; _VtxWritePtr[1].col = col;
+                _VtxWritePtr[2].pos = points[i] - dm_in;  _VtxWritePtr[2].uv = uv; _VtxWritePtr[2].col = col;
+                _VtxWritePtr[3].pos = points[i] - dm_out; _VtxWritePtr[3].uv = uv; _VtxWritePtr[3].col = col_trans;
                 _VtxWritePtr += 4;
             }
         }
@@ -806,10 +890,10 @@ void ImDrawList::AddPolyline(const ImVec2* points, const int points_count, ImU32
 
             const float dx = diff.x * (thickness * 0.5f);
             const float dy = diff.y * (thickness * 0.5f);
-            _VtxWritePtr[0].pos.x = p1.x + dy; _VtxWritePtr[0].pos.y = p1.y - dx; _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = col;
-            _VtxWritePtr[1].pos.x = p2.x + dy; _VtxWritePtr[1].pos.y = p2.y - dx; _VtxWritePtr[1].uv = uv; _VtxWritePtr[1].col = col;
-            _VtxWritePtr[2].pos.x = p2.x - dy; _VtxWritePtr[2].pos.y = p2.y + dx; _VtxWritePtr[2].uv = uv; _VtxWritePtr[2].col = col;
-            _VtxWritePtr[3].pos.x = p1.x - dy; _VtxWritePtr[3].pos.y = p1.y + dx; _VtxWritePtr[3].uv = uv; _VtxWritePtr[3].col = col;
+            _VtxWritePtr[0].pos = ImVec2(p1.x + dy, p1.y - dx); _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = col;
+            _VtxWritePtr[1].pos = ImVec2(p2.x + dy, p2.y - dx); _VtxWritePtr[1].uv = uv; _VtxWritePtr[1].col = col;
+            _VtxWritePtr[2].pos = ImVec2(p2.x - dy, p2.y + dx); _VtxWritePtr[2].uv = uv; _VtxWritePtr[2].col = col;
+            _VtxWritePtr[3].pos = ImVec2(p1.x - dy, p1.y + dx); _VtxWritePtr[3].uv = uv; _VtxWritePtr[3].col = col;
             _VtxWritePtr += 4;
 
             _IdxWritePtr[0] = (ImDrawIdx)(_VtxCurrentIdx); _IdxWritePtr[1] = (ImDrawIdx)(_VtxCurrentIdx+1); _IdxWritePtr[2] = (ImDrawIdx)(_VtxCurrentIdx+2);
@@ -845,32 +929,16 @@ void ImDrawList::AddConvexPolyFilled(const ImVec2* points, const int points_coun
             _IdxWritePtr += 3;
         }
 
-        // Compute normals
-        ImVec2* temp_normals = (ImVec2*)alloca(points_count * sizeof(ImVec2));
-        for (int i0 = points_count-1, i1 = 0; i1 < points_count; i0 = i1++)
-        {
-            const ImVec2& p0 = points[i0];
-            const ImVec2& p1 = points[i1];
-            ImVec2 diff = p1 - p0;
-            diff *= ImInvLength(diff, 1.0f);
-            temp_normals[i0].x = diff.y;
-            temp_normals[i0].y = -diff.x;
-        }
+        // Compute normals, then the miter of each point, points[i] sits between edges i-1 and i
+        ImVec2* temp_normals = (ImVec2*)alloca(points_count * 2 * sizeof(ImVec2));
+        ImVec2* temp_miters = temp_normals + points_count;
+        TessellateEdgeNormals(points, points_count, points_count, temp_normals);
+        TessellateMiters(temp_normals + points_count - 1, temp_normals, 1, temp_miters);
+        TessellateMiters(temp_normals, temp_normals + 1, points_count - 1, temp_miters + 1);
 
         for (int i0 = points_count-1, i1 = 0; i1 < points_count; i0 = i1++)
         {
-            // Average normals
-            const ImVec2& n0 = temp_normals[i0];
-            const ImVec2& n1 = temp_normals[i1];
-            ImVec2 dm = (n0 + n1) * 0.5f;
-            float dmr2 = dm.x*dm.x + dm.y*dm.y;
-            if (dmr2 > 0.000001f)
-            {
-                float scale = 1.0f / dmr2;
-                if (scale > 100.0f) scale = 100.0f;
-                dm *= scale;
-            }
-            dm *= AA_SIZE * 0.5f;
+            const ImVec2 dm = temp_miters[i1] * (AA_SIZE * 0.5f);
 
             // Add vertices
             _VtxWritePtr[0].pos = (points[i1] - dm); _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = col;        // Inner
@@ -926,11 +994,23 @@ void ImDrawList::PathArcTo(const ImVec2& centre, float radius, float a_min, floa
         _Path.push_back(centre);
         return;
     }
-    _Path.reserve(_Path.Size + (num_segments + 1));
+    if (num_segments < 0)
+        return;
+    const int path_size = _Path.Size;
+    _Path.resize(path_size + num_segments + 1);
+    ImVec2* out_points = _Path.Data + path_size;
+    if (_ArcCache == NULL && num_segments <= IM_DRAWLIST_ARC_CACHE_MAX_SEGMENTS)
+        _ArcCache = IM_NEW(ImDrawListArcCache)();
+    if (const ImVec2* unit_points = _ArcCache ? _ArcCache->GetUnitPoints(a_min, a_max, num_segments) : NULL)
+    {
+        for (int i = 0; i <= num_segments; i++)
+            out_points[i] = ImVec2(centre.x + unit_points[i].x * radius, centre.y + unit_points[i].y * radius);
+        return;
+    }
     for (int i = 0; i <= num_segments; i++)
     {
         const float a = a_min + ((float)i / (float)num_segments) * (a_max - a_min);
-        _Path.push_back(ImVec2(centre.x + ImCos(a) * radius, centre.y + ImSin(a) * radius));
+        out_points[i] = ImVec2(centre.x + ImCos(a) * radius, centre.y + ImSin(a) * radius);
     }
 }
 
@@ -1153,7 +1233,7 @@ void ImDrawList::AddText(const ImFont* font, float font_size, const ImVec2& pos,
     if (font_size == 0.0f)
         font_size = _Data->FontSize;
 
-    IM_ASSERT(font->ContainerAtlas->TexID == _TextureIdStack.back());  // Use high-level ImGui::PushFont() or low-level ImDrawList::PushTextureId() to change font.
+    IM_ASSERT(font->ContainerAtlas->TexID == _TextureIdStack.back() && font->IsDistanceField() == _DistanceFieldStack.back());  // Use high-level ImGui::PushFont() or low-level ImDrawList::PushTextureId() to change font.
 
     ImVec4 clip_rect = _ClipRectStack.back();
     if (cpu_fine_clip_rect)
@@ -1176,7 +1256,7 @@ void ImDrawList::AddImage(ImTextureID user_texture_id, const ImVec2& a, const Im
     if ((col & IM_COL32_A_MASK) == 0)
         return;
 
-    const bool push_texture_id = _TextureIdStack.empty() || user_texture_id != _TextureIdStack.back();
+    const bool push_texture_id = _TextureIdStack.empty() || user_texture_id != _TextureIdStack.back() || _DistanceFieldStack.back();
     if (push_texture_id)
         PushTextureID(user_texture_id);
 
@@ -1192,7 +1272,7 @@ void ImDrawList::AddImageQuad(ImTextureID user_texture_id, const ImVec2& a, cons
     if ((col & IM_COL32_A_MASK) == 0)
         return;
 
-    const bool push_texture_id = _TextureIdStack.empty() || user_texture_id != _TextureIdStack.back();
+    const bool push_texture_id = _TextureIdStack.empty() || user_texture_id != _TextureIdStack.back() || _DistanceFieldStack.back();
     if (push_texture_id)
         PushTextureID(user_texture_id);
 
@@ -1214,7 +1294,7 @@ void ImDrawList::AddImageRounded(ImTextureID user_texture_id, const ImVec2& a, c
         return;
     }
 
-    const bool push_texture_id = _TextureIdStack.empty() || user_texture_id != _TextureIdStack.back();
+    const bool push_texture_id = _TextureIdStack.empty() || user_texture_id != _TextureIdStack.back() || _DistanceFieldStack.back();
     if (push_texture_id)
         PushTextureID(user_texture_id);
 
@@ -1278,7 +1358,7 @@ void ImGui::ShadeVertsLinearColorGradientKeepAlpha(ImDrawList* draw_list, int ve
     ImDrawVert* vert_end = draw_list->VtxBuffer.Data + vert_end_idx;
     for (ImDrawVert* vert = vert_start; vert < vert_end; vert++)
     {
-        float d = ImDot(vert->pos - gradient_p0, gradient_extent);
+        float d = ImDot(ImVec2(vert->pos) - gradient_p0, gradient_extent);
         float t = ImClamp(d * gradient_inv_length2, 0.0f, 1.0f);
         int r = ImLerp((int)(col0 >> IM_COL32_R_SHIFT) & 0xFF, (int)(col1 >> IM_COL32_R_SHIFT) & 0xFF, t);
         int g = ImLerp((int)(col0 >> IM_COL32_G_SHIFT) & 0xFF, (int)(col1 >> IM_COL32_G_SHIFT) & 0xFF, t);
@@ -1303,12 +1383,12 @@ void ImGui::ShadeVertsLinearUV(ImDrawList* draw_list, int vert_start_idx, int ve
         const ImVec2 min = ImMin(uv_a, uv_b);
         const ImVec2 max = ImMax(uv_a, uv_b);
         for (ImDrawVert* vertex = vert_start; vertex < vert_end; ++vertex)
-            vertex->uv = ImClamp(uv_a + ImMul(ImVec2(vertex->pos.x, vertex->pos.y) - a, scale), min, max);
+            vertex->uv = ImClamp(uv_a + ImMul(ImVec2(vertex->pos) - a, scale), min, max);
     }
     else
     {
         for (ImDrawVert* vertex = vert_start; vertex < vert_end; ++vertex)
-            vertex->uv = uv_a + ImMul(ImVec2(vertex->pos.x, vertex->pos.y) - a, scale);
+            vertex->uv = uv_a + ImMul(ImVec2(vertex->pos) - a, scale);
     }
 }
 
@@ -1334,6 +1414,8 @@ ImFontConfig::ImFontConfig()
     MergeMode = false;
     RasterizerFlags = 0x00;
     RasterizerMultiply = 1.0f;
+    SignedDistanceField = false;
+    SdfPadding = 4;
     memset(Name, 0, sizeof(Name));
     DstFont = NULL;
 }
@@ -1398,6 +1480,8 @@ ImFontAtlas::ImFontAtlas()
     TexID = (ImTextureID)NULL;
     TexDesiredWidth = 0;
     TexGlyphPadding = 1;
+    ParallelFor = NULL;
+    TexDynamicHeight = 512;
 
     TexPixelsAlpha8 = NULL;
     TexPixelsRGBA32 = NULL;
@@ -1406,6 +1490,7 @@ ImFontAtlas::ImFontAtlas()
     TexUvWhitePixel = ImVec2(0.0f, 0.0f);
     for (int n = 0; n < IM_ARRAYSIZE(CustomRectIds); n++)
         CustomRectIds[n] = -1;
+    Dynamic = NULL;
 }
 
 ImFontAtlas::~ImFontAtlas()
@@ -1417,6 +1502,7 @@ ImFontAtlas::~ImFontAtlas()
 void    ImFontAtlas::ClearInputData()
 {
     IM_ASSERT(!Locked && "Cannot modify a locked ImFontAtlas between NewFrame() and EndFrame/Render()!");
+    ImFontAtlasDynamicDestroy(this);    // Rasterizes from the input data
     for (int i = 0; i < ConfigData.Size; i++)
         if (ConfigData[i].FontData && ConfigData[i].FontDataOwnedByAtlas)
         {
@@ -1440,6 +1526,7 @@ void    ImFontAtlas::ClearInputData()
 void    ImFontAtlas::ClearTexData()
 {
     IM_ASSERT(!Locked && "Cannot modify a locked ImFontAtlas between NewFrame() and EndFrame/Render()!");
+    ImFontAtlasDynamicDestroy(this);
     if (TexPixelsAlpha8)
         ImGui::MemFree(TexPixelsAlpha8);
     if (TexPixelsRGBA32)
@@ -1451,6 +1538,7 @@ void    ImFontAtlas::ClearTexData()
 void    ImFontAtlas::ClearFonts()
 {
     IM_ASSERT(!Locked && "Cannot modify a locked ImFontAtlas between NewFrame() and EndFrame/Render()!");
+    ImFontAtlasDynamicDestroy(this);
     for (int i = 0; i < Fonts.Size; i++)
         IM_DELETE(Fonts[i]);
     Fonts.clear();
@@ -1508,6 +1596,7 @@ ImFont* ImFontAtlas::AddFont(const ImFontConfig* font_cfg)
     IM_ASSERT(!Locked && "Cannot modify a locked ImFontAtlas between NewFrame() and EndFrame/Render()!");
     IM_ASSERT(font_cfg->FontData != NULL && font_cfg->FontDataSize > 0);
     IM_ASSERT(font_cfg->SizePixels > 0.0f);
+    IM_ASSERT(!font_cfg->SignedDistanceField || font_cfg->SdfPadding > 0);
 
     // Create new font
     if (!font_cfg->MergeMode)
@@ -1519,6 +1608,12 @@ ImFont* ImFontAtlas::AddFont(const ImFontConfig* font_cfg)
     ImFontConfig& new_font_cfg = ConfigData.back();
     if (!new_font_cfg.DstFont)
         new_font_cfg.DstFont = Fonts.back();
+    for (int i = 0; i < ConfigData.Size - 1; i++)
+        if (ConfigData[i].DstFont == new_font_cfg.DstFont)
+        {
+            IM_ASSERT(ConfigData[i].SignedDistanceField == new_font_cfg.SignedDistanceField && "A font is drawn with one shader, merge distance fields only with distance fields.");
+            break;
+        }
     if (!new_font_cfg.FontDataOwnedByAtlas)
     {
         new_font_cfg.FontData = ImGui::MemAlloc(new_font_cfg.FontDataSize);
@@ -1705,6 +1800,120 @@ void    ImFontAtlasBuildMultiplyRectAlpha8(const unsigned char table[256], unsig
             data[i] = table[data[i]];
 }
 
+// Distance field glyphs (ImFontConfig::SignedDistanceField), standing in for stbtt_PackFontRangesGatherRects()/stbtt_PackFontRangesRenderIntoRects().
+// They fill the rects and packed chars the same way, so packing and setting up the glyphs don't need to know.
+static float ImFontAtlasBuildSdfScale(const stbtt_fontinfo* font_info, float font_size)
+{
+    return (font_size > 0.0f) ? stbtt_ScaleForPixelHeight(font_info, font_size) : stbtt_ScaleForMappingEmToPixels(font_info, -font_size);
+}
+
+static void ImFontAtlasBuildGatherSdfRects(const stbtt_pack_context* spc, const ImFontConfig& cfg, const stbtt_fontinfo* font_info, const stbtt_pack_range* ranges, int ranges_count, stbrp_rect* rects)
+{
+    for (int range_i = 0; range_i < ranges_count; range_i++)
+    {
+        const stbtt_pack_range& range = ranges[range_i];
+        const float scale = ImFontAtlasBuildSdfScale(font_info, range.font_size);
+        for (int char_i = 0; char_i < range.num_chars; char_i++, rects++)
+        {
+            int x0, y0, x1, y1;
+            const int glyph = stbtt_FindGlyphIndex(font_info, range.first_unicode_codepoint_in_range + char_i);
+            stbtt_GetGlyphBitmapBox(font_info, glyph, scale, scale, &x0, &y0, &x1, &y1);
+            const int sdf_padding = (x0 == x1 || y0 == y1) ? 0 : cfg.SdfPadding; // stbtt_GetGlyphSDF() has no field for blank glyphs
+            rects->w = (stbrp_coord)(x1 - x0 + sdf_padding * 2 + spc->padding);
+            rects->h = (stbrp_coord)(y1 - y0 + sdf_padding * 2 + spc->padding);
+        }
+    }
+}
+
+static void ImFontAtlasBuildRenderSdfRects(const stbtt_pack_context* spc, const ImFontConfig& cfg, const stbtt_fontinfo* font_info, stbtt_pack_range* ranges, int ranges_count, const stbrp_rect* rects)
+{
+    // The outline sits at 128, and the field reaches 0 and 255 'SdfPadding' pixels away from it: sampled as alpha, the edge is at 0.5
+    const unsigned char onedge_value = 128;
+    const float pixel_dist_scale = (float)onedge_value / cfg.SdfPadding;
+    for (int range_i = 0; range_i < ranges_count; range_i++)
+    {
+        stbtt_pack_range& range = ranges[range_i];
+        const float scale = ImFontAtlasBuildSdfScale(font_info, range.font_size);
+        for (int char_i = 0; char_i < range.num_chars; char_i++, rects++)
+        {
+            if (!rects->was_packed || (rects->w == 0 && rects->h == 0))
+                continue;
+            const int glyph = stbtt_FindGlyphIndex(font_info, range.first_unicode_codepoint_in_range + char_i);
+            int advance, lsb, x0, y0, x1, y1;
+            stbtt_GetGlyphHMetrics(font_info, glyph, &advance, &lsb);
+            stbtt_GetGlyphBitmapBox(font_info, glyph, scale, scale, &x0, &y0, &x1, &y1);
+            int w = 0, h = 0;
+            unsigned char* sdf = stbtt_GetGlyphSDF(font_info, scale, glyph, cfg.SdfPadding, onedge_value, pixel_dist_scale, &w, &h, &x0, &y0);
+            IM_ASSERT(w == rects->w - spc->padding && h == rects->h - spc->padding);
+            for (int y = 0; y < h; y++)
+                memcpy(spc->pixels + rects->x + (rects->y + y) * spc->stride_in_bytes, sdf + y * w, (size_t)w);
+            if (sdf)
+                stbtt_FreeSDF(sdf, font_info->userdata);
+
+            stbtt_packedchar& pc = range.chardata_for_range[char_i];
+            pc.x0 = (unsigned short)rects->x;
+            pc.y0 = (unsigned short)rects->y;
+            pc.x1 = (unsigned short)(rects->x + w);
+            pc.y1 = (unsigned short)(rects->y + h);
+            pc.xadvance = scale * advance;
+            pc.xoff = (float)x0;
+            pc.yoff = (float)y0;
+            pc.xoff2 = (float)(x0 + w);
+            pc.yoff2 = (float)(y0 + h);
+        }
+    }
+}
+
+// Glyphs rendered by a task of the second pass of ImFontAtlasBuildWithStbTruetype(). A batch never spans two ranges.
+#define IM_FONTATLAS_RENDER_BATCH_GLYPHS    64
+
+struct ImFontAtlasBuildRenderBatch
+{
+    const ImFontConfig*     Cfg;
+    const stbtt_fontinfo*   FontInfo;
+    stbtt_pack_range        Range;      // Slice of one of the font's ranges
+    stbrp_rect*             Rects;      // Range.num_chars packed rects
+};
+
+struct ImFontAtlasBuildRenderBatches
+{
+    const stbtt_pack_context*               Spc;
+    ImVector<ImFontAtlasBuildRenderBatch>   Batches;
+    bool                                    Threaded;   // Running on ImFontAtlas::ParallelFor
+    ImFontAtlasBuildRenderBatches()         { Spc = NULL; Threaded = false; }
+};
+
+static void ImFontAtlasBuildRenderBatchesTask(int begin, int end, void* task_data)
+{
+    const ImFontAtlasBuildRenderBatches* render = (const ImFontAtlasBuildRenderBatches*)task_data;
+    for (int batch_i = begin; batch_i < end; batch_i++)
+    {
+        const ImFontAtlasBuildRenderBatch& batch = render->Batches[batch_i];
+        const ImFontConfig& cfg = *batch.Cfg;
+
+        // stb_truetype writes the range's oversampling into the pack context, so each batch works on its own copy.
+        // A non-NULL userdata keeps the worker threads away from the context's allocation counter (see STBTT_malloc).
+        stbtt_pack_context spc = *render->Spc;
+        stbtt_fontinfo font_info = *batch.FontInfo;
+        font_info.userdata = render->Threaded ? (void*)render : NULL;
+        stbtt_pack_range range = batch.Range;
+        if (cfg.SignedDistanceField)
+        {
+            ImFontAtlasBuildRenderSdfRects(&spc, cfg, &font_info, &range, 1, batch.Rects);
+            continue;
+        }
+        stbtt_PackFontRangesRenderIntoRects(&spc, &font_info, &range, 1, batch.Rects);
+        if (cfg.RasterizerMultiply != 1.0f)
+        {
+            unsigned char multiply_table[256];
+            ImFontAtlasBuildMultiplyCalcLookupTable(multiply_table, cfg.RasterizerMultiply);
+            for (const stbrp_rect* r = batch.Rects; r != batch.Rects + range.num_chars; r++)
+                if (r->was_packed)
+                    ImFontAtlasBuildMultiplyRectAlpha8(multiply_table, spc.pixels, r->x, r->y, r->w, r->h, spc.stride_in_bytes);
+        }
+    }
+}
+
 bool    ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
 {
     IM_ASSERT(atlas->ConfigData.Size > 0);
@@ -1768,6 +1977,7 @@ bool    ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
             ImGui::MemFree(tmp_array);
             return false;
         }
+        tmp.FontInfo.userdata = NULL;
     }
 
     // Allocate packing character data and flag packed characters buffer as non-packed (x0=y0=x1=y1=0)
@@ -1808,9 +2018,17 @@ bool    ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
         tmp.Rects = buf_rects + buf_rects_n;
         tmp.RectsCount = font_glyphs_count;
         buf_rects_n += font_glyphs_count;
-        stbtt_PackSetOversampling(&spc, cfg.OversampleH, cfg.OversampleV);
-        int n = stbtt_PackFontRangesGatherRects(&spc, &tmp.FontInfo, tmp.Ranges, tmp.RangesCount, tmp.Rects);
-        IM_ASSERT(n == font_glyphs_count);
+        int n = font_glyphs_count;
+        if (cfg.SignedDistanceField)
+        {
+            ImFontAtlasBuildGatherSdfRects(&spc, cfg, &tmp.FontInfo, tmp.Ranges, tmp.RangesCount, tmp.Rects);
+        }
+        else
+        {
+            stbtt_PackSetOversampling(&spc, cfg.OversampleH, cfg.OversampleV);
+            n = stbtt_PackFontRangesGatherRects(&spc, &tmp.FontInfo, tmp.Ranges, tmp.RangesCount, tmp.Rects);
+            IM_ASSERT(n == font_glyphs_count);
+        }
 
         // Detect missing glyphs and replace them with a zero-sized box instead of relying on the default glyphs
         // This allows us merging overlapping icon fonts more easily.
@@ -1837,7 +2055,9 @@ bool    ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
     IM_ASSERT(buf_packedchars_n == total_glyphs_count);
     IM_ASSERT(buf_ranges_n == total_ranges_count);
 
-    // Create texture
+    // Create texture, with room for the glyphs rasterized on demand
+    if (atlas->Flags & ImFontAtlasFlags_DynamicGlyphs)
+        atlas->TexHeight += atlas->TexGlyphPadding + atlas->TexDynamicHeight;
     atlas->TexHeight = (atlas->Flags & ImFontAtlasFlags_NoPowerOfTwoHeight) ? (atlas->TexHeight + 1) : ImUpperPowerOfTwo(atlas->TexHeight);
     atlas->TexUvScale = ImVec2(1.0f / atlas->TexWidth, 1.0f / atlas->TexHeight);
     atlas->TexPixelsAlpha8 = (unsigned char*)ImGui::MemAlloc(atlas->TexWidth * atlas->TexHeight);
@@ -1846,22 +2066,40 @@ bool    ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
     spc.height = atlas->TexHeight;
 
     // Second pass: render font characters
+    // Every glyph goes into its own rect, so we cut the ranges into batches that can be rendered in any order, on any thread.
+    ImFontAtlasBuildRenderBatches render;
+    render.Spc = &spc;
     for (int input_i = 0; input_i < atlas->ConfigData.Size; input_i++)
     {
         ImFontConfig& cfg = atlas->ConfigData[input_i];
         ImFontTempBuildData& tmp = tmp_array[input_i];
-        stbtt_PackSetOversampling(&spc, cfg.OversampleH, cfg.OversampleV);
-        stbtt_PackFontRangesRenderIntoRects(&spc, &tmp.FontInfo, tmp.Ranges, tmp.RangesCount, tmp.Rects);
-        if (cfg.RasterizerMultiply != 1.0f)
-        {
-            unsigned char multiply_table[256];
-            ImFontAtlasBuildMultiplyCalcLookupTable(multiply_table, cfg.RasterizerMultiply);
-            for (const stbrp_rect* r = tmp.Rects; r != tmp.Rects + tmp.RectsCount; r++)
-                if (r->was_packed)
-                    ImFontAtlasBuildMultiplyRectAlpha8(multiply_table, spc.pixels, r->x, r->y, r->w, r->h, spc.stride_in_bytes);
-        }
+        stbrp_rect* rects = tmp.Rects;
+        for (int range_i = 0; range_i < tmp.RangesCount; range_i++)
+            for (int char_i = 0; char_i < tmp.Ranges[range_i].num_chars; char_i += IM_FONTATLAS_RENDER_BATCH_GLYPHS)
+            {
+                ImFontAtlasBuildRenderBatch batch;
+                batch.Cfg = &cfg;
+                batch.FontInfo = &tmp.FontInfo;
+                batch.Range = tmp.Ranges[range_i];
+                batch.Range.first_unicode_codepoint_in_range += char_i;
+                batch.Range.chardata_for_range += char_i;
+                batch.Range.num_chars = ImMin(batch.Range.num_chars - char_i, IM_FONTATLAS_RENDER_BATCH_GLYPHS);
+                batch.Rects = rects;
+                render.Batches.push_back(batch);
+                rects += batch.Range.num_chars;
+            }
+        IM_ASSERT(rects == tmp.Rects + tmp.RectsCount);
         tmp.Rects = NULL;
     }
+    if (atlas->ParallelFor && render.Batches.Size > 1)
+    {
+        render.Threaded = true;
+        atlas->ParallelFor(render.Batches.Size, ImFontAtlasBuildRenderBatchesTask, &render);
+    }
+    else
+    {
+        ImFontAtlasBuildRenderBatchesTask(0, render.Batches.Size, &render);
+    }
 
     // End packing
     stbtt_PackEnd(&spc);
@@ -1920,6 +2158,7 @@ bool    ImFontAtlasBuildWithStbTruetype(ImFontAtlas* atlas)
     ImGui::MemFree(tmp_array);
 
     ImFontAtlasBuildFinish(atlas);
+    ImFontAtlasBuildDynamicInit(atlas);
 
     return true;
 }
@@ -2029,6 +2268,167 @@ void ImFontAtlasBuildFinish(ImFontAtlas* atlas)
             atlas->Fonts[i]->BuildLookupTable();
 }
 
+// Serialized atlas: header, custom rects, fonts (each followed by its glyphs), alpha8 pixels. Native endianness, read back with memcpy so nothing needs aligning.
+#define IM_FONTATLAS_SERIALIZED_MAGIC       0x53414D49  // "IMAS"
+#define IM_FONTATLAS_SERIALIZED_VERSION     1
+
+struct ImFontAtlasSerializedHeader
+{
+    ImU32           Magic;
+    ImU32           Version;
+    ImU32           GlyphSize;          // sizeof(ImFontGlyph), follows ImWchar
+    int             TexWidth, TexHeight;
+    ImVec2          TexUvWhitePixel;
+    int             FontsCount;
+    int             CustomRectsCount;
+};
+
+struct ImFontAtlasSerializedRect
+{
+    unsigned int    ID;
+    unsigned short  Width, Height;      // Checked against the atlas
+    unsigned short  X, Y;
+};
+
+struct ImFontAtlasSerializedFont
+{
+    float           FontSize;
+    float           Ascent, Descent;
+    int             MetricsTotalSurface;
+    int             GlyphsCount;
+};
+
+struct ImFontAtlasSerializedReader
+{
+    const unsigned char* Data;
+    const unsigned char* DataEnd;
+    bool Read(void* dst, size_t size)   { if ((size_t)(DataEnd - Data) < size) return false; memcpy(dst, Data, size); Data += size; return true; }
+    bool Skip(size_t size)              { if ((size_t)(DataEnd - Data) < size) return false; Data += size; return true; }
+};
+
+static void ImFontAtlasSerializedWrite(ImVector<unsigned char>* out_data, const void* src, size_t size)
+{
+    int offset = out_data->Size;
+    out_data->resize(offset + (int)size);
+    memcpy(out_data->Data + offset, src, size);
+}
+
+bool ImFontAtlasBuildSaveToMemory(ImFontAtlas* atlas, ImVector<unsigned char>* out_data)
+{
+    out_data->resize(0);
+    if (atlas->TexPixelsAlpha8 == NULL)
+        return false;
+
+    ImFontAtlasSerializedHeader header;
+    header.Magic = IM_FONTATLAS_SERIALIZED_MAGIC;
+    header.Version = IM_FONTATLAS_SERIALIZED_VERSION;
+    header.GlyphSize = (ImU32)sizeof(ImFontGlyph);
+    header.TexWidth = atlas->TexWidth;
+    header.TexHeight = atlas->TexHeight;
+    header.TexUvWhitePixel = atlas->TexUvWhitePixel;
+    header.FontsCount = atlas->Fonts.Size;
+    header.CustomRectsCount = atlas->CustomRects.Size;
+    ImFontAtlasSerializedWrite(out_data, &header, sizeof(header));
+
+    for (int i = 0; i < atlas->CustomRects.Size; i++)
+    {
+        const ImFontAtlas::CustomRect& r = atlas->CustomRects[i];
+        ImFontAtlasSerializedRect rect = { r.ID, r.Width, r.Height, r.X, r.Y };
+        ImFontAtlasSerializedWrite(out_data, &rect, sizeof(rect));
+    }
+    for (int i = 0; i < atlas->Fonts.Size; i++)
+    {
+        // Baked glyphs only, as Build() would output them. Dynamic ones come after those.
+        const ImFont* font = atlas->Fonts[i];
+        const int glyphs_count = ImMin(font->Glyphs.Size, font->DynamicGlyphsBegin);
+        ImFontAtlasSerializedFont font_header = { font->FontSize, font->Ascent, font->Descent, font->MetricsTotalSurface, glyphs_count };
+        ImFontAtlasSerializedWrite(out_data, &font_header, sizeof(font_header));
+        ImFontAtlasSerializedWrite(out_data, font->Glyphs.Data, (size_t)glyphs_count * sizeof(ImFontGlyph));
+    }
+    ImFontAtlasSerializedWrite(out_data, atlas->TexPixelsAlpha8, (size_t)atlas->TexWidth * atlas->TexHeight);
+    if (atlas->Dynamic)
+        ImFontAtlasDynamicClearRegion(atlas, out_data->Data + out_data->Size - (size_t)atlas->TexWidth * atlas->TexHeight);
+    return true;
+}
+
+bool ImFontAtlasBuildLoadFromMemory(ImFontAtlas* atlas, const void* data, size_t data_size)
+{
+    IM_ASSERT(!atlas->Locked && "Cannot modify a locked ImFontAtlas between NewFrame() and EndFrame/Render()!");
+    if (atlas->ConfigData.empty())
+        return false;
+    ImFontAtlasBuildRegisterDefaultCustomRects(atlas);
+
+    // Check everything before touching the atlas, so a failure leaves it ready for Build()
+    ImFontAtlasSerializedReader reader = { (const unsigned char*)data, (const unsigned char*)data + data_size };
+    ImFontAtlasSerializedHeader header;
+    if (!reader.Read(&header, sizeof(header)))
+        return false;
+    if (header.Magic != IM_FONTATLAS_SERIALIZED_MAGIC || header.Version != IM_FONTATLAS_SERIALIZED_VERSION || header.GlyphSize != sizeof(ImFontGlyph))
+        return false;
+    if (header.FontsCount != atlas->Fonts.Size || header.CustomRectsCount != atlas->CustomRects.Size || header.TexWidth <= 0 || header.TexHeight <= 0)
+        return false;
+    for (int i = 0; i < header.CustomRectsCount; i++)
+    {
+        const ImFontAtlas::CustomRect& r = atlas->CustomRects[i];
+        ImFontAtlasSerializedRect rect;
+        if (!reader.Read(&rect, sizeof(rect)) || rect.ID != r.ID || rect.Width != r.Width || rect.Height != r.Height)
+            return false;
+    }
+    const unsigned char* fonts_data = reader.Data;
+    for (int i = 0; i < header.FontsCount; i++)
+    {
+        ImFontAtlasSerializedFont font_header;
+        if (!reader.Read(&font_header, sizeof(font_header)) || font_header.GlyphsCount < 0 || !reader.Skip((size_t)font_header.GlyphsCount * sizeof(ImFontGlyph)))
+            return false;
+    }
+    const unsigned char* pixels_data = reader.Data;
+    if (!reader.Skip((size_t)header.TexWidth * header.TexHeight) || reader.Data != reader.DataEnd)
+        return false;
+
+    // Same state as after ImFontAtlasBuildWithStbTruetype() + ImFontAtlasBuildFinish()
+    atlas->ClearTexData();
+    atlas->TexID = (ImTextureID)NULL;
+    atlas->TexWidth = header.TexWidth;
+    atlas->TexHeight = header.TexHeight;
+    atlas->TexUvScale = ImVec2(1.0f / atlas->TexWidth, 1.0f / atlas->TexHeight);
+    atlas->TexUvWhitePixel = header.TexUvWhitePixel;
+    atlas->TexPixelsAlpha8 = (unsigned char*)ImGui::MemAlloc((size_t)atlas->TexWidth * atlas->TexHeight);
+    memcpy(atlas->TexPixelsAlpha8, pixels_data, (size_t)atlas->TexWidth * atlas->TexHeight);
+
+    reader.Data = (const unsigned char*)data + sizeof(header);
+    for (int i = 0; i < atlas->CustomRects.Size; i++)
+    {
+        ImFontAtlasSerializedRect rect;
+        reader.Read(&rect, sizeof(rect));
+        atlas->CustomRects[i].X = rect.X;
+        atlas->CustomRects[i].Y = rect.Y;
+    }
+
+    reader.Data = fonts_data;
+    for (int font_i = 0; font_i < atlas->Fonts.Size; font_i++)
+    {
+        ImFont* font = atlas->Fonts[font_i];
+        ImFontAtlasSerializedFont font_header;
+        reader.Read(&font_header, sizeof(font_header));
+        for (int input_i = 0; input_i < atlas->ConfigData.Size; input_i++)
+        {
+            ImFontConfig& cfg = atlas->ConfigData[input_i];
+            if (cfg.DstFont != font)
+                continue;
+            if (!cfg.GlyphRanges)
+                cfg.GlyphRanges = atlas->GetGlyphRangesDefault();
+            ImFontAtlasBuildSetupFont(atlas, font, &cfg, font_header.Ascent, font_header.Descent);
+        }
+        font->FontSize = font_header.FontSize;
+        font->MetricsTotalSurface = font_header.MetricsTotalSurface;
+        font->Glyphs.resize(font_header.GlyphsCount);
+        reader.Read(font->Glyphs.Data, (size_t)font_header.GlyphsCount * sizeof(ImFontGlyph));
+        font->BuildLookupTable();
+    }
+    ImFontAtlasBuildDynamicInit(atlas);
+    return true;
+}
+
 // Retrieve list of range (2 int per range, values are inclusive)
 const ImWchar*   ImFontAtlas::GetGlyphRangesDefault()
 {
@@ -2263,6 +2663,388 @@ void ImFontAtlas::GlyphRangesBuilder::BuildRanges(ImVector<ImWchar>* out_ranges)
     out_ranges->push_back(0);
 }
 
+//-----------------------------------------------------------------------------
+// [SECTION] ImFontAtlas dynamic glyphs
+//-----------------------------------------------------------------------------
+// With ImFontAtlasFlags_DynamicGlyphs, the rows below the baked glyphs are a second packing area. A codepoint missing from a font is
+// looked up in the font's sources the first time it is asked for, rasterized with the same stb_truetype calls as Build() into a
+// rect from stb_rect_pack, and appended to the font's glyphs. Untried codepoints have IndexAdvanceX < 0, tried ones >= 0.
+// When the area is full we don't evict in the middle of a frame, since draw lists already point at the glyphs' UV. We note what
+// didn't fit and ImFontAtlasDynamicNewFrame() repacks the most recently used glyphs, then lets the others be rasterized again.
+//-----------------------------------------------------------------------------
+
+// Never reused, so a font allocated where a deleted one was doesn't match its cached text layouts
+static int GImFontGenerationCounter = 0;
+
+struct ImFontAtlasDynamicGlyph
+{
+    ImFont*             Font;
+    int                 GlyphIndex;     // In Font->Glyphs
+    int                 X, Y, W, H;     // Pixels of the glyph, padding excluded
+};
+
+struct ImFontAtlasDynamicMiss
+{
+    ImFont*             Font;
+    ImWchar             Codepoint;
+};
+
+struct ImFontAtlasDynamic
+{
+    ImVector<stbtt_fontinfo>            FontInfos;          // Parallel to ConfigData
+    stbrp_context                       PackContext;
+    ImVector<stbrp_node>                PackNodes;
+    int                                 RegionY;            // First row of the dynamic area, it runs to TexHeight
+    ImVector<ImFontAtlasDynamicGlyph>   Glyphs;
+    ImVector<ImFontAtlasDynamicMiss>    Misses;             // Didn't fit, tried again after the next compaction
+    int                                 FrameCount;
+    int                                 DirtyX0, DirtyY0, DirtyX1, DirtyY1; // Not uploaded yet, empty when DirtyX0 >= DirtyX1
+
+    ImFontAtlasDynamic()                { RegionY = 0; FrameCount = 0; DirtyX0 = DirtyY0 = DirtyX1 = DirtyY1 = 0; memset(&PackContext, 0, sizeof(PackContext)); }
+};
+
+static void ImFontAtlasDynamicAddDirtyRect(ImFontAtlasDynamic* dyn, int x, int y, int w, int h)
+{
+    if (dyn->DirtyX0 >= dyn->DirtyX1)
+    {
+        dyn->DirtyX0 = x; dyn->DirtyY0 = y; dyn->DirtyX1 = x + w; dyn->DirtyY1 = y + h;
+        return;
+    }
+    dyn->DirtyX0 = ImMin(dyn->DirtyX0, x); dyn->DirtyY0 = ImMin(dyn->DirtyY0, y);
+    dyn->DirtyX1 = ImMax(dyn->DirtyX1, x + w); dyn->DirtyY1 = ImMax(dyn->DirtyY1, y + h);
+}
+
+// Copy a rect of the alpha8 texture into the RGBA32 one, if the user asked for it already
+static void ImFontAtlasDynamicUpdateRGBA32(ImFontAtlas* atlas, int x, int y, int w, int h)
+{
+    if (atlas->TexPixelsRGBA32 == NULL)
+        return;
+    for (int j = y; j < y + h; j++)
+    {
+        const unsigned char* src = atlas->TexPixelsAlpha8 + x + j * atlas->TexWidth;
+        unsigned int* dst = atlas->TexPixelsRGBA32 + x + j * atlas->TexWidth;
+        for (int i = 0; i < w; i++)
+            dst[i] = IM_COL32(255, 255, 255, (unsigned int)src[i]);
+    }
+}
+
+void ImFontAtlasDynamicClearRegion(ImFontAtlas* atlas, unsigned char* pixels_alpha8)
+{
+    IM_ASSERT(atlas->Dynamic != NULL);
+    const int region_y = atlas->Dynamic->RegionY;
+    memset(pixels_alpha8 + (size_t)region_y * atlas->TexWidth, 0, (size_t)(atlas->TexHeight - region_y) * atlas->TexWidth);
+}
+
+void ImFontAtlasDynamicDestroy(ImFontAtlas* atlas)
+{
+    if (atlas->Dynamic == NULL)
+        return;
+
+    // The glyphs rasterized so far stay, as regular ones. Whatever wasn't tried yet falls back like in a static atlas.
+    for (int font_i = 0; font_i < atlas->Fonts.Size; font_i++)
+    {
+        ImFont* font = atlas->Fonts[font_i];
+        for (int c = 0; c < font->IndexAdvanceX.Size; c++)
+            if (font->IndexAdvanceX.Data[c] < 0.0f)
+                font->IndexAdvanceX.Data[c] = font->FallbackAdvanceX;
+        font->DynamicGlyphsBegin = 0xFFFF;
+        font->DynamicGlyphsLastUsed.clear();
+    }
+    IM_DELETE(atlas->Dynamic);
+    atlas->Dynamic = NULL;
+}
+
+void ImFontAtlasBuildDynamicInit(ImFontAtlas* atlas)
+{
+    ImFontAtlasDynamicDestroy(atlas);
+    if (!(atlas->Flags & ImFontAtlasFlags_DynamicGlyphs) || atlas->TexPixelsAlpha8 == NULL)
+        return;
+
+    ImFontAtlasDynamic* dyn = IM_NEW(ImFontAtlasDynamic)();
+    dyn->FontInfos.resize(atlas->ConfigData.Size);
+    for (int input_i = 0; input_i < atlas->ConfigData.Size; input_i++)
+    {
+        const ImFontConfig& cfg = atlas->ConfigData[input_i];
+        stbtt_fontinfo& font_info = dyn->FontInfos[input_i];
+        memset(&font_info, 0, sizeof(font_info));
+        const int font_offset = stbtt_GetFontOffsetForIndex((unsigned char*)cfg.FontData, cfg.FontNo);
+        if (font_offset < 0 || !stbtt_InitFont(&font_info, (unsigned char*)cfg.FontData, font_offset))
+            font_info.data = NULL; // Skipped when looking for glyphs
+        font_info.userdata = NULL;
+    }
+
+    // Below everything baked. Measured rather than passed down from Build(), so this works the same after ImFontAtlasBuildLoadFromMemory().
+    int baked_height = 0;
+    for (int i = 0; i < atlas->CustomRects.Size; i++)
+        if (atlas->CustomRects[i].IsPacked())
+            baked_height = ImMax(baked_height, atlas->CustomRects[i].Y + atlas->CustomRects[i].Height);
+    for (int font_i = 0; font_i < atlas->Fonts.Size; font_i++)
+        for (int glyph_i = 0; glyph_i < atlas->Fonts[font_i]->Glyphs.Size; glyph_i++)
+            baked_height = ImMax(baked_height, (int)(atlas->Fonts[font_i]->Glyphs[glyph_i].V1 * atlas->TexHeight + 0.5f));
+    dyn->RegionY = ImMin(baked_height + atlas->TexGlyphPadding, atlas->TexHeight);
+    dyn->PackNodes.resize(atlas->TexWidth);
+    stbrp_init_target(&dyn->PackContext, atlas->TexWidth, atlas->TexHeight - dyn->RegionY, dyn->PackNodes.Data, dyn->PackNodes.Size);
+
+    // BuildLookupTable() gave the fallback advance to every codepoint below the last glyph, mark those as untried again
+    for (int font_i = 0; font_i < atlas->Fonts.Size; font_i++)
+    {
+        ImFont* font = atlas->Fonts[font_i];
+        for (int c = 0; c < font->IndexLookup.Size; c++)
+            if (font->IndexLookup.Data[c] == (ImWchar)-1)
+                font->IndexAdvanceX.Data[c] = -1.0f;
+        font->DynamicGlyphsBegin = font->Glyphs.Size;
+        font->DynamicGlyphsLastUsed.clear();
+    }
+    atlas->Dynamic = dyn;
+}
+
+// Rasterize 'codepoint' from the first source of 'font' which has it, as Build() would have. Returns the new glyph's index, -1 if none.
+static int ImFontAtlasDynamicAddGlyph(ImFontAtlas* atlas, ImFont* font, ImWchar codepoint)
+{
+    ImFontAtlasDynamic* dyn = atlas->Dynamic;
+    IM_ASSERT(dyn != NULL && font->ContainerAtlas == atlas);
+
+    // Tried, whatever happens next
+    font->GrowIndex((int)codepoint + 1);
+    font->IndexAdvanceX[codepoint] = font->FallbackAdvanceX;
+
+    int input_i = 0;
+    for (; input_i < atlas->ConfigData.Size; input_i++)
+        if (atlas->ConfigData[input_i].DstFont == font && dyn->FontInfos[input_i].data != NULL && stbtt_FindGlyphIndex(&dyn->FontInfos[input_i], codepoint) != 0)
+            break;
+    if (input_i == atlas->ConfigData.Size || font->Glyphs.Size + 1 >= 0xFFFF)
+        return -1;
+    const ImFontConfig& cfg = atlas->ConfigData[input_i];
+    const stbtt_fontinfo* font_info = &dyn->FontInfos[input_i];
+
+    // A one glyph range through the same stb_truetype calls as the build, so the glyph comes out identical to a baked one
+    stbtt_pack_context spc;
+    memset(&spc, 0, sizeof(spc));
+    spc.width = atlas->TexWidth;
+    spc.height = atlas->TexHeight;
+    spc.stride_in_bytes = atlas->TexWidth;
+    spc.padding = atlas->TexGlyphPadding;
+    spc.pixels = atlas->TexPixelsAlpha8;
+    stbtt_PackSetOversampling(&spc, cfg.OversampleH, cfg.OversampleV);
+    stbtt_packedchar packed_char;
+    memset(&packed_char, 0, sizeof(packed_char));
+    stbtt_pack_range range;
+    memset(&range, 0, sizeof(range));
+    range.font_size = cfg.SizePixels;
+    range.first_unicode_codepoint_in_range = codepoint;
+    range.num_chars = 1;
+    range.chardata_for_range = &packed_char;
+    stbrp_rect rect;
+    memset(&rect, 0, sizeof(rect));
+    if (cfg.SignedDistanceField)
+        ImFontAtlasBuildGatherSdfRects(&spc, cfg, font_info, &range, 1, &rect);
+    else
+        stbtt_PackFontRangesGatherRects(&spc, font_info, &range, 1, &rect);
+    if (rect.w > atlas->TexWidth || rect.h > atlas->TexHeight - dyn->RegionY)
+        return -1;  // Would never fit, don't evict for it
+    stbrp_pack_rects(&dyn->PackContext, &rect, 1);
+    if (!rect.was_packed)
+    {
+        ImFontAtlasDynamicMiss miss = { font, codepoint };
+        dyn->Misses.push_back(miss);
+        return -1;
+    }
+    rect.y = (stbrp_coord)(rect.y + dyn->RegionY);
+
+    // The area may hold an evicted glyph, and the oversampling filters expect zeroes past the bitmap
+    for (int j = rect.y; j < rect.y + rect.h; j++)
+        memset(atlas->TexPixelsAlpha8 + rect.x + j * atlas->TexWidth, 0, (size_t)rect.w);
+    if (cfg.SignedDistanceField)
+        ImFontAtlasBuildRenderSdfRects(&spc, cfg, font_info, &range, 1, &rect);
+    else
+        stbtt_PackFontRangesRenderIntoRects(&spc, font_info, &range, 1, &rect);
+    if (cfg.RasterizerMultiply != 1.0f && !cfg.SignedDistanceField)
+    {
+        unsigned char multiply_table[256];
+        ImFontAtlasBuildMultiplyCalcLookupTable(multiply_table, cfg.RasterizerMultiply);
+        ImFontAtlasBuildMultiplyRectAlpha8(multiply_table, atlas->TexPixelsAlpha8, rect.x, rect.y, rect.w, rect.h, atlas->TexWidth);
+    }
+    ImFontAtlasDynamicUpdateRGBA32(atlas, rect.x, rect.y, rect.w, rect.h);
+    ImFontAtlasDynamicAddDirtyRect(dyn, rect.x, rect.y, rect.w, rect.h);
+
+    // Same as the third pass of ImFontAtlasBuildWithStbTruetype()
+    const float font_off_x = cfg.GlyphOffset.x;
+    const float font_off_y = cfg.GlyphOffset.y + (float)(int)(font->Ascent + 0.5f);
+    float char_advance_x_org = packed_char.xadvance;
+    float char_advance_x_mod = ImClamp(char_advance_x_org, cfg.GlyphMinAdvanceX, cfg.GlyphMaxAdvanceX);
+    float char_off_x = font_off_x;
+    if (char_advance_x_org != char_advance_x_mod)
+        char_off_x += cfg.PixelSnapH ? (float)(int)((char_advance_x_mod - char_advance_x_org) * 0.5f) : (char_advance_x_mod - char_advance_x_org) * 0.5f;
+
+    stbtt_aligned_quad q;
+    float dummy_x = 0.0f, dummy_y = 0.0f;
+    stbtt_GetPackedQuad(&packed_char, atlas->TexWidth, atlas->TexHeight, 0, &dummy_x, &dummy_y, &q, 0);
+    const int metrics_total_surface = font->MetricsTotalSurface;   // Baked glyphs only, so a cached atlas saves the same
+    font->AddGlyph(codepoint, q.x0 + char_off_x, q.y0 + font_off_y, q.x1 + char_off_x, q.y1 + font_off_y, q.s0, q.t0, q.s1, q.t1, char_advance_x_mod);
+    font->MetricsTotalSurface = metrics_total_surface;
+
+    // Index it without BuildLookupTable(), which would go over every codepoint
+    const int glyph_index = font->Glyphs.Size - 1;
+    font->IndexAdvanceX[codepoint] = font->Glyphs[glyph_index].AdvanceX;
+    font->IndexLookup[codepoint] = (ImWchar)glyph_index;
+    font->DirtyLookupTables = false;
+    if (font->FallbackGlyph)
+        font->FallbackGlyph = font->FindGlyphNoFallback(font->FallbackChar);
+    font->DynamicGlyphsLastUsed.push_back(dyn->FrameCount);
+
+    ImFontAtlasDynamicGlyph entry = { font, glyph_index, packed_char.x0, packed_char.y0, packed_char.x1 - packed_char.x0, packed_char.y1 - packed_char.y0 };
+    dyn->Glyphs.push_back(entry);
+    return glyph_index;
+}
+
+static inline void ImFontAtlasDynamicMarkUsed(const ImFont* font, int glyph_index)
+{
+    ImFont* mutable_font = const_cast<ImFont*>(font);
+    const int n = glyph_index - font->DynamicGlyphsBegin;
+    if (n < mutable_font->DynamicGlyphsLastUsed.Size)   // Not the tab glyph, when BuildLookupTable() appended it after dynamic ones
+        mutable_font->DynamicGlyphsLastUsed.Data[n] = font->ContainerAtlas->Dynamic->FrameCount;
+}
+
+static int IMGUI_CDECL ImFontAtlasDynamicGlyphCompareByLastUsed(const void* lhs, const void* rhs)
+{
+    const ImFontAtlasDynamicGlyph* a = (const ImFontAtlasDynamicGlyph*)lhs;
+    const ImFontAtlasDynamicGlyph* b = (const ImFontAtlasDynamicGlyph*)rhs;
+    const int a_last_used = a->Font->DynamicGlyphsLastUsed[a->GlyphIndex - a->Font->DynamicGlyphsBegin];
+    const int b_last_used = b->Font->DynamicGlyphsLastUsed[b->GlyphIndex - b->Font->DynamicGlyphsBegin];
+    if (a_last_used != b_last_used)
+        return (a_last_used > b_last_used) ? -1 : +1;
+    return (a->Y != b->Y) ? a->Y - b->Y : a->X - b->X;  // Deterministic order for qsort
+}
+
+// Keep the most recently used glyphs, up to half of the area so we don't come back here every frame, and repack them from the top
+static void ImFontAtlasDynamicCompact(ImFontAtlas* atlas)
+{
+    ImFontAtlasDynamic* dyn = atlas->Dynamic;
+    const int tex_w = atlas->TexWidth;
+    const int pad = atlas->TexGlyphPadding;
+    const int region_h = atlas->TexHeight - dyn->RegionY;
+
+    ImQsort(dyn->Glyphs.Data, (size_t)dyn->Glyphs.Size, sizeof(ImFontAtlasDynamicGlyph), ImFontAtlasDynamicGlyphCompareByLastUsed);
+    int keep_count = 0;
+    for (int keep_area = 0; keep_count < dyn->Glyphs.Size; keep_count++)
+    {
+        const ImFontAtlasDynamicGlyph& entry = dyn->Glyphs[keep_count];
+        keep_area += (entry.W + pad) * (entry.H + pad);
+        if (keep_area > tex_w * region_h / 2)
+            break;
+    }
+
+    // Save what we keep before the fonts and pixels go back to their baked state
+    struct KeptGlyph { ImFont* Font; ImFontGlyph Glyph; int LastUsed; int PixelsOffset; int W, H; };
+    ImVector<KeptGlyph> kept;
+    ImVector<unsigned char> kept_pixels;
+    kept.resize(keep_count);
+    for (int i = 0; i < keep_count; i++)
+    {
+        const ImFontAtlasDynamicGlyph& entry = dyn->Glyphs[i];
+        KeptGlyph& k = kept[i];
+        k.Font = entry.Font;
+        k.Glyph = entry.Font->Glyphs[entry.GlyphIndex];
+        k.LastUsed = entry.Font->DynamicGlyphsLastUsed[entry.GlyphIndex - entry.Font->DynamicGlyphsBegin];
+        k.PixelsOffset = kept_pixels.Size;
+        k.W = entry.W;
+        k.H = entry.H;
+        kept_pixels.resize(kept_pixels.Size + entry.W * entry.H);
+        for (int j = 0; j < entry.H; j++)
+            memcpy(kept_pixels.Data + k.PixelsOffset + j * entry.W, atlas->TexPixelsAlpha8 + entry.X + (entry.Y + j) * tex_w, (size_t)entry.W);
+    }
+
+    for (int i = 0; i < dyn->Glyphs.Size; i++)
+    {
+        const ImFontAtlasDynamicGlyph& entry = dyn->Glyphs[i];
+        const ImWchar c = entry.Font->Glyphs[entry.GlyphIndex].Codepoint;
+        entry.Font->IndexLookup[c] = (ImWchar)-1;
+        entry.Font->IndexAdvanceX[c] = -1.0f;
+    }
+    for (int i = 0; i < dyn->Misses.Size; i++)
+        if (dyn->Misses[i].Font->IndexLookup[dyn->Misses[i].Codepoint] == (ImWchar)-1)
+            dyn->Misses[i].Font->IndexAdvanceX[dyn->Misses[i].Codepoint] = -1.0f;
+    for (int font_i = 0; font_i < atlas->Fonts.Size; font_i++)
+    {
+        ImFont* font = atlas->Fonts[font_i];
+        font->Glyphs.resize(ImMin(font->Glyphs.Size, font->DynamicGlyphsBegin));
+        font->DynamicGlyphsLastUsed.resize(0);
+        font->Generation = ++GImFontGenerationCounter;  // Cached text layouts have the old UVs
+    }
+    dyn->Glyphs.resize(0);
+    dyn->Misses.resize(0);
+    ImFontAtlasDynamicClearRegion(atlas, atlas->TexPixelsAlpha8);
+
+    // Repack from the top of the area
+    ImVector<stbrp_rect> rects;
+    rects.resize(keep_count);
+    memset(rects.Data, 0, (size_t)rects.Size * sizeof(stbrp_rect));
+    for (int i = 0; i < keep_count; i++)
+    {
+        rects[i].id = i;
+        rects[i].w = (stbrp_coord)(kept[i].W + pad);
+        rects[i].h = (stbrp_coord)(kept[i].H + pad);
+    }
+    stbrp_init_target(&dyn->PackContext, tex_w, region_h, dyn->PackNodes.Data, dyn->PackNodes.Size);
+    stbrp_pack_rects(&dyn->PackContext, rects.Data, rects.Size);
+    for (int i = 0; i < keep_count; i++)
+    {
+        const KeptGlyph& k = kept[rects[i].id];
+        if (!rects[i].was_packed)
+            continue;
+        const int x = rects[i].x + pad;
+        const int y = rects[i].y + dyn->RegionY + pad;
+        for (int j = 0; j < k.H; j++)
+            memcpy(atlas->TexPixelsAlpha8 + x + (y + j) * tex_w, kept_pixels.Data + k.PixelsOffset + j * k.W, (size_t)k.W);
+
+        // Same UV math as stbtt_GetPackedQuad()
+        ImFont* font = k.Font;
+        ImFontGlyph glyph = k.Glyph;
+        const float ipw = 1.0f / atlas->TexWidth, iph = 1.0f / atlas->TexHeight;
+        glyph.U0 = x * ipw;
+        glyph.V0 = y * iph;
+        glyph.U1 = (x + k.W) * ipw;
+        glyph.V1 = (y + k.H) * iph;
+        font->Glyphs.push_back(glyph);
+        font->IndexAdvanceX[glyph.Codepoint] = glyph.AdvanceX;
+        font->IndexLookup[glyph.Codepoint] = (ImWchar)(font->Glyphs.Size - 1);
+        font->DynamicGlyphsLastUsed.push_back(k.LastUsed);
+        ImFontAtlasDynamicGlyph entry = { font, font->Glyphs.Size - 1, x, y, k.W, k.H };
+        dyn->Glyphs.push_back(entry);
+    }
+
+    for (int font_i = 0; font_i < atlas->Fonts.Size; font_i++)
+    {
+        ImFont* font = atlas->Fonts[font_i];
+        if (font->FallbackGlyph)
+            font->FallbackGlyph = font->FindGlyphNoFallback(font->FallbackChar);
+    }
+    ImFontAtlasDynamicUpdateRGBA32(atlas, 0, dyn->RegionY, tex_w, region_h);
+    ImFontAtlasDynamicAddDirtyRect(dyn, 0, dyn->RegionY, tex_w, region_h);
+}
+
+void ImFontAtlasDynamicNewFrame(ImFontAtlas* atlas)
+{
+    ImFontAtlasDynamic* dyn = atlas->Dynamic;
+    if (dyn == NULL)
+        return;
+    dyn->FrameCount++;
+    if (dyn->Misses.Size > 0)
+        ImFontAtlasDynamicCompact(atlas);
+}
+
+bool ImFontAtlas::TakeTexDirtyRect(int* out_x, int* out_y, int* out_w, int* out_h)
+{
+    if (Dynamic == NULL || Dynamic->DirtyX0 >= Dynamic->DirtyX1)
+        return false;
+    *out_x = Dynamic->DirtyX0;
+    *out_y = Dynamic->DirtyY0;
+    *out_w = Dynamic->DirtyX1 - Dynamic->DirtyX0;
+    *out_h = Dynamic->DirtyY1 - Dynamic->DirtyY0;
+    Dynamic->DirtyX0 = Dynamic->DirtyY0 = Dynamic->DirtyX1 = Dynamic->DirtyY1 = 0;
+    return true;
+}
+
 //-----------------------------------------------------------------------------
 // [SECTION] ImFont
 //-----------------------------------------------------------------------------
@@ -2302,6 +3084,9 @@ void    ImFont::ClearOutputData()
     Ascent = Descent = 0.0f;
     DirtyLookupTables = true;
     MetricsTotalSurface = 0;
+    Generation = ++GImFontGenerationCounter;
+    DynamicGlyphsBegin = 0xFFFF;
+    DynamicGlyphsLastUsed.clear();
 }
 
 void ImFont::BuildLookupTable()
@@ -2314,6 +3099,7 @@ void ImFont::BuildLookupTable()
     IndexAdvanceX.clear();
     IndexLookup.clear();
     DirtyLookupTables = false;
+    Generation = ++GImFontGenerationCounter;
     GrowIndex(max_codepoint + 1);
     for (int i = 0; i < Glyphs.Size; i++)
     {
@@ -2324,20 +3110,29 @@ void ImFont::BuildLookupTable()
 
     // Create a glyph to handle TAB
     // FIXME: Needs proper TAB handling but it needs to be contextualized (or we could arbitrary say that each string starts at "column 0" ?)
-    if (FindGlyph((ImWchar)' '))
+    if (const ImFontGlyph* space_glyph = FindGlyph((ImWchar)' '))
     {
-        if (Glyphs.back().Codepoint != '\t')   // So we can call this function multiple times
-            Glyphs.resize(Glyphs.Size + 1);
-        ImFontGlyph& tab_glyph = Glyphs.back();
-        tab_glyph = *FindGlyph((ImWchar)' ');
+        ImFontGlyph tab_glyph = *space_glyph;
         tab_glyph.Codepoint = '\t';
         tab_glyph.AdvanceX *= 4;
+        ImWchar tab_index = IndexLookup[(int)tab_glyph.Codepoint];  // So we can call this function multiple times. Not always the last glyph once dynamic ones were added.
+        if (tab_index == (ImWchar)-1)
+        {
+            Glyphs.push_back(tab_glyph);
+            tab_index = (ImWchar)(Glyphs.Size-1);
+        }
+        else
+        {
+            Glyphs[tab_index] = tab_glyph;
+        }
         IndexAdvanceX[(int)tab_glyph.Codepoint] = (float)tab_glyph.AdvanceX;
-        IndexLookup[(int)tab_glyph.Codepoint] = (ImWchar)(Glyphs.Size-1);
+        IndexLookup[(int)tab_glyph.Codepoint] = tab_index;
     }
 
     FallbackGlyph = FindGlyphNoFallback(FallbackChar);
     FallbackAdvanceX = FallbackGlyph ? FallbackGlyph->AdvanceX : 0.0f;
+    if (ContainerAtlas && ContainerAtlas->Dynamic)
+        return; // The others aren't tried yet
     for (int i = 0; i < max_codepoint + 1; i++)
         if (IndexAdvanceX[i] < 0.0f)
             IndexAdvanceX[i] = FallbackAdvanceX;
@@ -2400,24 +3195,43 @@ void ImFont::AddRemapChar(ImWchar dst, ImWchar src, bool overwrite_dst)
 
 const ImFontGlyph* ImFont::FindGlyph(ImWchar c) const
 {
-    if (c >= IndexLookup.Size)
-        return FallbackGlyph;
-    const ImWchar i = IndexLookup[c];
+    const ImWchar i = (c < IndexLookup.Size) ? IndexLookup.Data[c] : (ImWchar)-1;
     if (i == (ImWchar)-1)
-        return FallbackGlyph;
+    {
+        const ImFontGlyph* glyph = FindGlyphMissing(c);
+        return glyph ? glyph : FallbackGlyph;
+    }
+    if (i >= DynamicGlyphsBegin)
+        ImFontAtlasDynamicMarkUsed(this, i);
     return &Glyphs.Data[i];
 }
 
 const ImFontGlyph* ImFont::FindGlyphNoFallback(ImWchar c) const
 {
-    if (c >= IndexLookup.Size)
-        return NULL;
-    const ImWchar i = IndexLookup[c];
+    const ImWchar i = (c < IndexLookup.Size) ? IndexLookup.Data[c] : (ImWchar)-1;
     if (i == (ImWchar)-1)
         return NULL;
+    if (i >= DynamicGlyphsBegin)
+        ImFontAtlasDynamicMarkUsed(this, i);
     return &Glyphs.Data[i];
 }
 
+const ImFontGlyph* ImFont::FindGlyphMissing(ImWchar c) const
+{
+    if (DynamicGlyphsBegin == 0xFFFF)
+        return NULL; // Not from a dynamic atlas, or the password font borrowing one
+    if (c < IndexAdvanceX.Size && IndexAdvanceX.Data[c] >= 0.0f)
+        return NULL; // Tried already
+    const int glyph_index = ImFontAtlasDynamicAddGlyph(ContainerAtlas, const_cast<ImFont*>(this), c);
+    return (glyph_index >= 0) ? &Glyphs.Data[glyph_index] : NULL;
+}
+
+float ImFont::GetCharAdvanceMissing(ImWchar c) const
+{
+    const ImFontGlyph* glyph = FindGlyphMissing(c);
+    return glyph ? glyph->AdvanceX : FallbackAdvanceX;
+}
+
 const char* ImFont::CalcWordWrapPositionA(float scale, const char* text, const char* text_end, float wrap_width) const
 {
     // Simple word-wrapping for English, not full-featured. Please submit failing cases!
@@ -2472,7 +3286,7 @@ const char* ImFont::CalcWordWrapPositionA(float scale, const char* text, const c
             }
         }
 
-        const float char_width = ((int)c < IndexAdvanceX.Size ? IndexAdvanceX[(int)c] : FallbackAdvanceX);
+        const float char_width = GetCharAdvance((ImWchar)c);
         if (ImCharIsBlankW(c))
         {
             if (inside_word)
@@ -2589,7 +3403,7 @@ ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, cons
                 continue;
         }
 
-        const float char_width = ((int)c < IndexAdvanceX.Size ? IndexAdvanceX[(int)c] : FallbackAdvanceX) * scale;
+        const float char_width = GetCharAdvance((ImWchar)c) * scale;
         if (line_width + char_width >= max_width)
         {
             s = prev_s;
@@ -2625,11 +3439,192 @@ void ImFont::RenderChar(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col
     }
 }
 
+// CPU side clipping used to fit text in their frame when the frame is too small. Only does clipping for axis aligned quads.
+// Returns false when nothing is left of the glyph.
+static bool FineClipGlyphQuad(const ImVec4& clip_rect, float& x1, float& y1, float& x2, float& y2, float& u1, float& v1, float& u2, float& v2)
+{
+    if (x1 < clip_rect.x)
+    {
+        u1 = u1 + (1.0f - (x2 - clip_rect.x) / (x2 - x1)) * (u2 - u1);
+        x1 = clip_rect.x;
+    }
+    if (y1 < clip_rect.y)
+    {
+        v1 = v1 + (1.0f - (y2 - clip_rect.y) / (y2 - y1)) * (v2 - v1);
+        y1 = clip_rect.y;
+    }
+    if (x2 > clip_rect.z)
+    {
+        u2 = u1 + ((clip_rect.z - x1) / (x2 - x1)) * (u2 - u1);
+        x2 = clip_rect.z;
+    }
+    if (y2 > clip_rect.w)
+    {
+        v2 = v1 + ((clip_rect.w - y1) / (y2 - y1)) * (v2 - v1);
+        y2 = clip_rect.w;
+    }
+    return y1 < y2;
+}
+
+#if defined(IMGUI_RENDER_TEXT_SSE2) && defined(IMGUI_USE_COMPACT_DRAWVERT)
+// Quantizes {x1, y1, x2, y2} and {u1, v1, u2, v2} four at a time, the same as ImDrawVertPos/ImDrawVertUV::Quantize() would
+static inline void WriteGlyphQuadCompact(ImDrawVert* vtx_write, __m128 pos_rect, __m128 uv_rect, ImU32 col)
+{
+    // Round half up, then let the 16-bit pack saturate instead of clamping first
+    const __m128i bias = _mm_set1_epi32(32768);
+    __m128 pos_f = _mm_add_ps(_mm_mul_ps(pos_rect, _mm_set1_ps((float)IM_DRAWVERT_POS_SCALE)), _mm_set1_ps(32768.5f));
+    __m128i pos = _mm_sub_epi32(_mm_cvttps_epi32(pos_f), bias);
+    pos = _mm_packs_epi32(pos, pos);
+    __m128 uv_f = _mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(uv_rect, _mm_setzero_ps()), _mm_set1_ps(1.0f)), _mm_set1_ps(65535.0f)), _mm_set1_ps(0.5f));
+    __m128i uv = _mm_sub_epi32(_mm_cvttps_epi32(uv_f), bias);
+    uv = _mm_xor_si128(_mm_packs_epi32(uv, uv), _mm_set1_epi16((short)0x8000));   // Signed pack, back to 0..65535
+
+    // Corners x1 y1, x2 y1, x2 y2, x1 y2 as one 32-bit lane each
+    pos = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pos, _MM_SHUFFLE(1, 2, 1, 0)), _MM_SHUFFLE(3, 0, 3, 2));
+    uv = _mm_shufflehi_epi16(_mm_shufflelo_epi16(uv, _MM_SHUFFLE(1, 2, 1, 0)), _MM_SHUFFLE(3, 0, 3, 2));
+    const __m128i pos_uv_01 = _mm_unpacklo_epi32(pos, uv);
+    const __m128i pos_uv_23 = _mm_unpackhi_epi32(pos, uv);
+    _mm_storel_epi64((__m128i*)&vtx_write[0].pos, pos_uv_01);
+    _mm_storel_epi64((__m128i*)&vtx_write[1].pos, _mm_unpackhi_epi64(pos_uv_01, pos_uv_01));
+    _mm_storel_epi64((__m128i*)&vtx_write[2].pos, pos_uv_23);
+    _mm_storel_epi64((__m128i*)&vtx_write[3].pos, _mm_unpackhi_epi64(pos_uv_23, pos_uv_23));
+    vtx_write[0].col = col; vtx_write[1].col = col; vtx_write[2].col = col; vtx_write[3].col = col;
+}
+#endif
+
+// Indices of 'quad_count' glyph quads written one after the other from vertex 'vtx_idx' on: 0,1,2, 0,2,3 for each
+static ImDrawIdx* WriteGlyphQuadIndices(ImDrawIdx* idx_write, unsigned int vtx_idx, int quad_count)
+{
+    int quad = 0;
+#ifdef IMGUI_RENDER_TEXT_SSE2
+    if (sizeof(ImDrawIdx) == 2)
+    {
+        // 4 quads = 24 indices = 3 stores. Wrapping around 16-bit does the same as the (ImDrawIdx) casts below.
+        const __m128i pattern0 = _mm_setr_epi16(0, 1, 2, 0, 2, 3, 4, 5);
+        const __m128i pattern1 = _mm_setr_epi16(6, 4, 6, 7, 8, 9, 10, 8);
+        const __m128i pattern2 = _mm_setr_epi16(10, 11, 12, 13, 14, 12, 14, 15);
+        for (; quad + 4 <= quad_count; quad += 4, idx_write += 24)
+        {
+            const __m128i base = _mm_set1_epi16((short)(vtx_idx + quad * 4));
+            _mm_storeu_si128((__m128i*)(idx_write + 0), _mm_add_epi16(pattern0, base));
+            _mm_storeu_si128((__m128i*)(idx_write + 8), _mm_add_epi16(pattern1, base));
+            _mm_storeu_si128((__m128i*)(idx_write + 16), _mm_add_epi16(pattern2, base));
+        }
+    }
+    else
+    {
+        // 2 quads = 12 indices = 3 stores
+        const __m128i pattern0 = _mm_setr_epi32(0, 1, 2, 0);
+        const __m128i pattern1 = _mm_setr_epi32(2, 3, 4, 5);
+        const __m128i pattern2 = _mm_setr_epi32(6, 4, 6, 7);
+        for (; quad + 2 <= quad_count; quad += 2, idx_write += 12)
+        {
+            const __m128i base = _mm_set1_epi32((int)(vtx_idx + quad * 4));
+            _mm_storeu_si128((__m128i*)(idx_write + 0), _mm_add_epi32(pattern0, base));
+            _mm_storeu_si128((__m128i*)(idx_write + 4), _mm_add_epi32(pattern1, base));
+            _mm_storeu_si128((__m128i*)(idx_write + 8), _mm_add_epi32(pattern2, base));
+        }
+    }
+#endif
+    for (; quad < quad_count; quad++, idx_write += 6)
+    {
+        const unsigned int idx = vtx_idx + quad * 4;
+        idx_write[0] = (ImDrawIdx)(idx); idx_write[1] = (ImDrawIdx)(idx+1); idx_write[2] = (ImDrawIdx)(idx+2);
+        idx_write[3] = (ImDrawIdx)(idx); idx_write[4] = (ImDrawIdx)(idx+2); idx_write[5] = (ImDrawIdx)(idx+3);
+    }
+    return idx_write;
+}
+
+// A text seen on an earlier frame is drawn from its cached quads, moved into place, when they all land inside clip_rect
+// (no culling nor fine clipping to do then). Returns false to go through the regular path.
+static bool RenderTextFromCache(ImFontTextCache* cache, const ImFont* font, ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col, const ImVec4& clip_rect, const char* text_begin, const char* text_end, float wrap_width)
+{
+    bool found;
+    ImFontTextCacheEntry* entry = cache->Find(font, size, wrap_width, text_begin, text_end, &found);
+    if (!entry || !found || entry->CreatedFrame == cache->FrameCount)
+        return false;
+
+    if (!entry->HasVertices)
+    {
+        ImDrawList* layout = &cache->LayoutDrawList;
+        layout->Clear();
+        layout->PushClipRectFullScreen();
+        font->RenderText(layout, size, ImVec2(0.0f, 0.0f), IM_COL32_WHITE, ImVec4(-FLT_MAX, -FLT_MAX, FLT_MAX, FLT_MAX), text_begin, text_end, wrap_width, false);
+        entry->Vertices.resize(layout->VtxBuffer.Size);
+        if (layout->VtxBuffer.Size > 0)
+            memcpy(entry->Vertices.Data, layout->VtxBuffer.Data, (size_t)layout->VtxBuffer.Size * sizeof(ImDrawVert));
+        if (!entry->HasTextSize)
+        {
+            entry->TextSize = font->CalcTextSizeA(size, FLT_MAX, wrap_width, text_begin, text_end, NULL);
+            entry->HasTextSize = true;
+        }
+
+        // The text block as well as the quads: every line then starts inside the clip rectangle too, like the regular path expects
+        ImVec4 bounds(font->DisplayOffset.x, font->DisplayOffset.y, font->DisplayOffset.x + entry->TextSize.x, font->DisplayOffset.y + entry->TextSize.y);
+        for (int i = 0; i < entry->Vertices.Size; i++)
+        {
+            const ImVec2 p = entry->Vertices.Data[i].pos;
+            bounds.x = ImMin(bounds.x, p.x); bounds.y = ImMin(bounds.y, p.y);
+            bounds.z = ImMax(bounds.z, p.x); bounds.w = ImMax(bounds.w, p.y);
+        }
+        entry->Bounds = bounds;
+        entry->HasVertices = true;
+    }
+
+    const float offset_x = (float)(int)pos.x;
+    const float offset_y = (float)(int)pos.y;
+    const ImVec4& bounds = entry->Bounds;
+    if (bounds.x + offset_x < clip_rect.x || bounds.y + offset_y < clip_rect.y || bounds.z + offset_x > clip_rect.z || bounds.w + offset_y > clip_rect.w)
+        return false;
+
+    const int vtx_count = entry->Vertices.Size;
+    if (vtx_count == 0)
+        return true;
+    draw_list->PrimReserve(vtx_count / 4 * 6, vtx_count);
+    ImDrawVert* vtx_write = draw_list->_VtxWritePtr;
+    const ImDrawVert* vtx_read = entry->Vertices.Data;
+#if defined(IMGUI_USE_COMPACT_DRAWVERT)
+    // Whole pixels are whole fixed-point steps, so the offset is added without going back to floats
+    const int offset_qx = (int)offset_x * IM_DRAWVERT_POS_SCALE;
+    const int offset_qy = (int)offset_y * IM_DRAWVERT_POS_SCALE;
+    for (int i = 0; i < vtx_count; i++)
+    {
+        vtx_write[i].pos.x = (short)ImClamp(vtx_read[i].pos.x + offset_qx, -32768, 32767);
+        vtx_write[i].pos.y = (short)ImClamp(vtx_read[i].pos.y + offset_qy, -32768, 32767);
+        vtx_write[i].uv = vtx_read[i].uv;
+        vtx_write[i].col = col;
+    }
+#elif defined(IMGUI_RENDER_TEXT_SSE2)
+    const __m128 offset = _mm_setr_ps(offset_x, offset_y, 0.0f, 0.0f);
+    for (int i = 0; i < vtx_count; i++)
+    {
+        _mm_storeu_ps(&vtx_write[i].pos.x, _mm_add_ps(_mm_loadu_ps(&vtx_read[i].pos.x), offset));
+        vtx_write[i].col = col;
+    }
+#else
+    for (int i = 0; i < vtx_count; i++)
+    {
+        const ImVec2 p = vtx_read[i].pos;
+        vtx_write[i].pos = ImVec2(p.x + offset_x, p.y + offset_y);
+        vtx_write[i].uv = vtx_read[i].uv;
+        vtx_write[i].col = col;
+    }
+#endif
+    draw_list->_IdxWritePtr = WriteGlyphQuadIndices(draw_list->_IdxWritePtr, draw_list->_VtxCurrentIdx, vtx_count / 4);
+    draw_list->_VtxWritePtr += vtx_count;
+    draw_list->_VtxCurrentIdx += vtx_count;
+    return true;
+}
+
 void ImFont::RenderText(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col, const ImVec4& clip_rect, const char* text_begin, const char* text_end, float wrap_width, bool cpu_fine_clip) const
 {
     if (!text_end)
         text_end = text_begin + strlen(text_begin); // ImGui functions generally already provides a valid text_end, so this is merely to handle direct calls.
 
+    ImFontTextCache* text_cache = draw_list->_Data ? draw_list->_Data->TextCache : NULL;
+    if (text_cache && text_cache->Enabled && RenderTextFromCache(text_cache, this, draw_list, size, pos, col, clip_rect, text_begin, text_end, wrap_width))
+        return;
+
     // Align to be pixel perfect
     pos.x = (float)(int)pos.x + DisplayOffset.x;
     pos.y = (float)(int)pos.y + DisplayOffset.y;
@@ -2662,7 +3657,7 @@ void ImFont::RenderText(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col
         while (y_end < clip_rect.w && s_end < text_end)
         {
             s_end = (const char*)memchr(s_end, '\n', text_end - s_end);
-            s = s ? s + 1 : text_end;
+            s_end = s_end ? s_end + 1 : text_end;
             y_end += line_height;
         }
         text_end = s_end;
@@ -2708,6 +3703,91 @@ void ImFont::RenderText(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col
             }
         }
 
+        // Runs of printable ASCII: no UTF-8 decoding, no control characters and no word wrapping to look out for. Quads are
+        // written with one store per {pos, uv} and their indices all at once at the end. The float operations are the same as
+        // in the generic path below, in the same order, so the vertices are bit-identical.
+        if ((unsigned char)*s >= 32 && (unsigned char)*s < 0x80)
+        {
+            const char* run_end = word_wrap_enabled ? word_wrap_eol : text_end;
+            const ImWchar* index_lookup = IndexLookup.Data;
+            unsigned int index_lookup_size = (unsigned int)IndexLookup.Size;
+            ImDrawVert* vtx_run_begin = vtx_write;
+            for (; s < run_end; s++)
+            {
+                const unsigned int c = (unsigned char)*s;
+                if (c < 32 || c >= 0x80)
+                    break;
+
+                // Baked glyphs inline, FindGlyph() for the rest: fallback, or dynamic glyphs which get marked used or rasterized
+                const ImFontGlyph* glyph;
+                if (c < index_lookup_size && index_lookup[c] < DynamicGlyphsBegin)
+                {
+                    glyph = &Glyphs.Data[index_lookup[c]];
+                }
+                else
+                {
+                    glyph = FindGlyph((ImWchar)c);
+                    index_lookup = IndexLookup.Data;
+                    index_lookup_size = (unsigned int)IndexLookup.Size;
+                }
+                if (!glyph)
+                    continue;
+                const float char_width = glyph->AdvanceX * scale;
+                if (c == ' ')
+                {
+                    x += char_width;
+                    continue;
+                }
+
+                float x1 = x + glyph->X0 * scale;
+                float x2 = x + glyph->X1 * scale;
+                float y1 = y + glyph->Y0 * scale;
+                float y2 = y + glyph->Y1 * scale;
+                x += char_width;
+                if (x1 > clip_rect.z || x2 < clip_rect.x)
+                    continue;
+
+#ifdef IMGUI_RENDER_TEXT_SSE2
+                const __m128 pos_rect = _mm_setr_ps(x1, y1, x2, y2);
+                const __m128 uv_rect = _mm_loadu_ps(&glyph->U0);
+                if (cpu_fine_clip && (x1 < clip_rect.x || y1 < clip_rect.y || x2 > clip_rect.z || y2 > clip_rect.w))
+                {
+                    float u1 = glyph->U0, v1 = glyph->V0, u2 = glyph->U1, v2 = glyph->V1;
+                    if (!FineClipGlyphQuad(clip_rect, x1, y1, x2, y2, u1, v1, u2, v2))
+                        continue;
+                    vtx_write[0].pos = ImVec2(x1, y1); vtx_write[0].col = col; vtx_write[0].uv = ImVec2(u1, v1);
+                    vtx_write[1].pos = ImVec2(x2, y1); vtx_write[1].col = col; vtx_write[1].uv = ImVec2(u2, v1);
+                    vtx_write[2].pos = ImVec2(x2, y2); vtx_write[2].col = col; vtx_write[2].uv = ImVec2(u2, v2);
+                    vtx_write[3].pos = ImVec2(x1, y2); vtx_write[3].col = col; vtx_write[3].uv = ImVec2(u1, v2);
+                    vtx_write += 4;
+                    continue;
+                }
+#ifdef IMGUI_USE_COMPACT_DRAWVERT
+                WriteGlyphQuadCompact(vtx_write, pos_rect, uv_rect, col);
+#else
+                _mm_storeu_ps(&vtx_write[0].pos.x, _mm_movelh_ps(pos_rect, uv_rect));                               // x1 y1 u1 v1
+                _mm_storeu_ps(&vtx_write[1].pos.x, _mm_shuffle_ps(pos_rect, uv_rect, _MM_SHUFFLE(1, 2, 1, 2)));     // x2 y1 u2 v1
+                _mm_storeu_ps(&vtx_write[2].pos.x, _mm_movehl_ps(uv_rect, pos_rect));                               // x2 y2 u2 v2
+                _mm_storeu_ps(&vtx_write[3].pos.x, _mm_shuffle_ps(pos_rect, uv_rect, _MM_SHUFFLE(3, 0, 3, 0)));     // x1 y2 u1 v2
+                vtx_write[0].col = col; vtx_write[1].col = col; vtx_write[2].col = col; vtx_write[3].col = col;
+#endif
+#else
+                float u1 = glyph->U0, v1 = glyph->V0, u2 = glyph->U1, v2 = glyph->V1;
+                if (cpu_fine_clip && !FineClipGlyphQuad(clip_rect, x1, y1, x2, y2, u1, v1, u2, v2))
+                    continue;
+                vtx_write[0].pos = ImVec2(x1, y1); vtx_write[0].col = col; vtx_write[0].uv = ImVec2(u1, v1);
+                vtx_write[1].pos = ImVec2(x2, y1); vtx_write[1].col = col; vtx_write[1].uv = ImVec2(u2, v1);
+                vtx_write[2].pos = ImVec2(x2, y2); vtx_write[2].col = col; vtx_write[2].uv = ImVec2(u2, v2);
+                vtx_write[3].pos = ImVec2(x1, y2); vtx_write[3].col = col; vtx_write[3].uv = ImVec2(u1, v2);
+#endif
+                vtx_write += 4;
+            }
+            const int quad_count = (int)(vtx_write - vtx_run_begin) / 4;
+            idx_write = WriteGlyphQuadIndices(idx_write, vtx_current_idx, quad_count);
+            vtx_current_idx += quad_count * 4;
+            continue;
+        }
+
         // Decode and advance source
         unsigned int c = (unsigned int)*s;
         if (c < 0x80)
@@ -2756,44 +3836,20 @@ void ImFont::RenderText(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col
                     float u2 = glyph->U1;
                     float v2 = glyph->V1;
 
-                    // CPU side clipping used to fit text in their frame when the frame is too small. Only does clipping for axis aligned quads.
-                    if (cpu_fine_clip)
+                    if (cpu_fine_clip && !FineClipGlyphQuad(clip_rect, x1, y1, x2, y2, u1, v1, u2, v2))
                     {
-                        if (x1 < clip_rect.x)
-                        {
-                            u1 = u1 + (1.0f - (x2 - clip_rect.x) / (x2 - x1)) * (u2 - u1);
-                            x1 = clip_rect.x;
-                        }
-                        if (y1 < clip_rect.y)
-                        {
-                            v1 = v1 + (1.0f - (y2 - clip_rect.y) / (y2 - y1)) * (v2 - v1);
-                            y1 = clip_rect.y;
-                        }
-                        if (x2 > clip_rect.z)
-                        {
-                            u2 = u1 + ((clip_rect.z - x1) / (x2 - x1)) * (u2 - u1);
-                            x2 = clip_rect.z;
-                        }
-                        if (y2 > clip_rect.w)
-                        {
-                            v2 = v1 + ((clip_rect.w - y1) / (y2 - y1)) * (v2 - v1);
-                            y2 = clip_rect.w;
-                        }
-                        if (y1 >= y2)
-                        {
-                            x += char_width;
-                            continue;
-                        }
+                        x += char_width;
+                        continue;
                     }
 
                     // We are NOT calling PrimRectUV() here because non-inlined causes too much overhead in a debug builds. Inlined here:
                     {
                         idx_write[0] = (ImDrawIdx)(vtx_current_idx); idx_write[1] = (ImDrawIdx)(vtx_current_idx+1); idx_write[2] = (ImDrawIdx)(vtx_current_idx+2);
                         idx_write[3] = (ImDrawIdx)(vtx_current_idx); idx_write[4] = (ImDrawIdx)(vtx_current_idx+2); idx_write[5] = (ImDrawIdx)(vtx_current_idx+3);
-                        vtx_write[0].pos.x = x1; vtx_write[0].pos.y = y1; vtx_write[0].col = col; vtx_write[0].uv.x = u1; vtx_write[0].uv.y = v1;
-                        vtx_write[1].pos.x = x2; vtx_write[1].pos.y = y1; vtx_write[1].col = col; vtx_write[1].uv.x = u2; vtx_write[1].uv.y = v1;
-                        vtx_write[2].pos.x = x2; vtx_write[2].pos.y = y2; vtx_write[2].col = col; vtx_write[2].uv.x = u2; vtx_write[2].uv.y = v2;
-                        vtx_write[3].pos.x = x1; vtx_write[3].pos.y = y2; vtx_write[3].col = col; vtx_write[3].uv.x = u1; vtx_write[3].uv.y = v2;
+                        vtx_write[0].pos = ImVec2(x1, y1); vtx_write[0].col = col; vtx_write[0].uv = ImVec2(u1, v1);
+                        vtx_write[1].pos = ImVec2(x2, y1); vtx_write[1].col = col; vtx_write[1].uv = ImVec2(u2, v1);
+                        vtx_write[2].pos = ImVec2(x2, y2); vtx_write[2].col = col; vtx_write[2].uv = ImVec2(u2, v2);
+                        vtx_write[3].pos = ImVec2(x1, y2); vtx_write[3].col = col; vtx_write[3].uv = ImVec2(u1, v2);
                         vtx_write += 4;
                         vtx_current_idx += 4;
                         idx_write += 6;
@@ -2814,6 +3870,116 @@ void ImFont::RenderText(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col
     draw_list->_VtxCurrentIdx = (unsigned int)draw_list->VtxBuffer.Size;
 }
 
+//-----------------------------------------------------------------------------
+// [SECTION] ImFontTextCache
+//-----------------------------------------------------------------------------
+
+ImFontTextCache::ImFontTextCache() : LayoutDrawList(&LayoutData)
+{
+    Enabled = true;
+    UseCounter = 0;
+    FrameCount = 0;
+    Hits = Misses = 0;
+    LastFrameHits = LastFrameMisses = 0;
+}
+
+void ImFontTextCache::Clear()
+{
+    for (int i = 0; i < Entries.Size; i++)
+    {
+        Entries[i].Text.clear();
+        Entries[i].Vertices.clear();
+    }
+    Entries.clear();
+    LayoutDrawList.ClearFreeMemory();
+}
+
+void ImFontTextCache::NewFrame()
+{
+    LastFrameHits = Hits;
+    LastFrameMisses = Misses;
+    Hits = Misses = 0;
+    FrameCount++;
+}
+
+ImFontTextCacheEntry* ImFontTextCache::Find(const ImFont* font, float size, float wrap_width, const char* text_begin, const char* text_end, bool* found)
+{
+    *found = false;
+    const int text_len = (int)(text_end - text_begin);
+    if (text_len <= 0 || text_len > IM_FONT_TEXT_CACHE_MAX_LENGTH)
+        return NULL;
+    if (Entries.empty())
+    {
+        ImFontTextCacheEntry unused;
+        memset(&unused, 0, sizeof(unused));
+        Entries.resize(IM_FONT_TEXT_CACHE_SETS * IM_FONT_TEXT_CACHE_WAYS, unused);
+    }
+
+    struct { const ImFont* Font; float Size; float WrapWidth; } key;
+    memset(&key, 0, sizeof(key));
+    key.Font = font;
+    key.Size = size;
+    key.WrapWidth = wrap_width;
+    ImU32 hash = ImHash(text_begin, text_len, ImHash(&key, sizeof(key), 0));
+    if (hash == 0)
+        hash = 1;
+
+    ImFontTextCacheEntry* set = &Entries.Data[(hash & (IM_FONT_TEXT_CACHE_SETS - 1)) * IM_FONT_TEXT_CACHE_WAYS];
+    ImFontTextCacheEntry* victim = set;
+    for (int way = 0; way < IM_FONT_TEXT_CACHE_WAYS; way++)
+    {
+        ImFontTextCacheEntry* entry = &set[way];
+        if (entry->Hash == hash && entry->Font == font && entry->FontGeneration == font->Generation && entry->Size == size && entry->WrapWidth == wrap_width &&
+            entry->Text.Size == text_len && memcmp(entry->Text.Data, text_begin, (size_t)text_len) == 0)
+        {
+            entry->LastUsed = ++UseCounter;
+            if (entry->CountedFrame != FrameCount)
+                Hits++;
+            entry->CountedFrame = FrameCount;
+            *found = true;
+            return entry;
+        }
+        if (entry->LastUsed < victim->LastUsed) // Unused ways are at 0
+            victim = entry;
+    }
+
+    Misses++;
+    victim->Hash = hash;
+    victim->LastUsed = ++UseCounter;
+    victim->CreatedFrame = victim->CountedFrame = FrameCount;
+    victim->Font = font;
+    victim->FontGeneration = font->Generation;
+    victim->Size = size;
+    victim->WrapWidth = wrap_width;
+    victim->Text.resize(text_len);
+    memcpy(victim->Text.Data, text_begin, (size_t)text_len);
+    victim->HasTextSize = victim->HasVertices = false;
+    return victim;
+}
+
+ImVec2 ImFontTextCache::CalcTextSize(const ImFont* font, float size, float wrap_width, const char* text_begin, const char* text_end)
+{
+    bool found;
+    ImFontTextCacheEntry* entry = Enabled ? Find(font, size, wrap_width, text_begin, text_end, &found) : NULL;
+    if (entry && entry->HasTextSize)
+        return entry->TextSize;
+    ImVec2 text_size = font->CalcTextSizeA(size, FLT_MAX, wrap_width, text_begin, text_end, NULL);
+    if (entry)
+    {
+        entry->TextSize = text_size;
+        entry->HasTextSize = true;
+    }
+    return text_size;
+}
+
+int ImFontTextCache::GetMemoryUsage() const
+{
+    int bytes = Entries.Capacity * (int)sizeof(ImFontTextCacheEntry);
+    for (int i = 0; i < Entries.Size; i++)
+        bytes += Entries[i].Text.Capacity + Entries[i].Vertices.Capacity * (int)sizeof(ImDrawVert);
+    return bytes;
+}
+
 //-----------------------------------------------------------------------------
 // [SECTION] Internal Render Helpers
 // (progressively moved from imgui.cpp to here when they are redesigned to stop accessing ImGui global state)
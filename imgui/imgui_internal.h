@@ -36,6 +36,7 @@
 struct ImRect;                      // An axis-aligned rectangle (2 points)
 struct ImDrawDataBuilder;           // Helper to build a ImDrawData instance
 struct ImDrawListSharedData;        // Data shared between all ImDrawList instances
+struct ImFontTextCache;             // Text layouts (sizes, glyph quads) kept from previous frames
 struct ImGuiColorMod;               // Stacked color modifier, backup of modified data so we can restore it
 struct ImGuiColumnData;             // Storage data for a single column
 struct ImGuiColumnsSet;             // Storage data for a columns set
@@ -118,14 +119,27 @@ IMGUI_API int           ImTextCountCharsFromUtf8(const char* in_text, const char
 IMGUI_API int           ImTextCountUtf8BytesFromChar(const char* in_text, const char* in_text_end);                        // return number of bytes to express one char in UTF-8
 IMGUI_API int           ImTextCountUtf8BytesFromStr(const ImWchar* in_text, const ImWchar* in_text_end);                   // return number of bytes to express string in UTF-8
 
-// Helpers: Misc
+// Helpers: Hashing
+// ImHash() handles the "label###id" syntax then hashes the bytes with a replaceable function. By default that's the fastest one the
+// CPU has: ImHashCrc32c() with SSE4.2, ImHashWords() otherwise. IDs depend on the function: only change it before the first NewFrame().
+typedef ImU32 (*ImHashFunction)(const void* data, int data_size, ImU32 seed);      // Hash exactly data_size bytes, no "###" handling
 IMGUI_API ImU32         ImHash(const void* data, int data_size, ImU32 seed = 0);    // Pass data_size==0 for zero-terminated strings
+IMGUI_API void          ImHashSetFunction(ImHashFunction fn);                       // NULL to go back to ImHashGetDefaultFunction()
+IMGUI_API ImHashFunction ImHashGetFunction();
+IMGUI_API ImHashFunction ImHashGetDefaultFunction();
+IMGUI_API ImU32         ImHashCrc32Table(const void* data, int data_size, ImU32 seed);  // Portable CRC32 through a 1KB table, same IDs as upstream dear imgui
+IMGUI_API ImU32         ImHashCrc32c(const void* data, int data_size, ImU32 seed);      // CRC32C, with the SSE4.2 instruction when ImHashCrc32cSupported()
+IMGUI_API ImU32         ImHashWords(const void* data, int data_size, ImU32 seed);       // Portable, 8 bytes at a time multiply/rotate
+IMGUI_API bool          ImHashCrc32cSupported();
+
+// Helpers: Misc
 IMGUI_API void*         ImFileLoadToMemory(const char* filename, const char* file_open_mode, size_t* out_file_size = NULL, int padding_bytes = 0);
 IMGUI_API FILE*         ImFileOpen(const char* filename, const char* file_open_mode);
 static inline bool      ImCharIsBlankA(char c)          { return c == ' ' || c == '\t'; }
 static inline bool      ImCharIsBlankW(unsigned int c)  { return c == ' ' || c == '\t' || c == 0x3000; }
 static inline bool      ImIsPowerOfTwo(int v)           { return v != 0 && (v & (v - 1)) == 0; }
 static inline int       ImUpperPowerOfTwo(int v)        { v--; v |= v >> 1; v |= v >> 2; v |= v >> 4; v |= v >> 8; v |= v >> 16; v++; return v; }
+IMGUI_API void          ImMinMax(const float* values, int values_count, int stride, float* in_out_min, float* in_out_max);  // Widen [*in_out_min, *in_out_max] to the values, 16 at a time with SSE when stride == sizeof(float)
 #define ImQsort         qsort
 
 // Helpers: Geometry
@@ -456,14 +470,106 @@ struct IMGUI_API ImGuiMenuColumns
     float       CalcExtraSpace(float avail_w);
 };
 
+// Fenwick (binary indexed) tree over an array of non-negative values: changing or appending a value, the sum of the first n
+// values and finding which value a running sum falls into are all O(log n). Build() is O(n).
+template<typename T>
+struct ImFenwickTree
+{
+    ImVector<T>     Data;       // Data[i-1] holds the sum of the values (i - (i & -i), i]
+
+    int             Size() const                    { return Data.Size; }
+    void            Clear()                         { Data.clear(); }
+    void            Build(const T* values, int count)
+    {
+        Data.resize(count);
+        for (int i = 0; i < count; i++)
+            Data[i] = values[i];
+        for (int i = 1; i <= count; i++)
+            if (i + (i & -i) <= count)
+                Data[i + (i & -i) - 1] += Data[i - 1];
+    }
+    void            Push(T value)                   // Append a value, O(log n)
+    {
+        int i = Data.Size + 1;
+        for (int j = i - 1; j > i - (i & -i); j -= j & -j)
+            value += Data[j - 1];
+        Data.push_back(value);
+    }
+    void            Shrink(int count)               { IM_ASSERT(count <= Data.Size); Data.resize(count); }
+    void            Add(int idx, T delta)           { for (int i = idx + 1; i <= Data.Size; i += i & -i) Data[i - 1] += delta; }
+    T               PrefixSum(int count) const      { T sum = 0; for (int i = count; i > 0; i -= i & -i) sum += Data[i - 1]; return sum; }
+    int             Find(T sum, T* out_prefix_sum = NULL) const  // Index of the value containing offset 'sum' (first with PrefixSum(idx+1) > sum), Size() past the end. Outputs PrefixSum(idx).
+    {
+        int idx = 0;
+        T prefix_sum = 0;
+        int step = 1;
+        while (step * 2 <= Data.Size)
+            step *= 2;
+        for (; step > 0; step >>= 1)
+            if (idx + step <= Data.Size && prefix_sum + Data[idx + step - 1] <= sum)
+            {
+                idx += step;
+                prefix_sum += Data[idx - 1];
+            }
+        if (out_prefix_sum)
+            *out_prefix_sum = prefix_sum;
+        return idx;
+    }
+};
+
+// Text for InputText(): wide characters in chunks of at most IM_TEXT_ROPE_CHUNK_SIZE, with Fenwick trees over the chunks'
+// lengths, UTF-8 sizes and newline counts. Getting to a character, a line or a UTF-8 offset is O(log n) plus a scan of one
+// chunk, and an edit only moves the characters of the chunks it touches. Adding or removing chunks rebuilds the trees.
+#define IM_TEXT_ROPE_CHUNK_SIZE     2048
+
+struct ImTextRopeChunk
+{
+    int                     Len;
+    int                     LenUtf8;
+    int                     Newlines;
+    ImWchar                 Text[IM_TEXT_ROPE_CHUNK_SIZE];
+};
+
+struct IMGUI_API ImTextRope
+{
+    ImVector<ImTextRopeChunk*> Chunks;
+    ImFenwickTree<int>      LenTree;
+    ImFenwickTree<int>      LenUtf8Tree;
+    ImFenwickTree<int>      NewlinesTree;
+    int                     Len, LenUtf8, Newlines;
+    int                     CacheChunk, CacheChunkBegin;    // Chunk GetChar() last looked into, -1 when not set
+    int                     EditBegin, EditEnd;             // Characters inserted or deleted since ClearEdits(), in current positions. EditBegin > EditEnd when none
+
+    ImTextRope()                                    { Len = LenUtf8 = Newlines = 0; CacheChunk = -1; CacheChunkBegin = 0; ClearEdits(); }
+    ~ImTextRope()                                   { Clear(); }
+    void                    Clear();
+    void                    SetFromUtf8(const char* text, const char* text_end);      // Clears the edits too
+    void                    Insert(int pos, const ImWchar* text, int text_len);
+    void                    Delete(int pos, int count);
+    ImWchar                 GetChar(int pos)        { if (pos >= Len) return 0; if (CacheChunk < 0 || pos < CacheChunkBegin || pos >= CacheChunkBegin + Chunks[CacheChunk]->Len) CacheChunk = FindChunk(pos, &CacheChunkBegin); return Chunks[CacheChunk]->Text[pos - CacheChunkBegin]; }
+    int                     GetLineCount() const    { return Newlines + 1; }
+    int                     GetLineStart(int line) const;                           // Position after the line'th newline
+    int                     GetLineFromPos(int pos) const;                          // Newlines before 'pos'
+    int                     GetUtf8Offset(int pos) const;                           // UTF-8 bytes before 'pos'
+    int                     GetPosFromUtf8Offset(int offset) const;                 // Characters in the first 'offset' bytes
+    int                     CopyUtf8(char* buf, int begin, int end) const;          // buf needs room for the UTF-8 of [begin, end), not zero-terminated. Returns the bytes written
+    bool                    HasEdits() const        { return EditBegin <= EditEnd; }
+    void                    ClearEdits()            { EditBegin = INT_MAX; EditEnd = INT_MIN; }
+
+    int                     FindChunk(int pos, int* out_chunk_begin) const;         // Chunk holding 'pos' (the last one for pos == Len)
+    void                    ReplaceChunks(int chunk_idx, int chunk_count, const ImWchar* a, int a_len, const ImWchar* b, int b_len, const ImWchar* c, int c_len);
+    void                    UpdateChunk(int chunk_idx, int len_delta, int len_utf8_delta, int newlines_delta);
+    void                    RebuildTrees();
+};
+
 // Internal state of the currently focused/edited text input box
 struct IMGUI_API ImGuiInputTextState
 {
     ImGuiID                 ID;                     // widget id owning the text state
-    ImVector<ImWchar>       TextW;                  // edit buffer, we need to persist but can't guarantee the persistence of the user-provided buffer. so we copy into own buffer.
+    ImTextRope              Text;                   // edit buffer, we need to persist but can't guarantee the persistence of the user-provided buffer. so we copy into own buffer.
     ImVector<char>          InitialText;            // backup of end-user buffer at the time of focus (in UTF-8, unaltered)
-    ImVector<char>          TempBuffer;             // temporary buffer for callback and other other operations. size=capacity.
-    int                     CurLenA, CurLenW;       // we need to maintain our buffer length in both UTF-8 and wchar format.
+    ImVector<char>          TempBuffer;             // UTF-8 copy of Text, kept in sync a changed range at a time, what callbacks and the display see. size=capacity.
+    int                     CurLenA;                // length of the text in TempBuffer
     int                     BufCapacityA;           // end-user buffer capacity
     float                   ScrollX;
     ImGuiStb::STB_TexteditState StbState;
@@ -476,12 +582,14 @@ struct IMGUI_API ImGuiInputTextState
     ImGuiInputTextCallback  UserCallback;
     void*                   UserCallbackData;
 
-    ImGuiInputTextState()                           { memset(this, 0, sizeof(*this)); }
+    ImGuiInputTextState()                           { ID = 0; CurLenA = BufCapacityA = 0; ScrollX = 0.0f; memset(&StbState, 0, sizeof(StbState)); CursorAnim = 0.0f; CursorFollow = SelectedAllMouseLock = false; UserFlags = 0; UserCallback = NULL; UserCallbackData = NULL; }
     void                CursorAnimReset()           { CursorAnim = -0.30f; }                                   // After a user-input the cursor stays on for a while without blinking
-    void                CursorClamp()               { StbState.cursor = ImMin(StbState.cursor, CurLenW); StbState.select_start = ImMin(StbState.select_start, CurLenW); StbState.select_end = ImMin(StbState.select_end, CurLenW); }
+    void                CursorClamp()               { StbState.cursor = ImMin(StbState.cursor, Text.Len); StbState.select_start = ImMin(StbState.select_start, Text.Len); StbState.select_end = ImMin(StbState.select_end, Text.Len); }
     bool                HasSelection() const        { return StbState.select_start != StbState.select_end; }
     void                ClearSelection()            { StbState.select_start = StbState.select_end = StbState.cursor; }
-    void                SelectAll()                 { StbState.select_start = 0; StbState.cursor = StbState.select_end = CurLenW; StbState.has_preferred_x = false; }
+    void                SelectAll()                 { StbState.select_start = 0; StbState.cursor = StbState.select_end = Text.Len; StbState.has_preferred_x = false; }
+    void                SetTextFromUtf8(const char* text, const char* text_end);   // Text and TempBuffer
+    void                SyncTempBuffer(int* out_begin, int* out_old_end, int* out_new_end);    // Re-encode what changed in Text since the last call into TempBuffer. Outputs the byte range replaced, out_begin > out_old_end if nothing
     void                OnKeyPressed(int key);      // Cannot be inline because we call in code in stb_textedit.h implementation
 };
 
@@ -562,6 +670,40 @@ struct ImGuiColumnsSet
     }
 };
 
+// Storage for an ImGuiVariableListClipper: the height of every item, measured when it was last displayed or estimated until then.
+// The running sums are kept in doubles, heights get changed by deltas over and over and a float sum over 100k items would drift.
+struct ImGuiListClipperHeights
+{
+    ImGuiID                 ID;
+    int                     LastFrameUsed;
+    ImVector<float>         Heights;
+    ImFenwickTree<double>   Offsets;            // Running sums of Heights
+
+    ImGuiListClipperHeights() { ID = 0; LastFrameUsed = -1; }
+};
+
+// Arcs PathArcTo() already computed, as unit vectors: AddCircle()/AddCircleFilled() and the color wheel ask for the same ones every
+// frame, and the radius only scales them. Direct-mapped on a hash of the angles and the segment count. Each ImDrawList owns one,
+// written while building the list: nothing in ImDrawListSharedData is written to, so lists may be built on several threads.
+#define IM_DRAWLIST_ARC_CACHE_SIZE          16
+#define IM_DRAWLIST_ARC_CACHE_MAX_SEGMENTS  512     // Finer arcs are computed every time
+
+struct ImDrawListArcCacheEntry
+{
+    float               AMin, AMax;
+    int                 NumSegments;                // 0: empty
+    ImVector<ImVec2>    UnitPoints;                 // NumSegments+1 points on the unit circle, from AMin to AMax
+
+    ImDrawListArcCacheEntry() { AMin = AMax = 0.0f; NumSegments = 0; }
+};
+
+struct ImDrawListArcCache
+{
+    ImDrawListArcCacheEntry Entries[IM_DRAWLIST_ARC_CACHE_SIZE];
+
+    const ImVec2*   GetUnitPoints(float a_min, float a_max, int num_segments);     // NULL if num_segments is out of the cache's range. Valid until the next call.
+};
+
 // Data shared between all ImDrawList instances
 struct IMGUI_API ImDrawListSharedData
 {
@@ -570,6 +712,7 @@ struct IMGUI_API ImDrawListSharedData
     float           FontSize;                   // Current/default font size (optional, for simplified AddText overload)
     float           CurveTessellationTol;
     ImVec4          ClipRectFullscreen;         // Value for PushClipRectFullscreen()
+    ImFontTextCache* TextCache;                 // Used by ImFont::RenderText() when set (the ImGui context sets its own)
 
     // Const data
     // FIXME: Bake rounded corners fill/borders in atlas
@@ -578,6 +721,52 @@ struct IMGUI_API ImDrawListSharedData
     ImDrawListSharedData();
 };
 
+// Text layout cache, for labels and paragraphs that are the same frame after frame: keeps what CalcTextSizeA() returned,
+// and the glyph quads RenderText() wrote at (0,0) so drawing the text again is a copy moved into place. Only quads
+// that end up fully inside the clip rectangle come from here, anything clipped goes through the regular path.
+// Set-associative: a text hashes to a set of IM_FONT_TEXT_CACHE_WAYS entries, a miss replaces the least recently used of them.
+#define IM_FONT_TEXT_CACHE_SETS         256
+#define IM_FONT_TEXT_CACHE_WAYS         4
+#define IM_FONT_TEXT_CACHE_MAX_LENGTH   512     // Longer texts (big text panes) are never cached
+
+struct ImFontTextCacheEntry
+{
+    ImU32                   Hash;               // Of the text, font, size and wrap width. 0 if unused
+    ImU64                   LastUsed;           // ImFontTextCache::UseCounter when last found
+    int                     CreatedFrame;       // Quads are only made for texts seen again on a later frame, not for values changing every frame
+    int                     CountedFrame;       // Last frame it counted as a hit or miss: CalcTextSize() and RenderText() both look a label up
+    const ImFont*           Font;
+    int                     FontGeneration;     // Font->Generation when cached
+    float                   Size;
+    float                   WrapWidth;
+    ImVector<char>          Text;
+    bool                    HasTextSize;
+    bool                    HasVertices;
+    ImVec2                  TextSize;           // CalcTextSizeA(Size, FLT_MAX, WrapWidth, text)
+    ImVector<ImDrawVert>    Vertices;           // What RenderText() wrote at (0,0), colors not set
+    ImVec4                  Bounds;             // Of the quads and the text block, at (0,0) too
+};
+
+struct IMGUI_API ImFontTextCache
+{
+    bool                    Enabled;
+    ImVector<ImFontTextCacheEntry> Entries;     // IM_FONT_TEXT_CACHE_SETS * IM_FONT_TEXT_CACHE_WAYS, allocated on first use
+    ImU64                   UseCounter;
+    int                     FrameCount;
+    int                     Hits, Misses;       // This frame, each text once
+    int                     LastFrameHits, LastFrameMisses;
+    ImDrawListSharedData    LayoutData;         // No TextCache, so laying out a text for the cache goes through the regular path
+    ImDrawList              LayoutDrawList;
+
+    ImFontTextCache();
+    ~ImFontTextCache()      { Clear(); }
+    void                    Clear();
+    void                    NewFrame();
+    ImFontTextCacheEntry*   Find(const ImFont* font, float size, float wrap_width, const char* text_begin, const char* text_end, bool* found); // Replaces a way on a miss. NULL if the text is too long
+    ImVec2                  CalcTextSize(const ImFont* font, float size, float wrap_width, const char* text_begin, const char* text_end);     // CalcTextSizeA(size, FLT_MAX, ...)
+    int                     GetMemoryUsage() const;
+};
+
 struct ImDrawDataBuilder
 {
     ImVector<ImDrawList*>   Layers[2];           // Global layers for: regular, tooltip
@@ -610,6 +799,7 @@ struct ImGuiNextWindowData
     ImGuiCond               SizeConstraintCond;
     ImGuiCond               FocusCond;
     ImGuiCond               BgAlphaCond;
+    ImGuiCond               ContentVersionCond;
     ImVec2                  PosVal;
     ImVec2                  PosPivotVal;
     ImVec2                  SizeVal;
@@ -619,11 +809,12 @@ struct ImGuiNextWindowData
     ImGuiSizeCallback       SizeCallback;
     void*                   SizeCallbackUserData;
     float                   BgAlphaVal;
+    ImU32                   ContentVersionVal;
     ImVec2                  MenuBarOffsetMinVal;                // This is not exposed publicly, so we don't clear it.
 
     ImGuiNextWindowData()
     {
-        PosCond = SizeCond = ContentSizeCond = CollapsedCond = SizeConstraintCond = FocusCond = BgAlphaCond = 0;
+        PosCond = SizeCond = ContentSizeCond = CollapsedCond = SizeConstraintCond = FocusCond = BgAlphaCond = ContentVersionCond = 0;
         PosVal = PosPivotVal = SizeVal = ImVec2(0.0f, 0.0f);
         ContentSizeVal = ImVec2(0.0f, 0.0f);
         CollapsedVal = false;
@@ -631,12 +822,13 @@ struct ImGuiNextWindowData
         SizeCallback = NULL;
         SizeCallbackUserData = NULL;
         BgAlphaVal = FLT_MAX;
+        ContentVersionVal = 0;
         MenuBarOffsetMinVal = ImVec2(0.0f, 0.0f);
     }
 
     void    Clear()
     {
-        PosCond = SizeCond = ContentSizeCond = CollapsedCond = SizeConstraintCond = FocusCond = BgAlphaCond = 0;
+        PosCond = SizeCond = ContentSizeCond = CollapsedCond = SizeConstraintCond = FocusCond = BgAlphaCond = ContentVersionCond = 0;
     }
 };
 
@@ -652,6 +844,7 @@ struct ImGuiContext
     float                   FontSize;                           // (Shortcut) == FontBaseSize * g.CurrentWindow->FontWindowScale == window->FontSize(). Text height for current window.
     float                   FontBaseSize;                       // (Shortcut) == IO.FontGlobalScale * Font->Scale * Font->FontSize. Base text height.
     ImDrawListSharedData    DrawListSharedData;
+    ImFontTextCache         TextCache;
 
     double                  Time;
     int                     FrameCount;
@@ -798,6 +991,7 @@ struct ImGuiContext
     int                     WantCaptureKeyboardNextFrame;
     int                     WantTextInputNextFrame;
     char                    TempBuffer[1024*3+1];               // Temporary text buffer
+    ImVector<ImVec2>        PlotColumns;                        // PlotEx(): min (x) and max (y) of the values in each pixel column, when there are more values than pixels
 
     ImGuiContext(ImFontAtlas* shared_font_atlas) : OverlayDrawList(NULL)
     {
@@ -866,6 +1060,7 @@ struct ImGuiContext
 
         DimBgRatio = 0.0f;
         OverlayDrawList._Data = &DrawListSharedData;
+        DrawListSharedData.TextCache = &TextCache;
         OverlayDrawList._OwnerName = "##Overlay"; // Give it a name for debugging
         MouseCursor = ImGuiMouseCursor_Arrow;
 
@@ -1055,11 +1250,21 @@ struct IMGUI_API ImGuiWindow
     ImGuiMenuColumns        MenuColumns;                        // Simplified columns storage for menu items
     ImGuiStorage            StateStorage;
     ImVector<ImGuiColumnsSet> ColumnsStorage;
+    ImVector<ImGuiListClipperHeights> ListClipperHeightsStorage;
     float                   FontWindowScale;                    // User scale multiplier per-window
     int                     SettingsIdx;                        // Index into SettingsWindow[] (indices are always valid as we only grow the array from the back)
 
-    ImDrawList*             DrawList;                           // == &DrawListInst (for backward compatibility reason with code using imgui_internal.h we keep this a pointer)
+    ImDrawList*             DrawList;                           // == &DrawListInst (for backward compatibility reason with code using imgui_internal.h we keep this a pointer). == &DrawListBack while Retained, until EndFrame().
     ImDrawList              DrawListInst;
+    ImDrawList              DrawListBack;                       // Windows with a content version draw their title bar, background etc. here first, to compare them with DrawListInst's
+
+    // Retained contents (see SetNextWindowContentVersion())
+    bool                    Retained;                           // Begin() kept last frame's DrawListInst and skips the contents this frame
+    bool                    RetainedValid;                      // DrawListInst was built with a content version, while the window was idle
+    ImU32                   RetainedKey;                        // Content version, style and fonts DrawListInst was built with
+    ImVec2                  RetainedScroll;
+    ImVec2                  RetainedCursorMaxPos;               // DC.CursorMaxPos after the contents, for next frame's SizeContents
+    int                     RetainedDecoVtxCount, RetainedDecoIdxCount, RetainedDecoCmdCount;  // Title bar, background etc. come first in DrawListInst, up to there. The last command carries on with the contents.
     ImGuiWindow*            ParentWindow;                       // If we are a child _or_ popup window, this is pointing to our parent. Otherwise NULL.
     ImGuiWindow*            RootWindow;                         // Point to ourself or first ancestor that is not a child window.
     ImGuiWindow*            RootWindowForTitleBarHighlight;     // Point to ourself or first ancestor which will display TitleBgActive color when this window is active.
@@ -1281,7 +1486,13 @@ namespace ImGui
     IMGUI_API void          ColorPickerOptionsPopup(const float* ref_col, ImGuiColorEditFlags flags);
 
     // Plot
-    IMGUI_API void          PlotEx(ImGuiPlotType plot_type, const char* label, float (*values_getter)(void* data, int idx), void* data, int values_count, int values_offset, const char* overlay_text, float scale_min, float scale_max, ImVec2 graph_size);
+    // values_range_getter: optional, widens [*in_out_min, *in_out_max] to the values idx_begin..idx_end-1 (indices as passed to values_getter,
+    // the range never wraps). With more values than pixels PlotEx() reduces each pixel column to its min/max, through it when given.
+    IMGUI_API void          PlotEx(ImGuiPlotType plot_type, const char* label, float (*values_getter)(void* data, int idx), void* data, int values_count, int values_offset, const char* overlay_text, float scale_min, float scale_max, ImVec2 graph_size, void (*values_range_getter)(void* data, int idx_begin, int idx_end, float* in_out_min, float* in_out_max) = NULL);
+
+    // Memory: same as MemAlloc()/MemFree() but leave io.MetricsActiveAllocations alone, so they can be called from other threads
+    IMGUI_API void*         MemAllocNoMetrics(size_t size);
+    IMGUI_API void          MemFreeNoMetrics(void* ptr);
 
     // Shade functions (write over already created vertices)
     IMGUI_API void          ShadeVertsLinearColorGradientKeepAlpha(ImDrawList* draw_list, int vert_start_idx, int vert_end_idx, ImVec2 gradient_p0, ImVec2 gradient_p1, ImU32 col0, ImU32 col1);
@@ -1297,6 +1508,12 @@ IMGUI_API void              ImFontAtlasBuildPackCustomRects(ImFontAtlas* atlas,
 IMGUI_API void              ImFontAtlasBuildFinish(ImFontAtlas* atlas);
 IMGUI_API void              ImFontAtlasBuildMultiplyCalcLookupTable(unsigned char out_table[256], float in_multiply_factor);
 IMGUI_API void              ImFontAtlasBuildMultiplyRectAlpha8(const unsigned char table[256], unsigned char* pixels, int x, int y, int w, int h, int stride);
+IMGUI_API bool              ImFontAtlasBuildSaveToMemory(ImFontAtlas* atlas, ImVector<unsigned char>* out_data);      // Everything Build() outputs (alpha8 pixels, glyphs, custom rects), for an application side cache
+IMGUI_API bool              ImFontAtlasBuildLoadFromMemory(ImFontAtlas* atlas, const void* data, size_t data_size);   // Instead of Build(). Fails if the data doesn't match the atlas fonts/custom rects, the caller keys it on the rest (font data, sizes, ranges...)
+IMGUI_API void              ImFontAtlasBuildDynamicInit(ImFontAtlas* atlas);          // After a build, with ImFontAtlasFlags_DynamicGlyphs
+IMGUI_API void              ImFontAtlasDynamicDestroy(ImFontAtlas* atlas);            // Dynamic glyphs rasterized so far become regular ones
+IMGUI_API void              ImFontAtlasDynamicClearRegion(ImFontAtlas* atlas, unsigned char* pixels_alpha8);
+IMGUI_API void              ImFontAtlasDynamicNewFrame(ImFontAtlas* atlas);           // Called by NewFrame(), evicts if glyphs didn't fit during the last frame
 
 #ifdef __clang__
 #pragma clang diagnostic pop
@@ -93,8 +93,9 @@ static bool             DataTypeApplyOpFromText(const char* buf, const char* ini
 
 // For InputTextEx()
 static bool             InputTextFilterCharacter(unsigned int* p_char, ImGuiInputTextFlags flags, ImGuiInputTextCallback callback, void* user_data);
-static int              InputTextCalcTextLenAndLineCount(const char* text_begin, const char** out_text_end);
-static ImVec2           InputTextCalcTextSizeW(const ImWchar* text_begin, const ImWchar* text_end, const ImWchar** remaining = NULL, ImVec2* out_offset = NULL, bool stop_on_new_line = false);
+static int              InputTextCalcTextLenAndLineCount(const char* text_begin, const char** out_text_end, int line_begin, int line_end, const char** out_lines_begin, const char** out_lines_end);
+static void             InputTextCalcVisibleLines(const ImDrawList* draw_list, float text_pos_y, int* out_line_begin, int* out_line_end);
+static ImVec2           InputTextCalcTextSizeW(ImTextRope* text, int text_begin, int text_end, int* remaining = NULL, ImVec2* out_offset = NULL, bool stop_on_new_line = false);
 
 //-------------------------------------------------------------------------
 // [SECTION] Widgets: Text, etc.
@@ -2818,21 +2819,35 @@ bool ImGui::InputTextMultiline(const char* label, char* buf, size_t buf_size, co
     return InputTextEx(label, buf, (int)buf_size, size, flags | ImGuiInputTextFlags_Multiline, callback, user_data);
 }
 
-static int InputTextCalcTextLenAndLineCount(const char* text_begin, const char** out_text_end)
+// Also finds where lines [line_begin, line_end) start and end, so only those need to be drawn
+static int InputTextCalcTextLenAndLineCount(const char* text_begin, const char** out_text_end, int line_begin, int line_end, const char** out_lines_begin, const char** out_lines_end)
 {
+    const char* text_end = text_begin + strlen(text_begin);
+    *out_lines_begin = (line_begin <= 0) ? text_begin : text_end;
+    *out_lines_end = text_end;
     int line_count = 0;
-    const char* s = text_begin;
-    while (char c = *s++) // We are only matching for \n so we can ignore UTF-8 decoding
-        if (c == '\n')
-            line_count++;
-    s--;
-    if (s[0] != '\n' && s[0] != '\r')
+    for (const char* s = text_begin; (s = (const char*)memchr(s, '\n', (size_t)(text_end - s))) != NULL; ) // We are only matching for \n so we can ignore UTF-8 decoding
+    {
         line_count++;
-    *out_text_end = s;
-    return line_count;
+        s++;
+        if (line_count == line_begin)
+            *out_lines_begin = s;
+        if (line_count == line_end)
+            *out_lines_end = s;
+    }
+    *out_text_end = text_end;
+    return line_count + 1;
+}
+
+// Lines of a multi-line text at 'text_pos_y' that can be within the clip rectangle, with a line of margin: RenderText() does the precise clipping
+static void InputTextCalcVisibleLines(const ImDrawList* draw_list, float text_pos_y, int* out_line_begin, int* out_line_end)
+{
+    const float line_height = GImGui->FontSize;
+    *out_line_begin = ImMax((int)ImFloor((draw_list->GetClipRectMin().y - text_pos_y) / line_height) - 1, 0);
+    *out_line_end = ImMax((int)ImFloor((draw_list->GetClipRectMax().y - text_pos_y) / line_height) + 2, *out_line_begin);
 }
 
-static ImVec2 InputTextCalcTextSizeW(const ImWchar* text_begin, const ImWchar* text_end, const ImWchar** remaining, ImVec2* out_offset, bool stop_on_new_line)
+static ImVec2 InputTextCalcTextSizeW(ImTextRope* text, int text_begin, int text_end, int* remaining, ImVec2* out_offset, bool stop_on_new_line)
 {
     ImFont* font = GImGui->Font;
     const float line_height = GImGui->FontSize;
@@ -2841,10 +2856,10 @@ static ImVec2 InputTextCalcTextSizeW(const ImWchar* text_begin, const ImWchar* t
     ImVec2 text_size = ImVec2(0,0);
     float line_width = 0.0f;
 
-    const ImWchar* s = text_begin;
+    int s = text_begin;
     while (s < text_end)
     {
-        unsigned int c = (unsigned int)(*s++);
+        unsigned int c = (unsigned int)text->GetChar(s++);
         if (c == '\n')
         {
             text_size.x = ImMax(text_size.x, line_width);
@@ -2880,79 +2895,72 @@ static ImVec2 InputTextCalcTextSizeW(const ImWchar* text_begin, const ImWchar* t
 namespace ImGuiStb
 {
 
-static int     STB_TEXTEDIT_STRINGLEN(const STB_TEXTEDIT_STRING* obj)                             { return obj->CurLenW; }
-static ImWchar STB_TEXTEDIT_GETCHAR(const STB_TEXTEDIT_STRING* obj, int idx)                      { return obj->TextW[idx]; }
-static float   STB_TEXTEDIT_GETWIDTH(STB_TEXTEDIT_STRING* obj, int line_start_idx, int char_idx)  { ImWchar c = obj->TextW[line_start_idx+char_idx]; if (c == '\n') return STB_TEXTEDIT_GETWIDTH_NEWLINE; return GImGui->Font->GetCharAdvance(c) * (GImGui->FontSize / GImGui->Font->FontSize); }
+static int     STB_TEXTEDIT_STRINGLEN(const STB_TEXTEDIT_STRING* obj)                             { return obj->Text.Len; }
+static ImWchar STB_TEXTEDIT_GETCHAR(STB_TEXTEDIT_STRING* obj, int idx)                            { return obj->Text.GetChar(idx); }
+static float   STB_TEXTEDIT_GETWIDTH(STB_TEXTEDIT_STRING* obj, int line_start_idx, int char_idx)  { ImWchar c = obj->Text.GetChar(line_start_idx+char_idx); if (c == '\n') return STB_TEXTEDIT_GETWIDTH_NEWLINE; return GImGui->Font->GetCharAdvance(c) * (GImGui->FontSize / GImGui->Font->FontSize); }
 static int     STB_TEXTEDIT_KEYTOTEXT(int key)                                                    { return key >= 0x10000 ? 0 : key; }
 static ImWchar STB_TEXTEDIT_NEWLINE = '\n';
 static void    STB_TEXTEDIT_LAYOUTROW(StbTexteditRow* r, STB_TEXTEDIT_STRING* obj, int line_start_idx)
 {
-    const ImWchar* text = obj->TextW.Data;
-    const ImWchar* text_remaining = NULL;
-    const ImVec2 size = InputTextCalcTextSizeW(text + line_start_idx, text + obj->CurLenW, &text_remaining, NULL, true);
+    int text_remaining = 0;
+    const ImVec2 size = InputTextCalcTextSizeW(&obj->Text, line_start_idx, obj->Text.Len, &text_remaining, NULL, true);
     r->x0 = 0.0f;
     r->x1 = size.x;
     r->baseline_y_delta = size.y;
     r->ymin = 0.0f;
     r->ymax = size.y;
-    r->num_chars = (int)(text_remaining - (text + line_start_idx));
+    r->num_chars = text_remaining - line_start_idx;
+}
+
+// We don't wrap, so rows are lines and all FontSize high: the line index of the text gets us to a row without laying out the ones above it
+static int STB_TEXTEDIT_ROWSTART_AT_Y_IMPL(STB_TEXTEDIT_STRING* obj, float y, float* out_row_y)
+{
+    const float line_height = GImGui->FontSize;
+    *out_row_y = 0.0f;
+    if (y < 0.0f)
+        return 0;
+    if (y >= obj->Text.GetLineCount() * line_height)
+        return obj->Text.Len;
+    const int line = (int)(y / line_height);
+    *out_row_y = line * line_height;
+    return obj->Text.GetLineStart(line);
+}
+static int STB_TEXTEDIT_ROWSTART_AT_CHAR_IMPL(STB_TEXTEDIT_STRING* obj, int idx, float* out_row_y)
+{
+    const int line = obj->Text.GetLineFromPos(idx);
+    *out_row_y = line * GImGui->FontSize;
+    return obj->Text.GetLineStart(line);
 }
+#define STB_TEXTEDIT_ROWSTART_AT_Y      STB_TEXTEDIT_ROWSTART_AT_Y_IMPL
+#define STB_TEXTEDIT_ROWSTART_AT_CHAR   STB_TEXTEDIT_ROWSTART_AT_CHAR_IMPL
 
 static bool is_separator(unsigned int c)                                        { return ImCharIsBlankW(c) || c==',' || c==';' || c=='(' || c==')' || c=='{' || c=='}' || c=='[' || c==']' || c=='|'; }
-static int  is_word_boundary_from_right(STB_TEXTEDIT_STRING* obj, int idx)      { return idx > 0 ? (is_separator( obj->TextW[idx-1] ) && !is_separator( obj->TextW[idx] ) ) : 1; }
+static int  is_word_boundary_from_right(STB_TEXTEDIT_STRING* obj, int idx)      { return idx > 0 ? (is_separator( obj->Text.GetChar(idx-1) ) && !is_separator( obj->Text.GetChar(idx) ) ) : 1; }
 static int  STB_TEXTEDIT_MOVEWORDLEFT_IMPL(STB_TEXTEDIT_STRING* obj, int idx)   { idx--; while (idx >= 0 && !is_word_boundary_from_right(obj, idx)) idx--; return idx < 0 ? 0 : idx; }
 #ifdef __APPLE__    // FIXME: Move setting to IO structure
-static int  is_word_boundary_from_left(STB_TEXTEDIT_STRING* obj, int idx)       { return idx > 0 ? (!is_separator( obj->TextW[idx-1] ) && is_separator( obj->TextW[idx] ) ) : 1; }
-static int  STB_TEXTEDIT_MOVEWORDRIGHT_IMPL(STB_TEXTEDIT_STRING* obj, int idx)  { idx++; int len = obj->CurLenW; while (idx < len && !is_word_boundary_from_left(obj, idx)) idx++; return idx > len ? len : idx; }
+static int  is_word_boundary_from_left(STB_TEXTEDIT_STRING* obj, int idx)       { return idx > 0 ? (!is_separator( obj->Text.GetChar(idx-1) ) && is_separator( obj->Text.GetChar(idx) ) ) : 1; }
+static int  STB_TEXTEDIT_MOVEWORDRIGHT_IMPL(STB_TEXTEDIT_STRING* obj, int idx)  { idx++; int len = obj->Text.Len; while (idx < len && !is_word_boundary_from_left(obj, idx)) idx++; return idx > len ? len : idx; }
 #else
-static int  STB_TEXTEDIT_MOVEWORDRIGHT_IMPL(STB_TEXTEDIT_STRING* obj, int idx)  { idx++; int len = obj->CurLenW; while (idx < len && !is_word_boundary_from_right(obj, idx)) idx++; return idx > len ? len : idx; }
+static int  STB_TEXTEDIT_MOVEWORDRIGHT_IMPL(STB_TEXTEDIT_STRING* obj, int idx)  { idx++; int len = obj->Text.Len; while (idx < len && !is_word_boundary_from_right(obj, idx)) idx++; return idx > len ? len : idx; }
 #endif
 #define STB_TEXTEDIT_MOVEWORDLEFT   STB_TEXTEDIT_MOVEWORDLEFT_IMPL    // They need to be #define for stb_textedit.h
 #define STB_TEXTEDIT_MOVEWORDRIGHT  STB_TEXTEDIT_MOVEWORDRIGHT_IMPL
 
 static void STB_TEXTEDIT_DELETECHARS(STB_TEXTEDIT_STRING* obj, int pos, int n)
 {
-    ImWchar* dst = obj->TextW.Data + pos;
-
-    // We maintain our buffer length in both UTF-8 and wchar formats
-    obj->CurLenA -= ImTextCountUtf8BytesFromStr(dst, dst + n);
-    obj->CurLenW -= n;
-
-    // Offset remaining text (FIXME-OPT: Use memmove)
-    const ImWchar* src = obj->TextW.Data + pos + n;
-    while (ImWchar c = *src++)
-        *dst++ = c;
-    *dst = '\0';
+    obj->Text.Delete(pos, n);
 }
 
 static bool STB_TEXTEDIT_INSERTCHARS(STB_TEXTEDIT_STRING* obj, int pos, const ImWchar* new_text, int new_text_len)
 {
     const bool is_resizable = (obj->UserFlags & ImGuiInputTextFlags_CallbackResize) != 0;
-    const int text_len = obj->CurLenW;
-    IM_ASSERT(pos <= text_len);
+    IM_ASSERT(pos <= obj->Text.Len);
 
     const int new_text_len_utf8 = ImTextCountUtf8BytesFromStr(new_text, new_text + new_text_len);
-    if (!is_resizable && (new_text_len_utf8 + obj->CurLenA + 1 > obj->BufCapacityA))
+    if (!is_resizable && (new_text_len_utf8 + obj->Text.LenUtf8 + 1 > obj->BufCapacityA))
         return false;
 
-    // Grow internal buffer if needed
-    if (new_text_len + text_len + 1 > obj->TextW.Size)
-    {
-        if (!is_resizable)
-            return false;
-        IM_ASSERT(text_len < obj->TextW.Size);
-        obj->TextW.resize(text_len + ImClamp(new_text_len * 4, 32, ImMax(256, new_text_len)) + 1);
-    }
-
-    ImWchar* text = obj->TextW.Data;
-    if (pos != text_len)
-        memmove(text + pos + new_text_len, text + pos, (size_t)(text_len - pos) * sizeof(ImWchar));
-    memcpy(text + pos, new_text, (size_t)new_text_len * sizeof(ImWchar));
-
-    obj->CurLenW += new_text_len;
-    obj->CurLenA += new_text_len_utf8;
-    obj->TextW[obj->CurLenW] = '\0';
-
+    obj->Text.Insert(pos, new_text, new_text_len);
     return true;
 }
 
@@ -2985,6 +2993,40 @@ void ImGuiInputTextState::OnKeyPressed(int key)
     CursorAnimReset();
 }
 
+void ImGuiInputTextState::SetTextFromUtf8(const char* text, const char* text_end)
+{
+    Text.SetFromUtf8(text, text_end);   // Before touching TempBuffer, 'text' may point into it
+    CurLenA = Text.LenUtf8;
+    if (TempBuffer.Size < CurLenA + 1)
+        TempBuffer.resize(CurLenA + 1);
+    Text.CopyUtf8(TempBuffer.Data, 0, Text.Len);
+    TempBuffer[CurLenA] = 0;
+}
+
+// Everything before Text.EditBegin and after Text.EditEnd is as it was, so only the text in between is encoded again and the rest moved
+void ImGuiInputTextState::SyncTempBuffer(int* out_begin, int* out_old_end, int* out_new_end)
+{
+    if (!Text.HasEdits())
+    {
+        *out_begin = 0;
+        *out_old_end = *out_new_end = -1;
+        return;
+    }
+    const int begin = Text.GetUtf8Offset(Text.EditBegin);
+    const int new_end = Text.GetUtf8Offset(Text.EditEnd);
+    const int old_end = CurLenA - (Text.LenUtf8 - new_end);
+    IM_ASSERT(begin <= old_end && old_end <= CurLenA);
+    if (TempBuffer.Size < Text.LenUtf8 + 1)
+        TempBuffer.resize(Text.LenUtf8 + 1);
+    memmove(TempBuffer.Data + new_end, TempBuffer.Data + old_end, (size_t)(CurLenA - old_end + 1));
+    Text.CopyUtf8(TempBuffer.Data + begin, Text.EditBegin, Text.EditEnd);
+    CurLenA = Text.LenUtf8;
+    Text.ClearEdits();
+    *out_begin = begin;
+    *out_old_end = old_end;
+    *out_new_end = new_end;
+}
+
 ImGuiInputTextCallbackData::ImGuiInputTextCallbackData()
 {
     memset(this, 0, sizeof(*this));
@@ -3107,6 +3149,8 @@ static bool InputTextFilterCharacter(unsigned int* p_char, ImGuiInputTextFlags f
 //   Note that in std::string world, capacity() would omit 1 byte used by the zero-terminator.
 // - When active, hold on a privately held copy of the text (and apply back to 'buf'). So changing 'buf' while the InputText is active has no effect.
 // - If you want to use ImGui::InputText() with std::string, see misc/cpp/imgui_stdlib.h
+// - The edited text is kept as wchar in a rope with a line index (ImTextRope), with a UTF-8 copy updated a changed range at a time. So moving around,
+//   typing and drawing only cost the lines involved, though an inactive multi-line still scans 'buf' once per frame for its line count.
 // (FIXME: Rather messy function partly because we are doing UTF8 > u16 > UTF8 conversions on the go to more easily handle stb_textedit calls. Ideally we should stay in UTF-8 all the time. See https://github.com/nothings/stb/issues/188)
 bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2& size_arg, ImGuiInputTextFlags flags, ImGuiInputTextCallback callback, void* callback_user_data)
 {
@@ -3172,9 +3216,12 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
         password_font->Ascent = g.Font->Ascent;
         password_font->Descent = g.Font->Descent;
         password_font->ContainerAtlas = g.Font->ContainerAtlas;
-        password_font->FallbackGlyph = glyph;
+        password_font->ConfigData = g.Font->ConfigData;    // Drawn the same way (distance field or not) as the font it stands in for
+        password_font->Glyphs.resize(0);
+        password_font->Glyphs.push_back(*glyph);    // A copy, glyphs rasterized on demand while the font is pushed can move the original
+        password_font->FallbackGlyph = &password_font->Glyphs[0];
         password_font->FallbackAdvanceX = glyph->AdvanceX;
-        IM_ASSERT(password_font->Glyphs.empty() && password_font->IndexAdvanceX.empty() && password_font->IndexLookup.empty());
+        IM_ASSERT(password_font->IndexAdvanceX.empty() && password_font->IndexLookup.empty());
         PushFont(password_font);
     }
 
@@ -3199,19 +3246,16 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
             // Start edition
             // Take a copy of the initial buffer value (both in original UTF-8 format and converted to wchar)
             // From the moment we focused we are ignoring the content of 'buf' (unless we are in read-only mode)
-            const int prev_len_w = edit_state.CurLenW;
+            const int prev_len_w = edit_state.Text.Len;
             const int init_buf_len = (int)strlen(buf);
-            edit_state.TextW.resize(buf_size+1);             // wchar count <= UTF-8 count. we use +1 to make sure that .Data isn't NULL so it doesn't crash.
             edit_state.InitialText.resize(init_buf_len + 1); // UTF-8. we use +1 to make sure that .Data isn't NULL so it doesn't crash.
             memcpy(edit_state.InitialText.Data, buf, init_buf_len + 1);
-            const char* buf_end = NULL;
-            edit_state.CurLenW = ImTextStrFromUtf8(edit_state.TextW.Data, buf_size, buf, NULL, &buf_end);
-            edit_state.CurLenA = (int)(buf_end - buf); // We can't get the result from ImStrncpy() above because it is not UTF-8 aware. Here we'll cut off malformed UTF-8.
+            edit_state.SetTextFromUtf8(buf, buf + init_buf_len); // Malformed UTF-8 comes out as U+FFFD in TempBuffer
             edit_state.CursorAnimReset();
 
             // Preserve cursor position and undo/redo stack if we come back to same widget
             // FIXME: We should probably compare the whole buffer to be on the safety side. Comparing buf (utf8) and edit_state.Text (wchar).
-            const bool recycle_state = (edit_state.ID == id) && (prev_len_w == edit_state.CurLenW);
+            const bool recycle_state = (edit_state.ID == id) && (prev_len_w == edit_state.Text.Len);
             if (recycle_state)
             {
                 // Recycle existing cursor/selection/undo stack but clamp position
@@ -3252,11 +3296,12 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
         if (!is_editable && !g.ActiveIdIsJustActivated)
         {
             // When read-only we always use the live data passed to the function
-            edit_state.TextW.resize(buf_size+1);
-            const char* buf_end = NULL;
-            edit_state.CurLenW = ImTextStrFromUtf8(edit_state.TextW.Data, edit_state.TextW.Size, buf, NULL, &buf_end);
-            edit_state.CurLenA = (int)(buf_end - buf);
-            edit_state.CursorClamp();
+            const int buf_len = (int)strlen(buf);
+            if (buf_len != edit_state.CurLenA || memcmp(buf, edit_state.TempBuffer.Data, (size_t)buf_len) != 0)
+            {
+                edit_state.SetTextFromUtf8(buf, buf + buf_len);
+                edit_state.CursorClamp();
+            }
         }
 
         backup_current_text_length = edit_state.CurLenA;
@@ -3397,10 +3442,11 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
             if (io.SetClipboardTextFn)
             {
                 const int ib = edit_state.HasSelection() ? ImMin(edit_state.StbState.select_start, edit_state.StbState.select_end) : 0;
-                const int ie = edit_state.HasSelection() ? ImMax(edit_state.StbState.select_start, edit_state.StbState.select_end) : edit_state.CurLenW;
-                edit_state.TempBuffer.resize((ie-ib) * 4 + 1);
-                ImTextStrToUtf8(edit_state.TempBuffer.Data, edit_state.TempBuffer.Size, edit_state.TextW.Data+ib, edit_state.TextW.Data+ie);
-                SetClipboardText(edit_state.TempBuffer.Data);
+                const int ie = edit_state.HasSelection() ? ImMax(edit_state.StbState.select_start, edit_state.StbState.select_end) : edit_state.Text.Len;
+                ImVector<char> clipboard_text;
+                clipboard_text.resize(edit_state.Text.GetUtf8Offset(ie) - edit_state.Text.GetUtf8Offset(ib) + 1);
+                clipboard_text[edit_state.Text.CopyUtf8(clipboard_text.Data, ib, ie)] = 0;
+                SetClipboardText(clipboard_text.Data);
             }
             if (is_cut)
             {
@@ -3443,6 +3489,7 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
     {
         const char* apply_new_text = NULL;
         int apply_new_text_length = 0;
+        int apply_edit_begin = 0, apply_edit_old_end = -1, apply_edit_new_end = -1;   // Byte range of TempBuffer that changed this frame
         if (cancel_edit)
         {
             // Restore initial value. Only return true if restoring to the initial value changes the current buffer contents.
@@ -3461,12 +3508,8 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
             // Apply new value immediately - copy modified buffer back
             // Note that as soon as the input box is active, the in-widget value gets priority over any underlying modification of the input buffer
             // FIXME: We actually always render 'buf' when calling DrawList->AddText, making the comment above incorrect.
-            // FIXME-OPT: CPU waste to do this every time the widget is active, should mark dirty state from the stb_textedit callbacks.
-            if (is_editable)
-            {
-                edit_state.TempBuffer.resize(edit_state.TextW.Size * 4 + 1);
-                ImTextStrToUtf8(edit_state.TempBuffer.Data, edit_state.TempBuffer.Size, edit_state.TextW.Data, NULL);
-            }
+            edit_state.SyncTempBuffer(&apply_edit_begin, &apply_edit_old_end, &apply_edit_new_end);
+            bool apply_whole_text = !is_multiline;
 
             // User callback
             if ((flags & (ImGuiInputTextFlags_CallbackCompletion | ImGuiInputTextFlags_CallbackHistory | ImGuiInputTextFlags_CallbackAlways)) != 0)
@@ -3496,6 +3539,10 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
 
                 if (event_flag)
                 {
+                    // The callback may write up to BufSize bytes in place
+                    if (edit_state.TempBuffer.Size < edit_state.BufCapacityA + 1)
+                        edit_state.TempBuffer.resize(edit_state.BufCapacityA + 1);
+
                     ImGuiInputTextCallbackData callback_data;
                     memset(&callback_data, 0, sizeof(ImGuiInputTextCallbackData));
                     callback_data.EventFlag = event_flag;
@@ -3508,11 +3555,10 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
                     callback_data.BufSize = edit_state.BufCapacityA;
                     callback_data.BufDirty = false;
 
-                    // We have to convert from wchar-positions to UTF-8-positions, which can be pretty slow (an incentive to ditch the ImWchar buffer, see https://github.com/nothings/stb/issues/188)
-                    ImWchar* text = edit_state.TextW.Data;
-                    const int utf8_cursor_pos = callback_data.CursorPos = ImTextCountUtf8BytesFromStr(text, text + edit_state.StbState.cursor);
-                    const int utf8_selection_start = callback_data.SelectionStart = ImTextCountUtf8BytesFromStr(text, text + edit_state.StbState.select_start);
-                    const int utf8_selection_end = callback_data.SelectionEnd = ImTextCountUtf8BytesFromStr(text, text + edit_state.StbState.select_end);
+                    // We have to convert from wchar-positions to UTF-8-positions, the text keeps the UTF-8 size of its chunks so that's quick
+                    const int utf8_cursor_pos = callback_data.CursorPos = edit_state.Text.GetUtf8Offset(edit_state.StbState.cursor);
+                    const int utf8_selection_start = callback_data.SelectionStart = edit_state.Text.GetUtf8Offset(edit_state.StbState.select_start);
+                    const int utf8_selection_end = callback_data.SelectionEnd = edit_state.Text.GetUtf8Offset(edit_state.StbState.select_end);
 
                     // Call user code
                     callback(&callback_data);
@@ -3521,33 +3567,45 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
                     IM_ASSERT(callback_data.Buf == edit_state.TempBuffer.Data);  // Invalid to modify those fields
                     IM_ASSERT(callback_data.BufSize == edit_state.BufCapacityA);
                     IM_ASSERT(callback_data.Flags == flags);
-                    if (callback_data.CursorPos != utf8_cursor_pos)            { edit_state.StbState.cursor = ImTextCountCharsFromUtf8(callback_data.Buf, callback_data.Buf + callback_data.CursorPos); edit_state.CursorFollow = true; }
-                    if (callback_data.SelectionStart != utf8_selection_start)  { edit_state.StbState.select_start = ImTextCountCharsFromUtf8(callback_data.Buf, callback_data.Buf + callback_data.SelectionStart); }
-                    if (callback_data.SelectionEnd != utf8_selection_end)      { edit_state.StbState.select_end = ImTextCountCharsFromUtf8(callback_data.Buf, callback_data.Buf + callback_data.SelectionEnd); }
                     if (callback_data.BufDirty)
                     {
                         IM_ASSERT(callback_data.BufTextLen == (int)strlen(callback_data.Buf)); // You need to maintain BufTextLen if you change the text!
-                        if (callback_data.BufTextLen > backup_current_text_length && is_resizable)
-                            edit_state.TextW.resize(edit_state.TextW.Size + (callback_data.BufTextLen - backup_current_text_length));
-                        edit_state.CurLenW = ImTextStrFromUtf8(edit_state.TextW.Data, edit_state.TextW.Size, callback_data.Buf, NULL);
-                        edit_state.CurLenA = callback_data.BufTextLen;  // Assume correct length and valid UTF-8 from user, saves us an extra strlen()
+                        edit_state.TempBuffer.resize(ImMax(edit_state.TempBuffer.Size, callback_data.BufTextLen + 1)); // InsertChars() may only have reserved
+                        edit_state.SetTextFromUtf8(callback_data.Buf, callback_data.Buf + callback_data.BufTextLen);
                         edit_state.CursorAnimReset();
+                        apply_whole_text = true;
                     }
+                    if (callback_data.CursorPos != utf8_cursor_pos)            { edit_state.StbState.cursor = edit_state.Text.GetPosFromUtf8Offset(callback_data.CursorPos); edit_state.CursorFollow = true; }
+                    if (callback_data.SelectionStart != utf8_selection_start)  { edit_state.StbState.select_start = edit_state.Text.GetPosFromUtf8Offset(callback_data.SelectionStart); }
+                    if (callback_data.SelectionEnd != utf8_selection_end)      { edit_state.StbState.select_end = edit_state.Text.GetPosFromUtf8Offset(callback_data.SelectionEnd); }
                 }
             }
 
-            // Will copy result string if modified
-            if (is_editable && strcmp(edit_state.TempBuffer.Data, buf) != 0)
+            // Will copy result string if modified.
+            // Multi-line: 'buf' only gets the bytes that changed this frame, so editing a large text doesn't copy all of it every frame.
+            // That needs 'buf' to still hold what we gave it last frame, as documented above ImGuiInputTextFlags_ in imgui.h. We check
+            // its length and copy the whole text otherwise; checking its bytes would cost what the partial copy saves.
+            const bool edited = apply_edit_begin <= apply_edit_old_end;
+            if (is_editable && !apply_whole_text && edited && (backup_current_text_length >= buf_size || buf[backup_current_text_length] != 0))
+                apply_whole_text = true;
+            if (is_editable && (apply_whole_text ? strcmp(edit_state.TempBuffer.Data, buf) != 0 : edited))
             {
                 apply_new_text = edit_state.TempBuffer.Data;
                 apply_new_text_length = edit_state.CurLenA;
+                if (!apply_whole_text && backup_current_text_length == apply_new_text_length && memcmp(buf + apply_edit_begin, apply_new_text + apply_edit_begin, (size_t)(apply_edit_new_end - apply_edit_begin)) == 0)
+                    apply_new_text = NULL; // e.g. typed then erased a character
             }
+            if (apply_whole_text)
+                apply_edit_old_end = -1;
         }
 
         // Copy result to user buffer
         if (apply_new_text)
         {
             IM_ASSERT(apply_new_text_length >= 0);
+            const bool apply_edit_only = (apply_new_text == edit_state.TempBuffer.Data && apply_edit_begin <= apply_edit_old_end);
+            if (apply_edit_only && apply_new_text_length < backup_current_text_length)
+                memmove(buf + apply_edit_new_end, buf + apply_edit_old_end, (size_t)(backup_current_text_length - apply_edit_old_end + 1)); // Before the buffer is shrunk
             if (backup_current_text_length != apply_new_text_length && is_resizable)
             {
                 ImGuiInputTextCallbackData callback_data;
@@ -3565,7 +3623,16 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
             }
 
             // If the underlying buffer resize was denied or not carried to the next frame, apply_new_text_length+1 may be >= buf_size.
-            ImStrncpy(buf, edit_state.TempBuffer.Data, ImMin(apply_new_text_length + 1, buf_size));
+            if (apply_edit_only && apply_new_text_length == edit_state.CurLenA)
+            {
+                if (apply_new_text_length > backup_current_text_length)
+                    memmove(buf + apply_edit_new_end, buf + apply_edit_old_end, (size_t)(backup_current_text_length - apply_edit_old_end + 1));
+                memcpy(buf + apply_edit_begin, apply_new_text + apply_edit_begin, (size_t)(apply_edit_new_end - apply_edit_begin));
+            }
+            else
+            {
+                ImStrncpy(buf, apply_new_text, ImMin(apply_new_text_length + 1, buf_size));
+            }
             value_changed = true;
         }
 
@@ -3581,7 +3648,9 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
 
     // Render
     // Select which buffer we are going to display. When ImGuiInputTextFlags_NoLiveEdit is set 'buf' might still be the old value. We set buf to NULL to prevent accidental usage from now on.
-    const char* buf_display = (g.ActiveId == id && is_editable) ? edit_state.TempBuffer.Data : buf; buf = NULL;
+    // While active (or scrolled right after) we display TempBuffer, which matches the positions in edit_state.Text, read-only included.
+    const bool is_currently_scrolling = (edit_state.ID == id && is_multiline && g.ActiveId == draw_window->GetIDNoKeepAlive("#SCROLLY"));
+    const char* buf_display = (g.ActiveId == id || is_currently_scrolling) ? edit_state.TempBuffer.Data : buf; buf = NULL;
 
     // Set upper limit of single-line InputTextEx() at 2 million characters strings. The current pathological worst case is a long line
     // without any carriage return, which would makes ImFont::RenderText() reserve too many vertices and probably crash. Avoid it altogether.
@@ -3597,62 +3666,34 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
     const ImVec4 clip_rect(frame_bb.Min.x, frame_bb.Min.y, frame_bb.Min.x + size.x, frame_bb.Min.y + size.y); // Not using frame_bb.Max because we have adjusted size
     ImVec2 render_pos = is_multiline ? draw_window->DC.CursorPos : frame_bb.Min + style.FramePadding;
     ImVec2 text_size(0.f, 0.f);
-    const bool is_currently_scrolling = (edit_state.ID == id && is_multiline && g.ActiveId == draw_window->GetIDNoKeepAlive("#SCROLLY"));
     if (g.ActiveId == id || is_currently_scrolling)
     {
         edit_state.CursorAnim += io.DeltaTime;
 
-        // This is going to be messy. We need to:
+        // We need to:
         // - Display the text (this alone can be more easily clipped)
         // - Handle scrolling, highlight selection, display cursor (those all requires some form of 1d->2d cursor position calculation)
         // - Measure text height (for scrollbar)
-        // We are attempting to do most of that in **one main pass** to minimize the computation cost (non-negligible for large amount of text) + 2nd pass for selection rendering (we could merge them by an extra refactoring effort)
-        // FIXME: This should occur on buf_display but we'd need to maintain cursor/select_start/select_end for UTF-8.
-        const ImWchar* text_begin = edit_state.TextW.Data;
+        // The line index of edit_state.Text answers the 1d->2d questions without going through the text, so we only look at the lines we draw.
+        ImTextRope& text = edit_state.Text;
         ImVec2 cursor_offset, select_start_offset;
 
         {
-            // Count lines + find lines numbers straddling 'cursor' and 'select_start' position.
-            const ImWchar* searches_input_ptr[2];
-            searches_input_ptr[0] = text_begin + edit_state.StbState.cursor;
-            searches_input_ptr[1] = NULL;
-            int searches_remaining = 1;
-            int searches_result_line_number[2] = { -1, -999 };
+            // Find lines numbers straddling 'cursor' and 'select_start' position, and measure the distance from the beginning of their line
+            const int cursor_line = text.GetLineFromPos(edit_state.StbState.cursor);
+            cursor_offset.x = InputTextCalcTextSizeW(&text, text.GetLineStart(cursor_line), edit_state.StbState.cursor).x;
+            cursor_offset.y = (cursor_line + 1) * g.FontSize;
             if (edit_state.StbState.select_start != edit_state.StbState.select_end)
             {
-                searches_input_ptr[1] = text_begin + ImMin(edit_state.StbState.select_start, edit_state.StbState.select_end);
-                searches_result_line_number[1] = -1;
-                searches_remaining++;
-            }
-
-            // Iterate all lines to find our line numbers
-            // In multi-line mode, we never exit the loop until all lines are counted, so add one extra to the searches_remaining counter.
-            searches_remaining += is_multiline ? 1 : 0;
-            int line_count = 0;
-            //for (const ImWchar* s = text_begin; (s = (const ImWchar*)wcschr((const wchar_t*)s, (wchar_t)'\n')) != NULL; s++)  // FIXME-OPT: Could use this when wchar_t are 16-bits
-            for (const ImWchar* s = text_begin; *s != 0; s++)
-                if (*s == '\n')
-                {
-                    line_count++;
-                    if (searches_result_line_number[0] == -1 && s >= searches_input_ptr[0]) { searches_result_line_number[0] = line_count; if (--searches_remaining <= 0) break; }
-                    if (searches_result_line_number[1] == -1 && s >= searches_input_ptr[1]) { searches_result_line_number[1] = line_count; if (--searches_remaining <= 0) break; }
-                }
-            line_count++;
-            if (searches_result_line_number[0] == -1) searches_result_line_number[0] = line_count;
-            if (searches_result_line_number[1] == -1) searches_result_line_number[1] = line_count;
-
-            // Calculate 2d position by finding the beginning of the line and measuring distance
-            cursor_offset.x = InputTextCalcTextSizeW(ImStrbolW(searches_input_ptr[0], text_begin), searches_input_ptr[0]).x;
-            cursor_offset.y = searches_result_line_number[0] * g.FontSize;
-            if (searches_result_line_number[1] >= 0)
-            {
-                select_start_offset.x = InputTextCalcTextSizeW(ImStrbolW(searches_input_ptr[1], text_begin), searches_input_ptr[1]).x;
-                select_start_offset.y = searches_result_line_number[1] * g.FontSize;
+                const int select_start = ImMin(edit_state.StbState.select_start, edit_state.StbState.select_end);
+                const int select_start_line = text.GetLineFromPos(select_start);
+                select_start_offset.x = InputTextCalcTextSizeW(&text, text.GetLineStart(select_start_line), select_start).x;
+                select_start_offset.y = (select_start_line + 1) * g.FontSize;
             }
 
             // Store text height (note that we haven't calculated text width at all, see GitHub issues #383, #1224)
             if (is_multiline)
-                text_size = ImVec2(size.x, line_count * g.FontSize);
+                text_size = ImVec2(size.x, text.GetLineCount() * g.FontSize);
         }
 
         // Scroll
@@ -3691,28 +3732,33 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
         // Draw selection
         if (edit_state.StbState.select_start != edit_state.StbState.select_end)
         {
-            const ImWchar* text_selected_begin = text_begin + ImMin(edit_state.StbState.select_start, edit_state.StbState.select_end);
-            const ImWchar* text_selected_end = text_begin + ImMax(edit_state.StbState.select_start, edit_state.StbState.select_end);
+            const int text_selected_begin = ImMin(edit_state.StbState.select_start, edit_state.StbState.select_end);
+            const int text_selected_end = ImMax(edit_state.StbState.select_start, edit_state.StbState.select_end);
 
             float bg_offy_up = is_multiline ? 0.0f : -1.0f;    // FIXME: those offsets should be part of the style? they don't play so well with multi-line selection.
             float bg_offy_dn = is_multiline ? 0.0f : 2.0f;
             ImU32 bg_color = GetColorU32(ImGuiCol_TextSelectedBg);
             ImVec2 rect_pos = render_pos + select_start_offset - render_scroll;
-            for (const ImWchar* p = text_selected_begin; p < text_selected_end; )
+            int line = text.GetLineFromPos(text_selected_begin);
+            const int line_first = line;
+            const int line_last = text.GetLineFromPos(text_selected_end - 1);
+
+            // Go straight to the first line that can be visible
+            const int line_first_visible = (int)((clip_rect.y - render_pos.y) / g.FontSize) - 1;
+            if (line_first_visible > line)
+            {
+                rect_pos.x = render_pos.x - render_scroll.x;
+                rect_pos.y += (line_first_visible - line) * g.FontSize;
+                line = line_first_visible;
+            }
+            for (; line <= line_last; line++)
             {
                 if (rect_pos.y > clip_rect.w + g.FontSize)
                     break;
-                if (rect_pos.y < clip_rect.y)
-                {
-                    //p = (const ImWchar*)wmemchr((const wchar_t*)p, '\n', text_selected_end - p);  // FIXME-OPT: Could use this when wchar_t are 16-bits
-                    //p = p ? p + 1 : text_selected_end;
-                    while (p < text_selected_end)
-                        if (*p++ == '\n')
-                            break;
-                }
-                else
+                if (rect_pos.y >= clip_rect.y)
                 {
-                    ImVec2 rect_size = InputTextCalcTextSizeW(p, text_selected_end, &p, NULL, true);
+                    const int p = (line == line_first) ? text_selected_begin : text.GetLineStart(line);
+                    ImVec2 rect_size = InputTextCalcTextSizeW(&text, p, text_selected_end, NULL, NULL, true);
                     if (rect_size.x <= 0.0f) rect_size.x = (float)(int)(g.Font->GetCharAdvance((ImWchar)' ') * 0.50f); // So we can see selected empty lines
                     ImRect rect(rect_pos + ImVec2(0.0f, bg_offy_up - g.FontSize), rect_pos +ImVec2(rect_size.x, bg_offy_dn));
                     rect.ClipWith(clip_rect);
@@ -3725,8 +3771,18 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
         }
 
         const int buf_display_len = edit_state.CurLenA;
-        if (is_multiline || buf_display_len < buf_display_max_length)
-            draw_window->DrawList->AddText(g.Font, g.FontSize, render_pos - render_scroll, GetColorU32(ImGuiCol_Text), buf_display, buf_display + buf_display_len, 0.0f, is_multiline ? NULL : &clip_rect);
+        if (is_multiline)
+        {
+            int line_begin, line_end;
+            InputTextCalcVisibleLines(draw_window->DrawList, render_pos.y, &line_begin, &line_end);
+            const char* lines_begin = buf_display + text.GetUtf8Offset(text.GetLineStart(line_begin));
+            const char* lines_end = buf_display + text.GetUtf8Offset(text.GetLineStart(line_end));
+            draw_window->DrawList->AddText(g.Font, g.FontSize, ImVec2(render_pos.x - render_scroll.x, render_pos.y + line_begin * g.FontSize), GetColorU32(ImGuiCol_Text), lines_begin, lines_end, 0.0f, NULL);
+        }
+        else if (buf_display_len < buf_display_max_length)
+        {
+            draw_window->DrawList->AddText(g.Font, g.FontSize, render_pos - render_scroll, GetColorU32(ImGuiCol_Text), buf_display, buf_display + buf_display_len, 0.0f, &clip_rect);
+        }
 
         // Draw blinking cursor
         bool cursor_is_visible = (!g.IO.ConfigInputTextCursorBlink) || (g.InputTextState.CursorAnim <= 0.0f) || ImFmod(g.InputTextState.CursorAnim, 1.20f) <= 0.80f;
@@ -3744,11 +3800,20 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
         // Render text only
         const char* buf_end = NULL;
         if (is_multiline)
-            text_size = ImVec2(size.x, InputTextCalcTextLenAndLineCount(buf_display, &buf_end) * g.FontSize); // We don't need width
+        {
+            int line_begin, line_end;
+            const char* lines_begin = NULL;
+            const char* lines_end = NULL;
+            InputTextCalcVisibleLines(draw_window->DrawList, render_pos.y, &line_begin, &line_end);
+            text_size = ImVec2(size.x, InputTextCalcTextLenAndLineCount(buf_display, &buf_end, line_begin, line_end, &lines_begin, &lines_end) * g.FontSize); // We don't need width
+            draw_window->DrawList->AddText(g.Font, g.FontSize, ImVec2(render_pos.x, render_pos.y + line_begin * g.FontSize), GetColorU32(ImGuiCol_Text), lines_begin, lines_end, 0.0f, NULL);
+        }
         else
+        {
             buf_end = buf_display + strlen(buf_display);
-        if (is_multiline || (buf_end - buf_display) < buf_display_max_length)
-            draw_window->DrawList->AddText(g.Font, g.FontSize, render_pos, GetColorU32(ImGuiCol_Text), buf_display, buf_end, 0.0f, is_multiline ? NULL : &clip_rect);
+            if ((buf_end - buf_display) < buf_display_max_length)
+                draw_window->DrawList->AddText(g.Font, g.FontSize, render_pos, GetColorU32(ImGuiCol_Text), buf_display, buf_end, 0.0f, &clip_rect);
+        }
     }
 
     if (is_multiline)
@@ -5199,9 +5264,41 @@ bool ImGui::ListBox(const char* label, int* current_item, bool (*items_getter)(v
 // - PlotEx() [Internal]
 // - PlotLines()
 // - PlotHistogram()
+// - ImGuiPlotHistory
 //-------------------------------------------------------------------------
 
-void ImGui::PlotEx(ImGuiPlotType plot_type, const char* label, float (*values_getter)(void* data, int idx), void* data, int values_count, int values_offset, const char* overlay_text, float scale_min, float scale_max, ImVec2 graph_size)
+// Min/max of the values idx_begin..idx_end-1 in plot order, i.e. counted from values_offset and wrapping around.
+static void PlotGetRangeMinMax(float (*values_getter)(void* data, int idx), void (*values_range_getter)(void* data, int idx_begin, int idx_end, float* in_out_min, float* in_out_max), void* data, int values_count, int values_offset, int idx_begin, int idx_end, float* out_min, float* out_max)
+{
+    float v_min = FLT_MAX;
+    float v_max = -FLT_MAX;
+    idx_begin += values_offset;
+    idx_end += values_offset;
+    while (idx_begin < idx_end)
+    {
+        // At most two runs of indices, either side of the wrap
+        const int run_begin = idx_begin % values_count;
+        const int run_end = ImMin(run_begin + (idx_end - idx_begin), values_count);
+        if (values_range_getter)
+        {
+            values_range_getter(data, run_begin, run_end, &v_min, &v_max);
+        }
+        else
+        {
+            for (int idx = run_begin; idx < run_end; idx++)
+            {
+                const float v = values_getter(data, idx);
+                v_min = ImMin(v_min, v);
+                v_max = ImMax(v_max, v);
+            }
+        }
+        idx_begin += run_end - run_begin;
+    }
+    *out_min = v_min;
+    *out_max = v_max;
+}
+
+void ImGui::PlotEx(ImGuiPlotType plot_type, const char* label, float (*values_getter)(void* data, int idx), void* data, int values_count, int values_offset, const char* overlay_text, float scale_min, float scale_max, ImVec2 graph_size, void (*values_range_getter)(void* data, int idx_begin, int idx_end, float* in_out_min, float* in_out_max))
 {
     ImGuiWindow* window = GetCurrentWindow();
     if (window->SkipItems)
@@ -5223,17 +5320,26 @@ void ImGui::PlotEx(ImGuiPlotType plot_type, const char* label, float (*values_ge
     if (!ItemAdd(total_bb, 0, &frame_bb))
         return;
     const bool hovered = ItemHoverable(inner_bb, 0);
+    if (values_count > 0)
+        values_offset %= values_count;
 
-    // Determine scale from values if not specified
-    if (scale_min == FLT_MAX || scale_max == FLT_MAX)
+    // More values than pixels: reduce each pixel column to the min/max of its values, which is all we can draw of them. Striding through
+    // the values instead would alias, skipping spikes between two samples. The scale comes out of the same pass.
+    const int columns_count = (int)inner_bb.GetWidth();
+    const bool decimate = columns_count > 0 && values_count > columns_count;
+    if (decimate)
     {
+        g.PlotColumns.resize(columns_count);
         float v_min = FLT_MAX;
         float v_max = -FLT_MAX;
-        for (int i = 0; i < values_count; i++)
+        for (int n = 0; n < columns_count; n++)
         {
-            const float v = values_getter(data, i);
-            v_min = ImMin(v_min, v);
-            v_max = ImMax(v_max, v);
+            ImVec2& column = g.PlotColumns[n];
+            const int idx_begin = (int)((ImS64)n * values_count / columns_count);
+            const int idx_end = (int)((ImS64)(n + 1) * values_count / columns_count);
+            PlotGetRangeMinMax(values_getter, values_range_getter, data, values_count, values_offset, idx_begin, idx_end, &column.x, &column.y);
+            v_min = ImMin(v_min, column.x);
+            v_max = ImMax(v_max, column.y);
         }
         if (scale_min == FLT_MAX)
             scale_min = v_min;
@@ -5241,9 +5347,71 @@ void ImGui::PlotEx(ImGuiPlotType plot_type, const char* label, float (*values_ge
             scale_max = v_max;
     }
 
+    // Determine scale from values if not specified
+    if (scale_min == FLT_MAX || scale_max == FLT_MAX)
+    {
+        float v_min = FLT_MAX;
+        float v_max = -FLT_MAX;
+        if (values_count > 0)
+            PlotGetRangeMinMax(values_getter, values_range_getter, data, values_count, values_offset, 0, values_count, &v_min, &v_max);
+        if (scale_min == FLT_MAX)
+            scale_min = v_min;
+        if (scale_max == FLT_MAX)
+            scale_max = v_max;
+    }
+
     RenderFrame(frame_bb.Min, frame_bb.Max, GetColorU32(ImGuiCol_FrameBg), true, style.FrameRounding);
 
-    if (values_count > 0)
+    const ImU32 col_base = GetColorU32((plot_type == ImGuiPlotType_Lines) ? ImGuiCol_PlotLines : ImGuiCol_PlotHistogram);
+    const ImU32 col_hovered = GetColorU32((plot_type == ImGuiPlotType_Lines) ? ImGuiCol_PlotLinesHovered : ImGuiCol_PlotHistogramHovered);
+
+    if (decimate)
+    {
+        // Tooltip on hover
+        int column_hovered = -1;
+        if (hovered)
+        {
+            column_hovered = ImClamp((int)(g.IO.MousePos.x - inner_bb.Min.x), 0, columns_count - 1);
+            const int idx_begin = (int)((ImS64)column_hovered * values_count / columns_count);
+            const int idx_end = (int)((ImS64)(column_hovered + 1) * values_count / columns_count);
+            const ImVec2 column = g.PlotColumns[column_hovered];
+            SetTooltip("%d..%d\nmin: %8.4g\nmax: %8.4g", idx_begin, idx_end - 1, column.x, column.y);
+        }
+
+        // One pixel wide rectangle per column. Lines span the min/max of the column, stretched to meet the previous column so the trace
+        // stays connected. Histogram bars go from the zero line to whichever of min/max lies further from it, or to both.
+        const float inv_scale = (scale_min == scale_max) ? 0.0f : (1.0f / (scale_max - scale_min));
+        const float y_scale = inner_bb.GetHeight();
+        const float histogram_zero_line_t = (scale_min * scale_max < 0.0f) ? (-scale_min * inv_scale) : (scale_min < 0.0f ? 0.0f : 1.0f);
+        const float histogram_zero_line_y = ImLerp(inner_bb.Min.y, inner_bb.Max.y, histogram_zero_line_t);
+        ImVec2 column_prev = g.PlotColumns[0];
+        for (int n = 0; n < columns_count; n++)
+        {
+            const ImVec2 column = g.PlotColumns[n];
+            float v_low = column.x, v_high = column.y;
+            if (plot_type == ImGuiPlotType_Lines)
+            {
+                v_low = ImMin(v_low, column_prev.y);
+                v_high = ImMax(v_high, column_prev.x);
+            }
+            column_prev = column;
+
+            float y0 = inner_bb.Min.y + (1.0f - ImSaturate((v_high - scale_min) * inv_scale)) * y_scale;
+            float y1 = inner_bb.Min.y + (1.0f - ImSaturate((v_low - scale_min) * inv_scale)) * y_scale;
+            if (plot_type == ImGuiPlotType_Histogram)
+            {
+                y0 = ImMin(y0, histogram_zero_line_y);
+                y1 = ImMax(y1, histogram_zero_line_y);
+            }
+            else if (y1 < y0 + 1.0f)
+            {
+                y1 = y0 + 1.0f;
+            }
+            const float x = inner_bb.Min.x + (float)n;
+            window->DrawList->AddRectFilled(ImVec2(x, y0), ImVec2(x + 1.0f, y1), column_hovered == n ? col_hovered : col_base);
+        }
+    }
+    else if (values_count > 0)
     {
         int res_w = ImMin((int)graph_size.x, values_count) + ((plot_type == ImGuiPlotType_Lines) ? -1 : 0);
         int item_count = values_count + ((plot_type == ImGuiPlotType_Lines) ? -1 : 0);
@@ -5273,9 +5441,6 @@ void ImGui::PlotEx(ImGuiPlotType plot_type, const char* label, float (*values_ge
         ImVec2 tp0 = ImVec2( t0, 1.0f - ImSaturate((v0 - scale_min) * inv_scale) );                       // Point in the normalized space of our target rectangle
         float histogram_zero_line_t = (scale_min * scale_max < 0.0f) ? (-scale_min * inv_scale) : (scale_min < 0.0f ? 0.0f : 1.0f);   // Where does the zero line stands
 
-        const ImU32 col_base = GetColorU32((plot_type == ImGuiPlotType_Lines) ? ImGuiCol_PlotLines : ImGuiCol_PlotHistogram);
-        const ImU32 col_hovered = GetColorU32((plot_type == ImGuiPlotType_Lines) ? ImGuiCol_PlotLinesHovered : ImGuiCol_PlotHistogramHovered);
-
         for (int n = 0; n < res_w; n++)
         {
             const float t1 = t0 + t_step;
@@ -5326,10 +5491,27 @@ static float Plot_ArrayGetter(void* data, int idx)
     return v;
 }
 
+static void Plot_ArrayRangeGetter(void* data, int idx_begin, int idx_end, float* in_out_min, float* in_out_max)
+{
+    ImGuiPlotArrayGetterData* plot_data = (ImGuiPlotArrayGetterData*)data;
+    const float* values = (const float*)(const void*)((const unsigned char*)plot_data->Values + (size_t)idx_begin * plot_data->Stride);
+    ImMinMax(values, idx_end - idx_begin, plot_data->Stride, in_out_min, in_out_max);
+}
+
+static float Plot_HistoryGetter(void* data, int idx)
+{
+    return ((const ImGuiPlotHistory*)data)->Values[idx];
+}
+
+static void Plot_HistoryRangeGetter(void* data, int idx_begin, int idx_end, float* in_out_min, float* in_out_max)
+{
+    ((const ImGuiPlotHistory*)data)->GetMinMax(idx_begin, idx_end, in_out_min, in_out_max);
+}
+
 void ImGui::PlotLines(const char* label, const float* values, int values_count, int values_offset, const char* overlay_text, float scale_min, float scale_max, ImVec2 graph_size, int stride)
 {
     ImGuiPlotArrayGetterData data(values, stride);
-    PlotEx(ImGuiPlotType_Lines, label, &Plot_ArrayGetter, (void*)&data, values_count, values_offset, overlay_text, scale_min, scale_max, graph_size);
+    PlotEx(ImGuiPlotType_Lines, label, &Plot_ArrayGetter, (void*)&data, values_count, values_offset, overlay_text, scale_min, scale_max, graph_size, &Plot_ArrayRangeGetter);
 }
 
 void ImGui::PlotLines(const char* label, float (*values_getter)(void* data, int idx), void* data, int values_count, int values_offset, const char* overlay_text, float scale_min, float scale_max, ImVec2 graph_size)
@@ -5337,10 +5519,15 @@ void ImGui::PlotLines(const char* label, float (*values_getter)(void* data, int
     PlotEx(ImGuiPlotType_Lines, label, values_getter, data, values_count, values_offset, overlay_text, scale_min, scale_max, graph_size);
 }
 
+void ImGui::PlotLines(const char* label, const ImGuiPlotHistory& history, const char* overlay_text, float scale_min, float scale_max, ImVec2 graph_size)
+{
+    PlotEx(ImGuiPlotType_Lines, label, &Plot_HistoryGetter, (void*)&history, history.Count, history.Offset, overlay_text, scale_min, scale_max, graph_size, &Plot_HistoryRangeGetter);
+}
+
 void ImGui::PlotHistogram(const char* label, const float* values, int values_count, int values_offset, const char* overlay_text, float scale_min, float scale_max, ImVec2 graph_size, int stride)
 {
     ImGuiPlotArrayGetterData data(values, stride);
-    PlotEx(ImGuiPlotType_Histogram, label, &Plot_ArrayGetter, (void*)&data, values_count, values_offset, overlay_text, scale_min, scale_max, graph_size);
+    PlotEx(ImGuiPlotType_Histogram, label, &Plot_ArrayGetter, (void*)&data, values_count, values_offset, overlay_text, scale_min, scale_max, graph_size, &Plot_ArrayRangeGetter);
 }
 
 void ImGui::PlotHistogram(const char* label, float (*values_getter)(void* data, int idx), void* data, int values_count, int values_offset, const char* overlay_text, float scale_min, float scale_max, ImVec2 graph_size)
@@ -5348,6 +5535,177 @@ void ImGui::PlotHistogram(const char* label, float (*values_getter)(void* data,
     PlotEx(ImGuiPlotType_Histogram, label, values_getter, data, values_count, values_offset, overlay_text, scale_min, scale_max, graph_size);
 }
 
+void ImGui::PlotHistogram(const char* label, const ImGuiPlotHistory& history, const char* overlay_text, float scale_min, float scale_max, ImVec2 graph_size)
+{
+    PlotEx(ImGuiPlotType_Histogram, label, &Plot_HistoryGetter, (void*)&history, history.Count, history.Offset, overlay_text, scale_min, scale_max, graph_size, &Plot_HistoryRangeGetter);
+}
+
+// ImGuiPlotHistory
+static const int PLOT_HISTORY_BLOCK_SHIFT = 4;  // 16 entries per block at every level
+static const int PLOT_HISTORY_BLOCK_SIZE = 1 << PLOT_HISTORY_BLOCK_SHIFT;
+
+void ImGuiPlotHistory::Init(int capacity)
+{
+    IM_ASSERT(capacity >= 0);
+    Values.resize(capacity);
+    LevelsCount = 1;
+    int blocks_size = 0;
+    for (int level_size = capacity; level_size > PLOT_HISTORY_BLOCK_SIZE; LevelsCount++)
+    {
+        IM_ASSERT(LevelsCount < IM_ARRAYSIZE(LevelOffset));
+        level_size = (level_size + PLOT_HISTORY_BLOCK_SIZE - 1) >> PLOT_HISTORY_BLOCK_SHIFT;
+        LevelOffset[LevelsCount] = blocks_size;
+        blocks_size += level_size;
+    }
+    Blocks.resize(blocks_size);
+    Clear();
+}
+
+void ImGuiPlotHistory::Clear()
+{
+    // Empty blocks are [+FLT_MAX, -FLT_MAX], which leaves any min/max they are merged into alone
+    for (int n = 0; n < Blocks.Size; n++)
+        Blocks[n] = ImVec2(FLT_MAX, -FLT_MAX);
+    Count = Offset = 0;
+}
+
+// Recompute the blocks over Values[idx_begin, idx_end) at every level
+static void PlotHistoryUpdateBlocks(ImGuiPlotHistory* history, int idx_begin, int idx_end)
+{
+    const int values_count = history->Count;
+    for (int level = 1; level < history->LevelsCount; level++)
+    {
+        const int block_begin = idx_begin >> PLOT_HISTORY_BLOCK_SHIFT;
+        const int block_end = ((idx_end - 1) >> PLOT_HISTORY_BLOCK_SHIFT) + 1;
+        ImVec2* blocks = history->Blocks.Data + history->LevelOffset[level];
+        for (int block = block_begin; block < block_end; block++)
+        {
+            float v_min = FLT_MAX;
+            float v_max = -FLT_MAX;
+            const int child_begin = block << PLOT_HISTORY_BLOCK_SHIFT;
+            if (level == 1)
+            {
+                // Values past Count were never written
+                ImMinMax(history->Values.Data + child_begin, ImMin(child_begin + PLOT_HISTORY_BLOCK_SIZE, values_count) - child_begin, sizeof(float), &v_min, &v_max);
+            }
+            else
+            {
+                const ImVec2* children = history->Blocks.Data + history->LevelOffset[level - 1] + child_begin;
+                const int children_count = ImMin(PLOT_HISTORY_BLOCK_SIZE, history->LevelOffset[level] - history->LevelOffset[level - 1] - child_begin);
+                for (int n = 0; n < children_count; n++)
+                {
+                    v_min = ImMin(v_min, children[n].x);
+                    v_max = ImMax(v_max, children[n].y);
+                }
+            }
+            blocks[block] = ImVec2(v_min, v_max);
+        }
+        idx_begin = block_begin;
+        idx_end = block_end;
+    }
+}
+
+void ImGuiPlotHistory::Push(float v)
+{
+    const int capacity = Values.Size;
+    if (capacity == 0)
+        return;
+    const bool full = (Count == capacity);
+    const int write_idx = full ? Offset : Count;
+    const float v_old = Values[write_idx];
+    Values[write_idx] = v;
+    if (!full)
+        Count++;
+    else if (++Offset == capacity)
+        Offset = 0;
+
+    // Unless the value written over was an extreme of its block, the blocks above it can only widen to the new value
+    if (LevelsCount > 1 && full)
+    {
+        const ImVec2& block = Blocks[LevelOffset[1] + (write_idx >> PLOT_HISTORY_BLOCK_SHIFT)];
+        if (v_old == block.x || v_old == block.y)
+        {
+            PlotHistoryUpdateBlocks(this, write_idx, write_idx + 1);
+            return;
+        }
+    }
+    int idx = write_idx;
+    for (int level = 1; level < LevelsCount; level++)
+    {
+        idx >>= PLOT_HISTORY_BLOCK_SHIFT;
+        ImVec2& block = Blocks[LevelOffset[level] + idx];
+        block.x = ImMin(block.x, v);
+        block.y = ImMax(block.y, v);
+    }
+}
+
+void ImGuiPlotHistory::Push(const float* values, int values_count)
+{
+    const int capacity = Values.Size;
+    if (capacity == 0 || values_count <= 0)
+        return;
+    if (values_count > capacity)
+    {
+        values += values_count - capacity;
+        values_count = capacity;
+    }
+    while (values_count > 0)
+    {
+        // Write at the end until full, then over the oldest values
+        const int write_idx = (Count < capacity) ? Count : Offset;
+        const int run_count = ImMin(values_count, capacity - write_idx);
+        memcpy(Values.Data + write_idx, values, (size_t)run_count * sizeof(float));
+        if (Count < capacity)
+            Count += run_count;
+        else
+            Offset = (Offset + run_count) % capacity;
+        PlotHistoryUpdateBlocks(this, write_idx, write_idx + run_count);
+        values += run_count;
+        values_count -= run_count;
+    }
+}
+
+void ImGuiPlotHistory::GetMinMax(int idx_begin, int idx_end, float* in_out_min, float* in_out_max) const
+{
+    IM_ASSERT(idx_begin >= 0 && idx_end <= Count);
+    float v_min = *in_out_min;
+    float v_max = *in_out_max;
+    for (int level = 0; level < LevelsCount && idx_begin < idx_end; level++)
+    {
+        // Entries up to the first block boundary and from the last one are taken one by one, the whole blocks between them one level up.
+        // The last level is taken whole.
+        int head_end = idx_end, tail_begin = idx_end;
+        if (level + 1 < LevelsCount)
+        {
+            head_end = ImMin((idx_begin + PLOT_HISTORY_BLOCK_SIZE - 1) & ~(PLOT_HISTORY_BLOCK_SIZE - 1), idx_end);
+            tail_begin = ImMax(idx_end & ~(PLOT_HISTORY_BLOCK_SIZE - 1), head_end);
+        }
+        if (level == 0)
+        {
+            ImMinMax(Values.Data + idx_begin, head_end - idx_begin, sizeof(float), &v_min, &v_max);
+            ImMinMax(Values.Data + tail_begin, idx_end - tail_begin, sizeof(float), &v_min, &v_max);
+        }
+        else
+        {
+            const ImVec2* blocks = Blocks.Data + LevelOffset[level];
+            for (int n = idx_begin; n < head_end; n++)
+            {
+                v_min = ImMin(v_min, blocks[n].x);
+                v_max = ImMax(v_max, blocks[n].y);
+            }
+            for (int n = tail_begin; n < idx_end; n++)
+            {
+                v_min = ImMin(v_min, blocks[n].x);
+                v_max = ImMax(v_max, blocks[n].y);
+            }
+        }
+        idx_begin = head_end >> PLOT_HISTORY_BLOCK_SHIFT;
+        idx_end = tail_begin >> PLOT_HISTORY_BLOCK_SHIFT;
+    }
+    *in_out_min = v_min;
+    *in_out_max = v_max;
+}
+
 //-------------------------------------------------------------------------
 // [SECTION] Widgets: Value helpers
 // Those is not very useful, legacy API.
@@ -1,4 +1,5 @@
 // [ImGui] this is a slightly modified version of stb_textedit.h 1.12. Those changes would need to be pushed into nothings/stb
+// [ImGui] - optional STB_TEXTEDIT_ROWSTART_AT_Y / STB_TEXTEDIT_ROWSTART_AT_CHAR, to jump to a row instead of laying out every row above it
 // [ImGui] - 2018-06: fixed undo/redo after pasting large amount of text (over 32 kb). Redo will still fail when undo buffers are exhausted, but text won't be corrupted (see nothings/stb issue #620)
 // [ImGui] - 2018-06: fix in stb_textedit_discard_redo (see https://github.com/nothings/stb/issues/321)
 // [ImGui] - fixed some minor warnings
@@ -167,6 +168,9 @@
 //    STB_TEXTEDIT_K_LINEEND2            secondary keyboard input to move cursor to end of line
 //    STB_TEXTEDIT_K_TEXTSTART2          secondary keyboard input to move cursor to start of text
 //    STB_TEXTEDIT_K_TEXTEND2            secondary keyboard input to move cursor to end of text
+//    STB_TEXTEDIT_ROWSTART_AT_Y(obj,y,&ry)   first char of the row straddling 'y' (0 above the text, the length
+//                                            below it), stores the row's y in ry. Saves laying out the rows above
+//    STB_TEXTEDIT_ROWSTART_AT_CHAR(obj,i,&ry) first char of the row holding char i (i < length), stores the row's y in ry
 //
 // Todo:
 //    STB_TEXTEDIT_K_PGUP        keyboard input to move cursor up a page
@@ -402,6 +406,11 @@ static int stb_text_locate_coord(STB_TEXTEDIT_STRING *str, float x, float y)
    r.ymin = r.ymax = 0;
    r.num_chars = 0;
 
+#ifdef STB_TEXTEDIT_ROWSTART_AT_Y
+   // start from the row the client says straddles 'y' (the loop below still checks it)
+   i = STB_TEXTEDIT_ROWSTART_AT_Y(str, y, &base_y);
+#endif
+
    // search rows to find one that straddles 'y'
    while (i < n) {
       STB_TEXTEDIT_LAYOUTROW(&r, str, i);
@@ -532,11 +541,19 @@ static void stb_textedit_find_charpos(StbFindState *find, STB_TEXTEDIT_STRING *s
          find->y = 0;
          find->x = 0;
          find->height = 1;
+#ifdef STB_TEXTEDIT_ROWSTART_AT_CHAR
+         if (z > 0) {
+            float row_y;
+            prev_start = STB_TEXTEDIT_ROWSTART_AT_CHAR(str, z-1, &row_y);
+         }
+         i = z;
+#else
          while (i < z) {
             STB_TEXTEDIT_LAYOUTROW(&r, str, i);
             prev_start = i;
             i += r.num_chars;
          }
+#endif
          find->first_char = i;
          find->length = 0;
          find->prev_first = prev_start;
@@ -547,6 +564,15 @@ static void stb_textedit_find_charpos(StbFindState *find, STB_TEXTEDIT_STRING *s
    // search rows to find the one that straddles character n
    find->y = 0;
 
+#ifdef STB_TEXTEDIT_ROWSTART_AT_CHAR
+   // start from the row the client says holds character n, the previous row is the one holding the character before it
+   i = STB_TEXTEDIT_ROWSTART_AT_CHAR(str, n, &find->y);
+   if (i > 0) {
+      float row_y;
+      prev_start = STB_TEXTEDIT_ROWSTART_AT_CHAR(str, i-1, &row_y);
+   }
+#endif
+
    for(;;) {
       STB_TEXTEDIT_LAYOUTROW(&r, str, i);
       if (n < i + r.num_chars)
@@ -50,6 +50,12 @@
 // OpenGL Data
 static GLuint       g_FontTexture = 0;
 
+#ifdef IMGUI_USE_COMPACT_DRAWVERT
+// The fixed pipeline has no normalized texture coordinates, so compact vertices are expanded back to floats.
+struct ImDrawVertFloat { ImVec2 pos; ImVec2 uv; ImU32 col; };
+static ImVector<ImDrawVertFloat> g_VtxExpanded;
+#endif
+
 // Functions
 bool    ImGui_ImplOpenGL2_Init()
 {
@@ -72,13 +78,12 @@ void    ImGui_ImplOpenGL2_NewFrame()
 // Note that this implementation is little overcomplicated because we are saving/setting up/restoring every OpenGL state explicitly, in order to be able to run within any OpenGL engine that doesn't do so. 
 void ImGui_ImplOpenGL2_RenderDrawData(ImDrawData* draw_data)
 {
-    // Avoid rendering when minimized, scale coordinates for retina displays (screen coordinates != framebuffer coordinates)
+    // Avoid rendering when minimized, scale clip rectangles for retina displays (screen coordinates != framebuffer coordinates) below
     ImGuiIO& io = ImGui::GetIO();
     int fb_width = (int)(draw_data->DisplaySize.x * io.DisplayFramebufferScale.x);
     int fb_height = (int)(draw_data->DisplaySize.y * io.DisplayFramebufferScale.y);
     if (fb_width == 0 || fb_height == 0)
         return;
-    draw_data->ScaleClipRects(io.DisplayFramebufferScale);
 
     // We are using the OpenGL fixed pipeline to make the example code simpler to read!
     // Setup render state: alpha-blending enabled, no face culling, no depth testing, scissor enabled, vertex/texcoord/color pointers, polygon fill.
@@ -114,14 +119,29 @@ void ImGui_ImplOpenGL2_RenderDrawData(ImDrawData* draw_data)
 
     // Render command lists
     ImVec2 pos = draw_data->DisplayPos;
+    ImVec2 scale = io.DisplayFramebufferScale;  // Applied here rather than with ScaleClipRects(), which would change lists a renderer may keep
     for (int n = 0; n < draw_data->CmdListsCount; n++)
     {
         const ImDrawList* cmd_list = draw_data->CmdLists[n];
-        const ImDrawVert* vtx_buffer = cmd_list->VtxBuffer.Data;
         const ImDrawIdx* idx_buffer = cmd_list->IdxBuffer.Data;
-        glVertexPointer(2, GL_FLOAT, sizeof(ImDrawVert), (const GLvoid*)((const char*)vtx_buffer + IM_OFFSETOF(ImDrawVert, pos)));
-        glTexCoordPointer(2, GL_FLOAT, sizeof(ImDrawVert), (const GLvoid*)((const char*)vtx_buffer + IM_OFFSETOF(ImDrawVert, uv)));
-        glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(ImDrawVert), (const GLvoid*)((const char*)vtx_buffer + IM_OFFSETOF(ImDrawVert, col)));
+#ifdef IMGUI_USE_COMPACT_DRAWVERT
+        g_VtxExpanded.resize(cmd_list->VtxBuffer.Size);
+        for (int i = 0; i < cmd_list->VtxBuffer.Size; i++)
+        {
+            const ImDrawVert& v = cmd_list->VtxBuffer[i];
+            g_VtxExpanded[i].pos = v.pos;
+            g_VtxExpanded[i].uv = v.uv;
+            g_VtxExpanded[i].col = v.col;
+        }
+        typedef ImDrawVertFloat Vert;
+        const Vert* vtx_buffer = g_VtxExpanded.Data;
+#else
+        typedef ImDrawVert Vert;
+        const Vert* vtx_buffer = cmd_list->VtxBuffer.Data;
+#endif
+        glVertexPointer(2, GL_FLOAT, sizeof(Vert), (const GLvoid*)((const char*)vtx_buffer + IM_OFFSETOF(Vert, pos)));
+        glTexCoordPointer(2, GL_FLOAT, sizeof(Vert), (const GLvoid*)((const char*)vtx_buffer + IM_OFFSETOF(Vert, uv)));
+        glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vert), (const GLvoid*)((const char*)vtx_buffer + IM_OFFSETOF(Vert, col)));
 
         for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
         {
@@ -133,7 +153,7 @@ void ImGui_ImplOpenGL2_RenderDrawData(ImDrawData* draw_data)
             }
             else
             {
-                ImVec4 clip_rect = ImVec4(pcmd->ClipRect.x - pos.x, pcmd->ClipRect.y - pos.y, pcmd->ClipRect.z - pos.x, pcmd->ClipRect.w - pos.y);
+                ImVec4 clip_rect = ImVec4((pcmd->ClipRect.x - pos.x) * scale.x, (pcmd->ClipRect.y - pos.y) * scale.y, (pcmd->ClipRect.z - pos.x) * scale.x, (pcmd->ClipRect.w - pos.y) * scale.y);
                 if (clip_rect.x < fb_width && clip_rect.y < fb_height && clip_rect.z >= 0.0f && clip_rect.w >= 0.0f)
                 {
                     // Apply scissor/clipping rectangle
@@ -4,6 +4,9 @@
 
 // Implemented features:
 //  [X] Renderer: User texture binding. Use 'GLuint' OpenGL texture identifier as void*/ImTextureID. Read the FAQ about ImTextureID in imgui.cpp.
+//  [X] Renderer: Compact vertices (IMGUI_USE_COMPACT_DRAWVERT in imconfig.h).
+//  [X] Renderer: Distance field fonts (ImFontConfig::SignedDistanceField), drawn through a second program (see ImDrawCmd::DistanceField).
+//  [X] Renderer: Draw lists that didn't change since the last frame (ImDrawList::Version) stay in GPU memory, not copied again.
 
 // You can copy and use unmodified imgui_impl_* files in your project. See main.cpp for an example of using this.
 // If you are new to dear imgui, read examples/README.txt and read the documentation at the top of imgui.cpp.
@@ -89,13 +92,53 @@
 #endif
 #endif
 
+// All state changes go through the application's shadow state cache: redundant binds are skipped and
+// saving/restoring the caller's state needs no glGet*.
+#include "jake_gl_state.h"
+
+// Stream vertices/indices through a ring of buffers mapped once, rather than re-specifying a buffer per draw list.
+// Needs glDrawElementsBaseVertex (GL 3.2), missing from GL ES 3.0.
+#ifndef USE_GL_ES3
+#define IMGUI_IMPL_OPENGL_RING_BUFFER
+#endif
+#define IMGUI_IMPL_OPENGL_RING_FRAMES   3       // Frames the GPU may still be reading from
+
 // OpenGL Data
 static char         g_GlslVersionString[32] = "";
 static GLuint       g_FontTexture = 0;
 static GLuint       g_ShaderHandle = 0, g_VertHandle = 0, g_FragHandle = 0;
+static GLuint       g_SdfShaderHandle = 0, g_SdfFragHandle = 0;         // Same vertex shader, distance field fragment shader
 static int          g_AttribLocationTex = 0, g_AttribLocationProjMtx = 0;
+static int          g_SdfAttribLocationTex = 0, g_SdfAttribLocationProjMtx = 0;
 static int          g_AttribLocationPosition = 0, g_AttribLocationUV = 0, g_AttribLocationColor = 0;
 static unsigned int g_VboHandle = 0, g_ElementsHandle = 0;
+static ImGui_ImplOpenGL3_CreateProgramFn g_CreateProgramFn = NULL;
+static ImGui_ImplOpenGL3_DeleteProgramFn g_DeleteProgramFn = NULL;
+static bool         g_ShaderFromFn = false, g_SdfShaderFromFn = false;   // Made by g_CreateProgramFn, deleted by g_DeleteProgramFn
+#ifdef IMGUI_IMPL_OPENGL_RING_BUFFER
+enum ImGui_ImplOpenGL3_RingMode { RingMode_None, RingMode_MapUnsynchronized, RingMode_Persistent };
+static ImGui_ImplOpenGL3_RingMode g_RingMode = RingMode_None;
+static int          g_RingVtxCapacity = 0, g_RingIdxCapacity = 0;  // Per frame, in vertices/indices
+static ImDrawVert*  g_RingVtxMapped = NULL;                         // RingMode_Persistent only
+static ImDrawIdx*   g_RingIdxMapped = NULL;
+static GLsync       g_RingFences[IMGUI_IMPL_OPENGL_RING_FRAMES] = {};
+static int          g_RingFrame = 0;
+static ImVector<int> g_RingListVtxFirst, g_RingListIdxFirst;        // Where each draw list of the frame is, in vertices/indices
+static ImVector<int> g_RingListEntry;                                // Index of each draw list's entry in g_ResidentLists
+
+// Draw lists drawn with the same ImDrawList::Version two frames in a row are copied once more, into a resident area after
+// the ring segments, and drawn from there with no copying until they change or stop being drawn. The area is bump
+// allocated and reclaimed all at once when it fills up. It is as large as a ring segment.
+struct ImGui_ImplOpenGL3_ResidentList
+{
+    const ImDrawList*   List;
+    unsigned int        Version;
+    int                 VtxFirst, IdxFirst;     // In the resident area, -1 while not resident
+    bool                Seen;                   // Drawn this frame
+};
+static ImVector<ImGui_ImplOpenGL3_ResidentList> g_ResidentLists;
+static int          g_ResidentVtxUsed = 0, g_ResidentIdxUsed = 0;
+#endif
 
 // Functions
 bool    ImGui_ImplOpenGL3_Init(const char* glsl_version)
@@ -119,6 +162,220 @@ void    ImGui_ImplOpenGL3_Shutdown()
     ImGui_ImplOpenGL3_DestroyDeviceObjects();
 }
 
+void    ImGui_ImplOpenGL3_SetCreateProgramFn(ImGui_ImplOpenGL3_CreateProgramFn create_fn, ImGui_ImplOpenGL3_DeleteProgramFn delete_fn)
+{
+    g_CreateProgramFn = create_fn;
+    g_DeleteProgramFn = delete_fn;
+}
+
+#ifdef IMGUI_IMPL_OPENGL_RING_BUFFER
+static void ImGui_ImplOpenGL3_DestroyRingBuffers()
+{
+    for (int i = 0; i < IMGUI_IMPL_OPENGL_RING_FRAMES; i++)
+    {
+        if (g_RingFences[i]) glDeleteSync(g_RingFences[i]);
+        g_RingFences[i] = 0;
+    }
+    // Buffers the GPU is still reading from live on in the driver until it is done with them
+    if (g_VboHandle) GlStateDeleteBuffers(1, &g_VboHandle);
+    if (g_ElementsHandle) GlStateDeleteBuffers(1, &g_ElementsHandle);
+    g_VboHandle = g_ElementsHandle = 0;
+    g_RingVtxMapped = NULL;
+    g_RingIdxMapped = NULL;
+    g_RingVtxCapacity = g_RingIdxCapacity = 0;
+    g_ResidentLists.clear();
+    g_ResidentVtxUsed = g_ResidentIdxUsed = 0;
+}
+
+static void* ImGui_ImplOpenGL3_CreateRingBuffer(GLuint* handle, GLsizeiptr size)
+{
+    // Bound to GL_COPY_WRITE_BUFFER, which unlike GL_ELEMENT_ARRAY_BUFFER isn't part of the current VAO's state
+    glGenBuffers(1, handle);
+    GlStateBindBuffer(GL_COPY_WRITE_BUFFER, *handle);
+    if (g_RingMode == RingMode_Persistent)
+    {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_COPY_WRITE_BUFFER, size, NULL, flags);
+        return glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, flags);
+    }
+    glBufferData(GL_COPY_WRITE_BUFFER, size, NULL, GL_STREAM_DRAW);
+    return NULL;
+}
+
+static void ImGui_ImplOpenGL3_CreateRingBuffers(int vtx_capacity, int idx_capacity)
+{
+    g_RingVtxCapacity = vtx_capacity;
+    g_RingIdxCapacity = idx_capacity;
+    // The ring segments, then the resident area
+    g_RingVtxMapped = (ImDrawVert*)ImGui_ImplOpenGL3_CreateRingBuffer(&g_VboHandle, (GLsizeiptr)vtx_capacity * (IMGUI_IMPL_OPENGL_RING_FRAMES + 1) * sizeof(ImDrawVert));
+    g_RingIdxMapped = (ImDrawIdx*)ImGui_ImplOpenGL3_CreateRingBuffer(&g_ElementsHandle, (GLsizeiptr)idx_capacity * (IMGUI_IMPL_OPENGL_RING_FRAMES + 1) * sizeof(ImDrawIdx));
+}
+
+// Map part of a ring buffer for writing, or just point into it when persistently mapped. Unsynchronized: callers have
+// made sure the GPU is done with the range.
+static void* ImGui_ImplOpenGL3_MapRingRange(GLuint handle, void* mapped, size_t offset, size_t size)
+{
+    if (mapped != NULL)
+        return (char*)mapped + offset;
+    GlStateBindBuffer(GL_COPY_WRITE_BUFFER, handle);
+    return glMapBufferRange(GL_COPY_WRITE_BUFFER, (GLintptr)offset, (GLsizeiptr)size, GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+}
+
+static void ImGui_ImplOpenGL3_UnmapRingRange(GLuint handle, void* mapped)
+{
+    if (mapped != NULL)
+        return;
+    GlStateBindBuffer(GL_COPY_WRITE_BUFFER, handle);
+    glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+}
+
+static void ImGui_ImplOpenGL3_WaitRingFence(int segment)
+{
+    if (g_RingFences[segment])
+    {
+        while (glClientWaitSync(g_RingFences[segment], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {}
+        glDeleteSync(g_RingFences[segment]);
+        g_RingFences[segment] = 0;
+    }
+}
+
+// Copy the vertices and indices of the frame's draw lists into its segment of the ring, back to back, except for the ones
+// kept in the resident area. Fills g_RingListVtxFirst/g_RingListIdxFirst with where each list is.
+static void ImGui_ImplOpenGL3_UploadToRing(ImDrawData* draw_data)
+{
+    // Grow to fit, by powers of two so it only happens a few times
+    if (draw_data->TotalVtxCount > g_RingVtxCapacity || draw_data->TotalIdxCount > g_RingIdxCapacity)
+    {
+        int vtx_capacity = g_RingVtxCapacity > 0 ? g_RingVtxCapacity : 1 << 14;
+        int idx_capacity = g_RingIdxCapacity > 0 ? g_RingIdxCapacity : 1 << 15;
+        while (vtx_capacity < draw_data->TotalVtxCount)
+            vtx_capacity *= 2;
+        while (idx_capacity < draw_data->TotalIdxCount)
+            idx_capacity *= 2;
+        ImGui_ImplOpenGL3_DestroyRingBuffers();
+        ImGui_ImplOpenGL3_CreateRingBuffers(vtx_capacity, idx_capacity);
+    }
+
+    // Wait for the GPU to be done with the frame that last used this segment. It normally is, by a frame or two.
+    const int segment = g_RingFrame % IMGUI_IMPL_OPENGL_RING_FRAMES;
+    ImGui_ImplOpenGL3_WaitRingFence(segment);
+
+    // Find each list's entry. Lists with a new version get streamed, the ones with the same version as last frame get
+    // (or stay) resident.
+    for (int i = 0; i < g_ResidentLists.Size; i++)
+        g_ResidentLists[i].Seen = false;
+    g_RingListEntry.resize(draw_data->CmdListsCount);
+    int vtx_to_resident = 0, idx_to_resident = 0;
+    for (int n = 0; n < draw_data->CmdListsCount; n++)
+    {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+        int i = 0;
+        while (i < g_ResidentLists.Size && g_ResidentLists[i].List != cmd_list)
+            i++;
+        if (i == g_ResidentLists.Size)
+        {
+            ImGui_ImplOpenGL3_ResidentList new_entry = { cmd_list, cmd_list->Version + 1, -1, -1, false };
+            g_ResidentLists.push_back(new_entry);
+        }
+        ImGui_ImplOpenGL3_ResidentList& entry = g_ResidentLists[i];
+        if (!entry.Seen && entry.Version == cmd_list->Version && entry.VtxFirst < 0)
+        {
+            vtx_to_resident += cmd_list->VtxBuffer.Size;
+            idx_to_resident += cmd_list->IdxBuffer.Size;
+        }
+        entry.Seen = true;
+        g_RingListEntry[n] = i;
+    }
+
+    // No room: reclaim the whole area once the frames still drawing from it are done
+    if (g_ResidentVtxUsed + vtx_to_resident > g_RingVtxCapacity || g_ResidentIdxUsed + idx_to_resident > g_RingIdxCapacity)
+    {
+        for (int i = 0; i < IMGUI_IMPL_OPENGL_RING_FRAMES; i++)
+            ImGui_ImplOpenGL3_WaitRingFence(i);
+        for (int i = 0; i < g_ResidentLists.Size; i++)
+            g_ResidentLists[i].VtxFirst = g_ResidentLists[i].IdxFirst = -1;
+        g_ResidentVtxUsed = g_ResidentIdxUsed = 0;
+    }
+
+    // Place every list, counting what goes into the ring
+    g_RingListVtxFirst.resize(draw_data->CmdListsCount);
+    g_RingListIdxFirst.resize(draw_data->CmdListsCount);
+    const int resident_vtx_first = IMGUI_IMPL_OPENGL_RING_FRAMES * g_RingVtxCapacity;
+    const int resident_idx_first = IMGUI_IMPL_OPENGL_RING_FRAMES * g_RingIdxCapacity;
+    int vtx_streamed = 0, idx_streamed = 0;
+    for (int n = 0; n < draw_data->CmdListsCount; n++)
+    {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+        ImGui_ImplOpenGL3_ResidentList* entry = &g_ResidentLists[g_RingListEntry[n]];
+        const int vtx_count = cmd_list->VtxBuffer.Size, idx_count = cmd_list->IdxBuffer.Size;
+        if (entry->Version == cmd_list->Version && entry->VtxFirst < 0 && idx_count > 0
+            && g_ResidentVtxUsed + vtx_count <= g_RingVtxCapacity && g_ResidentIdxUsed + idx_count <= g_RingIdxCapacity)
+        {
+            // Never drawn from since the area was last reclaimed, so no waiting
+            entry->VtxFirst = resident_vtx_first + g_ResidentVtxUsed;
+            entry->IdxFirst = resident_idx_first + g_ResidentIdxUsed;
+            g_ResidentVtxUsed += vtx_count;
+            g_ResidentIdxUsed += idx_count;
+            void* vtx_dst = ImGui_ImplOpenGL3_MapRingRange(g_VboHandle, g_RingVtxMapped, (size_t)entry->VtxFirst * sizeof(ImDrawVert), (size_t)vtx_count * sizeof(ImDrawVert));
+            memcpy(vtx_dst, cmd_list->VtxBuffer.Data, (size_t)vtx_count * sizeof(ImDrawVert));
+            ImGui_ImplOpenGL3_UnmapRingRange(g_VboHandle, g_RingVtxMapped);
+            void* idx_dst = ImGui_ImplOpenGL3_MapRingRange(g_ElementsHandle, g_RingIdxMapped, (size_t)entry->IdxFirst * sizeof(ImDrawIdx), (size_t)idx_count * sizeof(ImDrawIdx));
+            memcpy(idx_dst, cmd_list->IdxBuffer.Data, (size_t)idx_count * sizeof(ImDrawIdx));
+            ImGui_ImplOpenGL3_UnmapRingRange(g_ElementsHandle, g_RingIdxMapped);
+        }
+        if (entry->Version == cmd_list->Version && entry->VtxFirst >= 0)
+        {
+            g_RingListVtxFirst[n] = entry->VtxFirst;
+            g_RingListIdxFirst[n] = entry->IdxFirst;
+        }
+        else
+        {
+            // The space a changed list had stays used until the area is reclaimed
+            entry->Version = cmd_list->Version;
+            entry->VtxFirst = entry->IdxFirst = -1;
+            g_RingListVtxFirst[n] = segment * g_RingVtxCapacity + vtx_streamed;
+            g_RingListIdxFirst[n] = segment * g_RingIdxCapacity + idx_streamed;
+            vtx_streamed += vtx_count;
+            idx_streamed += idx_count;
+        }
+    }
+
+    // Lists that weren't drawn this frame are forgotten
+    for (int i = 0; i < g_ResidentLists.Size; )
+        if (!g_ResidentLists[i].Seen)
+            g_ResidentLists.erase_unsorted(g_ResidentLists.Data + i);
+        else
+            i++;
+    if (vtx_streamed == 0 || idx_streamed == 0)
+        return;
+
+    // Without persistent mapping, map just what this frame uses of the segment. The fence above already did the waiting.
+    ImDrawVert* vtx_dst = (ImDrawVert*)ImGui_ImplOpenGL3_MapRingRange(g_VboHandle, g_RingVtxMapped, (size_t)segment * g_RingVtxCapacity * sizeof(ImDrawVert), (size_t)vtx_streamed * sizeof(ImDrawVert));
+    for (int n = 0; n < draw_data->CmdListsCount; n++)
+    {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+        if (g_RingListVtxFirst[n] < resident_vtx_first)
+        {
+            memcpy(vtx_dst, cmd_list->VtxBuffer.Data, (size_t)cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
+            vtx_dst += cmd_list->VtxBuffer.Size;
+        }
+    }
+    ImGui_ImplOpenGL3_UnmapRingRange(g_VboHandle, g_RingVtxMapped);
+
+    ImDrawIdx* idx_dst = (ImDrawIdx*)ImGui_ImplOpenGL3_MapRingRange(g_ElementsHandle, g_RingIdxMapped, (size_t)segment * g_RingIdxCapacity * sizeof(ImDrawIdx), (size_t)idx_streamed * sizeof(ImDrawIdx));
+    for (int n = 0; n < draw_data->CmdListsCount; n++)
+    {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+        if (g_RingListVtxFirst[n] < resident_vtx_first)
+        {
+            memcpy(idx_dst, cmd_list->IdxBuffer.Data, (size_t)cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx));
+            idx_dst += cmd_list->IdxBuffer.Size;
+        }
+    }
+    ImGui_ImplOpenGL3_UnmapRingRange(g_ElementsHandle, g_RingIdxMapped);
+}
+#endif
+
 void    ImGui_ImplOpenGL3_NewFrame()
 {
     if (!g_FontTexture)
@@ -130,101 +387,111 @@ void    ImGui_ImplOpenGL3_NewFrame()
 // Note that this implementation is little overcomplicated because we are saving/setting up/restoring every OpenGL state explicitly, in order to be able to run within any OpenGL engine that doesn't do so.
 void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
 {
-    // Avoid rendering when minimized, scale coordinates for retina displays (screen coordinates != framebuffer coordinates)
+    // Avoid rendering when minimized, scale clip rectangles for retina displays (screen coordinates != framebuffer coordinates) below
     ImGuiIO& io = ImGui::GetIO();
     int fb_width = (int)(draw_data->DisplaySize.x * io.DisplayFramebufferScale.x);
     int fb_height = (int)(draw_data->DisplaySize.y * io.DisplayFramebufferScale.y);
     if (fb_width <= 0 || fb_height <= 0)
         return;
-    draw_data->ScaleClipRects(io.DisplayFramebufferScale);
 
-    // Backup GL state
-    GLenum last_active_texture; glGetIntegerv(GL_ACTIVE_TEXTURE, (GLint*)&last_active_texture);
-    glActiveTexture(GL_TEXTURE0);
-    GLint last_program; glGetIntegerv(GL_CURRENT_PROGRAM, &last_program);
-    GLint last_texture; glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
-#ifdef GL_SAMPLER_BINDING
-    GLint last_sampler; glGetIntegerv(GL_SAMPLER_BINDING, &last_sampler);
-#endif
-    GLint last_array_buffer; glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &last_array_buffer);
-    GLint last_vertex_array; glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &last_vertex_array);
-#ifdef GL_POLYGON_MODE
-    GLint last_polygon_mode[2]; glGetIntegerv(GL_POLYGON_MODE, last_polygon_mode);
-#endif
-    GLint last_viewport[4]; glGetIntegerv(GL_VIEWPORT, last_viewport);
-    GLint last_scissor_box[4]; glGetIntegerv(GL_SCISSOR_BOX, last_scissor_box);
-    GLenum last_blend_src_rgb; glGetIntegerv(GL_BLEND_SRC_RGB, (GLint*)&last_blend_src_rgb);
-    GLenum last_blend_dst_rgb; glGetIntegerv(GL_BLEND_DST_RGB, (GLint*)&last_blend_dst_rgb);
-    GLenum last_blend_src_alpha; glGetIntegerv(GL_BLEND_SRC_ALPHA, (GLint*)&last_blend_src_alpha);
-    GLenum last_blend_dst_alpha; glGetIntegerv(GL_BLEND_DST_ALPHA, (GLint*)&last_blend_dst_alpha);
-    GLenum last_blend_equation_rgb; glGetIntegerv(GL_BLEND_EQUATION_RGB, (GLint*)&last_blend_equation_rgb);
-    GLenum last_blend_equation_alpha; glGetIntegerv(GL_BLEND_EQUATION_ALPHA, (GLint*)&last_blend_equation_alpha);
-    GLboolean last_enable_blend = glIsEnabled(GL_BLEND);
-    GLboolean last_enable_cull_face = glIsEnabled(GL_CULL_FACE);
-    GLboolean last_enable_depth_test = glIsEnabled(GL_DEPTH_TEST);
-    GLboolean last_enable_scissor_test = glIsEnabled(GL_SCISSOR_TEST);
-    bool clip_origin_lower_left = true;
-#ifdef GL_CLIP_ORIGIN
-    GLenum last_clip_origin; glGetIntegerv(GL_CLIP_ORIGIN, (GLint*)&last_clip_origin); // Support for GL 4.5's glClipControl(GL_UPPER_LEFT)
-    clip_origin_lower_left = (last_clip_origin == GL_LOWER_LEFT);
-#endif
+    // Backup GL state: a copy of the shadow, free
+    const GlState last_state = GlStateGet();
+    bool clip_origin_lower_left = (last_state.clip_origin == GL_LOWER_LEFT); // Support for GL 4.5's glClipControl(GL_UPPER_LEFT)
 
     // Setup render state: alpha-blending enabled, no face culling, no depth testing, scissor enabled, polygon fill
-    glEnable(GL_BLEND);
-    glBlendEquation(GL_FUNC_ADD);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glDisable(GL_CULL_FACE);
-    glDisable(GL_DEPTH_TEST);
-    glEnable(GL_SCISSOR_TEST);
-#ifdef GL_POLYGON_MODE
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-#endif
+    GlStateActiveTexture(GL_TEXTURE0);
+    GlStateSetEnabled(GL_BLEND, true);
+    GlStateBlendEquationSeparate(GL_FUNC_ADD, GL_FUNC_ADD);
+    GlStateBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GlStateSetEnabled(GL_CULL_FACE, false);
+    GlStateSetEnabled(GL_DEPTH_TEST, false);
+    GlStateSetEnabled(GL_SCISSOR_TEST, true);
+    GlStatePolygonMode(GL_FILL);
 
     // Setup viewport, orthographic projection matrix
     // Our visible imgui space lies from draw_data->DisplayPos (top left) to draw_data->DisplayPos+data_data->DisplaySize (bottom right). DisplayMin is typically (0,0) for single viewport apps.
-    glViewport(0, 0, (GLsizei)fb_width, (GLsizei)fb_height);
+    GlStateViewport(0, 0, (GLsizei)fb_width, (GLsizei)fb_height);
     float L = draw_data->DisplayPos.x;
     float R = draw_data->DisplayPos.x + draw_data->DisplaySize.x;
     float T = draw_data->DisplayPos.y;
     float B = draw_data->DisplayPos.y + draw_data->DisplaySize.y;
+#ifdef IMGUI_USE_COMPACT_DRAWVERT
+    const float S = 1.0f / IM_DRAWVERT_POS_SCALE;  // Fixed-point positions, converted by the projection
+#else
+    const float S = 1.0f;
+#endif
     const float ortho_projection[4][4] =
     {
-        { 2.0f/(R-L),   0.0f,         0.0f,   0.0f },
-        { 0.0f,         2.0f/(T-B),   0.0f,   0.0f },
+        { S*2.0f/(R-L), 0.0f,         0.0f,   0.0f },
+        { 0.0f,         S*2.0f/(T-B), 0.0f,   0.0f },
         { 0.0f,         0.0f,        -1.0f,   0.0f },
         { (R+L)/(L-R),  (T+B)/(B-T),  0.0f,   1.0f },
     };
-    glUseProgram(g_ShaderHandle);
+    GlStateUseProgram(g_ShaderHandle);
     glUniform1i(g_AttribLocationTex, 0);
     glUniformMatrix4fv(g_AttribLocationProjMtx, 1, GL_FALSE, &ortho_projection[0][0]);
-#ifdef GL_SAMPLER_BINDING
-    glBindSampler(0, 0); // We use combined texture/sampler state. Applications using GL 3.3 may set that otherwise.
+    GlStateBindSampler(0, 0); // We use combined texture/sampler state. Applications using GL 3.3 may set that otherwise.
+    bool sdf_uniforms_set = false;
+
+    // Glyphs rasterized on demand since the last frame (ImFontAtlasFlags_DynamicGlyphs): upload only the part of the atlas they changed
+    int dirty_x, dirty_y, dirty_w, dirty_h;
+    if (g_FontTexture && io.Fonts->TexPixelsRGBA32 && io.Fonts->TakeTexDirtyRect(&dirty_x, &dirty_y, &dirty_w, &dirty_h))
+    {
+        GlStateBindTexture2D(g_FontTexture);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, io.Fonts->TexWidth);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, dirty_x, dirty_y, dirty_w, dirty_h, GL_RGBA, GL_UNSIGNED_BYTE, io.Fonts->TexPixelsRGBA32 + dirty_x + dirty_y * io.Fonts->TexWidth);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
+
+    // Upload the whole frame at once, before the VAO below picks up the (possibly recreated) buffers
+#ifdef IMGUI_IMPL_OPENGL_RING_BUFFER
+    const bool use_ring = g_RingMode != RingMode_None;
+    if (use_ring)
+        ImGui_ImplOpenGL3_UploadToRing(draw_data);
+#else
+    const bool use_ring = false;
 #endif
+
     // Recreate the VAO every time
     // (This is to easily allow multiple GL contexts. VAO are not shared among GL contexts, and we don't track creation/deletion of windows so we don't have an obvious key to use to cache them.)
     GLuint vao_handle = 0;
     glGenVertexArrays(1, &vao_handle);
-    glBindVertexArray(vao_handle);
-    glBindBuffer(GL_ARRAY_BUFFER, g_VboHandle);
+    GlStateBindVertexArray(vao_handle);
+    GlStateBindBuffer(GL_ARRAY_BUFFER, g_VboHandle);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_ElementsHandle); // Part of the VAO, not of the state cache
     glEnableVertexAttribArray(g_AttribLocationPosition);
     glEnableVertexAttribArray(g_AttribLocationUV);
     glEnableVertexAttribArray(g_AttribLocationColor);
+#ifdef IMGUI_USE_COMPACT_DRAWVERT
+    glVertexAttribPointer(g_AttribLocationPosition, 2, GL_SHORT, GL_FALSE, sizeof(ImDrawVert), (GLvoid*)IM_OFFSETOF(ImDrawVert, pos));
+    glVertexAttribPointer(g_AttribLocationUV, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(ImDrawVert), (GLvoid*)IM_OFFSETOF(ImDrawVert, uv));
+#else
     glVertexAttribPointer(g_AttribLocationPosition, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (GLvoid*)IM_OFFSETOF(ImDrawVert, pos));
     glVertexAttribPointer(g_AttribLocationUV, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (GLvoid*)IM_OFFSETOF(ImDrawVert, uv));
+#endif
     glVertexAttribPointer(g_AttribLocationColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ImDrawVert), (GLvoid*)IM_OFFSETOF(ImDrawVert, col));
 
     // Draw
     ImVec2 pos = draw_data->DisplayPos;
+    ImVec2 scale = io.DisplayFramebufferScale;  // Applied here rather than with ScaleClipRects(), which would change lists a renderer may keep
     for (int n = 0; n < draw_data->CmdListsCount; n++)
     {
         const ImDrawList* cmd_list = draw_data->CmdLists[n];
-        const ImDrawIdx* idx_buffer_offset = 0;
-
-        glBindBuffer(GL_ARRAY_BUFFER, g_VboHandle);
-        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)cmd_list->VtxBuffer.Size * sizeof(ImDrawVert), (const GLvoid*)cmd_list->VtxBuffer.Data, GL_STREAM_DRAW);
+        int vtx_list_first = 0, idx_list_first = 0;
+#ifdef IMGUI_IMPL_OPENGL_RING_BUFFER
+        if (use_ring)
+        {
+            vtx_list_first = g_RingListVtxFirst[n];
+            idx_list_first = g_RingListIdxFirst[n];
+        }
+#endif
+        const ImDrawIdx* idx_buffer_offset = (const ImDrawIdx*)0 + idx_list_first;
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_ElementsHandle);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx), (const GLvoid*)cmd_list->IdxBuffer.Data, GL_STREAM_DRAW);
+        if (!use_ring)
+        {
+            glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)cmd_list->VtxBuffer.Size * sizeof(ImDrawVert), (const GLvoid*)cmd_list->VtxBuffer.Data, GL_STREAM_DRAW);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx), (const GLvoid*)cmd_list->IdxBuffer.Data, GL_STREAM_DRAW);
+        }
 
         for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
         {
@@ -236,45 +503,52 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
             }
             else
             {
-                ImVec4 clip_rect = ImVec4(pcmd->ClipRect.x - pos.x, pcmd->ClipRect.y - pos.y, pcmd->ClipRect.z - pos.x, pcmd->ClipRect.w - pos.y);
+                ImVec4 clip_rect = ImVec4((pcmd->ClipRect.x - pos.x) * scale.x, (pcmd->ClipRect.y - pos.y) * scale.y, (pcmd->ClipRect.z - pos.x) * scale.x, (pcmd->ClipRect.w - pos.y) * scale.y);
                 if (clip_rect.x < fb_width && clip_rect.y < fb_height && clip_rect.z >= 0.0f && clip_rect.w >= 0.0f)
                 {
                     // Apply scissor/clipping rectangle
                     if (clip_origin_lower_left)
-                        glScissor((int)clip_rect.x, (int)(fb_height - clip_rect.w), (int)(clip_rect.z - clip_rect.x), (int)(clip_rect.w - clip_rect.y));
+                        GlStateScissor((int)clip_rect.x, (int)(fb_height - clip_rect.w), (int)(clip_rect.z - clip_rect.x), (int)(clip_rect.w - clip_rect.y));
                     else
-                        glScissor((int)clip_rect.x, (int)clip_rect.y, (int)clip_rect.z, (int)clip_rect.w); // Support for GL 4.5's glClipControl(GL_UPPER_LEFT)
+                        GlStateScissor((int)clip_rect.x, (int)clip_rect.y, (int)clip_rect.z, (int)clip_rect.w); // Support for GL 4.5's glClipControl(GL_UPPER_LEFT)
+
+                    // Distance field fonts sample the font texture through their own program
+                    const bool sdf = pcmd->DistanceField;
+                    GlStateUseProgram(sdf ? g_SdfShaderHandle : g_ShaderHandle);
+                    if (sdf && !sdf_uniforms_set)
+                    {
+                        glUniform1i(g_SdfAttribLocationTex, 0);
+                        glUniformMatrix4fv(g_SdfAttribLocationProjMtx, 1, GL_FALSE, &ortho_projection[0][0]);
+                        sdf_uniforms_set = true;
+                    }
 
                     // Bind texture, Draw
-                    glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)pcmd->TextureId);
+                    GlStateBindTexture2D((GLuint)(intptr_t)pcmd->TextureId);
+#ifdef IMGUI_IMPL_OPENGL_RING_BUFFER
+                    if (use_ring)
+                        glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, idx_buffer_offset, (GLint)vtx_list_first);
+                    else
+#endif
                     glDrawElements(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, idx_buffer_offset);
                 }
             }
             idx_buffer_offset += pcmd->ElemCount;
         }
     }
-    glDeleteVertexArrays(1, &vao_handle);
+    GlStateDeleteVertexArrays(1, &vao_handle);
 
-    // Restore modified GL state
-    glUseProgram(last_program);
-    glBindTexture(GL_TEXTURE_2D, last_texture);
-#ifdef GL_SAMPLER_BINDING
-    glBindSampler(0, last_sampler);
-#endif
-    glActiveTexture(last_active_texture);
-    glBindVertexArray(last_vertex_array);
-    glBindBuffer(GL_ARRAY_BUFFER, last_array_buffer);
-    glBlendEquationSeparate(last_blend_equation_rgb, last_blend_equation_alpha);
-    glBlendFuncSeparate(last_blend_src_rgb, last_blend_dst_rgb, last_blend_src_alpha, last_blend_dst_alpha);
-    if (last_enable_blend) glEnable(GL_BLEND); else glDisable(GL_BLEND);
-    if (last_enable_cull_face) glEnable(GL_CULL_FACE); else glDisable(GL_CULL_FACE);
-    if (last_enable_depth_test) glEnable(GL_DEPTH_TEST); else glDisable(GL_DEPTH_TEST);
-    if (last_enable_scissor_test) glEnable(GL_SCISSOR_TEST); else glDisable(GL_SCISSOR_TEST);
-#ifdef GL_POLYGON_MODE
-    glPolygonMode(GL_FRONT_AND_BACK, (GLenum)last_polygon_mode[0]);
+#ifdef IMGUI_IMPL_OPENGL_RING_BUFFER
+    // The segment is free again once the GPU passes this point
+    if (use_ring)
+    {
+        const int segment = g_RingFrame % IMGUI_IMPL_OPENGL_RING_FRAMES;
+        g_RingFences[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        g_RingFrame++;
+    }
 #endif
-    glViewport(last_viewport[0], last_viewport[1], (GLsizei)last_viewport[2], (GLsizei)last_viewport[3]);
-    glScissor(last_scissor_box[0], last_scissor_box[1], (GLsizei)last_scissor_box[2], (GLsizei)last_scissor_box[3]);
+
+    // Restore modified GL state, only what actually changed
+    GlStateSet(last_state);
 }
 
 bool ImGui_ImplOpenGL3_CreateFontsTexture()
@@ -285,11 +559,11 @@ bool ImGui_ImplOpenGL3_CreateFontsTexture()
     int width, height;
     io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);   // Load as RGBA 32-bits (75% of the memory is wasted, but default font is so small) because it is more likely to be compatible with user's existing shaders. If your ImTextureId represent a higher-level concept than just a GL texture id, consider calling GetTexDataAsAlpha8() instead to save on GPU memory.
 
-    // Upload texture to graphics system
-    GLint last_texture;
-    glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
+    // Upload texture to graphics system. On unit 0: the shadow state only tracks the bindings of the first few units.
+    const GlState last_state = GlStateGet();
+    GlStateActiveTexture(GL_TEXTURE0);
     glGenTextures(1, &g_FontTexture);
-    glBindTexture(GL_TEXTURE_2D, g_FontTexture);
+    GlStateBindTexture2D(g_FontTexture);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
@@ -299,7 +573,7 @@ bool ImGui_ImplOpenGL3_CreateFontsTexture()
     io.Fonts->TexID = (ImTextureID)(intptr_t)g_FontTexture;
 
     // Restore state
-    glBindTexture(GL_TEXTURE_2D, last_texture);
+    GlStateSet(last_state);
 
     return true;
 }
@@ -309,7 +583,7 @@ void ImGui_ImplOpenGL3_DestroyFontsTexture()
     if (g_FontTexture)
     {
         ImGuiIO& io = ImGui::GetIO();
-        glDeleteTextures(1, &g_FontTexture);
+        GlStateDeleteTextures(1, &g_FontTexture);
         io.Fonts->TexID = 0;
         g_FontTexture = 0;
     }
@@ -351,13 +625,67 @@ static bool CheckProgram(GLuint handle, const char* desc)
     return (GLboolean)status == GL_TRUE;
 }
 
+static GLuint ImGui_ImplOpenGL3_CompileShader(GLenum type, const GLchar* source, const char* desc)
+{
+    const GLchar* source_with_version[2] = { g_GlslVersionString, source };
+    GLuint handle = glCreateShader(type);
+    glShaderSource(handle, 2, source_with_version, NULL);
+    glCompileShader(handle);
+    CheckShader(handle, desc);
+    return handle;
+}
+
+// Both programs get the same attribute locations, so one vertex array setup serves them
+static GLuint ImGui_ImplOpenGL3_LinkProgram(GLuint vert_handle, GLuint frag_handle, const char* desc)
+{
+    GLuint handle = glCreateProgram();
+    glAttachShader(handle, vert_handle);
+    glAttachShader(handle, frag_handle);
+    glBindAttribLocation(handle, 0, "Position");
+    glBindAttribLocation(handle, 1, "UV");
+    glBindAttribLocation(handle, 2, "Color");
+    glLinkProgram(handle);
+    CheckProgram(handle, desc);
+    return handle;
+}
+
+static GLuint ImGui_ImplOpenGL3_CreateProgramWithFn(const GLchar* vertex_shader, const GLchar* fragment_shader)
+{
+    ImVector<char> vertex_source, fragment_source;
+    const int version_len = (int)strlen(g_GlslVersionString);
+    vertex_source.resize(version_len + (int)strlen(vertex_shader) + 1);
+    fragment_source.resize(version_len + (int)strlen(fragment_shader) + 1);
+    strcpy(vertex_source.Data, g_GlslVersionString);
+    strcpy(vertex_source.Data + version_len, vertex_shader);
+    strcpy(fragment_source.Data, g_GlslVersionString);
+    strcpy(fragment_source.Data + version_len, fragment_shader);
+    return g_CreateProgramFn(vertex_source.Data, fragment_source.Data);
+}
+
+static void ImGui_ImplOpenGL3_DeleteProgram(GLuint handle, bool from_fn)
+{
+    if (from_fn && g_DeleteProgramFn != NULL)
+        g_DeleteProgramFn(handle);
+    else
+        glDeleteProgram(handle);
+}
+
+#ifdef IMGUI_IMPL_OPENGL_RING_BUFFER
+static bool ImGui_ImplOpenGL3_HasExtension(const char* name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; i++)
+        if (strcmp((const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i), name) == 0)
+            return true;
+    return false;
+}
+#endif
+
 bool    ImGui_ImplOpenGL3_CreateDeviceObjects()
 {
     // Backup GL state
-    GLint last_texture, last_array_buffer, last_vertex_array;
-    glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
-    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &last_array_buffer);
-    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &last_vertex_array);
+    const GlState last_state = GlStateGet();
 
     // Parse GLSL version string
     int glsl_version = 130;
@@ -463,76 +791,178 @@ bool    ImGui_ImplOpenGL3_CreateDeviceObjects()
         "    Out_Color = Frag_Color * texture(Texture, Frag_UV.st);\n"
         "}\n";
 
+    // Distance field fonts: the outline is at 0.5 in the alpha channel, antialiased over about one screen pixel whatever the scale.
+    // The white pixel and anything else fully opaque stays opaque.
+    const GLchar* fragment_shader_sdf_glsl_120 =
+        "#ifdef GL_ES\n"
+        "    #extension GL_OES_standard_derivatives : enable\n"
+        "    precision mediump float;\n"
+        "#endif\n"
+        "uniform sampler2D Texture;\n"
+        "varying vec2 Frag_UV;\n"
+        "varying vec4 Frag_Color;\n"
+        "void main()\n"
+        "{\n"
+        "    float dist = texture2D(Texture, Frag_UV.st).a;\n"
+        "    float width = max(fwidth(dist) * 0.5, 1.0 / 512.0);\n"
+        "    gl_FragColor = vec4(Frag_Color.rgb, Frag_Color.a * smoothstep(0.5 - width, 0.5 + width, dist));\n"
+        "}\n";
+
+    const GLchar* fragment_shader_sdf_glsl_130 =
+        "uniform sampler2D Texture;\n"
+        "in vec2 Frag_UV;\n"
+        "in vec4 Frag_Color;\n"
+        "out vec4 Out_Color;\n"
+        "void main()\n"
+        "{\n"
+        "    float dist = texture(Texture, Frag_UV.st).a;\n"
+        "    float width = max(fwidth(dist) * 0.5, 1.0 / 512.0);\n"
+        "    Out_Color = vec4(Frag_Color.rgb, Frag_Color.a * smoothstep(0.5 - width, 0.5 + width, dist));\n"
+        "}\n";
+
+    const GLchar* fragment_shader_sdf_glsl_300_es =
+        "precision mediump float;\n"
+        "uniform sampler2D Texture;\n"
+        "in vec2 Frag_UV;\n"
+        "in vec4 Frag_Color;\n"
+        "layout (location = 0) out vec4 Out_Color;\n"
+        "void main()\n"
+        "{\n"
+        "    float dist = texture(Texture, Frag_UV.st).a;\n"
+        "    float width = max(fwidth(dist) * 0.5, 1.0 / 512.0);\n"
+        "    Out_Color = vec4(Frag_Color.rgb, Frag_Color.a * smoothstep(0.5 - width, 0.5 + width, dist));\n"
+        "}\n";
+
+    const GLchar* fragment_shader_sdf_glsl_410_core =
+        "in vec2 Frag_UV;\n"
+        "in vec4 Frag_Color;\n"
+        "uniform sampler2D Texture;\n"
+        "layout (location = 0) out vec4 Out_Color;\n"
+        "void main()\n"
+        "{\n"
+        "    float dist = texture(Texture, Frag_UV.st).a;\n"
+        "    float width = max(fwidth(dist) * 0.5, 1.0 / 512.0);\n"
+        "    Out_Color = vec4(Frag_Color.rgb, Frag_Color.a * smoothstep(0.5 - width, 0.5 + width, dist));\n"
+        "}\n";
+
     // Select shaders matching our GLSL versions
     const GLchar* vertex_shader = NULL;
     const GLchar* fragment_shader = NULL;
+    const GLchar* fragment_shader_sdf = NULL;
     if (glsl_version < 130)
     {
         vertex_shader = vertex_shader_glsl_120;
         fragment_shader = fragment_shader_glsl_120;
+        fragment_shader_sdf = fragment_shader_sdf_glsl_120;
     }
     else if (glsl_version == 410)
     {
         vertex_shader = vertex_shader_glsl_410_core;
         fragment_shader = fragment_shader_glsl_410_core;
+        fragment_shader_sdf = fragment_shader_sdf_glsl_410_core;
     }
     else if (glsl_version == 300)
     {
         vertex_shader = vertex_shader_glsl_300_es;
         fragment_shader = fragment_shader_glsl_300_es;
+        fragment_shader_sdf = fragment_shader_sdf_glsl_300_es;
     }
     else
     {
         vertex_shader = vertex_shader_glsl_130;
         fragment_shader = fragment_shader_glsl_130;
+        fragment_shader_sdf = fragment_shader_sdf_glsl_130;
     }
 
-    // Create shaders
-    const GLchar* vertex_shader_with_version[2] = { g_GlslVersionString, vertex_shader };
-    g_VertHandle = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(g_VertHandle, 2, vertex_shader_with_version, NULL);
-    glCompileShader(g_VertHandle);
-    CheckShader(g_VertHandle, "vertex shader");
-
-    const GLchar* fragment_shader_with_version[2] = { g_GlslVersionString, fragment_shader };
-    g_FragHandle = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(g_FragHandle, 2, fragment_shader_with_version, NULL);
-    glCompileShader(g_FragHandle);
-    CheckShader(g_FragHandle, "fragment shader");
-
-    g_ShaderHandle = glCreateProgram();
-    glAttachShader(g_ShaderHandle, g_VertHandle);
-    glAttachShader(g_ShaderHandle, g_FragHandle);
-    glLinkProgram(g_ShaderHandle);
-    CheckProgram(g_ShaderHandle, "shader program");
+    // Create shaders. The programs from g_CreateProgramFn may still be linking, they are checked once the font atlas is built.
+    if (g_CreateProgramFn != NULL)
+    {
+        g_ShaderHandle = ImGui_ImplOpenGL3_CreateProgramWithFn(vertex_shader, fragment_shader);
+        g_SdfShaderHandle = ImGui_ImplOpenGL3_CreateProgramWithFn(vertex_shader, fragment_shader_sdf);
+        g_ShaderFromFn = g_ShaderHandle != 0;
+        g_SdfShaderFromFn = g_SdfShaderHandle != 0;
+    }
+
+    // Create buffers
+#ifdef IMGUI_IMPL_OPENGL_RING_BUFFER
+    GLint gl_major = 0, gl_minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &gl_major);
+    glGetIntegerv(GL_MINOR_VERSION, &gl_minor);
+    const int gl_version = gl_major * 100 + gl_minor * 10;
+    if (gl_version >= 440 || ImGui_ImplOpenGL3_HasExtension("GL_ARB_buffer_storage"))
+        g_RingMode = RingMode_Persistent;
+    else if (gl_version >= 320)
+        g_RingMode = RingMode_MapUnsynchronized;
+    else
+        g_RingMode = RingMode_None;
+    if (g_RingMode != RingMode_None)
+        ImGui_ImplOpenGL3_CreateRingBuffers(1 << 14, 1 << 15);
+    else
+#endif
+    {
+        glGenBuffers(1, &g_VboHandle);
+        glGenBuffers(1, &g_ElementsHandle);
+    }
+
+    // Build the font atlas before querying the programs, which waits for the link: a driver compiling
+    // in the background gets to do that while we rasterize glyphs.
+    ImGui_ImplOpenGL3_CreateFontsTexture();
+
+    // A program that failed to link or load goes back where it came from, and we compile our own
+    if (g_ShaderFromFn && !CheckProgram(g_ShaderHandle, "shader program"))
+    {
+        ImGui_ImplOpenGL3_DeleteProgram(g_ShaderHandle, true);
+        g_ShaderHandle = 0;
+        g_ShaderFromFn = false;
+    }
+    if (g_SdfShaderFromFn && !CheckProgram(g_SdfShaderHandle, "distance field shader program"))
+    {
+        ImGui_ImplOpenGL3_DeleteProgram(g_SdfShaderHandle, true);
+        g_SdfShaderHandle = 0;
+        g_SdfShaderFromFn = false;
+    }
+
+    if (g_ShaderHandle == 0)
+    {
+        g_VertHandle = ImGui_ImplOpenGL3_CompileShader(GL_VERTEX_SHADER, vertex_shader, "vertex shader");
+        g_FragHandle = ImGui_ImplOpenGL3_CompileShader(GL_FRAGMENT_SHADER, fragment_shader, "fragment shader");
+        g_ShaderHandle = ImGui_ImplOpenGL3_LinkProgram(g_VertHandle, g_FragHandle, "shader program");
+    }
+
+    if (g_SdfShaderHandle == 0)
+    {
+        if (g_VertHandle == 0)
+            g_VertHandle = ImGui_ImplOpenGL3_CompileShader(GL_VERTEX_SHADER, vertex_shader, "vertex shader");
+        g_SdfFragHandle = ImGui_ImplOpenGL3_CompileShader(GL_FRAGMENT_SHADER, fragment_shader_sdf, "distance field fragment shader");
+        g_SdfShaderHandle = ImGui_ImplOpenGL3_LinkProgram(g_VertHandle, g_SdfFragHandle, "distance field shader program");
+    }
 
     g_AttribLocationTex = glGetUniformLocation(g_ShaderHandle, "Texture");
     g_AttribLocationProjMtx = glGetUniformLocation(g_ShaderHandle, "ProjMtx");
     g_AttribLocationPosition = glGetAttribLocation(g_ShaderHandle, "Position");
     g_AttribLocationUV = glGetAttribLocation(g_ShaderHandle, "UV");
     g_AttribLocationColor = glGetAttribLocation(g_ShaderHandle, "Color");
-
-    // Create buffers
-    glGenBuffers(1, &g_VboHandle);
-    glGenBuffers(1, &g_ElementsHandle);
-
-    ImGui_ImplOpenGL3_CreateFontsTexture();
+    g_SdfAttribLocationTex = glGetUniformLocation(g_SdfShaderHandle, "Texture");
+    g_SdfAttribLocationProjMtx = glGetUniformLocation(g_SdfShaderHandle, "ProjMtx");
+    IM_ASSERT(glGetAttribLocation(g_SdfShaderHandle, "Position") == g_AttribLocationPosition);
 
     // Restore modified GL state
-    glBindTexture(GL_TEXTURE_2D, last_texture);
-    glBindBuffer(GL_ARRAY_BUFFER, last_array_buffer);
-    glBindVertexArray(last_vertex_array);
+    GlStateSet(last_state);
 
     return true;
 }
 
 void    ImGui_ImplOpenGL3_DestroyDeviceObjects()
 {
-    if (g_VboHandle) glDeleteBuffers(1, &g_VboHandle);
-    if (g_ElementsHandle) glDeleteBuffers(1, &g_ElementsHandle);
+#ifdef IMGUI_IMPL_OPENGL_RING_BUFFER
+    ImGui_ImplOpenGL3_DestroyRingBuffers();
+#endif
+    if (g_VboHandle) GlStateDeleteBuffers(1, &g_VboHandle);
+    if (g_ElementsHandle) GlStateDeleteBuffers(1, &g_ElementsHandle);
     g_VboHandle = g_ElementsHandle = 0;
 
-    if (g_ShaderHandle && g_VertHandle) glDetachShader(g_ShaderHandle, g_VertHandle);
+    if (g_ShaderHandle && g_VertHandle && g_FragHandle) glDetachShader(g_ShaderHandle, g_VertHandle);
+    if (g_SdfShaderHandle && g_VertHandle && g_SdfFragHandle) glDetachShader(g_SdfShaderHandle, g_VertHandle);
     if (g_VertHandle) glDeleteShader(g_VertHandle);
     g_VertHandle = 0;
 
@@ -540,8 +970,14 @@ void    ImGui_ImplOpenGL3_DestroyDeviceObjects()
     if (g_FragHandle) glDeleteShader(g_FragHandle);
     g_FragHandle = 0;
 
-    if (g_ShaderHandle) glDeleteProgram(g_ShaderHandle);
-    g_ShaderHandle = 0;
+    if (g_SdfShaderHandle && g_SdfFragHandle) glDetachShader(g_SdfShaderHandle, g_SdfFragHandle);
+    if (g_SdfFragHandle) glDeleteShader(g_SdfFragHandle);
+    g_SdfFragHandle = 0;
+
+    if (g_ShaderHandle) ImGui_ImplOpenGL3_DeleteProgram(g_ShaderHandle, g_ShaderFromFn);
+    if (g_SdfShaderHandle) ImGui_ImplOpenGL3_DeleteProgram(g_SdfShaderHandle, g_SdfShaderFromFn);
+    g_ShaderHandle = g_SdfShaderHandle = 0;
+    g_ShaderFromFn = g_SdfShaderFromFn = false;
 
     ImGui_ImplOpenGL3_DestroyFontsTexture();
 }
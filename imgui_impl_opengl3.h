@@ -39,3 +39,12 @@ IMGUI_IMPL_API bool     ImGui_ImplOpenGL3_CreateFontsTexture();
 IMGUI_IMPL_API void     ImGui_ImplOpenGL3_DestroyFontsTexture();
 IMGUI_IMPL_API bool     ImGui_ImplOpenGL3_CreateDeviceObjects();
 IMGUI_IMPL_API void     ImGui_ImplOpenGL3_DestroyDeviceObjects();
+
+// Optional: create the shader programs yourself, e.g. through a program binary cache. Called by CreateDeviceObjects(), once for
+// the regular program and once for the distance field fonts' one. The sources are complete, including the #version line.
+// Bind the attributes "Position", "UV" and "Color" to locations 0, 1 and 2 so both programs share the vertex layout.
+// The program may still be linking when this returns. Return 0 to let the binding compile the shaders itself; a program that
+// fails to link is handed back to delete_fn and the binding compiles its own. delete_fn also gets them at DestroyDeviceObjects().
+typedef unsigned int    (*ImGui_ImplOpenGL3_CreateProgramFn)(const char* vertex_shader, const char* fragment_shader);
+typedef void            (*ImGui_ImplOpenGL3_DeleteProgramFn)(unsigned int program);
+IMGUI_IMPL_API void     ImGui_ImplOpenGL3_SetCreateProgramFn(ImGui_ImplOpenGL3_CreateProgramFn create_fn, ImGui_ImplOpenGL3_DeleteProgramFn delete_fn);
@@ -2,6 +2,10 @@
 
 #include <SDL.h>
 #include "imgui.h"
+#include "jake_file_watch.h"
+#include "jake_frame_pacer.h"
+#include "jake_simulation.h"
+#include "jake_text_viewer.h"
 
 #define SDL_CHECK_ZERO_FATAL(CODE) {                                    \
     int result = (CODE);                                                \
@@ -33,15 +37,15 @@ const int DEFAULT_WINDOW_WIDTH = 1280;
 const int DEFAULT_WINDOW_HEIGHT = 720;
 
 struct GameDebugInfo {
-  float actual_delay_s;
-  ulong actual_delay_perf;
   float framerate;
   float frame_length;
-  float imgui_draw_time_s;
-  ulong imgui_draw_time_perf;
+  FramePacerStats pacing;
 };
 struct GameUI {
   bool show_demo_window = true;
+  bool show_profiler_window = true;
+  bool show_gpu_timer_window = true;
+  bool show_log_window = false;
   ImVec4 clear_color = ImVec4(0.05f, 0.35f, 0.60f, 1.00f);
 };
 struct GameWorld {
@@ -51,5 +55,15 @@ struct GameWorld {
   bool do_run = true;
 
   int target_framerate = 60;
-  int frame_delay = 10;
+  FramePacer pacer;
+  FixedTimestep timestep;
+
+  Multiverse multiverse;
+  int universe_count = 4096;
+
+  // Shader sources, reloaded when saved
+  FileWatch shader_watch;
+
+  // SDL_Log output, from the world's creation on
+  TextViewer log;
 };
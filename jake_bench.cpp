@@ -0,0 +1,970 @@
+#include <SDL.h>
+#include "imgui.h"
+#include "imgui_internal.h"
+#include "jake.h"
+#include "jake_bench.h"
+#include "jake_fixtures.h"
+#include "jake_font_cache.h"
+#include "jake_jobs.h"
+#include "jake_profiler.h"
+#include "jake_text_viewer.h"
+
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Results go here so the compiler can't drop the work
+static volatile ImU32 hash_sink;
+
+static double TicksToNs(Uint64 ticks) {
+  return ticks * 1e9 / (double)SDL_GetPerformanceFrequency();
+}
+
+/**
+   A tool screen the way ours look: rows of widgets under PushID, tree
+   nodes, hidden labels and "###" ids, on top of the demo and the profiler.
+ */
+static void ShowToolScreen(int rows) {
+  ImGui::ShowDemoWindow();
+  ImGui::ShowMetricsWindow();
+  ShowProfilerWindow();
+
+  ImGui::SetNextWindowSize(ImVec2(600.0f, 600.0f));
+  ImGui::Begin("Universes###bench_tool");
+  static float values[4] = {};
+  for (int i = 0; i < rows; i++) {
+    ImGui::PushID(i);
+    if (ImGui::TreeNode("Universe", "Universe %d", i)) {
+      ImGui::SliderFloat("##velocity", &values[0], 0.0f, 1.0f);
+      ImGui::DragFloat2("Position", values);
+      ImGui::TreePop();
+    }
+    char label[64];
+    snprintf(label, sizeof(label), "Tick rate %d###tick_rate", i);
+    ImGui::Button(label);
+    ImGui::SameLine();
+    ImGui::Checkbox("Paused", (bool*)&values[3]);
+    ImGui::PopID();
+  }
+  ImGui::End();
+}
+
+// What ImHash() was asked to hash during real frames
+struct HashSample {
+  int offset;     // into HashCorpus::bytes, zero-terminated there
+  int size;
+  ImU32 seed;
+  bool is_string;   // no zero bytes, can also go through ImHash(str, 0)
+};
+
+struct HashCorpus {
+  std::vector<char> bytes;
+  std::vector<HashSample> samples;
+};
+
+static HashCorpus* recording = NULL;
+
+static ImU32 RecordHash(const void* data, int data_size, ImU32 seed) {
+  HashSample sample = {(int)recording->bytes.size(), data_size, seed,
+                       data_size > 0 && memchr(data, '\0', data_size) == NULL};
+  recording->bytes.insert(recording->bytes.end(), (const char*)data, (const char*)data + data_size);
+  recording->bytes.push_back('\0');
+  recording->samples.push_back(sample);
+  return ImHashCrc32Table(data, data_size, seed);
+}
+
+static void RecordHashCorpus(HashCorpus& corpus) {
+  CreateFixtureContext();
+  recording = &corpus;
+  ImHashSetFunction(RecordHash);
+  for (int frame = 0; frame < 3; frame++) {
+    ImGui::NewFrame();
+    ShowToolScreen(2000);
+    ImGui::Render();
+  }
+  ImHashSetFunction(NULL);
+  recording = NULL;
+  ImGui::DestroyContext();
+}
+
+struct HashCandidate {
+  const char* name;
+  ImHashFunction fn;
+};
+
+static int RunHashBenchmark() {
+  HashCorpus corpus;
+  RecordHashCorpus(corpus);
+  size_t total_bytes = 0, strings = 0;
+  for (const HashSample& sample : corpus.samples) {
+    total_bytes += sample.size;
+    strings += sample.is_string;
+  }
+  printf("corpus: %d hashes over 3 frames, %.1f bytes on average, %d usable as strings\n",
+         (int)corpus.samples.size(), (double)total_bytes / corpus.samples.size(), (int)strings);
+
+  const HashCandidate candidates[] = {
+    {"ImHashCrc32Table", ImHashCrc32Table},
+    {ImHashCrc32cSupported() ? "ImHashCrc32c (SSE4.2)" : "ImHashCrc32c (table)", ImHashCrc32c},
+    {"ImHashWords", ImHashWords},
+  };
+  const int REPEATS = 20;
+
+  printf("%-24s %12s %14s %10s %11s\n", "function", "ns/hash", "ns/string+###", "MB/s", "collisions");
+  for (const HashCandidate& candidate : candidates) {
+    // Known sizes, straight to the function
+    ImU32 sink = 0;
+    Uint64 begin = SDL_GetPerformanceCounter();
+    for (int repeat = 0; repeat < REPEATS; repeat++)
+      for (const HashSample& sample : corpus.samples)
+        sink += candidate.fn(&corpus.bytes[sample.offset], sample.size, sample.seed);
+    double bytes_ns = TicksToNs(SDL_GetPerformanceCounter() - begin);
+
+    // Zero-terminated, the way labels come in: the "###" scan plus the function
+    ImHashSetFunction(candidate.fn);
+    begin = SDL_GetPerformanceCounter();
+    for (int repeat = 0; repeat < REPEATS; repeat++)
+      for (const HashSample& sample : corpus.samples)
+        if (sample.is_string)
+          sink += ImHash(&corpus.bytes[sample.offset], 0, sample.seed);
+    double strings_ns = TicksToNs(SDL_GetPerformanceCounter() - begin);
+    ImHashSetFunction(NULL);
+
+    // Distinct inputs that ended up on the same ID
+    std::vector<std::string> inputs;
+    for (const HashSample& sample : corpus.samples) {
+      std::string input((const char*)&sample.seed, sizeof(sample.seed));
+      input.append(&corpus.bytes[sample.offset], sample.size);
+      inputs.push_back(input);
+    }
+    std::sort(inputs.begin(), inputs.end());
+    inputs.erase(std::unique(inputs.begin(), inputs.end()), inputs.end());
+    std::vector<ImU32> hashes;
+    for (const std::string& input : inputs) {
+      ImU32 seed;
+      memcpy(&seed, input.data(), sizeof(seed));
+      hashes.push_back(candidate.fn(input.data() + sizeof(seed), (int)input.size() - (int)sizeof(seed), seed));
+    }
+    std::sort(hashes.begin(), hashes.end());
+    int collisions = (int)(hashes.end() - std::unique(hashes.begin(), hashes.end()));
+
+    double hashes_done = (double)corpus.samples.size() * REPEATS;
+    hash_sink = sink;
+    printf("%-24s %12.2f %14.2f %10.1f %11d\n", candidate.name, bytes_ns / hashes_done,
+           strings_ns / (strings * (double)REPEATS), total_bytes * REPEATS / bytes_ns * 1e3, collisions);
+  }
+  printf("default: %s\n", ImHashGetDefaultFunction() == ImHashCrc32Table ? "ImHashCrc32Table"
+         : ImHashGetDefaultFunction() == ImHashCrc32c ? "ImHashCrc32c" : "ImHashWords");
+  return 0;
+}
+
+static int RunStorageBenchmark() {
+  printf("%-9s %12s %12s %12s %12s %10s\n", "keys", "insert ns", "hit ns", "miss ns", "ref ns", "bytes/key");
+  for (int count : {1000, 100000, 1000000}) {
+    std::vector<ImGuiID> keys(count), misses(count);
+    for (int i = 0; i < count; i++) {
+      keys[i] = StorageKey(i);
+      misses[i] = StorageKey(count + i);
+    }
+    // Look them up in another order than they went in
+    std::vector<ImGuiID> shuffled = keys;
+    Uint32 rng = 1;
+    for (int i = count - 1; i > 0; i--) {
+      rng = rng * 1664525u + 1013904223u;
+      std::swap(shuffled[i], shuffled[rng % (i + 1)]);
+    }
+    const int LOOKUPS = 2000000;
+    ImU32 sink = 0;
+
+    ImGuiStorage storage;
+    Uint64 begin = SDL_GetPerformanceCounter();
+    for (int i = 0; i < count; i++)
+      storage.SetInt(keys[i], i);
+    double insert_ns = TicksToNs(SDL_GetPerformanceCounter() - begin) / count;
+    begin = SDL_GetPerformanceCounter();
+    for (int i = 0; i < LOOKUPS; i++)
+      sink += storage.GetInt(shuffled[i % count], 0);
+    double hit_ns = TicksToNs(SDL_GetPerformanceCounter() - begin) / LOOKUPS;
+    begin = SDL_GetPerformanceCounter();
+    for (int i = 0; i < LOOKUPS; i++)
+      sink += storage.GetInt(misses[i % count], 0);
+    double miss_ns = TicksToNs(SDL_GetPerformanceCounter() - begin) / LOOKUPS;
+    begin = SDL_GetPerformanceCounter();
+    for (int i = 0; i < LOOKUPS; i++)
+      (*storage.GetIntRef(shuffled[i % count], 0))++;
+    double ref_ns = TicksToNs(SDL_GetPerformanceCounter() - begin) / LOOKUPS;
+    hash_sink = sink;
+
+    printf("%-9d %12.1f %12.1f %12.1f %12.1f %10.1f\n", count, insert_ns, hit_ns, miss_ns, ref_ns,
+           (double)storage.GetMemoryUsage() / count);
+  }
+  return 0;
+}
+
+static void BeginTextDrawList(ImDrawList& draw_list, const ImFont* font) {
+  draw_list.Clear();
+  draw_list.PushClipRectFullScreen();
+  draw_list.PushTextureID(font->ContainerAtlas->TexID);
+}
+
+static int RunTextBenchmark() {
+  CreateFixtureContext();
+  ImGui::NewFrame();
+  const ImFont* font = ImGui::GetFont();
+  ImDrawList draw_list(ImGui::GetDrawListSharedData());
+  // This one is about laying out glyphs, not about the cache skipping it
+  ImGui::GetCurrentContext()->TextCache.Enabled = false;
+
+  // A log pane: 60 lines of 100 characters or so, clipped to its window. Best of a few rounds, this box is noisy
+  const std::string log = MakeLogText(60, false);
+  const int ROUNDS = 7, REPEATS = 300;
+  printf("%-26s %12s\n", "case", "RenderText");
+  for (int fine_clip = 0; fine_clip < 2; fine_clip++) {
+    const ImVec4 clip_rect(8.0f, 8.0f, 600.0f, 712.0f);
+    double ns = 1e30;
+    for (int round = 0; round < ROUNDS; round++) {
+      Uint64 begin = SDL_GetPerformanceCounter();
+      for (int repeat = 0; repeat < REPEATS; repeat++) {
+        BeginTextDrawList(draw_list, font);
+        font->RenderText(&draw_list, 13.0f, ImVec2(10.0f, 10.0f), IM_COL32_WHITE, clip_rect, log.c_str(),
+                         log.c_str() + log.size(), 0.0f, fine_clip != 0);
+      }
+      ns = std::min(ns, TicksToNs(SDL_GetPerformanceCounter() - begin));
+    }
+
+    const double glyphs = (double)draw_list.VtxBuffer.Size / 4 * REPEATS;
+    printf("%-26s %9.2f ns\n", fine_clip ? "log pane, cpu fine clip" : "log pane", ns / glyphs);
+  }
+  printf("(per glyph drawn)\n");
+
+  ImGui::EndFrame();
+  ImGui::DestroyContext();
+  return 0;
+}
+
+struct TextCacheRun {
+  double ms_per_frame;
+  int hits, misses;
+};
+
+static TextCacheRun RunInspectorFrames(bool cache_enabled, const char* font_path, float font_size) {
+  CreateFixtureContext(font_path, font_size);
+  ImGuiContext& g = *ImGui::GetCurrentContext();
+  g.TextCache.Enabled = cache_enabled;
+  const int WARMUP = 5, FRAMES = 200;
+  TextCacheRun run = {};
+  Uint64 begin = 0;
+  for (int frame = 0; frame < WARMUP + FRAMES; frame++) {
+    if (frame == WARMUP)
+      begin = SDL_GetPerformanceCounter();
+    ImGui::NewFrame();
+    ShowInspectorScreen(frame);
+    ImGui::Render();
+  }
+  run.ms_per_frame = TicksToNs(SDL_GetPerformanceCounter() - begin) / FRAMES * 1e-6;
+  run.hits = g.TextCache.Hits;
+  run.misses = g.TextCache.Misses;
+  ImGui::DestroyContext();
+  return run;
+}
+
+static int RunTextCacheBenchmark() {
+  // The default font, then the one the app uses, which has fractional advances
+  const char* APP_FONT = "./imgui/misc/fonts/Cousine-Regular.ttf";
+  FILE* app_font = fopen(APP_FONT, "rb");
+  if (app_font != NULL)
+    fclose(app_font);
+  else
+    printf("%s not found, run from the repository root to include it\n", APP_FONT);
+
+  printf("%-24s %10s %10s %14s\n", "font", "cache off", "cache on", "hits/misses");
+  for (int font = 0; font < (app_font != NULL ? 2 : 1); font++) {
+    const char* path = font == 0 ? NULL : APP_FONT;
+    TextCacheRun off = RunInspectorFrames(false, path, 15.0f);
+    TextCacheRun on = RunInspectorFrames(true, path, 15.0f);
+    char hits[32];
+    snprintf(hits, sizeof(hits), "%d/%d", on.hits, on.misses);
+    printf("%-24s %7.3f ms %7.3f ms %14s\n", font == 0 ? "ProggyClean 13 (default)" : "Cousine 15 (app)",
+           off.ms_per_frame, on.ms_per_frame, hits);
+  }
+  return 0;
+}
+
+struct RetainedRun {
+  double ms_per_frame;
+  double retained_per_frame;
+  int version_changes;    // of the panels' draw lists, from one frame to the next
+};
+
+static RetainedRun RunDashboardFrames(bool versions) {
+  CreateFixtureContext();
+  ImGuiContext& g = *ImGui::GetCurrentContext();
+  const int WARMUP = 5, FRAMES = 400;
+  RetainedRun run = {};
+  std::unordered_map<const ImDrawList*, unsigned int> last_versions;
+  Uint64 ticks = 0;
+  int retained = 0;
+  for (int frame = 0; frame < WARMUP + FRAMES; frame++) {
+    Uint64 begin = SDL_GetPerformanceCounter();
+    ImGui::NewFrame();
+    ShowDashboardScreen(frame, versions);
+    ImGui::Render();
+    if (frame < WARMUP)
+      continue;
+    ticks += SDL_GetPerformanceCounter() - begin;
+
+    const ImDrawData* draw_data = ImGui::GetDrawData();
+    for (int n = 0; n < draw_data->CmdListsCount; n++) {
+      const ImDrawList* list = draw_data->CmdLists[n];
+      if (!IsDashboardPanel(*list))
+        continue;
+      auto last = last_versions.find(list);
+      run.version_changes += last != last_versions.end() && last->second != list->Version;
+      last_versions[list] = list->Version;
+    }
+    for (const ImGuiWindow* window : g.Windows)
+      retained += window->Retained;
+  }
+  run.ms_per_frame = TicksToNs(ticks) / FRAMES * 1e-6;
+  run.retained_per_frame = retained / (double)FRAMES;
+  ImGui::DestroyContext();
+  return run;
+}
+
+static int RunRetainedBenchmark() {
+  RetainedRun redrawn = RunDashboardFrames(false);
+  RetainedRun retained = RunDashboardFrames(true);
+
+  printf("16 panels updating every 50 frames, one live window\n");
+  printf("%-24s %12s %18s %16s\n", "", "ms/frame", "retained windows", "new versions");
+  printf("%-24s %9.3f ms %18.1f %16d\n", "redrawn every frame", redrawn.ms_per_frame, redrawn.retained_per_frame,
+         redrawn.version_changes);
+  printf("%-24s %9.3f ms %18.1f %16d\n", "content versions", retained.ms_per_frame, retained.retained_per_frame,
+         retained.version_changes);
+  return 0;
+}
+
+/**
+   A multi-megabyte log in an InputTextMultiline, the way our config and log
+   panes hold them, through the frames someone editing it goes through.
+ */
+struct InputTextPhase {
+  const char* name;
+  int frames;
+  double ms;
+};
+
+static int RunInputTextBenchmark() {
+  CreateFixtureContext();
+  ImGuiIO& io = ImGui::GetIO();
+  const ImGuiKey KEYS[] = {ImGuiKey_UpArrow, ImGuiKey_DownArrow, ImGuiKey_Home, ImGuiKey_End, ImGuiKey_Backspace, ImGuiKey_Enter};
+
+  // ASCII, so byte positions are character positions
+  const std::string text = MakeLogText(220000, false);
+  std::vector<char> buf(text.begin(), text.end());
+  buf.resize(text.size() + (1 << 20), 0);
+  const int lines = (int)std::count(text.begin(), text.end(), '\n') + 1;
+  int length = (int)text.size();
+
+  InputTextPhase phases[] = {
+    {"inactive", 60, 0.0},
+    {"focusing", 1, 0.0},
+    {"focused, idle", 60, 0.0},
+    {"typing at random lines", 300, 0.0},
+    {"moving up and down", 300, 0.0},
+  };
+  srand(1);
+  for (InputTextPhase& phase : phases) {
+    Uint64 ticks = 0;
+    for (int i = 0; i < phase.frames; i++) {
+      // SetKeyboardFocusHere() activates on the next frame, the focusing one
+      bool focus = &phase == &phases[0] && i == phase.frames - 1;
+      bool typing = &phase == &phases[3], moving = &phase == &phases[4];
+      if (typing) {
+        // Jump somewhere and type a character, a new line, or erase one
+        length += QueueInputTextEdit(i, rand() % length) == '\b' ? -1 : 1;
+      } else if (moving) {
+        const ImGuiKey MOVES[] = {ImGuiKey_DownArrow, ImGuiKey_UpArrow, ImGuiKey_End, ImGuiKey_Home};
+        io.KeyCtrl = i % 50 == 0;    // Now and then to the start or the end of the text
+        PressKey(MOVES[i / 10 % 4], true);
+      }
+
+      Uint64 begin = SDL_GetPerformanceCounter();
+      InputTextFrame(buf, focus);
+      ticks += SDL_GetPerformanceCounter() - begin;
+      for (ImGuiKey key : KEYS)
+        PressKey(key, false);
+      io.KeyCtrl = false;
+    }
+    phase.ms = TicksToNs(ticks) / phase.frames * 1e-6;
+  }
+  ImGui::DestroyContext();
+
+  printf("%.1f MB, %d lines\n", text.size() / (1024.0 * 1024.0), lines);
+  printf("%-24s %12s\n", "", "ms/frame");
+  for (const InputTextPhase& phase : phases)
+    printf("%-24s %9.3f ms\n", phase.name, phase.ms);
+  return 0;
+}
+
+/**
+   A validation log of a couple million lines, drawn whole with
+   TextUnformatted against the TextViewer: following the tail while lines
+   come in, and filtered.
+ */
+struct TextViewerPhase {
+  const char* name;
+  int frames;
+  double ms;
+};
+
+static void TextViewerFrame(TextViewer* viewer, const std::string& text) {
+  ImGui::NewFrame();
+  ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
+  ImGui::SetNextWindowSize(ImVec2((float)DEFAULT_WINDOW_WIDTH, (float)DEFAULT_WINDOW_HEIGHT));
+  ImGui::Begin("Log###bench_viewer");
+  if (viewer != NULL) {
+    ShowTextViewer(*viewer, "log");
+  } else {
+    ImGui::BeginChild("log", ImVec2(0.0f, 0.0f), true, ImGuiWindowFlags_HorizontalScrollbar);
+    ImGui::TextUnformatted(text.c_str(), text.c_str() + text.size());
+    ImGui::EndChild();
+  }
+  ImGui::End();
+  ImGui::Render();
+}
+
+static int RunTextViewerBenchmark() {
+  CreateFixtureContext();
+  JobSystemInit();
+
+  std::string text = MakeLogText(2000000, false);
+  const std::string new_lines = MakeLogText(100, false);
+
+  TextViewer viewer;
+  viewer.auto_scroll = false;
+  Uint64 begin = SDL_GetPerformanceCounter();
+  TextViewerAppend(viewer, text.c_str(), text.c_str() + text.size());
+  double index_ms = TicksToNs(SDL_GetPerformanceCounter() - begin) * 1e-6;
+
+  TextViewerPhase phases[] = {
+    {"TextUnformatted", 3, 0.0},
+    {"viewer, at the top", 60, 0.0},
+    {"viewer, following", 60, 0.0},
+    {"viewer, filtering", 0, 0.0},
+    {"viewer, filtered", 60, 0.0},
+  };
+  for (TextViewerPhase& phase : phases) {
+    bool following = &phase == &phases[2], filtering = &phase == &phases[3];
+    viewer.auto_scroll = following;
+    if (filtering)
+      TextViewerSetFilter(viewer, "WARN");
+
+    Uint64 ticks = 0;
+    for (int i = 0; filtering ? TextViewerIsFiltering(viewer) : i < phase.frames; i++) {
+      if (following) {
+        TextViewerAppend(viewer, new_lines.c_str());
+        text += new_lines;
+      }
+      Uint64 frame_begin = SDL_GetPerformanceCounter();
+      TextViewerFrame(&phase == &phases[0] ? NULL : &viewer, text);
+      ticks += SDL_GetPerformanceCounter() - frame_begin;
+      if (filtering)
+        phase.frames++;
+    }
+    phase.ms = TicksToNs(ticks) / phase.frames * 1e-6;
+  }
+  int threads = JobSystemThreadCount();
+
+  TextViewerClear(viewer);
+  JobSystemShutdown();
+  ImGui::DestroyContext();
+
+  printf("%.1f MB, %d lines indexed in %.1f ms, %d threads\n", text.size() / (1024.0 * 1024.0),
+         (int)std::count(text.begin(), text.end(), '\n'), index_ms, threads);
+  printf("%-24s %8s %12s\n", "", "frames", "ms/frame");
+  for (const TextViewerPhase& phase : phases)
+    printf("%-24s %8d %9.3f ms\n", phase.name, phase.frames, phase.ms);
+  return 0;
+}
+
+static int RunVariableClipperBenchmark() {
+  const int ROWS = 100000;
+  const float POSITIONS[] = {0.0f, 0.1f, 0.35f, 0.6f, 0.85f, 1.0f};
+
+  // Every row, every frame
+  // The content size is known from the second frame on
+  CreateFixtureContext();
+  ShowMixedList(ROWS, false, -1.0f);
+  float full_max_y = ShowMixedList(ROWS, false, -1.0f);
+  Uint64 full_ticks = 0;
+  for (int n = 0; n < IM_ARRAYSIZE(POSITIONS); n++) {
+    ShowMixedList(ROWS, false, POSITIONS[n] * full_max_y);
+    Uint64 begin = SDL_GetPerformanceCounter();
+    ShowMixedList(ROWS, false, -1.0f);
+    full_ticks += SDL_GetPerformanceCounter() - begin;
+  }
+  ImGui::DestroyContext();
+
+  // Clipped: a first pass down the list measures every row, then the same positions
+  CreateFixtureContext();
+  int first_pass_frames = 0;
+  Uint64 first_pass_ticks = 0;
+  ShowMixedList(ROWS, true, -1.0f);
+  float scroll_max_y = ShowMixedList(ROWS, true, -1.0f);
+  for (float y = 0.0f; y <= scroll_max_y + DEFAULT_WINDOW_HEIGHT; y += DEFAULT_WINDOW_HEIGHT * 0.5f) {
+    Uint64 begin = SDL_GetPerformanceCounter();
+    scroll_max_y = ShowMixedList(ROWS, true, y);
+    first_pass_ticks += SDL_GetPerformanceCounter() - begin;
+    first_pass_frames++;
+  }
+  ShowMixedList(ROWS, true, -1.0f);   // SetScrollY() lands on the next frame
+  Uint64 clipped_ticks = 0;
+  for (int n = 0; n < IM_ARRAYSIZE(POSITIONS); n++) {
+    ShowMixedList(ROWS, true, POSITIONS[n] * full_max_y);
+    Uint64 begin = SDL_GetPerformanceCounter();
+    ShowMixedList(ROWS, true, -1.0f);
+    clipped_ticks += SDL_GetPerformanceCounter() - begin;
+  }
+
+  // Jumping around, measured
+  const int JUMPS = 200;
+  srand(1);
+  Uint64 jump_ticks = 0;
+  for (int i = 0; i < JUMPS; i++) {
+    Uint64 begin = SDL_GetPerformanceCounter();
+    ShowMixedList(ROWS, true, (float)(rand() % 1000) / 1000.0f * full_max_y);
+    jump_ticks += SDL_GetPerformanceCounter() - begin;
+  }
+  ImGui::DestroyContext();
+
+  printf("%d rows of mixed heights, %.0f px of content\n", ROWS, full_max_y + DEFAULT_WINDOW_HEIGHT);
+  printf("%-28s %8s %12s\n", "", "frames", "ms/frame");
+  printf("%-28s %8d %9.3f ms\n", "every row", IM_ARRAYSIZE(POSITIONS), TicksToNs(full_ticks) / IM_ARRAYSIZE(POSITIONS) * 1e-6);
+  printf("%-28s %8d %9.3f ms\n", "clipped, first pass down", first_pass_frames, TicksToNs(first_pass_ticks) / first_pass_frames * 1e-6);
+  printf("%-28s %8d %9.3f ms\n", "clipped, measured", IM_ARRAYSIZE(POSITIONS), TicksToNs(clipped_ticks) / IM_ARRAYSIZE(POSITIONS) * 1e-6);
+  printf("%-28s %8d %9.3f ms\n", "clipped, jumping around", JUMPS, TicksToNs(jump_ticks) / JUMPS * 1e-6);
+  return 0;
+}
+
+static int RunPlotBenchmark() {
+  const int VALUES = 10000000;
+  const int WRAPPED = 2500000;    // pushed past capacity, so the plot starts mid-buffer
+  const int SPIKES = 8;
+  const float SPIKE = 100.0f;
+
+  // Frame times around 16 ms with a few single value spikes, which
+  // sampling one value per pixel would almost always miss
+  ImGuiPlotHistory history;
+  history.Init(VALUES);
+  std::vector<float> values(VALUES + WRAPPED);
+  srand(1);
+  for (float& v : values)
+    v = 16.0f + (float)(rand() % 1000) * 0.001f;
+  for (int i = 0; i < SPIKES; i++)
+    values[WRAPPED + (int)((double)rand() / RAND_MAX * (VALUES - 1))] = SPIKE;
+
+  history.Push(values.data(), VALUES);
+  Uint64 begin = SDL_GetPerformanceCounter();
+  for (int i = 0; i < VALUES / 10; i++)
+    history.Push(values[i]);
+  double push_ns = TicksToNs(SDL_GetPerformanceCounter() - begin) / (VALUES / 10);
+  begin = SDL_GetPerformanceCounter();
+  history.Push(values.data() + VALUES / 10, (int)values.size() - VALUES / 10);
+  double push_batch_ns = TicksToNs(SDL_GetPerformanceCounter() - begin) / (values.size() - VALUES / 10);
+
+  struct PlotCase {
+    const char* name;
+    PlotSource source;
+    ImGuiPlotType type;
+    int frames;
+  };
+  const PlotCase cases[] = {
+    {"lines, values_getter", PLOT_CALLBACK, ImGuiPlotType_Lines, 5},
+    {"lines, float array", PLOT_ARRAY, ImGuiPlotType_Lines, 20},
+    {"lines, ImGuiPlotHistory", PLOT_HISTORY, ImGuiPlotType_Lines, 200},
+    {"histogram, values_getter", PLOT_CALLBACK, ImGuiPlotType_Histogram, 5},
+    {"histogram, float array", PLOT_ARRAY, ImGuiPlotType_Histogram, 20},
+    {"histogram, ImGuiPlotHistory", PLOT_HISTORY, ImGuiPlotType_Histogram, 200},
+  };
+
+  printf("%d values, %d single value spikes, %d px wide plot\n", VALUES, SPIKES, DEFAULT_WINDOW_WIDTH);
+  printf("%-14s %7.1f ns/value, %.1f ns/value in one batch\n", "Push()", push_ns, push_batch_ns);
+  printf("%-30s %8s %12s\n", "", "frames", "ms/frame");
+  CreateFixtureContext();
+  ShowPlotFrame(history, PLOT_HISTORY, ImGuiPlotType_Lines);
+  for (const PlotCase& plot : cases) {
+    ShowPlotFrame(history, plot.source, plot.type);
+    Uint64 ticks = 0;
+    for (int frame = 0; frame < plot.frames; frame++) {
+      begin = SDL_GetPerformanceCounter();
+      ShowPlotFrame(history, plot.source, plot.type);
+      ticks += SDL_GetPerformanceCounter() - begin;
+    }
+    printf("%-30s %8d %9.3f ms\n", plot.name, plot.frames, TicksToNs(ticks) / plot.frames * 1e-6);
+  }
+  ImGui::DestroyContext();
+  return 0;
+}
+
+// One frame of `polyline.shapes` into `lists`
+static void DrawPolylineFrame(std::vector<ImDrawList*>& lists, const PolylineCase& polyline, const std::vector<ImVec2>& points) {
+  for (int shape = 0; shape < polyline.shapes; shape++) {
+    ImDrawList* draw_list = lists[shape / polyline.shapes_per_list];
+    if (shape % polyline.shapes_per_list == 0) {
+      draw_list->Clear();
+      draw_list->PushClipRectFullScreen();
+      draw_list->PushTextureID(ImGui::GetIO().Fonts->TexID);
+    }
+    DrawPolylineShape(*draw_list, polyline, points, shape);
+  }
+}
+
+static int RunPolylineBenchmark() {
+  CreateFixtureContext();
+  ImGui::NewFrame();
+
+  // 100k segments per frame in every case: a hundred noisy 1000 segment
+  // graphs, or rings of 32 segments
+  const PolylineCase cases[] = {
+    {"graphs, 1 px", POLYLINE_OPEN, 1.0f, 100, 1000, 20},
+    {"graphs, 2 px", POLYLINE_OPEN, 2.0f, 100, 1000, 15},
+    {"AddCircle, 32 segments", POLYLINE_CIRCLE, 1.0f, 3125, 32, 600},
+    {"AddCircleFilled, 32 segments", POLYLINE_CIRCLE_FILLED, 1.0f, 3125, 32, 900},
+  };
+  const std::vector<ImVec2> points = MakeGraphPoints(100, 1000);
+
+  const int FRAMES = 50;
+  printf("%-30s %10s %12s\n", "100k segments", "vertices", "ms/frame");
+  for (const PolylineCase& polyline : cases) {
+    const int list_count = (polyline.shapes + polyline.shapes_per_list - 1) / polyline.shapes_per_list;
+    std::vector<ImDrawList*> lists;
+    for (int i = 0; i < list_count; i++)
+      lists.push_back(IM_NEW(ImDrawList)(ImGui::GetDrawListSharedData()));
+
+    // Warm up, and fills the arc cache
+    DrawPolylineFrame(lists, polyline, points);
+    Uint64 begin = SDL_GetPerformanceCounter();
+    for (int frame = 0; frame < FRAMES; frame++)
+      DrawPolylineFrame(lists, polyline, points);
+    double ms = TicksToNs(SDL_GetPerformanceCounter() - begin) / FRAMES * 1e-6;
+
+    int vertices = 0;
+    for (ImDrawList* draw_list : lists) {
+      vertices += draw_list->VtxBuffer.Size;
+      IM_DELETE(draw_list);
+    }
+    printf("%-30s %10d %9.3f ms\n", polyline.name, vertices, ms);
+  }
+  ImGui::EndFrame();
+  ImGui::DestroyContext();
+  return 0;
+}
+
+struct AtlasBuild {
+  double ms;      // best round
+  int width, height;
+  int glyphs;
+};
+
+// Only Build() is timed, not reading the file
+static AtlasBuild BuildFontAtlas(const char* font_path, float font_size, const ImWchar* ranges, bool parallel, int rounds) {
+  AtlasBuild build = {};
+  build.ms = 1e30;
+  for (int round = 0; round < rounds; round++) {
+    ImFontAtlas atlas;
+    AddFontOrDefault(atlas, font_path, font_size, ranges);
+    atlas.ParallelFor = parallel ? JobParallelForWait : NULL;
+    Uint64 begin = SDL_GetPerformanceCounter();
+    atlas.Build();
+    build.ms = std::min(build.ms, TicksToNs(SDL_GetPerformanceCounter() - begin) * 1e-6);
+    build.width = atlas.TexWidth;
+    build.height = atlas.TexHeight;
+    build.glyphs = atlas.Fonts[0]->Glyphs.Size;
+  }
+  return build;
+}
+
+// None of our fonts has CJK glyphs, take the system's. NULL if there's none.
+static const char* FindCjkFont() {
+  const char* CJK_FONTS[] = {
+    getenv("JAKE_CJK_FONT"),
+    "/usr/share/fonts/truetype/droid/DroidSansFallbackFull.ttf",
+    "/usr/share/fonts/truetype/arphic/uming.ttc",
+    "/usr/share/fonts/opentype/noto/NotoSansCJK-Regular.ttc",
+    "/usr/share/fonts/noto-cjk/NotoSansCJK-Regular.ttc",
+    "/usr/share/fonts/google-droid/DroidSansFallbackFull.ttf",
+  };
+  for (const char* path : CJK_FONTS)
+    if (path != NULL && FileExists(path))
+      return path;
+  return NULL;
+}
+
+static int RunFontAtlasBenchmark() {
+  // Missing glyphs are skipped and cost next to nothing
+  const char* APP_FONT = "./imgui/misc/fonts/Cousine-Regular.ttf";
+  const char* cjk_font = FindCjkFont();
+  if (!FileExists(APP_FONT)) {
+    printf("%s not found, run from the repository root\n", APP_FONT);
+    return 1;
+  }
+  if (cjk_font == NULL) {
+    printf("No CJK font found, set JAKE_CJK_FONT to one. Timing the CJK ranges with %s, which only has Latin glyphs\n", APP_FONT);
+    cjk_font = APP_FONT;
+  }
+
+  struct AtlasCase {
+    const char* name;
+    const char* font_path;
+    float font_size;
+    const ImWchar* ranges;
+    int rounds;
+  };
+  ImFontAtlas ranges;   // only for the glyph range tables
+  const AtlasCase cases[] = {
+    {"ProggyClean 13 (default)", NULL, 13.0f, NULL, 9},
+    {"Cousine 15 (app)", APP_FONT, 15.0f, NULL, 9},
+    {"Japanese", cjk_font, 18.0f, ranges.GetGlyphRangesJapanese(), 3},
+    {"Chinese full", cjk_font, 18.0f, ranges.GetGlyphRangesChineseFull(), 2},
+  };
+
+  JobSystemInit();
+  printf("%d threads\n", JobSystemThreadCount());
+  printf("%-26s %7s %11s %10s %10s %8s\n", "atlas", "glyphs", "texture", "serial", "parallel", "speedup");
+  for (const AtlasCase& atlas : cases) {
+    AtlasBuild serial = BuildFontAtlas(atlas.font_path, atlas.font_size, atlas.ranges, false, atlas.rounds);
+    AtlasBuild parallel = BuildFontAtlas(atlas.font_path, atlas.font_size, atlas.ranges, true, atlas.rounds);
+    char texture[32];
+    snprintf(texture, sizeof(texture), "%dx%d", serial.width, serial.height);
+    printf("%-26s %7d %11s %7.1f ms %7.1f ms %7.2fx\n", atlas.name, serial.glyphs, texture,
+           serial.ms, parallel.ms, serial.ms / parallel.ms);
+  }
+  JobSystemShutdown();
+  return 0;
+}
+
+// A tool with a few fonts at a few sizes and DPI scales, one of them merging in a second font
+static void AddFontCacheBenchFonts(ImFontAtlas& atlas) {
+  const char* FONTS[] = {"Cousine-Regular.ttf", "DroidSans.ttf", "Roboto-Medium.ttf", "Karla-Regular.ttf"};
+  const float SIZES[] = {13.0f, 15.0f, 19.5f, 26.0f};
+  for (const char* font : FONTS) {
+    for (float size : SIZES) {
+      std::string path = std::string("./imgui/misc/fonts/") + font;
+      atlas.AddFontFromFileTTF(path.c_str(), size, NULL, atlas.GetGlyphRangesCyrillic());
+    }
+  }
+  ImFontConfig merge;
+  merge.MergeMode = true;
+  atlas.AddFontFromFileTTF("./imgui/misc/fonts/ProggyClean.ttf", 13.0f, &merge, atlas.GetGlyphRangesDefault());
+}
+
+static int RunFontCacheBenchmark() {
+  const char* DIRECTORY = "font_cache";
+  if (!FileExists("./imgui/misc/fonts/Cousine-Regular.ttf")) {
+    printf("./imgui/misc/fonts not found, run from the repository root\n");
+    return 1;
+  }
+
+  ImFontAtlas built;
+  AddFontCacheBenchFonts(built);
+  Uint64 begin = SDL_GetPerformanceCounter();
+  built.Build();
+  double build_ms = TicksToNs(SDL_GetPerformanceCounter() - begin) * 1e-6;
+
+  // Stores it, unless an earlier run already did
+  {
+    ImFontAtlas atlas;
+    AddFontCacheBenchFonts(atlas);
+    if (!FontCacheLoadAtlas(&atlas, DIRECTORY)) {
+      printf("Font cache: FAILED, can't store into '%s'\n", DIRECTORY);
+      return 1;
+    }
+  }
+
+  const int ROUNDS = 9;
+  double load_ms = 1e30;
+  for (int round = 0; round < ROUNDS; round++) {
+    ImFontAtlas atlas;
+    AddFontCacheBenchFonts(atlas);
+    FontCacheLoadAtlas(&atlas, DIRECTORY);
+    load_ms = std::min(load_ms, FontCacheGetStats().ms);
+  }
+
+  int glyphs = 0;
+  for (const ImFont* font : built.Fonts)
+    glyphs += font->Glyphs.Size;
+  printf("%d fonts, %d glyphs, %dx%d texture\n", built.Fonts.Size, glyphs, built.TexWidth, built.TexHeight);
+  printf("%-34s %8.2f ms\n", "build from TTF", build_ms);
+  printf("%-34s %8.2f ms\n", "font cache hit (hashing included)", load_ms);
+  return 0;
+}
+
+static int RunDynamicAtlasBenchmark() {
+  // Cousine has no Cyrillic, DroidSans does
+  const char* FONT = "./imgui/misc/fonts/DroidSans.ttf";
+  const float SIZE = 16.0f;
+  if (!FileExists(FONT)) {
+    printf("%s not found, run from the repository root\n", FONT);
+    return 1;
+  }
+  ImFontAtlas ranges;   // only for the glyph range tables
+  const ImWchar* cyrillic = ranges.GetGlyphRangesCyrillic();
+  std::vector<ImWchar> codepoints;
+  for (const ImWchar* range = cyrillic; range[0] && range[1]; range += 2)
+    for (int c = range[0]; c <= range[1]; c++)
+      if (c > 0xFF)
+        codepoints.push_back((ImWchar)c);
+
+  // Default ranges baked, Cyrillic on first use, against everything baked
+  ImFontAtlas baked;
+  baked.AddFontFromFileTTF(FONT, SIZE, NULL, cyrillic);
+  baked.Build();
+  ImFontAtlas dynamic;
+  BuildDynamicAtlas(dynamic, FONT, SIZE, 512);
+  const ImFont* font = dynamic.Fonts[0];
+  Uint64 begin = SDL_GetPerformanceCounter();
+  for (ImWchar c : codepoints)
+    font->FindGlyph(c);
+  double first_use_ns = TicksToNs(SDL_GetPerformanceCounter() - begin) / codepoints.size();
+  begin = SDL_GetPerformanceCounter();
+  for (ImWchar c : codepoints)
+    font->FindGlyph(c);
+  double lookup_ns = TicksToNs(SDL_GetPerformanceCounter() - begin) / codepoints.size();
+
+  // Room for a few dozen glyphs, a window sliding through all of them: frames evict and repack
+  ImFontAtlas small;
+  BuildDynamicAtlas(small, FONT, SIZE, 24);
+  const int FRAMES = 400, WINDOW = 24;
+  int evictions = 0, deferred = 0;
+  for (int frame = 0; frame < FRAMES; frame++) {
+    int before = DynamicGlyphCount(small);
+    ImFontAtlasDynamicNewFrame(&small);
+    if (DynamicGlyphCount(small) < before)
+      evictions++;
+    for (int i = 0; i < WINDOW; i++) {
+      ImWchar c = codepoints[(frame * 5 + i) % codepoints.size()];
+      const ImFontGlyph* glyph = small.Fonts[0]->FindGlyph(c);
+      if (glyph == small.Fonts[0]->FallbackGlyph && baked.Fonts[0]->FindGlyphNoFallback(c) != NULL)
+        deferred++;
+    }
+  }
+
+  // Texture memory for a page of text using 600 glyphs of a big font: all of its glyphs baked, or the page's on demand
+  const char* big_font = FindCjkFont();
+  if (big_font == NULL)
+    big_font = FileExists("/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf") ? "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf" : FONT;
+  static const ImWchar ALL_RANGES[] = {0x0020, 0xFFFF, 0};
+  ImFontAtlas everything;
+  everything.AddFontFromFileTTF(big_font, 18.0f, NULL, ALL_RANGES);
+  everything.Build();
+  const ImVector<ImFontGlyph>& all_glyphs = everything.Fonts[0]->Glyphs;
+  ImFontAtlas page;
+  BuildDynamicAtlas(page, big_font, 18.0f, 1024);
+  const int PAGE_GLYPHS = 600;
+  for (int i = 0; i < PAGE_GLYPHS; i++)
+    page.Fonts[0]->FindGlyph(all_glyphs[(int)((long long)i * all_glyphs.Size / PAGE_GLYPHS)].Codepoint);
+
+  printf("DroidSans 16, %d Cyrillic codepoints asked for, %d rasterized on demand\n", (int)codepoints.size(), DynamicGlyphCount(dynamic));
+  printf("%-34s %10s %10s\n", "atlas", "texture", "memory");
+  printf("%-34s %5dx%-4d %7d kB\n", "baked, Cyrillic ranges", baked.TexWidth, baked.TexHeight, baked.TexWidth * baked.TexHeight / 1024);
+  printf("%-34s %5dx%-4d %7d kB\n", "dynamic, default ranges baked", dynamic.TexWidth, dynamic.TexHeight, dynamic.TexWidth * dynamic.TexHeight / 1024);
+  printf("%s 18, a page of %d of its %d glyphs%s\n", big_font, PAGE_GLYPHS, all_glyphs.Size,
+         FindCjkFont() ? "" : " (set JAKE_CJK_FONT for a CJK font)");
+  printf("%-34s %5dx%-4d %7d kB\n", "baked, every glyph", everything.TexWidth, everything.TexHeight, everything.TexWidth * everything.TexHeight / 1024);
+  printf("%-34s %5dx%-4d %7d kB\n", "dynamic, the page's glyphs", page.TexWidth, page.TexHeight, page.TexWidth * page.TexHeight / 1024);
+  printf("%-34s %8.2f us\n", "first use (rasterize + pack)", first_use_ns * 1e-3);
+  printf("%-34s %8.1f ns\n", "lookup afterwards", lookup_ns);
+  printf("%-34s %8d frames, %d evicting, %d glyphs deferred\n", "eviction", FRAMES, evictions, deferred);
+  return 0;
+}
+
+static int RunSdfAtlasBenchmark() {
+  const char* FONT = "./imgui/misc/fonts/DroidSans.ttf";
+  const float SDF_SIZE = 32.0f;
+  const float SIZES[] = {13.0f, 16.0f, 20.0f, 24.0f, 32.0f, 48.0f};
+  if (!FileExists(FONT)) {
+    printf("%s not found, run from the repository root\n", FONT);
+    return 1;
+  }
+  ImFontAtlas ranges;   // only for the glyph range tables
+  const ImWchar* cyrillic = ranges.GetGlyphRangesCyrillic();
+
+  // Serial and parallel builds, as for the coverage atlases
+  JobSystemInit();
+  const int threads = JobSystemThreadCount();
+  AtlasBuild builds[2];
+  for (int parallel = 0; parallel < 2; parallel++) {
+    builds[parallel].ms = 1e30;
+    for (int round = 0; round < 3; round++) {
+      ImFontAtlas atlas;
+      AddSdfFont(atlas, FONT, SDF_SIZE, cyrillic);
+      atlas.ParallelFor = parallel ? JobParallelForWait : NULL;
+      Uint64 begin = SDL_GetPerformanceCounter();
+      atlas.Build();
+      builds[parallel].ms = std::min(builds[parallel].ms, TicksToNs(SDL_GetPerformanceCounter() - begin) * 1e-6);
+      builds[parallel].width = atlas.TexWidth;
+      builds[parallel].height = atlas.TexHeight;
+      builds[parallel].glyphs = atlas.Fonts[0]->Glyphs.Size;
+    }
+  }
+  JobSystemShutdown();
+
+  // What one field replaces: a coverage font per size the UI draws at
+  ImFontAtlas sizes;
+  for (float size : SIZES)
+    sizes.AddFontFromFileTTF(FONT, size, NULL, cyrillic);
+  Uint64 begin = SDL_GetPerformanceCounter();
+  sizes.Build();
+  double sizes_ms = TicksToNs(SDL_GetPerformanceCounter() - begin) * 1e-6;
+
+  const AtlasBuild& sdf = builds[0];
+  printf("DroidSans, Cyrillic ranges, %d glyphs, %d threads\n", sdf.glyphs, threads);
+  printf("%-36s %10s %7s %10s %10s\n", "atlas", "texture", "memory", "serial", "parallel");
+  printf("%-36s %5dx%-4d %4d kB %7.1f ms %7.1f ms\n", "distance field, 32 px, any size", sdf.width, sdf.height,
+         sdf.width * sdf.height / 1024, builds[0].ms, builds[1].ms);
+  printf("%-36s %5dx%-4d %4d kB %7.1f ms\n", "coverage, 13 16 20 24 32 48 px", sizes.TexWidth, sizes.TexHeight,
+         sizes.TexWidth * sizes.TexHeight / 1024, sizes_ms);
+  return 0;
+}
+
+struct Benchmark {
+  const char* name;
+  const char* description;
+  int (*run)();
+};
+
+static const Benchmark benchmarks[] = {
+  {"hash", "ImHash functions on the IDs of real frames", RunHashBenchmark},
+  {"storage", "ImGuiStorage inserts and lookups, 1k to 1M keys", RunStorageBenchmark},
+  {"text", "ImFont::RenderText on a log pane, per glyph", RunTextBenchmark},
+  {"textcache", "Frames of labels and wrapped text with the text layout cache on and off", RunTextCacheBenchmark},
+  {"retained", "Frames of mostly idle windows redrawn against kept with content versions", RunRetainedBenchmark},
+  {"inputtext", "Editing a 20 MB log in InputTextMultiline: idle, typing and moving frames", RunInputTextBenchmark},
+  {"textviewer", "A 2M line log in TextUnformatted against the indexed TextViewer, tailed and filtered", RunTextViewerBenchmark},
+  {"varclipper", "100k rows of mixed heights submitted whole against ImGuiVariableListClipper", RunVariableClipperBenchmark},
+  {"plot", "PlotLines/PlotHistogram over 10M values from a callback, an array and an ImGuiPlotHistory", RunPlotBenchmark},
+  {"polyline", "100k anti-aliased polyline and circle segments per frame", RunPolylineBenchmark},
+  {"fontatlas", "Font atlas builds with the glyphs rasterized serially and on the job system", RunFontAtlasBenchmark},
+  {"fontcache", "Sixteen fonts built from TTF against loaded from the font cache", RunFontCacheBenchmark},
+  {"dynamicatlas", "Glyphs rasterized on first use against baked ones, with eviction", RunDynamicAtlasBenchmark},
+  {"sdfatlas", "One distance field font atlas against coverage atlases at several sizes", RunSdfAtlasBenchmark},
+};
+
+int RunBenchmark(const char* name) {
+  for (const Benchmark& benchmark : benchmarks)
+    if (strcmp(benchmark.name, name) == 0)
+      return benchmark.run();
+
+  bool list = strcmp(name, "list") == 0;
+  if (!list)
+    printf("Unknown benchmark '%s'\n", name);
+  for (const Benchmark& benchmark : benchmarks)
+    printf("  %-12s %s\n", benchmark.name, benchmark.description);
+  return list ? 0 : 1;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+/**
+   Microbenchmarks for the hot paths we tuned, run without a window:
+
+     jake --headless --bench hash
+
+   Each one only times and prints a table; the results are checked by
+   tests/jake_tests. `--bench list` prints the names.
+ */
+int RunBenchmark(const char* name);
@@ -0,0 +1,31 @@
+#include "jake_file.h"
+
+#include <atomic>
+#include <errno.h>
+#include <stdio.h>
+#include <unistd.h>
+
+static std::atomic<unsigned> temp_counter{0};
+
+bool FileWriteReplace(const std::string& path, const void* data, size_t size) {
+  char temp_suffix[48];
+  snprintf(temp_suffix, sizeof(temp_suffix), ".%ld.%u.tmp", (long)getpid(), temp_counter.fetch_add(1));
+  std::string temp_path = path + temp_suffix;
+
+  FILE* file = fopen(temp_path.c_str(), "wb");
+  if (file == NULL)
+    return false;
+  bool ok = fwrite(data, 1, size, file) == size;
+  int error = errno;
+  if (fclose(file) != 0 && ok) {
+    ok = false;
+    error = errno;
+  }
+  if (ok && rename(temp_path.c_str(), path.c_str()) == 0)
+    return true;
+  if (ok)
+    error = errno;
+  remove(temp_path.c_str());
+  errno = error;
+  return false;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stddef.h>
+#include <string>
+
+/**
+   Write `data` to a temporary file next to `path` and rename it over
+   `path`, so readers see either the old file or all of the new one. The
+   temporary name holds the process id and a per-process counter, so
+   concurrent writers, in this process or another, never share it.
+
+   On failure nothing is left behind and `errno` says why.
+ */
+bool FileWriteReplace(const std::string& path, const void* data, size_t size);
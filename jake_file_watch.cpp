@@ -0,0 +1,91 @@
+#include <SDL.h>
+#include "jake_file_watch.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+// Written in place or renamed over. Not IN_CREATE: the file is still empty then
+const uint32_t WATCH_EVENTS = IN_CLOSE_WRITE | IN_MOVED_TO;
+
+bool FileWatchInit(FileWatch& watch) {
+  watch.fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (watch.fd < 0) {
+    SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "inotify_init1 failed: %s", strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+void FileWatchShutdown(FileWatch& watch) {
+  if (watch.fd >= 0)
+    close(watch.fd);
+  watch = FileWatch();
+}
+
+bool FileWatchAdd(FileWatch& watch, const char* path) {
+  if (watch.fd < 0)
+    return false;
+
+  std::string file = path;
+  std::string directory = ".";
+  size_t slash = file.rfind('/');
+  if (slash != std::string::npos) {
+    directory = slash == 0 ? "/" : file.substr(0, slash);
+    file = file.substr(slash + 1);
+  }
+
+  // Watching the same directory again hands back the same descriptor
+  int wd = inotify_add_watch(watch.fd, directory.c_str(), WATCH_EVENTS);
+  if (wd < 0) {
+    SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Can't watch '%s': %s", directory.c_str(), strerror(errno));
+    return false;
+  }
+
+  int directory_index = -1;
+  for (size_t i = 0; i < watch.directories.size(); i++)
+    if (watch.directories[i] == wd)
+      directory_index = (int)i;
+  if (directory_index < 0) {
+    directory_index = (int)watch.directories.size();
+    watch.directories.push_back(wd);
+  }
+
+  watch.paths.push_back(path);
+  watch.path_directories.push_back(directory_index);
+  watch.names.push_back(file);
+  return true;
+}
+
+static void MarkChanged(FileWatch& watch, int wd, const char* name, std::vector<std::string>& changed) {
+  for (size_t i = 0; i < watch.paths.size(); i++) {
+    if (watch.directories[watch.path_directories[i]] != wd || watch.names[i] != name)
+      continue;
+    for (const std::string& path : changed)
+      if (path == watch.paths[i])
+        return;
+    changed.push_back(watch.paths[i]);
+  }
+}
+
+bool FileWatchPoll(FileWatch& watch, std::vector<std::string>& changed) {
+  changed.clear();
+  if (watch.fd < 0)
+    return false;
+
+  alignas(struct inotify_event) char buffer[4096];
+  for (;;) {
+    ssize_t length = read(watch.fd, buffer, sizeof(buffer));
+    if (length <= 0)
+      break; // EAGAIN: nothing more for now
+
+    for (char* at = buffer; at < buffer + length; ) {
+      const struct inotify_event* event = (const struct inotify_event*)at;
+      if (event->len > 0)
+        MarkChanged(watch, event->wd, event->name, changed);
+      at += sizeof(struct inotify_event) + event->len;
+    }
+  }
+  return !changed.empty();
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+   Notices when files change on disk, through inotify.
+
+   The directories holding the files are watched rather than the files
+   themselves: most editors save by writing a new file and renaming it over
+   the old one, which would silently end a watch on the file. Polling never
+   blocks, so it can be called every frame.
+ */
+struct FileWatch {
+  int fd = -1;
+  std::vector<int> directories;       // watch descriptors
+  std::vector<std::string> paths;     // as passed to FileWatchAdd
+  std::vector<int> path_directories;  // index into `directories`, per path
+  std::vector<std::string> names;     // file name part of each path
+};
+
+bool FileWatchInit(FileWatch& watch);
+void FileWatchShutdown(FileWatch& watch);
+
+bool FileWatchAdd(FileWatch& watch, const char* path);
+
+/**
+   Collects the watched paths written since the last call into `changed`,
+   each at most once. Returns whether there were any.
+ */
+bool FileWatchPoll(FileWatch& watch, std::vector<std::string>& changed);
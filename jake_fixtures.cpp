@@ -0,0 +1,284 @@
+#include "imgui.h"
+#include "imgui_internal.h"
+#include "jake.h"
+#include "jake_fixtures.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+void CreateFixtureContext(const char* font_path, float font_size) {
+  ImGui::CreateContext();
+  ImGuiIO& io = ImGui::GetIO();
+  io.IniFilename = NULL;
+  io.DisplaySize = ImVec2((float)DEFAULT_WINDOW_WIDTH, (float)DEFAULT_WINDOW_HEIGHT);
+  io.DeltaTime = 1.0f / 60.0f;
+  for (int key = 0; key < ImGuiKey_COUNT; key++)
+    io.KeyMap[key] = key;
+  if (font_path != NULL)
+    io.Fonts->AddFontFromFileTTF(font_path, font_size);
+  unsigned char* pixels;
+  int width, height;
+  io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+}
+
+bool FileExists(const char* path) {
+  FILE* file = fopen(path, "rb");
+  if (file != NULL)
+    fclose(file);
+  return file != NULL;
+}
+
+std::string MakeLogText(int lines, bool unicode) {
+  std::string text;
+  char line[256];
+  for (int i = 0; i < lines; i++) {
+    snprintf(line, sizeof(line), "[%02d:%02d:%02d.%03d] %s universe %d: tick %d took %.3f ms, %d bodies, seed 0x%08X%s\n",
+             i / 3600 % 24, i / 60 % 60, i % 60, i * 37 % 1000, i % 7 == 0 ? "WARN " : "INFO ", i % 13, i * 3,
+             (i % 17) * 0.137, i * 11 % 5000, i * 2654435761u, i % 5 == 0 ? "\ttabbed\r" : "");
+    text += line;
+    if (unicode && i % 4 == 0)
+      text += "  \xC3\xBC\xC3\xA9 \xE2\x9C\x93 \xE6\x97\xA5\xE6\x9C\xAC \xF0\x9F\x98\x80 \xFF bad\n";
+  }
+  return text;
+}
+
+ImGuiID StorageKey(int i) {
+  return ImHashCrc32Table(&i, sizeof(i), 0);
+}
+
+void PressKey(ImGuiKey key, bool down) {
+  ImGui::GetIO().KeysDown[ImGui::GetIO().KeyMap[key]] = down;
+}
+
+char QueueInputTextEdit(int edit, int pos) {
+  ImGuiInputTextState& state = ImGui::GetCurrentContext()->InputTextState;
+  state.StbState.cursor = state.StbState.select_start = state.StbState.select_end = pos;
+  state.CursorFollow = true;
+  if (edit % 3 == 0 && pos > 0) {
+    PressKey(ImGuiKey_Backspace, true);
+    return '\b';
+  }
+  if (edit % 3 == 1) {
+    PressKey(ImGuiKey_Enter, true);
+    return '\n';
+  }
+  ImGui::GetIO().AddInputCharacter('x');
+  return 'x';
+}
+
+void InputTextFrame(std::vector<char>& buf, bool focus) {
+  ImGui::NewFrame();
+  ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
+  ImGui::SetNextWindowSize(ImVec2((float)DEFAULT_WINDOW_WIDTH, (float)DEFAULT_WINDOW_HEIGHT));
+  ImGui::Begin("Log###fixture_log");
+  if (focus)
+    ImGui::SetKeyboardFocusHere();
+  ImGui::InputTextMultiline("##log", buf.data(), buf.size(), ImVec2(-1.0f, -1.0f));
+  ImGui::End();
+  ImGui::Render();
+}
+
+void ShowInspectorScreen(int frame) {
+  ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
+  ImGui::SetNextWindowSize(ImVec2(700.0f, (float)DEFAULT_WINDOW_HEIGHT));
+  ImGui::Begin("Inspector###fixture_inspector");
+  for (int i = 0; i < 40; i++) {
+    ImGui::PushID(i);
+    ImGui::Text("Body %d", i);
+    ImGui::SameLine(120.0f);
+    if (i % 8 == 0)
+      ImGui::Text("%.4f m/s", frame * 0.013f + i * 1.7f);
+    else
+      ImGui::Text("mass %d kg", i * 7);
+    ImGui::SameLine(260.0f);
+    ImGui::SmallButton("Select");
+    ImGui::SameLine();
+    bool visible = i % 3 != 0;
+    ImGui::Checkbox("Visible", &visible);
+    ImGui::PopID();
+  }
+  ImGui::End();
+
+  ImGui::SetNextWindowPos(ImVec2(710.0f, 0.0f));
+  ImGui::SetNextWindowSize(ImVec2(560.0f, (float)DEFAULT_WINDOW_HEIGHT));
+  ImGui::Begin("Help###fixture_help");
+  for (int i = 0; i < 6; i++) {
+    ImGui::TextWrapped("Each universe runs its own simulation at a fixed tick rate. Pausing one keeps its state, "
+                       "stepping advances it by exactly one tick, and resetting it starts over from the seed it was "
+                       "created with. Universes never share bodies.");
+    ImGui::BulletText("Tick %d", i);
+  }
+  ImGui::End();
+}
+
+void ShowDashboardScreen(int frame, bool versions) {
+  const int COLUMNS = 4, ROWS = 4;
+  const ImVec2 panel_size(DEFAULT_WINDOW_WIDTH / (float)COLUMNS, (DEFAULT_WINDOW_HEIGHT - 120.0f) / ROWS);
+  for (int i = 0; i < COLUMNS * ROWS; i++) {
+    // One panel updates every 50 frames, a different one each time
+    const int updates = (frame + (COLUMNS * ROWS - i) * 50) / (50 * COLUMNS * ROWS);
+    ImGui::SetNextWindowPos(ImVec2(panel_size.x * (i % COLUMNS), 120.0f + panel_size.y * (i / COLUMNS)));
+    ImGui::SetNextWindowSize(panel_size);
+    if (versions)
+      ImGui::SetNextWindowContentVersion((ImU32)updates);
+    char name[40];
+    snprintf(name, sizeof(name), "Universe %d###fixture_panel%d", i, i);
+    ImGui::Begin(name);
+    ImGui::Text("%d bodies, %d updates", 100 + i * 17, updates);
+    ImGui::ProgressBar((updates % 10) / 10.0f);
+    for (int row = 0; row < 8; row++) {
+      ImGui::PushID(row);
+      ImGui::Text("Body %d", row);
+      ImGui::SameLine(80.0f);
+      ImGui::SmallButton("Select");
+      ImGui::SameLine();
+      bool visible = (row + updates) % 3 != 0;
+      ImGui::Checkbox("Visible", &visible);
+      ImGui::PopID();
+    }
+    ImGui::End();
+  }
+
+  // Last, so it has the focus, and different every frame
+  ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
+  ImGui::SetNextWindowSize(ImVec2((float)DEFAULT_WINDOW_WIDTH, 120.0f));
+  ImGui::Begin("Timings###fixture_live");
+  ImGui::Text("Frame %d", frame);
+  ImGui::PlotLines("##frame_ms", [](void*, int i) { return sinf(i * 0.3f); }, NULL, 60, frame % 60);
+  ImGui::End();
+}
+
+bool IsDashboardPanel(const ImDrawList& draw_list) {
+  return draw_list._OwnerName != NULL && strstr(draw_list._OwnerName, "###fixture_panel") != NULL;
+}
+
+static void ShowMixedRow(int i) {
+  static bool paused = false;
+  ImGui::PushID(i);
+  switch (i % 5) {
+  case 0:
+    ImGui::Text("Entry %d", i);
+    break;
+  case 1:
+    ImGui::TextWrapped("Entry %d: %s", i, i % 3 == 0
+                       ? "universe diverged from its neighbours after a collision near the origin, the tick was replayed twice and both replays "
+                         "agreed with each other but not with the first run, which points at uninitialised state rather than at the solver"
+                       : "universe checksum matches");
+    break;
+  case 2:
+    ImGui::SetNextTreeNodeOpen(i % 15 == 2);
+    if (ImGui::TreeNode("node", "Universe %d", i)) {
+      ImGui::Text("Tick %d", i * 3);
+      ImGui::BulletText("%d bodies", i % 500);
+      ImGui::TreePop();
+    }
+    break;
+  case 3:
+    ImGui::Button("Reset");
+    ImGui::SameLine();
+    ImGui::Checkbox("Paused", &paused);
+    break;
+  case 4:
+    ImGui::Separator();
+    break;
+  }
+  ImGui::PopID();
+}
+
+float ShowMixedList(int rows, bool clip, float scroll_y) {
+  ImGui::NewFrame();
+  ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
+  ImGui::SetNextWindowSize(ImVec2((float)DEFAULT_WINDOW_WIDTH, (float)DEFAULT_WINDOW_HEIGHT));
+  ImGui::Begin("List###fixture_list");
+  if (scroll_y >= 0.0f)
+    ImGui::SetScrollY(scroll_y);
+  if (clip) {
+    ImGuiVariableListClipper clipper("##rows", rows);
+    while (clipper.Step())
+      for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+        ShowMixedRow(i);
+  } else {
+    for (int i = 0; i < rows; i++)
+      ShowMixedRow(i);
+  }
+  float scroll_max_y = ImGui::GetScrollMaxY();
+  ImGui::End();
+  ImGui::Render();
+  return scroll_max_y;
+}
+
+static float PlotHistoryGetter(void* data, int idx) {
+  return ((const ImGuiPlotHistory*)data)->Values[idx];
+}
+
+void ShowPlotFrame(const ImGuiPlotHistory& history, PlotSource source, ImGuiPlotType type) {
+  ImGui::NewFrame();
+  ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
+  ImGui::SetNextWindowSize(ImVec2((float)DEFAULT_WINDOW_WIDTH, 300.0f));
+  ImGui::Begin("Plot###fixture_plot");
+  const ImVec2 size(ImGui::GetContentRegionAvailWidth(), 200.0f);
+  void* getter_data = (void*)&history;
+  bool lines = type == ImGuiPlotType_Lines;
+  if (source == PLOT_CALLBACK && lines)
+    ImGui::PlotLines("##plot", PlotHistoryGetter, getter_data, history.Count, history.Offset, NULL, FLT_MAX, FLT_MAX, size);
+  else if (source == PLOT_CALLBACK)
+    ImGui::PlotHistogram("##plot", PlotHistoryGetter, getter_data, history.Count, history.Offset, NULL, FLT_MAX, FLT_MAX, size);
+  else if (source == PLOT_ARRAY && lines)
+    ImGui::PlotLines("##plot", history.Values.Data, history.Count, history.Offset, NULL, FLT_MAX, FLT_MAX, size);
+  else if (source == PLOT_ARRAY)
+    ImGui::PlotHistogram("##plot", history.Values.Data, history.Count, history.Offset, NULL, FLT_MAX, FLT_MAX, size);
+  else if (lines)
+    ImGui::PlotLines("##plot", history, NULL, FLT_MAX, FLT_MAX, size);
+  else
+    ImGui::PlotHistogram("##plot", history, NULL, FLT_MAX, FLT_MAX, size);
+  ImGui::End();
+  ImGui::Render();
+}
+
+std::vector<ImVec2> MakeGraphPoints(int graphs, int segments) {
+  std::vector<ImVec2> points((size_t)graphs * (segments + 1));
+  ImU32 rng = 1;
+  for (size_t i = 0; i < points.size(); i++) {
+    rng = rng * 1664525u + 1013904223u;
+    points[i] = ImVec2((float)(i % (segments + 1)) * 1.2f, (float)(i / (segments + 1)) * 7.0f + (float)(rng >> 22) * 0.02f);
+  }
+  return points;
+}
+
+void DrawPolylineShape(ImDrawList& draw_list, const PolylineCase& polyline, const std::vector<ImVec2>& points, int shape) {
+  const ImU32 col = IM_COL32(255, 200, 80, 255);
+  const ImVec2 centre((float)(shape % 100) * 12.5f + 10.0f, (float)(shape / 100) * 20.0f + 10.0f);
+  const float radius = 4.0f + (float)(shape % 7);
+  if (polyline.shape == POLYLINE_OPEN)
+    draw_list.AddPolyline(&points[shape * (polyline.segments + 1)], polyline.segments + 1, col, false, polyline.thickness);
+  else if (polyline.shape == POLYLINE_CIRCLE_FILLED)
+    draw_list.AddCircleFilled(centre, radius, col, polyline.segments);
+  else
+    draw_list.AddCircle(centre, radius, col, polyline.segments, polyline.thickness);
+}
+
+void AddFontOrDefault(ImFontAtlas& atlas, const char* font_path, float font_size, const ImWchar* ranges) {
+  if (font_path != NULL)
+    atlas.AddFontFromFileTTF(font_path, font_size, NULL, ranges);
+  else
+    atlas.AddFontDefault();
+}
+
+void BuildDynamicAtlas(ImFontAtlas& atlas, const char* font_path, float font_size, int dynamic_height) {
+  atlas.Flags |= ImFontAtlasFlags_DynamicGlyphs;
+  atlas.TexDynamicHeight = dynamic_height;
+  atlas.AddFontFromFileTTF(font_path, font_size);
+  atlas.Build();
+}
+
+int DynamicGlyphCount(const ImFontAtlas& atlas) {
+  const ImFont* font = atlas.Fonts[0];
+  return font->Glyphs.Size - font->DynamicGlyphsBegin;
+}
+
+void AddSdfFont(ImFontAtlas& atlas, const char* font_path, float font_size, const ImWchar* ranges) {
+  ImFontConfig config;
+  config.SignedDistanceField = true;
+  atlas.AddFontFromFileTTF(font_path, font_size, &config, ranges);
+}
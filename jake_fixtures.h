@@ -0,0 +1,114 @@
+#pragma once
+
+#include "imgui.h"
+
+#include <string>
+#include <vector>
+
+/**
+   Headless ImGui scenes and inputs shared by the benchmarks (jake_bench)
+   and the tests (tests/jake_tests): the benchmarks time them, the tests
+   check what comes out. Run from the repository root, the fonts are under
+   ./imgui/misc/fonts.
+
+   Everything here only depends on its arguments, so the same frame
+   number draws the same frame in both.
+ */
+
+/**
+   Headless context with the font atlas built, ready for frames, the size
+   of the app window. The default font unless given a TTF file. Every
+   `ImGuiKey` maps to itself, see `PressKey`.
+ */
+void CreateFixtureContext(const char* font_path = NULL, float font_size = 0.0f);
+
+bool FileExists(const char* path);
+
+/**
+   Log lines the way our tool panes print them, optionally with a line of
+   UTF-8 (and one invalid byte) every fourth line. The golden hashes of the
+   tests depend on every byte of it.
+ */
+std::string MakeLogText(int lines, bool unicode);
+
+/**
+   IDs the way ImGui makes them. CRC32 of 4 bytes is a bijection, so these
+   never repeat (and one of them is 0).
+ */
+ImGuiID StorageKey(int i);
+
+void PressKey(ImGuiKey key, bool down);
+
+/**
+   Move the cursor of the active InputText to `pos` and queue edit number
+   `edit` for the next frame: erase the character before the cursor, type
+   a new line, or an 'x'. Returns '\b', '\n' or 'x' accordingly; '\b' only
+   when `pos` > 0. Release the keys after the frame.
+ */
+char QueueInputTextEdit(int edit, int pos);
+
+/**
+   One frame of a window-sized multi-line InputText over `buf`, focused on
+   the next frame with `focus`.
+ */
+void InputTextFrame(std::vector<char>& buf, bool focus);
+
+/**
+   An inspector the way ours look: labels, buttons and checkboxes that stay
+   the same, a value every few rows that changes each frame, and wrapped
+   help text. Between NewFrame() and Render().
+ */
+void ShowInspectorScreen(int frame);
+
+/**
+   A dashboard the way ours look: a grid of panels that only change now and
+   then, and one live window with the frame timings. With `versions` the
+   panels pass a content version, which changes with what they show.
+   Between NewFrame() and Render().
+ */
+void ShowDashboardScreen(int frame, bool versions);
+bool IsDashboardPanel(const ImDrawList& draw_list);
+
+/**
+   One frame of `rows` rows of different heights, the way our inspectors
+   list entries: a line of text, wrapped paragraphs, tree nodes (some open)
+   and rows of widgets. With `clip` through an ImGuiVariableListClipper.
+   Scrolls to `scroll_y` (from the next frame on) unless negative. Returns
+   GetScrollMaxY().
+ */
+float ShowMixedList(int rows, bool clip, float scroll_y);
+
+enum PlotSource { PLOT_CALLBACK, PLOT_ARRAY, PLOT_HISTORY };
+
+/**
+   One frame of a window-wide plot of `history`, from a values getter, the
+   float array or the ImGuiPlotHistory itself. All three draw the same.
+ */
+void ShowPlotFrame(const ImGuiPlotHistory& history, PlotSource source, ImGuiPlotType type);
+
+enum PolylineShape { POLYLINE_OPEN, POLYLINE_CIRCLE, POLYLINE_CIRCLE_FILLED };
+
+struct PolylineCase {
+  const char* name;
+  PolylineShape shape;
+  float thickness;
+  int shapes;
+  int segments;           // per shape
+  int shapes_per_list;    // 16-bit indices, under 64k vertices per list
+};
+
+/**
+   `graphs` noisy graphs of `segments` segments, one after the other.
+ */
+std::vector<ImVec2> MakeGraphPoints(int graphs, int segments);
+
+/**
+   Shape number `shape` of `polyline`: a graph from `points`, or a ring on a
+   grid.
+ */
+void DrawPolylineShape(ImDrawList& draw_list, const PolylineCase& polyline, const std::vector<ImVec2>& points, int shape);
+
+void AddFontOrDefault(ImFontAtlas& atlas, const char* font_path, float font_size, const ImWchar* ranges);
+void BuildDynamicAtlas(ImFontAtlas& atlas, const char* font_path, float font_size, int dynamic_height);
+int DynamicGlyphCount(const ImFontAtlas& atlas);
+void AddSdfFont(ImFontAtlas& atlas, const char* font_path, float font_size, const ImWchar* ranges);
@@ -0,0 +1,154 @@
+#include <SDL.h>
+#include "jake_font_cache.h"
+#include "jake_file.h"
+#include "imgui.h"
+#include "imgui_internal.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static FontCacheStats stats = {};
+
+// FNV-1a, a word at a time: the font files are most of what goes in
+static Uint64 HashBytes(Uint64 hash, const void* data, size_t size) {
+  const unsigned char* c = (const unsigned char*)data;
+  size_t i = 0;
+  for (; i + sizeof(Uint64) <= size; i += sizeof(Uint64)) {
+    Uint64 word;
+    memcpy(&word, c + i, sizeof(word));
+    hash = (hash ^ word) * 1099511628211ull;
+  }
+  for (; i < size; i++)
+    hash = (hash ^ c[i]) * 1099511628211ull;
+  return hash;
+}
+
+template <typename T>
+static Uint64 HashValue(Uint64 hash, const T& value) {
+  return HashBytes(hash, &value, sizeof(value));
+}
+
+static int FontIndex(const ImFontAtlas* atlas, const ImFont* font) {
+  for (int i = 0; i < atlas->Fonts.Size; i++)
+    if (atlas->Fonts[i] == font)
+      return i;
+  return -1;
+}
+
+// Field by field: the structs have padding and pointers
+static Uint64 AtlasKey(ImFontAtlas* atlas) {
+  Uint64 key = 14695981039346656037ull;
+  key = HashBytes(key, IMGUI_VERSION, sizeof(IMGUI_VERSION));
+  key = HashValue(key, atlas->Flags);
+  key = HashValue(key, atlas->TexDesiredWidth);
+  key = HashValue(key, atlas->TexGlyphPadding);
+  key = HashValue(key, atlas->TexDynamicHeight);
+  key = HashValue(key, atlas->Fonts.Size);
+
+  for (const ImFontConfig& config : atlas->ConfigData) {
+    key = HashValue(key, config.FontDataSize);
+    key = HashBytes(key, config.FontData, config.FontDataSize);
+    key = HashValue(key, config.FontNo);
+    key = HashValue(key, config.SizePixels);
+    key = HashValue(key, config.OversampleH);
+    key = HashValue(key, config.OversampleV);
+    key = HashValue(key, config.PixelSnapH);
+    key = HashValue(key, config.GlyphExtraSpacing);
+    key = HashValue(key, config.GlyphOffset);
+    key = HashValue(key, config.GlyphMinAdvanceX);
+    key = HashValue(key, config.GlyphMaxAdvanceX);
+    key = HashValue(key, config.MergeMode);
+    key = HashValue(key, config.RasterizerFlags);
+    key = HashValue(key, config.RasterizerMultiply);
+    key = HashValue(key, config.SignedDistanceField);
+    key = HashValue(key, config.SdfPadding);
+    key = HashValue(key, FontIndex(atlas, config.DstFont));
+    // NULL builds with the default ranges, hash those so both give the same key
+    const ImWchar* ranges = config.GlyphRanges ? config.GlyphRanges : atlas->GetGlyphRangesDefault();
+    for (; ranges[0] && ranges[1]; ranges += 2)
+      key = HashBytes(key, ranges, 2 * sizeof(ImWchar));
+    key = HashValue(key, (ImWchar)0);
+  }
+
+  for (const ImFontAtlas::CustomRect& rect : atlas->CustomRects) {
+    key = HashValue(key, rect.ID);
+    key = HashValue(key, rect.Width);
+    key = HashValue(key, rect.Height);
+    key = HashValue(key, rect.GlyphAdvanceX);
+    key = HashValue(key, rect.GlyphOffset);
+    key = HashValue(key, FontIndex(atlas, rect.Font));
+  }
+  return key;
+}
+
+static bool LoadAtlas(ImFontAtlas* atlas, const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+  struct stat info;
+  void* data = MAP_FAILED;
+  if (fstat(fd, &info) == 0 && info.st_size > 0)
+    data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED)
+    return false;
+
+  bool ok = ImFontAtlasBuildLoadFromMemory(atlas, data, (size_t)info.st_size);
+  munmap(data, (size_t)info.st_size);
+  return ok;
+}
+
+static bool StoreAtlas(ImFontAtlas* atlas, const std::string& path) {
+  ImVector<unsigned char> data;
+  if (!ImFontAtlasBuildSaveToMemory(atlas, &data))
+    return false;
+
+  // Written aside and renamed, so parallel runs never see half a file
+  if (FileWriteReplace(path, data.Data, (size_t)data.Size))
+    return true;
+  SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Can't write '%s': %s", path.c_str(), strerror(errno));
+  return false;
+}
+
+bool FontCacheLoadAtlas(ImFontAtlas* atlas, const char* directory) {
+  Uint64 begin = SDL_GetPerformanceCounter();
+  // What GetTexDataAsAlpha8 and the build would add, so they're part of the key
+  if (atlas->ConfigData.empty())
+    atlas->AddFontDefault();
+  ImFontAtlasBuildRegisterDefaultCustomRects(atlas);
+
+  char file[32];
+  snprintf(file, sizeof(file), "/%016llx.atlas", (unsigned long long)AtlasKey(atlas));
+  std::string path = std::string(directory) + file;
+
+  bool ok = true;
+  bool hit = LoadAtlas(atlas, path);
+  if (hit) {
+    stats.hits++;
+  } else {
+    stats.misses++;
+    atlas->Build();
+    if (mkdir(directory, 0755) != 0 && errno != EEXIST) {
+      SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Can't create font cache '%s': %s", directory, strerror(errno));
+      ok = false;
+    } else if (StoreAtlas(atlas, path)) {
+      stats.stored++;
+    } else {
+      ok = false;
+    }
+  }
+
+  stats.ms = (SDL_GetPerformanceCounter() - begin) * 1000.0 / SDL_GetPerformanceFrequency();
+  SDL_Log("Font cache: %s %s in %.1f ms", hit ? "loaded" : "built", path.c_str(), stats.ms);
+  return ok;
+}
+
+const FontCacheStats& FontCacheGetStats() {
+  return stats;
+}
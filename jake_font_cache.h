@@ -0,0 +1,33 @@
+#pragma once
+
+struct ImFontAtlas;
+
+/**
+   On-disk cache of built font atlases.
+
+   Atlases are keyed by a hash of everything that goes into a build: the
+   font files' contents, sizes, glyph ranges, the rest of each
+   `ImFontConfig`, the atlas settings and custom rects, and the ImGui
+   version. A hit maps the file and loads the pixels and glyph tables
+   straight into the atlas, so `GetTexDataAsRGBA32` has nothing to
+   rasterize. A miss builds the atlas as usual and stores it.
+
+   Call after adding the fonts and before anything builds the atlas (the
+   first `ImGui_ImplOpenGL3_NewFrame`). Set `ImFontAtlas::ParallelFor`
+   first to build misses on the workers.
+ */
+
+struct FontCacheStats {
+  int hits;
+  int misses;
+  int stored;
+  double ms;      // in the last FontCacheLoadAtlas, hashing included
+};
+
+/**
+   `directory` is created if needed. Returns false when the atlas had to
+   be built and could not be stored.
+ */
+bool FontCacheLoadAtlas(ImFontAtlas* atlas, const char* directory);
+
+const FontCacheStats& FontCacheGetStats();
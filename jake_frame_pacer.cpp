@@ -0,0 +1,148 @@
+#include <SDL.h>
+#include "jake_frame_pacer.h"
+#include "jake_profiler.h"
+
+#include <algorithm>
+#include <math.h>
+
+// Only the last this many frames count when predicting the work time
+const int WORK_PREDICTION_FRAMES = 30;
+
+static double TicksToMs(Uint64 ticks) {
+  return ticks * 1000.0 / (double)SDL_GetPerformanceFrequency();
+}
+
+static Uint64 MsToTicks(double ms) {
+  return (Uint64)(ms * (double)SDL_GetPerformanceFrequency() / 1000.0);
+}
+
+static Uint64 FramePeriod(int target_framerate) {
+  return SDL_GetPerformanceFrequency() / (Uint64)std::max(target_framerate, 1);
+}
+
+const char* FramePacingModeName(FramePacingMode mode) {
+  switch (mode) {
+  case FramePacingMode_Capped: return "Capped";
+  case FramePacingMode_LowLatency: return "Low latency";
+  case FramePacingMode_Uncapped: return "Uncapped";
+  default: return "?";
+  }
+}
+
+/**
+   Sleep while the remaining time is well above the spin margin, then spin.
+   Every sleep measures how much `SDL_Delay` overslept; the margin jumps up
+   to that and decays slowly, so it tracks the scheduler's granularity.
+ */
+static void WaitUntil(FramePacer& pacer, Uint64 target) {
+  PROFILE_SCOPE("FramePacer::Wait");
+  Uint64 start = SDL_GetPerformanceCounter();
+  for (;;) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (now >= target)
+      break;
+
+    double remaining_ms = TicksToMs(target - now);
+    if (remaining_ms > pacer.spin_margin_ms + 1.0) {
+      Uint32 sleep_ms = (Uint32)(remaining_ms - pacer.spin_margin_ms);
+      SDL_Delay(sleep_ms);
+      double overshoot_ms = TicksToMs(SDL_GetPerformanceCounter() - now) - sleep_ms;
+      pacer.spin_margin_ms = std::min(std::max(overshoot_ms, pacer.spin_margin_ms * 0.99), 4.0);
+      pacer.spin_margin_ms = std::max(pacer.spin_margin_ms, 0.5);
+    }
+  }
+  pacer.wait_ticks += SDL_GetPerformanceCounter() - start;
+}
+
+/**
+   The worst work time of the recent frames, low latency mode starts the
+   frame this long before its deadline.
+ */
+static double PredictWorkMs(const FramePacer& pacer) {
+  int count = std::min(pacer.history_count, WORK_PREDICTION_FRAMES);
+  double worst = 0.0;
+  for (int i = 0; i < count; i++) {
+    int index = (pacer.history_offset - i + FRAME_PACER_HISTORY_SIZE) % FRAME_PACER_HISTORY_SIZE;
+    worst = std::max(worst, (double)pacer.work_ms[index]);
+  }
+  return worst;
+}
+
+void FramePacerBeginFrame(FramePacer& pacer, int target_framerate) {
+  Uint64 now = SDL_GetPerformanceCounter();
+  pacer.wait_ticks = 0;
+
+  if (pacer.mode == FramePacingMode_LowLatency && pacer.deadline != 0) {
+    pacer.deadline += FramePeriod(target_framerate);
+    if (pacer.deadline <= now)
+      pacer.deadline = now;
+    // Leave some slack for the wait itself to wake up late
+    Uint64 lead = MsToTicks(PredictWorkMs(pacer) + pacer.spin_margin_ms * 0.5);
+    if (pacer.deadline > now + lead)
+      WaitUntil(pacer, pacer.deadline - lead);
+  }
+
+  pacer.frame_begin = SDL_GetPerformanceCounter();
+}
+
+void FramePacerEndFrame(FramePacer& pacer, int target_framerate) {
+  Uint64 present = SDL_GetPerformanceCounter();
+  Uint64 period = FramePeriod(target_framerate);
+  Uint64 work_ticks = present - pacer.frame_begin;
+
+  switch (pacer.mode) {
+  case FramePacingMode_Capped: {
+    Uint64 next = pacer.deadline + period;
+    if (pacer.deadline != 0 && present > next)
+      pacer.stats.missed_deadlines++;
+    // First frame, or more than a whole frame behind: re-anchor instead of
+    // rushing through the frames we owe
+    if (pacer.deadline == 0 || present > next + period)
+      next = present;
+    pacer.deadline = next;
+    WaitUntil(pacer, pacer.deadline);
+    present = SDL_GetPerformanceCounter();
+    break;
+  }
+  case FramePacingMode_LowLatency:
+    if (pacer.deadline == 0)
+      pacer.deadline = present;
+    else if (present > pacer.deadline + MsToTicks(pacer.spin_margin_ms))
+      pacer.stats.missed_deadlines++;
+    break;
+  case FramePacingMode_Uncapped:
+  default:
+    pacer.deadline = 0;
+    break;
+  }
+
+  // In capped mode `present` was moved to the end of the wait above, which
+  // is when the next frame really starts
+  FramePacerRecordPresent(pacer, present, work_ticks);
+}
+
+void FramePacerRecordPresent(FramePacer& pacer, Uint64 present, Uint64 work_ticks) {
+  float work_ms = (float)TicksToMs(work_ticks);
+  if (pacer.last_present != 0) {
+    pacer.history_offset = (pacer.history_offset + 1) % FRAME_PACER_HISTORY_SIZE;
+    pacer.history_count = std::min(pacer.history_count + 1, FRAME_PACER_HISTORY_SIZE);
+    pacer.interval_ms[pacer.history_offset] = (float)TicksToMs(present - pacer.last_present);
+    pacer.work_ms[pacer.history_offset] = work_ms;
+  }
+  pacer.last_present = present;
+
+  double sum = 0.0, sum_sq = 0.0;
+  for (int i = 0; i < pacer.history_count; i++) {
+    int index = (pacer.history_offset - i + FRAME_PACER_HISTORY_SIZE) % FRAME_PACER_HISTORY_SIZE;
+    sum += pacer.interval_ms[index];
+    sum_sq += (double)pacer.interval_ms[index] * pacer.interval_ms[index];
+  }
+  double mean = pacer.history_count > 0 ? sum / pacer.history_count : 0.0;
+  double variance = pacer.history_count > 0 ? sum_sq / pacer.history_count - mean * mean : 0.0;
+
+  pacer.stats.frame_interval_ms = (float)mean;
+  pacer.stats.jitter_ms = (float)sqrt(std::max(variance, 0.0));
+  pacer.stats.work_ms = work_ms;
+  pacer.stats.wait_ms = (float)TicksToMs(pacer.wait_ticks);
+  pacer.stats.spin_margin_ms = (float)pacer.spin_margin_ms;
+}
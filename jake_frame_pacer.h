@@ -0,0 +1,72 @@
+#pragma once
+
+#include <SDL.h>
+
+/**
+   Frame pacing towards a target framerate.
+
+   Waiting is done by sleeping in coarse `SDL_Delay` steps and spinning on
+   the performance counter for the last fraction; the spin margin follows
+   the measured oversleep of `SDL_Delay`.
+
+   - Capped: wait after present until the next deadline.
+   - LowLatency: wait before input polling instead, for as long as the
+     recent work time history allows, so input is as fresh as possible
+     when the frame is presented on the deadline.
+   - Uncapped: never wait.
+ */
+
+enum FramePacingMode {
+  FramePacingMode_Capped,
+  FramePacingMode_LowLatency,
+  FramePacingMode_Uncapped,
+  FramePacingMode_COUNT
+};
+
+const int FRAME_PACER_HISTORY_SIZE = 120;
+
+struct FramePacerStats {
+  float frame_interval_ms;  // average time between presents
+  float jitter_ms;          // standard deviation of the time between presents
+  float work_ms;            // last frame, begin to present, without waiting
+  float wait_ms;            // last frame, time spent waiting
+  float spin_margin_ms;     // current spin-wait fraction of a wait
+  int missed_deadlines;     // frames presented after their deadline, in total
+};
+
+struct FramePacer {
+  FramePacingMode mode = FramePacingMode_Capped;
+
+  Uint64 deadline = 0;
+  Uint64 frame_begin = 0;
+  Uint64 last_present = 0;
+  Uint64 wait_ticks = 0;
+  double spin_margin_ms = 2.0;
+
+  float interval_ms[FRAME_PACER_HISTORY_SIZE] = {};
+  float work_ms[FRAME_PACER_HISTORY_SIZE] = {};
+  int history_offset = 0;
+  int history_count = 0;
+
+  FramePacerStats stats = {};
+};
+
+const char* FramePacingModeName(FramePacingMode mode);
+
+/**
+   Call at the top of the frame, before input polling.
+ */
+void FramePacerBeginFrame(FramePacer& pacer, int target_framerate);
+
+/**
+   Call right after `SDL_GL_SwapWindow`.
+ */
+void FramePacerEndFrame(FramePacer& pacer, int target_framerate);
+
+/**
+   Fold a frame presented at `present` after `work_ticks` of work (waits
+   not included) into `interval_ms`, `work_ms` and `stats`, which is all
+   `FramePacerEndFrame` does once it is done waiting. Performance counter
+   ticks, so the statistics can be fed made-up timestamps.
+ */
+void FramePacerRecordPresent(FramePacer& pacer, Uint64 present, Uint64 work_ticks);
@@ -0,0 +1,270 @@
+#include <GL/glew.h>
+#include "jake_gl_state.h"
+
+#include <string.h>
+
+static GlState shadow;
+static GlStateStats frame_stats = {};
+static GlStateStats last_frame_stats = {};
+
+// Counts the call and says whether it has to go through
+static bool Changed(bool differs) {
+  if (differs)
+    frame_stats.calls++;
+  else
+    frame_stats.avoided++;
+  return differs;
+}
+
+void GlStateInit() {
+  memset(&shadow, 0, sizeof(shadow));
+  GLint value = 0;
+
+  glGetIntegerv(GL_CURRENT_PROGRAM, &value);
+  shadow.program = value;
+  glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &value);
+  shadow.vertex_array = value;
+  glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &value);
+  shadow.array_buffer = value;
+  glGetIntegerv(GL_COPY_WRITE_BUFFER_BINDING, &value);
+  shadow.copy_write_buffer = value;
+
+  glGetIntegerv(GL_ACTIVE_TEXTURE, &value);
+  shadow.active_texture = value;
+  for (int unit = 0; unit < GL_STATE_TEXTURE_UNITS; unit++) {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &value);
+    shadow.texture_2d[unit] = value;
+    if (glBindSampler != NULL) {
+      glGetIntegerv(GL_SAMPLER_BINDING, &value);
+      shadow.sampler[unit] = value;
+    }
+  }
+  glActiveTexture(shadow.active_texture);
+
+  shadow.blend = glIsEnabled(GL_BLEND);
+  shadow.cull_face = glIsEnabled(GL_CULL_FACE);
+  shadow.depth_test = glIsEnabled(GL_DEPTH_TEST);
+  shadow.scissor_test = glIsEnabled(GL_SCISSOR_TEST);
+
+  glGetIntegerv(GL_BLEND_EQUATION_RGB, (GLint*)&shadow.blend_equation_rgb);
+  glGetIntegerv(GL_BLEND_EQUATION_ALPHA, (GLint*)&shadow.blend_equation_alpha);
+  glGetIntegerv(GL_BLEND_SRC_RGB, (GLint*)&shadow.blend_src_rgb);
+  glGetIntegerv(GL_BLEND_DST_RGB, (GLint*)&shadow.blend_dst_rgb);
+  glGetIntegerv(GL_BLEND_SRC_ALPHA, (GLint*)&shadow.blend_src_alpha);
+  glGetIntegerv(GL_BLEND_DST_ALPHA, (GLint*)&shadow.blend_dst_alpha);
+
+  GLint polygon_mode[2];
+  glGetIntegerv(GL_POLYGON_MODE, polygon_mode);
+  shadow.polygon_mode = polygon_mode[0];
+
+  glGetIntegerv(GL_VIEWPORT, shadow.viewport);
+  glGetIntegerv(GL_SCISSOR_BOX, shadow.scissor_box);
+  glGetFloatv(GL_COLOR_CLEAR_VALUE, shadow.clear_color);
+
+  shadow.clip_origin = GL_LOWER_LEFT;
+  if (GLEW_VERSION_4_5 || GLEW_ARB_clip_control)
+    glGetIntegerv(GL_CLIP_ORIGIN, (GLint*)&shadow.clip_origin);
+}
+
+void GlStateInvalidate() {
+  GlStateInit();
+}
+
+const GlState& GlStateGet() {
+  return shadow;
+}
+
+void GlStateSet(const GlState& state) {
+  GlStateUseProgram(state.program);
+  GlStateBindVertexArray(state.vertex_array);
+  GlStateBindBuffer(GL_ARRAY_BUFFER, state.array_buffer);
+  GlStateBindBuffer(GL_COPY_WRITE_BUFFER, state.copy_write_buffer);
+
+  for (int unit = 0; unit < GL_STATE_TEXTURE_UNITS; unit++) {
+    if (shadow.texture_2d[unit] != state.texture_2d[unit]) {
+      GlStateActiveTexture(GL_TEXTURE0 + unit);
+      GlStateBindTexture2D(state.texture_2d[unit]);
+    }
+    GlStateBindSampler(unit, state.sampler[unit]);
+  }
+  GlStateActiveTexture(state.active_texture);
+
+  GlStateSetEnabled(GL_BLEND, state.blend);
+  GlStateSetEnabled(GL_CULL_FACE, state.cull_face);
+  GlStateSetEnabled(GL_DEPTH_TEST, state.depth_test);
+  GlStateSetEnabled(GL_SCISSOR_TEST, state.scissor_test);
+  GlStateBlendEquationSeparate(state.blend_equation_rgb, state.blend_equation_alpha);
+  GlStateBlendFuncSeparate(state.blend_src_rgb, state.blend_dst_rgb, state.blend_src_alpha, state.blend_dst_alpha);
+  GlStatePolygonMode(state.polygon_mode);
+  GlStateViewport(state.viewport[0], state.viewport[1], state.viewport[2], state.viewport[3]);
+  GlStateScissor(state.scissor_box[0], state.scissor_box[1], state.scissor_box[2], state.scissor_box[3]);
+  GlStateClearColor(state.clear_color[0], state.clear_color[1], state.clear_color[2], state.clear_color[3]);
+}
+
+void GlStateUseProgram(GLuint program) {
+  if (Changed(shadow.program != program)) {
+    glUseProgram(program);
+    shadow.program = program;
+  }
+}
+
+void GlStateBindVertexArray(GLuint vertex_array) {
+  if (Changed(shadow.vertex_array != vertex_array)) {
+    glBindVertexArray(vertex_array);
+    shadow.vertex_array = vertex_array;
+  }
+}
+
+void GlStateBindBuffer(GLenum target, GLuint buffer) {
+  GLuint* binding = NULL;
+  if (target == GL_ARRAY_BUFFER)
+    binding = &shadow.array_buffer;
+  else if (target == GL_COPY_WRITE_BUFFER)
+    binding = &shadow.copy_write_buffer;
+
+  if (binding == NULL) {
+    glBindBuffer(target, buffer);
+  } else if (Changed(*binding != buffer)) {
+    glBindBuffer(target, buffer);
+    *binding = buffer;
+  }
+}
+
+void GlStateActiveTexture(GLenum texture_unit) {
+  if (Changed(shadow.active_texture != texture_unit)) {
+    glActiveTexture(texture_unit);
+    shadow.active_texture = texture_unit;
+  }
+}
+
+void GlStateBindTexture2D(GLuint texture) {
+  GLuint unit = shadow.active_texture - GL_TEXTURE0;
+  if (unit >= (GLuint)GL_STATE_TEXTURE_UNITS) {
+    glBindTexture(GL_TEXTURE_2D, texture);
+    return;
+  }
+  if (Changed(shadow.texture_2d[unit] != texture)) {
+    glBindTexture(GL_TEXTURE_2D, texture);
+    shadow.texture_2d[unit] = texture;
+  }
+}
+
+void GlStateBindSampler(GLuint unit, GLuint sampler) {
+  // Samplers are GL 3.3, the rest of this works on 3.2
+  if (glBindSampler == NULL)
+    return;
+  if (unit >= (GLuint)GL_STATE_TEXTURE_UNITS) {
+    glBindSampler(unit, sampler);
+    return;
+  }
+  if (Changed(shadow.sampler[unit] != sampler)) {
+    glBindSampler(unit, sampler);
+    shadow.sampler[unit] = sampler;
+  }
+}
+
+void GlStateSetEnabled(GLenum capability, bool enabled) {
+  bool* current = NULL;
+  switch (capability) {
+  case GL_BLEND: current = &shadow.blend; break;
+  case GL_CULL_FACE: current = &shadow.cull_face; break;
+  case GL_DEPTH_TEST: current = &shadow.depth_test; break;
+  case GL_SCISSOR_TEST: current = &shadow.scissor_test; break;
+  }
+
+  if (current == NULL || Changed(*current != enabled)) {
+    if (enabled)
+      glEnable(capability);
+    else
+      glDisable(capability);
+    if (current != NULL)
+      *current = enabled;
+  }
+}
+
+void GlStateBlendEquationSeparate(GLenum rgb, GLenum alpha) {
+  if (Changed(shadow.blend_equation_rgb != rgb || shadow.blend_equation_alpha != alpha)) {
+    glBlendEquationSeparate(rgb, alpha);
+    shadow.blend_equation_rgb = rgb;
+    shadow.blend_equation_alpha = alpha;
+  }
+}
+
+void GlStateBlendFuncSeparate(GLenum src_rgb, GLenum dst_rgb, GLenum src_alpha, GLenum dst_alpha) {
+  if (Changed(shadow.blend_src_rgb != src_rgb || shadow.blend_dst_rgb != dst_rgb
+              || shadow.blend_src_alpha != src_alpha || shadow.blend_dst_alpha != dst_alpha)) {
+    glBlendFuncSeparate(src_rgb, dst_rgb, src_alpha, dst_alpha);
+    shadow.blend_src_rgb = src_rgb;
+    shadow.blend_dst_rgb = dst_rgb;
+    shadow.blend_src_alpha = src_alpha;
+    shadow.blend_dst_alpha = dst_alpha;
+  }
+}
+
+void GlStatePolygonMode(GLenum mode) {
+  if (Changed(shadow.polygon_mode != mode)) {
+    glPolygonMode(GL_FRONT_AND_BACK, mode);
+    shadow.polygon_mode = mode;
+  }
+}
+
+void GlStateViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+  GLint* v = shadow.viewport;
+  if (Changed(v[0] != x || v[1] != y || v[2] != width || v[3] != height)) {
+    glViewport(x, y, width, height);
+    v[0] = x; v[1] = y; v[2] = width; v[3] = height;
+  }
+}
+
+void GlStateScissor(GLint x, GLint y, GLsizei width, GLsizei height) {
+  GLint* box = shadow.scissor_box;
+  if (Changed(box[0] != x || box[1] != y || box[2] != width || box[3] != height)) {
+    glScissor(x, y, width, height);
+    box[0] = x; box[1] = y; box[2] = width; box[3] = height;
+  }
+}
+
+void GlStateClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {
+  GLfloat* c = shadow.clear_color;
+  if (Changed(c[0] != red || c[1] != green || c[2] != blue || c[3] != alpha)) {
+    glClearColor(red, green, blue, alpha);
+    c[0] = red; c[1] = green; c[2] = blue; c[3] = alpha;
+  }
+}
+
+void GlStateDeleteBuffers(GLsizei count, const GLuint* buffers) {
+  for (GLsizei i = 0; i < count; i++) {
+    if (buffers[i] == 0)
+      continue;
+    if (shadow.array_buffer == buffers[i])
+      shadow.array_buffer = 0;
+    if (shadow.copy_write_buffer == buffers[i])
+      shadow.copy_write_buffer = 0;
+  }
+  glDeleteBuffers(count, buffers);
+}
+
+void GlStateDeleteVertexArrays(GLsizei count, const GLuint* vertex_arrays) {
+  for (GLsizei i = 0; i < count; i++)
+    if (vertex_arrays[i] != 0 && shadow.vertex_array == vertex_arrays[i])
+      shadow.vertex_array = 0;
+  glDeleteVertexArrays(count, vertex_arrays);
+}
+
+void GlStateDeleteTextures(GLsizei count, const GLuint* textures) {
+  for (GLsizei i = 0; i < count; i++)
+    for (int unit = 0; unit < GL_STATE_TEXTURE_UNITS; unit++)
+      if (textures[i] != 0 && shadow.texture_2d[unit] == textures[i])
+        shadow.texture_2d[unit] = 0;
+  glDeleteTextures(count, textures);
+}
+
+void GlStateEndFrame() {
+  last_frame_stats = frame_stats;
+  frame_stats = GlStateStats();
+}
+
+const GlStateStats& GlStateGetFrameStats() {
+  return last_frame_stats;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <GL/glew.h>
+
+/**
+   Shadow copy of the GL state that the app, tutorial.h and the ImGui
+   backend change every frame.
+
+   Every change goes through a `GlState*` call, which compares against the
+   shadow and only reaches GL when the value actually differs. Saving the
+   state is a struct copy instead of a round of `glGet*` (which can stall
+   the pipeline on some drivers), and restoring it only touches what
+   changed since.
+
+   This only works if nothing changes the tracked state behind its back.
+   After code that does (a third party library, say), call
+   `GlStateInvalidate` to read the real state again. One GL context only.
+ */
+
+const int GL_STATE_TEXTURE_UNITS = 8;
+
+struct GlState {
+  GLuint program;
+  GLuint vertex_array;
+  GLuint array_buffer;
+  GLuint copy_write_buffer;
+  GLenum active_texture;                          // GL_TEXTURE0 + unit
+  GLuint texture_2d[GL_STATE_TEXTURE_UNITS];
+  GLuint sampler[GL_STATE_TEXTURE_UNITS];
+  bool blend;
+  bool cull_face;
+  bool depth_test;
+  bool scissor_test;
+  GLenum blend_equation_rgb, blend_equation_alpha;
+  GLenum blend_src_rgb, blend_dst_rgb, blend_src_alpha, blend_dst_alpha;
+  GLenum polygon_mode;                            // front and back
+  GLint viewport[4];
+  GLint scissor_box[4];
+  GLfloat clear_color[4];
+  GLenum clip_origin;                             // read only, nothing here calls glClipControl
+};
+
+struct GlStateStats {
+  int calls;      // that reached GL
+  int avoided;    // skipped, the value was already set
+};
+
+/**
+   Read the real state into the shadow. Call once the context is current
+   and GLEW is initialised.
+ */
+void GlStateInit();
+void GlStateInvalidate();
+
+const GlState& GlStateGet();
+
+/**
+   Go back to a state returned by `GlStateGet`, only calling GL for what
+   differs.
+ */
+void GlStateSet(const GlState& state);
+
+void GlStateUseProgram(GLuint program);
+void GlStateBindVertexArray(GLuint vertex_array);
+void GlStateBindBuffer(GLenum target, GLuint buffer);  // others than GL_ARRAY_BUFFER and GL_COPY_WRITE_BUFFER go straight through
+void GlStateActiveTexture(GLenum texture_unit);
+void GlStateBindTexture2D(GLuint texture);             // on the active unit
+void GlStateBindSampler(GLuint unit, GLuint sampler);
+void GlStateSetEnabled(GLenum capability, bool enabled); // GL_BLEND, GL_CULL_FACE, GL_DEPTH_TEST or GL_SCISSOR_TEST
+void GlStateBlendEquationSeparate(GLenum rgb, GLenum alpha);
+void GlStateBlendFuncSeparate(GLenum src_rgb, GLenum dst_rgb, GLenum src_alpha, GLenum dst_alpha);
+void GlStatePolygonMode(GLenum mode);
+void GlStateViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+void GlStateScissor(GLint x, GLint y, GLsizei width, GLsizei height);
+void GlStateClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+
+/**
+   Deleting a bound object unbinds it, these keep the shadow in step.
+   (A deleted program stays in use until the next `glUseProgram`, so there
+   is no need for one of these for programs.)
+ */
+void GlStateDeleteBuffers(GLsizei count, const GLuint* buffers);
+void GlStateDeleteVertexArrays(GLsizei count, const GLuint* vertex_arrays);
+void GlStateDeleteTextures(GLsizei count, const GLuint* textures);
+
+/**
+   Counters of the frame that just ended. Call once per frame.
+ */
+void GlStateEndFrame();
+const GlStateStats& GlStateGetFrameStats();
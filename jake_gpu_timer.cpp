@@ -0,0 +1,159 @@
+#include <GL/glew.h>
+#include "imgui.h"
+#include "jake_gpu_timer.h"
+
+#include <string.h>
+
+static bool supported = false;
+static int frame_slot = 0;
+static int frame_index = 0;
+static int slot_frames[GPU_TIMER_FRAMES_IN_FLIGHT];
+static GpuTimerPass passes[GPU_TIMER_MAX_PASSES];
+static int pass_count = 0;
+
+bool GpuTimerInit() {
+  supported = GLEW_ARB_timer_query || GLEW_VERSION_3_3;
+  return supported;
+}
+
+void GpuTimerShutdown() {
+  for (int i = 0; i < pass_count; i++) {
+    glDeleteQueries(GPU_TIMER_FRAMES_IN_FLIGHT, passes[i].begin_queries);
+    glDeleteQueries(GPU_TIMER_FRAMES_IN_FLIGHT, passes[i].end_queries);
+  }
+  pass_count = 0;
+  supported = false;
+}
+
+static GpuTimerPass* FindPass(const char* name) {
+  for (int i = 0; i < pass_count; i++)
+    if (passes[i].name == name || strcmp(passes[i].name, name) == 0)
+      return &passes[i];
+
+  if (pass_count == GPU_TIMER_MAX_PASSES)
+    return NULL;
+
+  GpuTimerPass* pass = &passes[pass_count++];
+  memset(pass, 0, sizeof(*pass));
+  pass->name = name;
+  glGenQueries(GPU_TIMER_FRAMES_IN_FLIGHT, pass->begin_queries);
+  glGenQueries(GPU_TIMER_FRAMES_IN_FLIGHT, pass->end_queries);
+  return pass;
+}
+
+void GpuTimerBeginFrame() {
+  if (!supported)
+    return;
+
+  // The profiler just closed the frame that issued the current slot's
+  // queries: keep its CPU zones until the GPU side comes back
+  for (int i = 0; i < pass_count; i++)
+    if (passes[i].pending[frame_slot])
+      passes[i].cpu_ms_slots[frame_slot] = ProfilerGetZoneMs(passes[i].name);
+
+  frame_slot = (frame_slot + 1) % GPU_TIMER_FRAMES_IN_FLIGHT;
+  frame_index++;
+
+  for (int i = 0; i < pass_count; i++) {
+    GpuTimerPass& pass = passes[i];
+    if (!pass.pending[frame_slot])
+      continue;
+
+    // The end query is issued last, so once it is available both are
+    GLint available = 0;
+    glGetQueryObjectiv(pass.end_queries[frame_slot], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+      // Still in flight after a full round of slots; the slot gets reused
+      // below, which throws this result away rather than waiting for it
+      pass.results_lost++;
+      pass.pending[frame_slot] = false;
+      continue;
+    }
+
+    GLuint64 begin = 0, end = 0;
+    glGetQueryObjectui64v(pass.begin_queries[frame_slot], GL_QUERY_RESULT, &begin);
+    glGetQueryObjectui64v(pass.end_queries[frame_slot], GL_QUERY_RESULT, &end);
+    pass.pending[frame_slot] = false;
+
+    pass.gpu_ms = (float)((end - begin) / 1000000.0);
+    pass.cpu_ms = pass.cpu_ms_slots[frame_slot];
+    pass.frame = slot_frames[frame_slot];
+    pass.history_offset = (pass.history_offset + 1) % GPU_TIMER_HISTORY_SIZE;
+    pass.gpu_history[pass.history_offset] = pass.gpu_ms;
+  }
+
+  slot_frames[frame_slot] = frame_index;
+}
+
+void GpuTimerBegin(const char* name) {
+  if (!supported)
+    return;
+  GpuTimerPass* pass = FindPass(name);
+  if (pass == NULL)
+    return;
+  glQueryCounter(pass->begin_queries[frame_slot], GL_TIMESTAMP);
+}
+
+void GpuTimerEnd(const char* name) {
+  if (!supported)
+    return;
+  GpuTimerPass* pass = FindPass(name);
+  if (pass == NULL)
+    return;
+  glQueryCounter(pass->end_queries[frame_slot], GL_TIMESTAMP);
+  pass->pending[frame_slot] = true;
+}
+
+int GpuTimerGetFrame() {
+  return frame_index;
+}
+
+int GpuTimerGetPassCount() {
+  return pass_count;
+}
+
+const GpuTimerPass& GpuTimerGetPass(int index) {
+  IM_ASSERT(index >= 0 && index < pass_count);
+  return passes[index];
+}
+
+void ShowGpuTimerWindow(bool* p_open) {
+  if (!ImGui::Begin("GPU Timings", p_open)) {
+    ImGui::End();
+    return;
+  }
+
+  if (!supported) {
+    ImGui::TextDisabled("Timer queries are not supported by this GL context.");
+    ImGui::End();
+    return;
+  }
+
+  ImGui::Text("Frame %d", frame_index);
+  ImGui::Columns(5, "passes");
+  ImGui::Text("Pass"); ImGui::NextColumn();
+  ImGui::Text("Frame"); ImGui::NextColumn();
+  ImGui::Text("CPU ms"); ImGui::NextColumn();
+  ImGui::Text("GPU ms"); ImGui::NextColumn();
+  ImGui::Text("GPU history"); ImGui::NextColumn();
+  ImGui::Separator();
+  for (int i = 0; i < pass_count; i++) {
+    const GpuTimerPass& pass = passes[i];
+    ImGui::Text("%s", pass.name);
+    if (pass.results_lost > 0 && ImGui::IsItemHovered())
+      ImGui::SetTooltip("%d results were not ready in time and got dropped", pass.results_lost);
+    ImGui::NextColumn();
+    ImGui::Text("%d (-%d)", pass.frame, frame_index - pass.frame); ImGui::NextColumn();
+    ImGui::Text("%.3f", pass.cpu_ms); ImGui::NextColumn();
+    ImGui::Text("%.3f", pass.gpu_ms); ImGui::NextColumn();
+    ImGui::PushID(i);
+    ImGui::PlotLines("##history", pass.gpu_history, GPU_TIMER_HISTORY_SIZE,
+                     (pass.history_offset + 1) % GPU_TIMER_HISTORY_SIZE,
+                     NULL, 0.0f, FLT_MAX, ImVec2(-1, 20));
+    ImGui::PopID();
+    ImGui::NextColumn();
+  }
+  ImGui::Columns(1);
+
+  ImGui::End();
+}
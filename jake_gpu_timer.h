@@ -0,0 +1,80 @@
+#pragma once
+
+#include <GL/glew.h>
+#include "jake_profiler.h"
+
+/**
+   GPU pass timing with `GL_TIMESTAMP` queries.
+
+   Each pass owns a begin/end query pair per frame in flight. Results are
+   read back `GPU_TIMER_FRAMES_IN_FLIGHT` frames later and only once
+   `GL_QUERY_RESULT_AVAILABLE` says so, so reading never stalls the
+   pipeline. The CPU zone time is held back with its queries, so both
+   numbers of a pass come from the same frame. Timestamps (unlike
+   `GL_TIME_ELAPSED`) nest, so passes may be timed inside each other.
+
+   Needs GL 3.3 or `ARB_timer_query`; Mesa llvmpipe has both, so this runs
+   with LIBGL_ALWAYS_SOFTWARE=1 on a box without a GPU. Without it all
+   calls are no-ops and the window says so.
+ */
+
+const int GPU_TIMER_FRAMES_IN_FLIGHT = 3;
+const int GPU_TIMER_MAX_PASSES = 16;
+const int GPU_TIMER_HISTORY_SIZE = 120;
+
+struct GpuTimerPass {
+  const char* name;
+  GLuint begin_queries[GPU_TIMER_FRAMES_IN_FLIGHT];
+  GLuint end_queries[GPU_TIMER_FRAMES_IN_FLIGHT];
+  bool pending[GPU_TIMER_FRAMES_IN_FLIGHT];
+  float cpu_ms_slots[GPU_TIMER_FRAMES_IN_FLIGHT]; // CPU zone of the frame that issued the queries
+  float gpu_ms;   // latest result, GPU_TIMER_FRAMES_IN_FLIGHT frames old
+  float cpu_ms;   // CPU zone of the same frame
+  int frame;      // the frame both come from, see GpuTimerGetFrame
+  float gpu_history[GPU_TIMER_HISTORY_SIZE];
+  int history_offset;
+  int results_lost; // results overwritten before the GPU delivered them
+};
+
+/**
+   Call after the GL context is created and GLEW is initialised.
+ */
+bool GpuTimerInit();
+void GpuTimerShutdown();
+
+/**
+   Collect whatever results are ready and switch to the next query slot.
+   Call once per frame, before the first timed pass.
+ */
+void GpuTimerBeginFrame();
+
+void GpuTimerBegin(const char* name);
+void GpuTimerEnd(const char* name);
+
+struct GpuTimerScope {
+  explicit GpuTimerScope(const char* name) : name(name) { GpuTimerBegin(name); }
+  ~GpuTimerScope() { GpuTimerEnd(name); }
+
+  GpuTimerScope(const GpuTimerScope&) = delete;
+  GpuTimerScope& operator=(const GpuTimerScope&) = delete;
+
+  const char* name;
+};
+
+/**
+   Time a block on both the CPU (profiler zone) and the GPU, under the same
+   name so the window can put them next to each other.
+ */
+#define PROFILE_GPU_SCOPE(NAME)                                         \
+  PROFILE_SCOPE(NAME);                                                  \
+  GpuTimerScope PROFILE_CONCAT(gpu_timer_scope_, __LINE__)(NAME)
+
+/**
+   Index of the current frame, counted by `GpuTimerBeginFrame`.
+ */
+int GpuTimerGetFrame();
+
+int GpuTimerGetPassCount();
+const GpuTimerPass& GpuTimerGetPass(int index);
+
+void ShowGpuTimerWindow(bool* p_open = NULL);
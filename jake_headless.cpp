@@ -0,0 +1,191 @@
+#include <SDL.h>
+#include "imgui.h"
+#include "jake.h"
+#include "jake_bench.h"
+#include "jake_headless.h"
+#include "jake_jobs.h"
+#include "jake_profiler.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+const Uint64 DEFAULT_HEADLESS_FRAMES = 1000;
+
+static bool ParseCount(const char* text, Uint64& out) {
+  char* end = NULL;
+  unsigned long long value = strtoull(text, &end, 10);
+  if (end == text || *end != '\0')
+    return false;
+  out = value;
+  return true;
+}
+
+bool ParseHeadlessOptions(int argc, char** argv, HeadlessOptions& options) {
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+    Uint64 count = 0;
+
+    if (strcmp(arg, "--headless") == 0) {
+      options.enabled = true;
+      continue;
+    }
+    if (strcmp(arg, "--bench") == 0) {
+      if (value == NULL) {
+        SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "--bench needs a name, or 'list'");
+        return false;
+      }
+      options.bench = value;
+      i++;
+      continue;
+    }
+
+    bool takes_value = strcmp(arg, "--frames") == 0 || strcmp(arg, "--ticks") == 0
+      || strcmp(arg, "--tick-rate") == 0 || strcmp(arg, "--batch") == 0
+      || strcmp(arg, "--universes") == 0 || strcmp(arg, "--workers") == 0;
+    if (!takes_value) {
+      SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "Unknown argument '%s'", arg);
+      return false;
+    }
+    bool zero_allowed = strcmp(arg, "--workers") == 0;
+    if (value == NULL || !ParseCount(value, count) || (count == 0 && !zero_allowed)) {
+      SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "%s needs a positive number", arg);
+      return false;
+    }
+    i++;
+
+    if (strcmp(arg, "--frames") == 0)
+      options.frames = count;
+    else if (strcmp(arg, "--ticks") == 0)
+      options.ticks = count;
+    else if (strcmp(arg, "--tick-rate") == 0)
+      options.tick_rate = (int)count;
+    else if (strcmp(arg, "--universes") == 0)
+      options.universes = (int)count;
+    else if (strcmp(arg, "--workers") == 0)
+      options.workers = (int)count;
+    else
+      options.batch_size = (int)count;
+  }
+
+  if ((options.frames != 0 || options.ticks != 0 || options.bench != NULL) && !options.enabled) {
+    SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "--frames, --ticks and --bench only apply with --headless");
+    return false;
+  }
+  if (options.frames != 0 && options.ticks != 0) {
+    SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION, "Pass either --frames or --ticks, not both");
+    return false;
+  }
+  if (options.enabled && options.frames == 0 && options.ticks == 0)
+    options.frames = DEFAULT_HEADLESS_FRAMES;
+  return true;
+}
+
+static double TicksToMs(Uint64 ticks) {
+  return ticks * 1000.0 / (double)SDL_GetPerformanceFrequency();
+}
+
+static void PrintLatency(const char* label, std::vector<float>& samples) {
+  if (samples.empty())
+    return;
+  std::sort(samples.begin(), samples.end());
+  double sum = 0.0;
+  for (float sample : samples)
+    sum += sample;
+  size_t last = samples.size() - 1;
+  printf("%s: min %.4f avg %.4f p50 %.4f p99 %.4f max %.4f\n", label,
+         samples[0], sum / samples.size(),
+         samples[last / 2], samples[last * 99 / 100], samples[last]);
+}
+
+/**
+   One simulation tick and one full ImGui frame per iteration, minus the GL
+   upload. The UI is the same set of windows the interactive mode opens.
+ */
+static void RunFrames(const HeadlessOptions& options, SimulationState& state, Multiverse& multiverse, std::vector<float>& frame_ms) {
+  IMGUI_CHECKVERSION();
+  ImGui::CreateContext();
+  ImGuiIO& io = ImGui::GetIO();
+  io.IniFilename = NULL; // parallel runs must not fight over imgui.ini
+  io.DisplaySize = ImVec2((float)DEFAULT_WINDOW_WIDTH, (float)DEFAULT_WINDOW_HEIGHT);
+  io.DeltaTime = 1.0f / options.tick_rate;
+  unsigned char* pixels;
+  int width, height;
+  io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+  const double dt = 1.0 / options.tick_rate;
+  frame_ms.reserve((size_t)options.frames);
+  for (Uint64 frame = 0; frame < options.frames; frame++) {
+    Uint64 begin = SDL_GetPerformanceCounter();
+    ProfilerBeginFrame();
+    {
+      PROFILE_SCOPE("Simulation");
+      SimulationStep(state, dt);
+      MultiverseAdvance(multiverse, 1, options.tick_rate);
+    }
+    {
+      PROFILE_SCOPE("UI");
+      ImGui::NewFrame();
+      ImGui::ShowDemoWindow();
+      ShowProfilerWindow();
+      ImGui::Render();
+    }
+    MultiverseWait(multiverse);
+    JobSystemEndFrame();
+    ProfilerEndFrame();
+    frame_ms.push_back((float)TicksToMs(SDL_GetPerformanceCounter() - begin));
+  }
+
+  ImGui::DestroyContext();
+}
+
+static void RunTicks(const HeadlessOptions& options, SimulationState& state, Multiverse& multiverse, std::vector<float>& tick_us) {
+  tick_us.reserve((size_t)(options.ticks / options.batch_size + 1));
+  for (Uint64 done = 0; done < options.ticks; ) {
+    Uint64 batch = std::min((Uint64)options.batch_size, options.ticks - done);
+    Uint64 begin = SDL_GetPerformanceCounter();
+    MultiverseAdvance(multiverse, (int)batch, options.tick_rate);
+    SimulationRunTicks(state, batch, options.tick_rate);
+    MultiverseWait(multiverse);
+    tick_us.push_back((float)(TicksToMs(SDL_GetPerformanceCounter() - begin) * 1000.0 / batch));
+    done += batch;
+  }
+}
+
+int RunHeadless(const HeadlessOptions& options) {
+  if (options.bench != NULL)
+    return RunBenchmark(options.bench);
+
+  JobSystemInit(options.workers);
+
+  SimulationState state;
+  Multiverse multiverse;
+  MultiverseInit(multiverse, options.universes);
+  std::vector<float> samples;
+
+  Uint64 begin = SDL_GetPerformanceCounter();
+  if (options.frames != 0)
+    RunFrames(options, state, multiverse, samples);
+  else
+    RunTicks(options, state, multiverse, samples);
+  double seconds = TicksToMs(SDL_GetPerformanceCounter() - begin) / 1000.0;
+
+  printf("jake headless: %llu frames, %llu ticks in %.3f s\n",
+         (unsigned long long)options.frames, (unsigned long long)state.tick, seconds);
+  if (options.frames != 0)
+    printf("throughput: %.1f frames/s\n", options.frames / seconds);
+  printf("throughput: %.1f ticks/s\n", state.tick / seconds);
+  if (options.universes != 0)
+    printf("multiverse: %d universes on %d threads, %.1f universe ticks/s\n", options.universes,
+           JobSystemThreadCount(), (double)state.tick * options.universes / seconds);
+  PrintLatency(options.frames != 0 ? "frame latency ms" : "tick latency us", samples);
+  printf("checksum: 0x%08x\n", (unsigned)state.checksum);
+  if (options.universes != 0)
+    printf("multiverse checksum: 0x%08x\n", (unsigned)multiverse.checksum);
+
+  JobSystemShutdown();
+  return 0;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <SDL.h>
+
+/**
+   Headless batch mode: no window, no GL context. Runs a fixed amount of
+   work as fast as possible, prints throughput and latency stats plus the
+   final simulation checksum, and exits. Several runs can go in parallel on
+   a box without a display and be compared afterwards.
+
+     jake --headless --frames 10000    simulation tick + ImGui frame (CPU side)
+     jake --headless --ticks 1000000   simulation ticks only
+
+   --universes N also advances a multiverse of N universes every tick,
+   spread over --workers N worker threads (default: one per extra core).
+
+     jake --headless --bench NAME      one of the benchmarks in jake_bench.h
+ */
+struct HeadlessOptions {
+  bool enabled = false;
+  Uint64 frames = 0;
+  Uint64 ticks = 0;
+  int tick_rate = 60;
+  int batch_size = 1024; // ticks timed together in --ticks mode
+  int universes = 0;
+  int workers = -1;
+  const char* bench = NULL;
+};
+
+/**
+   Returns false and logs why on a malformed command line.
+ */
+bool ParseHeadlessOptions(int argc, char** argv, HeadlessOptions& options);
+
+int RunHeadless(const HeadlessOptions& options);
@@ -0,0 +1,356 @@
+#include <SDL.h>
+#include "imgui.h"
+#include "jake_jobs.h"
+#include "jake_profiler.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+struct alignas(64) Job {
+  JobFunction function;
+  Job* parent;
+  std::atomic<int> unfinished{0};
+  alignas(8) char data[JOB_DATA_SIZE];   // read back as the caller's struct, still one cache line
+};
+
+/**
+   Chase-Lev deque. The owner pushes and pops at `bottom`, thieves take from
+   `top`; the only contended case, the last job, is settled by a CAS on
+   `top`.
+ */
+struct JobDeque {
+  std::atomic<long> top{0};
+  std::atomic<long> bottom{0};
+  std::atomic<Job*> jobs[JOB_DEQUE_SIZE];
+
+  void Push(Job* job) {
+    long b = bottom.load(std::memory_order_relaxed);
+    IM_ASSERT(b - top.load(std::memory_order_acquire) < JOB_DEQUE_SIZE && "Job deque overflow");
+    jobs[b & (JOB_DEQUE_SIZE - 1)].store(job, std::memory_order_relaxed);
+    // Release: a thief that sees the new bottom sees the job's contents
+    bottom.store(b + 1, std::memory_order_release);
+  }
+
+  Job* Pop() {
+    long b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    long t = top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return NULL;
+    }
+
+    Job* job = jobs[b & (JOB_DEQUE_SIZE - 1)].load(std::memory_order_relaxed);
+    if (t == b) {
+      // Last one: race the thieves for it
+      if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        job = NULL;
+      bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return job;
+  }
+
+  Job* Steal() {
+    long t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    long b = bottom.load(std::memory_order_acquire);
+    if (t >= b)
+      return NULL;
+
+    Job* job = jobs[t & (JOB_DEQUE_SIZE - 1)].load(std::memory_order_relaxed);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+      return NULL;
+    return job;
+  }
+};
+
+struct JobThread {
+  JobDeque deque;
+  Job pool[JOB_POOL_SIZE];
+  Uint32 pool_next = 0;
+  Uint32 random_state = 0;
+  char name[16] = "";
+
+  std::atomic<Uint64> busy_ticks{0};
+  std::atomic<Uint64> jobs{0};
+  std::atomic<Uint64> steals{0};
+  std::atomic<Uint64> steal_attempts{0};
+
+  // Counter values at the last JobSystemEndFrame
+  Uint64 last_busy_ticks = 0, last_jobs = 0, last_steals = 0, last_steal_attempts = 0;
+  JobWorkerStats stats = {};
+};
+
+static std::vector<JobThread*> threads;
+static std::vector<std::thread> workers;
+static thread_local int thread_index = -1;
+
+static std::atomic<bool> quit{false};
+static std::atomic<int> queued_jobs{0};
+static std::atomic<int> sleeping_workers{0};
+static std::mutex sleep_mutex;
+static std::condition_variable sleep_condition;
+static Uint64 last_frame_end = 0;
+
+static JobThread* CurrentThread() {
+  IM_ASSERT(thread_index >= 0 && "Job functions may only be called from the main thread or from a job");
+  return threads[thread_index];
+}
+
+static Uint32 NextRandom(Uint32& state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+static Job* GetJob() {
+  JobThread* self = CurrentThread();
+  Job* job = self->deque.Pop();
+
+  if (job == NULL && threads.size() > 1) {
+    // Start at a random victim so thieves do not all pile onto the same deque
+    int count = (int)threads.size();
+    int start = (int)(NextRandom(self->random_state) % count);
+    for (int i = 0; i < count && job == NULL; i++) {
+      int victim = (start + i) % count;
+      if (victim == thread_index)
+        continue;
+      self->steal_attempts.fetch_add(1, std::memory_order_relaxed);
+      job = threads[victim]->deque.Steal();
+      if (job != NULL)
+        self->steals.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  if (job != NULL)
+    queued_jobs.fetch_sub(1);
+  return job;
+}
+
+static void Finish(Job* job) {
+  // Read before the decrement: once done, the slot may be handed out again
+  Job* parent = job->parent;
+  if (job->unfinished.fetch_sub(1, std::memory_order_acq_rel) == 1 && parent != NULL)
+    Finish(parent);
+}
+
+static void Execute(Job* job) {
+  JobThread* self = CurrentThread();
+  Uint64 begin = SDL_GetPerformanceCounter();
+  job->function(job, job->data);
+  Finish(job);
+  self->busy_ticks.fetch_add(SDL_GetPerformanceCounter() - begin, std::memory_order_relaxed);
+  self->jobs.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void WorkerMain(int index) {
+  thread_index = index;
+  ProfilerSetThreadName(threads[index]->name);
+
+  while (!quit.load()) {
+    Job* job = GetJob();
+    if (job != NULL) {
+      Execute(job);
+      continue;
+    }
+
+    // Nothing anywhere: sleep until a job gets queued. `sleeping_workers`
+    // and `queued_jobs` are both sequentially consistent, so either we see
+    // the new job here or JobRun sees us sleeping and wakes us.
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    sleeping_workers.fetch_add(1);
+    sleep_condition.wait(lock, [] { return queued_jobs.load() > 0 || quit.load(); });
+    sleeping_workers.fetch_sub(1);
+  }
+}
+
+void JobSystemInit(int worker_count) {
+  IM_ASSERT(threads.empty() && "JobSystemInit() called twice");
+  if (worker_count < 0)
+    worker_count = SDL_GetCPUCount() - 1;
+  if (worker_count > JOB_MAX_WORKERS - 1)
+    worker_count = JOB_MAX_WORKERS - 1;
+  if (worker_count < 0)
+    worker_count = 0;
+
+  quit = false;
+  for (int i = 0; i <= worker_count; i++) {
+    JobThread* thread = new JobThread();
+    thread->random_state = 2463534242u + i * 7919u;
+    if (i == 0)
+      snprintf(thread->name, sizeof(thread->name), "main");
+    else
+      snprintf(thread->name, sizeof(thread->name), "worker %d", i);
+    threads.push_back(thread);
+  }
+
+  thread_index = 0;
+  for (int i = 1; i <= worker_count; i++)
+    workers.emplace_back(WorkerMain, i);
+  last_frame_end = SDL_GetPerformanceCounter();
+}
+
+void JobSystemShutdown() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex);
+    quit = true;
+  }
+  sleep_condition.notify_all();
+  for (std::thread& worker : workers)
+    worker.join();
+  workers.clear();
+
+  for (JobThread* thread : threads)
+    delete thread;
+  threads.clear();
+  thread_index = -1;
+}
+
+int JobSystemThreadCount() {
+  return (int)threads.size();
+}
+
+Job* JobCreate(JobFunction function, const void* data, size_t size, Job* parent) {
+  IM_ASSERT(size <= JOB_DATA_SIZE && "Job data does not fit, pass a pointer instead");
+  JobThread* self = CurrentThread();
+  Job* job = &self->pool[self->pool_next++ & (JOB_POOL_SIZE - 1)];
+  // The ring came round to a job that is still running (or still has
+  // children running): help out until it is done rather than reuse it.
+  // Never returns if that job is waiting for this one to be created.
+  if (!JobIsDone(job))
+    JobWait(job);
+  job->function = function;
+  job->parent = parent;
+  job->unfinished.store(1, std::memory_order_relaxed);
+  if (size > 0)
+    memcpy(job->data, data, size);
+  if (parent != NULL)
+    parent->unfinished.fetch_add(1, std::memory_order_relaxed);
+  return job;
+}
+
+void JobRun(Job* job) {
+  CurrentThread()->deque.Push(job);
+  queued_jobs.fetch_add(1);
+  if (sleeping_workers.load() > 0) {
+    { std::lock_guard<std::mutex> lock(sleep_mutex); }
+    sleep_condition.notify_one();
+  }
+}
+
+bool JobIsDone(const Job* job) {
+  return job->unfinished.load(std::memory_order_acquire) == 0;
+}
+
+static void HelpOrYield() {
+  Job* next = GetJob();
+  if (next != NULL)
+    Execute(next);
+  else
+    std::this_thread::yield();
+}
+
+void JobWait(const Job* job) {
+  PROFILE_SCOPE("JobWait");
+  while (!JobIsDone(job))
+    HelpOrYield();
+}
+
+void JobWaitCounter(const std::atomic<int>& counter) {
+  PROFILE_SCOPE("JobWait");
+  while (counter.load(std::memory_order_acquire) > 0)
+    HelpOrYield();
+}
+
+struct JobRangeData {
+  JobRangeFunction function;
+  void* user_data;
+  int begin;
+  int end;
+};
+
+static void RunRange(Job*, const void* data) {
+  const JobRangeData* range = (const JobRangeData*)data;
+  range->function(range->begin, range->end, range->user_data);
+}
+
+static void Empty(Job*, const void*) {
+}
+
+Job* JobParallelFor(int count, int batch_size, JobRangeFunction function, void* user_data, Job* parent) {
+  IM_ASSERT(batch_size > 0);
+  // Going round the job ring would wait for the root, which only runs
+  // once every batch is created: use fewer, bigger batches instead
+  const int max_batches = JOB_POOL_SIZE / 2;
+  if ((count + batch_size - 1) / batch_size > max_batches)
+    batch_size = (count + max_batches - 1) / max_batches;
+  Job* root = JobCreate(Empty, NULL, 0, parent);
+  for (int begin = 0; begin < count; begin += batch_size) {
+    JobRangeData range = {function, user_data, begin, begin + batch_size < count ? begin + batch_size : count};
+    JobRun(JobCreate(RunRange, &range, sizeof(range), root));
+  }
+  JobRun(root);
+  return root;
+}
+
+void JobParallelForWait(int count, JobRangeFunction function, void* user_data) {
+  if (count <= 0)
+    return;
+  // Enough batches for uneven ones to even out, without filling the job pool
+  int batches = JobSystemThreadCount() * 8;
+  int batch_size = (count + batches - 1) / batches;
+  JobWait(JobParallelFor(count, batch_size, function, user_data));
+}
+
+void JobSystemEndFrame() {
+  Uint64 now = SDL_GetPerformanceCounter();
+  double frame_ticks = (double)(now - last_frame_end);
+  last_frame_end = now;
+
+  for (JobThread* thread : threads) {
+    Uint64 busy_ticks = thread->busy_ticks.load(std::memory_order_relaxed);
+    Uint64 jobs = thread->jobs.load(std::memory_order_relaxed);
+    Uint64 steals = thread->steals.load(std::memory_order_relaxed);
+    Uint64 steal_attempts = thread->steal_attempts.load(std::memory_order_relaxed);
+
+    thread->stats.utilisation = frame_ticks > 0.0 ? (float)((busy_ticks - thread->last_busy_ticks) / frame_ticks) : 0.0f;
+    thread->stats.jobs = jobs - thread->last_jobs;
+    thread->stats.steals = steals - thread->last_steals;
+    thread->stats.steal_attempts = steal_attempts - thread->last_steal_attempts;
+
+    thread->last_busy_ticks = busy_ticks;
+    thread->last_jobs = jobs;
+    thread->last_steals = steals;
+    thread->last_steal_attempts = steal_attempts;
+  }
+}
+
+const JobWorkerStats& JobGetWorkerStats(int index) {
+  IM_ASSERT(index >= 0 && index < (int)threads.size());
+  return threads[index]->stats;
+}
+
+void ShowJobSystemStats() {
+  ImGui::Columns(4, "job_workers");
+  ImGui::Text("Thread"); ImGui::NextColumn();
+  ImGui::Text("Utilisation"); ImGui::NextColumn();
+  ImGui::Text("Jobs"); ImGui::NextColumn();
+  ImGui::Text("Steals/attempts"); ImGui::NextColumn();
+  ImGui::Separator();
+  for (JobThread* thread : threads) {
+    const JobWorkerStats& stats = thread->stats;
+    ImGui::Text("%s", thread->name); ImGui::NextColumn();
+    ImGui::ProgressBar(stats.utilisation, ImVec2(-1, 0)); ImGui::NextColumn();
+    ImGui::Text("%llu", (unsigned long long)stats.jobs); ImGui::NextColumn();
+    ImGui::Text("%llu/%llu", (unsigned long long)stats.steals, (unsigned long long)stats.steal_attempts); ImGui::NextColumn();
+  }
+  ImGui::Columns(1);
+}
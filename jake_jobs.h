@@ -0,0 +1,92 @@
+#pragma once
+
+#include <SDL.h>
+#include <atomic>
+#include <stddef.h>
+
+/**
+   Work-stealing job system.
+
+   Every thread in the system (the main thread plus one worker per extra
+   core) owns a deque: it pushes and pops its own jobs at the bottom
+   without locks, idle threads steal from the top of someone else's deque
+   with a single CAS. A job counts its unfinished children; it is done
+   once it ran and all of them are done, which is what `JobWait` waits for
+   while helping out with other jobs.
+
+   Jobs come from a per-thread ring of `JOB_POOL_SIZE`: `JobCreate` reuses
+   the slot of the job created `JOB_POOL_SIZE` jobs earlier on the same
+   thread, and waits for that one to be done first. Keep the number of
+   jobs of a `JobParallelFor` well under the ring (split by thread count,
+   not by a fixed batch size), and do not keep a `Job*` across frames:
+   the slot may be handed out again and the pointer then names someone
+   else's job. Work that outlives a frame counts its jobs down in an
+   `std::atomic<int>` of its own instead, see `JobWaitCounter`. Only call
+   these from the main thread or from inside a job.
+ */
+
+const int JOB_MAX_WORKERS = 64;
+const int JOB_POOL_SIZE = 4096;     // per thread, power of two
+const int JOB_DEQUE_SIZE = 4096;    // per thread, power of two
+const int JOB_DATA_SIZE = 40;
+
+struct Job;
+typedef void (*JobFunction)(Job* job, const void* data);
+
+struct JobWorkerStats {
+  float utilisation;      // share of the last frame spent running jobs
+  Uint64 jobs;            // run during the last frame
+  Uint64 steals;          // stolen from other deques during the last frame
+  Uint64 steal_attempts;  // including the ones that came back empty
+};
+
+/**
+   `worker_count` extra threads, or one per core but the main one when -1.
+ */
+void JobSystemInit(int worker_count = -1);
+void JobSystemShutdown();
+
+/**
+   Including the main thread.
+ */
+int JobSystemThreadCount();
+
+/**
+   Create a job, copying `size` bytes of `data` into it. With a `parent`,
+   the parent is not done until this job is.
+ */
+Job* JobCreate(JobFunction function, const void* data = NULL, size_t size = 0, Job* parent = NULL);
+void JobRun(Job* job);
+void JobWait(const Job* job);
+bool JobIsDone(const Job* job);
+
+/**
+   `JobWait` for a counter the jobs decrement themselves when done, helping
+   out with other jobs until it reaches 0.
+ */
+void JobWaitCounter(const std::atomic<int>& counter);
+
+/**
+   Split [0, count) into chunks of `batch_size` and run `function` on each
+   as a child of the returned job, which is already running. Chunks get
+   bigger when there would be more than half of `JOB_POOL_SIZE`.
+ */
+typedef void (*JobRangeFunction)(int begin, int end, void* user_data);
+Job* JobParallelFor(int count, int batch_size, JobRangeFunction function, void* user_data, Job* parent = NULL);
+
+/**
+   `JobParallelFor` with a few batches per thread, returning once all of
+   [0, count) ran. Fits `ImFontAtlas::ParallelFor`.
+ */
+void JobParallelForWait(int count, JobRangeFunction function, void* user_data);
+
+/**
+   Snapshot the per-worker counters into `JobGetWorkerStats`, once a frame.
+ */
+void JobSystemEndFrame();
+const JobWorkerStats& JobGetWorkerStats(int thread_index);
+
+/**
+   Per-worker utilisation and steal counts, drawn into the current window.
+ */
+void ShowJobSystemStats();
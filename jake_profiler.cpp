@@ -0,0 +1,349 @@
+#include <SDL.h>
+#include "imgui.h"
+#include "jake_profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+
+/**
+   One per thread. Only the owning thread writes `events`, `head` and
+   `depth`; only the thread calling `ProfilerEndFrame` touches `tail`.
+   The name is a copy, the frames point at it long after the thread (and
+   whatever it named itself from) is gone.
+ */
+struct ProfilerThreadBuffer {
+  char name[32] = "worker";
+  ProfilerEvent events[PROFILER_RING_SIZE];
+  std::atomic<Uint32> head{0};
+  Uint32 tail = 0;
+  int depth = 0;
+};
+
+struct ProfilerTrack {
+  const char* name;
+  float ms[PROFILER_HISTORY_SIZE] = {};
+};
+
+// Buffers are never freed, the profiler lives as long as the process
+static std::mutex registry_mutex;
+static std::vector<ProfilerThreadBuffer*> registry;
+static thread_local ProfilerThreadBuffer* local_buffer = NULL;
+static ProfilerThreadBuffer* main_buffer = NULL;
+
+static Uint64 frame_begin = 0;
+static ProfilerFrame last_frame;
+static ProfilerFrame paused_frame;
+static bool paused = false;
+
+static float frame_history[PROFILER_HISTORY_SIZE] = {};
+static ImGuiPlotHistory session_history;
+static std::vector<ProfilerTrack> tracks;
+static int history_offset = 0;
+
+static ProfilerThreadBuffer* GetThreadBuffer() {
+  if (local_buffer == NULL) {
+    local_buffer = new ProfilerThreadBuffer();
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    registry.push_back(local_buffer);
+  }
+  return local_buffer;
+}
+
+static bool SameName(const char* a, const char* b) {
+  return a == b || strcmp(a, b) == 0;
+}
+
+static double TicksToMs(Uint64 ticks) {
+  static const double ms_per_tick = 1000.0 / (double)SDL_GetPerformanceFrequency();
+  return ticks * ms_per_tick;
+}
+
+ProfilerZone::ProfilerZone(const char* name) : name(name) {
+  ProfilerThreadBuffer* buffer = GetThreadBuffer();
+  depth = buffer->depth++;
+  begin = SDL_GetPerformanceCounter();
+}
+
+ProfilerZone::~ProfilerZone() {
+  Uint64 end = SDL_GetPerformanceCounter();
+  ProfilerThreadBuffer* buffer = local_buffer;
+  buffer->depth--;
+  Uint32 head = buffer->head.load(std::memory_order_relaxed);
+  buffer->events[head & (PROFILER_RING_SIZE - 1)] = {name, begin, end, depth};
+  buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void ProfilerSetThreadName(const char* name) {
+  ProfilerThreadBuffer* buffer = GetThreadBuffer();
+  snprintf(buffer->name, sizeof(buffer->name), "%s", name);
+}
+
+/**
+   Copy out everything `buffer` recorded since the last drain. The owner may
+   lap us while we copy, in which case the oldest copied slots are torn and
+   get dropped.
+ */
+static int DrainThreadBuffer(ProfilerThreadBuffer* buffer, std::vector<ProfilerEvent>& events) {
+  int dropped = 0;
+  Uint32 head = buffer->head.load(std::memory_order_acquire);
+  Uint32 tail = buffer->tail;
+  if (head - tail > (Uint32)PROFILER_RING_SIZE) {
+    dropped += head - tail - PROFILER_RING_SIZE;
+    tail = head - PROFILER_RING_SIZE;
+  }
+
+  events.clear();
+  for (Uint32 i = tail; i != head; i++)
+    events.push_back(buffer->events[i & (PROFILER_RING_SIZE - 1)]);
+
+  Uint32 head_after = buffer->head.load(std::memory_order_acquire);
+  if (head_after - tail > (Uint32)PROFILER_RING_SIZE) {
+    int torn = std::min((int)(head_after - tail - PROFILER_RING_SIZE), (int)events.size());
+    events.erase(events.begin(), events.begin() + torn);
+    dropped += torn;
+  }
+
+  buffer->tail = head;
+  return dropped;
+}
+
+static int FindOrAddNode(ProfilerThreadFrame& thread, int parent, const char* name, int depth) {
+  int first = parent == -1 ? thread.first_root : thread.nodes[parent].first_child;
+  int last = -1;
+  for (int i = first; i != -1; i = thread.nodes[i].next_sibling) {
+    if (SameName(thread.nodes[i].name, name))
+      return i;
+    last = i;
+  }
+
+  ProfilerNode node;
+  node.name = name;
+  node.parent = parent;
+  node.depth = depth;
+  thread.nodes.push_back(node);
+  int index = (int)thread.nodes.size() - 1;
+  if (last != -1)
+    thread.nodes[last].next_sibling = index;
+  else if (parent != -1)
+    thread.nodes[parent].first_child = index;
+  else
+    thread.first_root = index;
+  return index;
+}
+
+/**
+   Fold the events of one thread into a call tree. Zones are recorded when
+   they end, so children show up before their parent; sorting by begin time
+   puts them back in call order.
+ */
+static void BuildZoneTree(ProfilerThreadFrame& thread) {
+  std::sort(thread.events.begin(), thread.events.end(),
+            [](const ProfilerEvent& a, const ProfilerEvent& b) {
+              return a.begin != b.begin ? a.begin < b.begin : a.depth < b.depth;
+            });
+
+  thread.nodes.clear();
+  thread.first_root = -1;
+  thread.max_depth = 0;
+
+  std::vector<int> stack;
+  for (const ProfilerEvent& event : thread.events) {
+    while ((int)stack.size() > event.depth)
+      stack.pop_back();
+
+    int parent = stack.empty() ? -1 : stack.back();
+    int index = FindOrAddNode(thread, parent, event.name, (int)stack.size());
+
+    thread.nodes[index].ticks += event.end - event.begin;
+    thread.nodes[index].calls++;
+    thread.max_depth = std::max(thread.max_depth, event.depth);
+    stack.push_back(index);
+  }
+}
+
+void ProfilerBeginFrame() {
+  if (main_buffer == NULL) {
+    main_buffer = GetThreadBuffer();
+    snprintf(main_buffer->name, sizeof(main_buffer->name), "main");
+  }
+  frame_begin = SDL_GetPerformanceCounter();
+}
+
+static ProfilerTrack& GetTrack(const char* name) {
+  for (ProfilerTrack& track : tracks)
+    if (SameName(track.name, name))
+      return track;
+  tracks.push_back(ProfilerTrack());
+  tracks.back().name = name;
+  return tracks.back();
+}
+
+void ProfilerEndFrame() {
+  IM_ASSERT(main_buffer == local_buffer && "ProfilerEndFrame() must be called from the thread that called ProfilerBeginFrame()");
+
+  last_frame.begin = frame_begin;
+  last_frame.end = SDL_GetPerformanceCounter();
+  last_frame.dropped_events = 0;
+
+  std::vector<ProfilerThreadBuffer*> buffers;
+  {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    buffers = registry;
+  }
+  std::stable_partition(buffers.begin(), buffers.end(),
+                        [](ProfilerThreadBuffer* buffer) { return buffer == main_buffer; });
+
+  last_frame.threads.resize(buffers.size());
+  for (size_t i = 0; i < buffers.size(); i++) {
+    ProfilerThreadFrame& thread = last_frame.threads[i];
+    thread.thread_name = buffers[i]->name;
+    last_frame.dropped_events += DrainThreadBuffer(buffers[i], thread.events);
+    BuildZoneTree(thread);
+  }
+
+  // Rolling histories of the whole frame and of each top level zone of the main thread
+  history_offset = (history_offset + 1) % PROFILER_HISTORY_SIZE;
+  frame_history[history_offset] = (float)TicksToMs(last_frame.end - last_frame.begin);
+  if (session_history.Values.empty())
+    session_history.Init(PROFILER_SESSION_HISTORY_SIZE);
+  session_history.Push(frame_history[history_offset]);
+  for (ProfilerTrack& track : tracks)
+    track.ms[history_offset] = 0.0f;
+  const ProfilerThreadFrame& main_thread = last_frame.threads[0];
+  for (int i = main_thread.first_root; i != -1; i = main_thread.nodes[i].next_sibling)
+    GetTrack(main_thread.nodes[i].name).ms[history_offset] += (float)TicksToMs(main_thread.nodes[i].ticks);
+}
+
+const ProfilerFrame& ProfilerGetLastFrame() {
+  return last_frame;
+}
+
+float ProfilerGetZoneMs(const char* name) {
+  Uint64 ticks = 0;
+  for (const ProfilerThreadFrame& thread : last_frame.threads)
+    for (const ProfilerNode& node : thread.nodes)
+      if (SameName(node.name, name))
+        ticks += node.ticks;
+  return (float)TicksToMs(ticks);
+}
+
+static ImU32 ZoneColor(const char* name) {
+  ImU32 hash = 2166136261u;
+  for (const char* c = name; *c; c++)
+    hash = (hash ^ (unsigned char)*c) * 16777619u;
+  return ImColor::HSV((hash & 0xff) / 255.0f, 0.55f, 0.75f);
+}
+
+static void DrawFlameGraph(const ProfilerFrame& frame) {
+  double frame_ticks = (double)(frame.end - frame.begin);
+  if (frame_ticks <= 0.0)
+    return;
+
+  ImDrawList* draw_list = ImGui::GetWindowDrawList();
+  const float row_height = ImGui::GetTextLineHeight() + 2.0f;
+  const float width = ImGui::GetContentRegionAvailWidth();
+  const ImVec2 mouse = ImGui::GetIO().MousePos;
+
+  for (size_t t = 0; t < frame.threads.size(); t++) {
+    const ProfilerThreadFrame& thread = frame.threads[t];
+    if (thread.events.empty())
+      continue;
+
+    ImGui::TextDisabled("%s", thread.thread_name);
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImGui::PushID((int)t);
+    ImGui::InvisibleButton("##flame", ImVec2(width, (thread.max_depth + 1) * row_height));
+    ImGui::PopID();
+    bool hovered = ImGui::IsItemHovered();
+
+    for (const ProfilerEvent& event : thread.events) {
+      // Zones that straddle the frame boundary are clamped to it
+      double x0 = (double)(Sint64)(event.begin - frame.begin) / frame_ticks;
+      double x1 = (double)(Sint64)(event.end - frame.begin) / frame_ticks;
+      x0 = std::max(x0, 0.0);
+      x1 = std::min(x1, 1.0);
+      if (x1 <= x0)
+        continue;
+
+      ImVec2 min(origin.x + (float)(x0 * width), origin.y + event.depth * row_height);
+      ImVec2 max(std::max(origin.x + (float)(x1 * width), min.x + 1.0f), min.y + row_height - 1.0f);
+      draw_list->AddRectFilled(min, max, ZoneColor(event.name));
+      if (max.x - min.x > 8.0f) {
+        ImVec4 clip(min.x, min.y, max.x - 2.0f, max.y);
+        draw_list->AddText(NULL, 0.0f, ImVec2(min.x + 2.0f, min.y + 1.0f), IM_COL32_WHITE, event.name, NULL, 0.0f, &clip);
+      }
+
+      if (hovered && mouse.x >= min.x && mouse.x < max.x && mouse.y >= min.y && mouse.y < max.y)
+        ImGui::SetTooltip("%s: %.3f ms", event.name, TicksToMs(event.end - event.begin));
+    }
+  }
+}
+
+static void DrawZoneTree(const ProfilerThreadFrame& thread, int first) {
+  for (int i = first; i != -1; i = thread.nodes[i].next_sibling) {
+    const ProfilerNode& node = thread.nodes[i];
+    ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_DefaultOpen;
+    if (node.first_child == -1)
+      flags |= ImGuiTreeNodeFlags_Leaf;
+
+    bool open = ImGui::TreeNodeEx((void*)(intptr_t)i, flags, "%s", node.name);
+    ImGui::SameLine(ImGui::GetWindowContentRegionWidth() * 0.6f);
+    ImGui::Text("%8.3f ms %6d", TicksToMs(node.ticks), node.calls);
+    if (open) {
+      DrawZoneTree(thread, node.first_child);
+      ImGui::TreePop();
+    }
+  }
+}
+
+void ShowProfilerWindow(bool* p_open) {
+  if (!ImGui::Begin("Profiler", p_open)) {
+    ImGui::End();
+    return;
+  }
+
+  if (ImGui::Checkbox("Pause", &paused) && paused)
+    paused_frame = last_frame;
+  const ProfilerFrame& frame = paused ? paused_frame : last_frame;
+
+  ImGui::SameLine();
+  ImGui::Text("Frame: %.3f ms, %d dropped events",
+              TicksToMs(frame.end - frame.begin), frame.dropped_events);
+
+  if (ImGui::CollapsingHeader("History", ImGuiTreeNodeFlags_DefaultOpen)) {
+    char overlay[32];
+    int latest = history_offset;
+    int oldest = (history_offset + 1) % PROFILER_HISTORY_SIZE;
+
+    snprintf(overlay, sizeof(overlay), "%.3f ms", frame_history[latest]);
+    ImGui::PlotLines("Frame", frame_history, PROFILER_HISTORY_SIZE, oldest, overlay, 0.0f, FLT_MAX, ImVec2(0, 50));
+    snprintf(overlay, sizeof(overlay), "%d frames", session_history.Count);
+    ImGui::PlotLines("Session", session_history, overlay, 0.0f, FLT_MAX, ImVec2(0, 50));
+    for (const ProfilerTrack& track : tracks) {
+      snprintf(overlay, sizeof(overlay), "%.3f ms", track.ms[latest]);
+      ImGui::PlotLines(track.name, track.ms, PROFILER_HISTORY_SIZE, oldest, overlay, 0.0f, FLT_MAX, ImVec2(0, 30));
+    }
+  }
+
+  if (ImGui::CollapsingHeader("Flame graph", ImGuiTreeNodeFlags_DefaultOpen))
+    DrawFlameGraph(frame);
+
+  if (ImGui::CollapsingHeader("Zones", ImGuiTreeNodeFlags_DefaultOpen)) {
+    for (size_t t = 0; t < frame.threads.size(); t++) {
+      const ProfilerThreadFrame& thread = frame.threads[t];
+      if (thread.nodes.empty())
+        continue;
+      ImGui::PushID((int)t);
+      if (ImGui::TreeNodeEx("##thread", ImGuiTreeNodeFlags_DefaultOpen, "%s", thread.thread_name)) {
+        DrawZoneTree(thread, thread.first_root);
+        ImGui::TreePop();
+      }
+      ImGui::PopID();
+    }
+  }
+
+  ImGui::End();
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <SDL.h>
+#include <vector>
+
+/**
+   Hierarchical CPU profiler.
+
+   Put `PROFILE_SCOPE("name")` at the top of a block to time it. Zones nest,
+   and every thread records into its own ring buffer, so zones are cheap and
+   lock free on the hot path. Once per frame `ProfilerEndFrame` drains the
+   buffers and folds the events into a zone tree per thread, which
+   `ShowProfilerWindow` draws as a flame graph plus rolling histories.
+
+   `name` must be a string with static storage duration (a literal), the
+   pointer is stored as-is.
+ */
+
+const int PROFILER_RING_SIZE = 1 << 14; // events per thread, power of two
+const int PROFILER_HISTORY_SIZE = 240;  // frames kept for the history plots
+const int PROFILER_SESSION_HISTORY_SIZE = 1 << 20;  // frames kept for the session plot, over 4 hours at 60 Hz
+
+struct ProfilerEvent {
+  const char* name;
+  Uint64 begin;
+  Uint64 end;
+  int depth;
+};
+
+struct ProfilerNode {
+  const char* name;
+  int parent = -1;
+  int first_child = -1;
+  int next_sibling = -1;
+  int depth = 0;
+  Uint64 ticks = 0;
+  int calls = 0;
+};
+
+struct ProfilerThreadFrame {
+  const char* thread_name;
+  std::vector<ProfilerEvent> events; // sorted by begin time
+  std::vector<ProfilerNode> nodes;
+  int first_root = -1;
+  int max_depth = 0;
+};
+
+struct ProfilerFrame {
+  Uint64 begin = 0;
+  Uint64 end = 0;
+  std::vector<ProfilerThreadFrame> threads; // threads[0] is the main thread
+  int dropped_events = 0;
+};
+
+struct ProfilerZone {
+  explicit ProfilerZone(const char* name);
+  ~ProfilerZone();
+
+  ProfilerZone(const ProfilerZone&) = delete;
+  ProfilerZone& operator=(const ProfilerZone&) = delete;
+
+  const char* name;
+  Uint64 begin;
+  int depth;
+};
+
+#define PROFILE_CONCAT_(A, B) A##B
+#define PROFILE_CONCAT(A, B) PROFILE_CONCAT_(A, B)
+#define PROFILE_SCOPE(NAME) ProfilerZone PROFILE_CONCAT(profiler_zone_, __LINE__)(NAME)
+
+/**
+   Name the calling thread in the profiler window. Call once per thread,
+   before it records its first zone. Unlike zone names, `name` is copied.
+ */
+void ProfilerSetThreadName(const char* name);
+
+/**
+   Frame boundaries, call both from the main thread.
+ */
+void ProfilerBeginFrame();
+void ProfilerEndFrame();
+
+/**
+   The last completed frame, stable until the next `ProfilerEndFrame`.
+ */
+const ProfilerFrame& ProfilerGetLastFrame();
+
+/**
+   Total time in milliseconds spent in zones called `name`, summed over all
+   threads, during the last completed frame.
+ */
+float ProfilerGetZoneMs(const char* name);
+
+void ShowProfilerWindow(bool* p_open = NULL);
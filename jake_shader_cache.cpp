@@ -0,0 +1,324 @@
+#include <GL/glew.h>
+#include <SDL.h>
+#include "jake_shader_cache.h"
+#include "jake_file.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+const Uint32 PROGRAM_BINARY_MAGIC = 0x4248534a; // "JSHB"
+
+// Without KHR_parallel_shader_compile there's no asking whether a link is done, and asking for its status waits
+// for it. Leave the driver this many ShaderCacheUpdate() calls to get on with it before asking.
+const int LINK_CHECK_DELAY_FRAMES = 2;
+
+struct ProgramBinaryHeader {
+  Uint32 magic;
+  Uint32 format;
+  Uint32 length;
+};
+
+struct PendingProgram {
+  GLuint program;
+  GLuint vertex;
+  GLuint fragment;
+  Uint64 key;
+  bool from_cache;
+  int frames;     // ShaderCacheUpdate() calls while pending
+  std::string name;
+};
+
+static std::string cache_directory;
+static bool binaries_supported = false;
+static bool parallel_compile = false;
+static std::vector<PendingProgram> pending;
+struct FailedProgram {
+  GLuint program;
+  std::string error;
+};
+
+static std::vector<FailedProgram> failed;
+static ShaderCacheStats stats = {};
+
+static Uint64 HashString(Uint64 hash, const char* text) {
+  // Hash the terminator too so "ab" + "c" and "a" + "bc" differ
+  const unsigned char* c = (const unsigned char*)(text ? text : "");
+  do {
+    hash = (hash ^ *c) * 1099511628211ull;
+  } while (*c++);
+  return hash;
+}
+
+static Uint64 ProgramKey(const ShaderProgramDesc& desc) {
+  Uint64 key = 14695981039346656037ull;
+  key = HashString(key, (const char*)glGetString(GL_VENDOR));
+  key = HashString(key, (const char*)glGetString(GL_RENDERER));
+  key = HashString(key, (const char*)glGetString(GL_VERSION));
+  key = HashString(key, desc.vertex_source);
+  key = HashString(key, desc.fragment_source);
+  for (int i = 0; i < desc.attribute_count; i++)
+    key = HashString(key, desc.attributes[i]);
+  return key;
+}
+
+static std::string BinaryPath(Uint64 key) {
+  char file[32];
+  snprintf(file, sizeof(file), "/%016llx.bin", (unsigned long long)key);
+  return cache_directory + file;
+}
+
+void ShaderCacheInit(const char* directory) {
+  GLint formats = 0;
+  if (GLEW_ARB_get_program_binary)
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+  binaries_supported = directory != NULL && formats > 0;
+
+  if (binaries_supported) {
+    cache_directory = directory;
+    if (mkdir(directory, 0755) != 0 && errno != EEXIST) {
+      SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Can't create shader cache '%s': %s", directory, strerror(errno));
+      binaries_supported = false;
+    }
+  }
+
+  // Let the driver use as many compiler threads as it likes
+  if (GLEW_KHR_parallel_shader_compile) {
+    glMaxShaderCompilerThreadsKHR(0xffffffff);
+    parallel_compile = true;
+  } else if (GLEW_ARB_parallel_shader_compile) {
+    glMaxShaderCompilerThreadsARB(0xffffffff);
+    parallel_compile = true;
+  }
+
+  SDL_Log("Shader cache: %s, parallel compile %s", binaries_supported ? cache_directory.c_str() : "off",
+          parallel_compile ? "on" : "off");
+}
+
+void ShaderCacheShutdown() {
+  for (const PendingProgram& program : pending) {
+    glDeleteShader(program.vertex);
+    glDeleteShader(program.fragment);
+  }
+  pending.clear();
+  failed.clear();
+}
+
+static bool LoadBinary(GLuint program, Uint64 key) {
+  FILE* file = fopen(BinaryPath(key).c_str(), "rb");
+  if (file == NULL)
+    return false;
+
+  ProgramBinaryHeader header;
+  std::vector<char> binary;
+  long file_size = -1;
+  if (fseek(file, 0, SEEK_END) == 0) {
+    file_size = ftell(file);
+    rewind(file);
+  }
+  bool ok = fread(&header, sizeof(header), 1, file) == 1 && header.magic == PROGRAM_BINARY_MAGIC;
+  if (ok && (file_size < 0 || (Uint64)header.length > (Uint64)file_size - sizeof(header))) {
+    // Cut short or corrupt: don't believe the length before allocating it
+    stats.rejected++;
+    ok = false;
+  }
+  if (ok) {
+    binary.resize(header.length);
+    ok = fread(binary.data(), 1, header.length, file) == header.length;
+  }
+  fclose(file);
+  if (!ok)
+    return false;
+
+  glProgramBinary(program, header.format, binary.data(), (GLsizei)header.length);
+  GLint linked = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &linked);
+  if (!linked)
+    stats.rejected++;
+  return linked == GL_TRUE;
+}
+
+static void StoreBinary(GLuint program, Uint64 key) {
+  GLint length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0)
+    return;
+
+  // Header and binary in one buffer, written aside and renamed so parallel
+  // runs never see half a file
+  ProgramBinaryHeader header = {PROGRAM_BINARY_MAGIC, 0, 0};
+  std::vector<char> file(sizeof(header) + length);
+  GLenum format = 0;
+  GLsizei written = 0;
+  glGetProgramBinary(program, length, &written, &format, file.data() + sizeof(header));
+  header.format = format;
+  header.length = (Uint32)written;
+  memcpy(file.data(), &header, sizeof(header));
+
+  if (FileWriteReplace(BinaryPath(key), file.data(), sizeof(header) + written))
+    stats.stored++;
+}
+
+static GLuint CompileShader(GLenum type, const char* source) {
+  GLuint shader = glCreateShader(type);
+  glShaderSource(shader, 1, &source, NULL);
+  glCompileShader(shader);
+  return shader;
+}
+
+GLuint ShaderCacheCreateProgram(const ShaderProgramDesc& desc) {
+  PendingProgram entry;
+  entry.program = glCreateProgram();
+  entry.vertex = 0;
+  entry.fragment = 0;
+  entry.key = binaries_supported ? ProgramKey(desc) : 0;
+  entry.name = desc.name;
+  entry.from_cache = false;
+  entry.frames = 0;
+
+  if (binaries_supported && LoadBinary(entry.program, entry.key)) {
+    stats.hits++;
+    entry.from_cache = true;
+    pending.push_back(entry);
+    return entry.program;
+  }
+  stats.misses++;
+
+  for (int i = 0; i < desc.attribute_count; i++)
+    glBindAttribLocation(entry.program, i, desc.attributes[i]);
+  if (binaries_supported)
+    glProgramParameteri(entry.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+  // With parallel compile none of these wait for the compiler
+  entry.vertex = CompileShader(GL_VERTEX_SHADER, desc.vertex_source);
+  entry.fragment = CompileShader(GL_FRAGMENT_SHADER, desc.fragment_source);
+  glAttachShader(entry.program, entry.vertex);
+  glAttachShader(entry.program, entry.fragment);
+  glLinkProgram(entry.program);
+
+  pending.push_back(entry);
+  return entry.program;
+}
+
+static void PrintInfoLog(const char* what, const char* name, GLuint object, bool is_program, std::string& error) {
+  GLint length = 0;
+  if (is_program)
+    glGetProgramiv(object, GL_INFO_LOG_LENGTH, &length);
+  else
+    glGetShaderiv(object, GL_INFO_LOG_LENGTH, &length);
+  std::vector<char> log(length > 0 ? length : 1, '\0');
+  if (is_program)
+    glGetProgramInfoLog(object, (GLsizei)log.size(), NULL, log.data());
+  else
+    glGetShaderInfoLog(object, (GLsizei)log.size(), NULL, log.data());
+  SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "%s '%s' failed: %s", what, name, log.data());
+  error += what;
+  error += " failed:\n";
+  error += log.data();
+}
+
+static bool IsComplete(const PendingProgram& entry) {
+  if (entry.from_cache)
+    return true;
+  if (!parallel_compile)
+    return entry.frames >= LINK_CHECK_DELAY_FRAMES;
+  GLint complete = GL_FALSE;
+  glGetProgramiv(entry.program, GL_COMPLETION_STATUS_KHR, &complete);
+  return complete == GL_TRUE;
+}
+
+/**
+   The link is done: check it, store the binary and let go of the shaders.
+ */
+static void Finish(const PendingProgram& entry) {
+  GLint linked = GL_FALSE;
+  glGetProgramiv(entry.program, GL_LINK_STATUS, &linked);
+
+  if (!linked) {
+    FailedProgram failure;
+    failure.program = entry.program;
+    GLint vertex_compiled = GL_FALSE, fragment_compiled = GL_FALSE;
+    glGetShaderiv(entry.vertex, GL_COMPILE_STATUS, &vertex_compiled);
+    glGetShaderiv(entry.fragment, GL_COMPILE_STATUS, &fragment_compiled);
+    if (!vertex_compiled)
+      PrintInfoLog("Vertex shader", entry.name.c_str(), entry.vertex, false, failure.error);
+    if (!fragment_compiled)
+      PrintInfoLog("Fragment shader", entry.name.c_str(), entry.fragment, false, failure.error);
+    // The link log only repeats compile errors, it's interesting when both compiled
+    if (vertex_compiled && fragment_compiled)
+      PrintInfoLog("Link", entry.name.c_str(), entry.program, true, failure.error);
+    failed.push_back(failure);
+  } else if (binaries_supported && !entry.from_cache) {
+    StoreBinary(entry.program, entry.key);
+  }
+
+  if (entry.vertex) {
+    glDetachShader(entry.program, entry.vertex);
+    glDeleteShader(entry.vertex);
+  }
+  if (entry.fragment) {
+    glDetachShader(entry.program, entry.fragment);
+    glDeleteShader(entry.fragment);
+  }
+}
+
+ShaderProgramStatus ShaderCacheGetStatus(GLuint program) {
+  for (size_t i = 0; i < pending.size(); i++) {
+    if (pending[i].program != program)
+      continue;
+    if (!IsComplete(pending[i]))
+      return ShaderProgramStatus_Pending;
+    Finish(pending[i]);
+    pending.erase(pending.begin() + i);
+    break;
+  }
+
+  for (const FailedProgram& failure : failed)
+    if (failure.program == program)
+      return ShaderProgramStatus_Failed;
+  return ShaderProgramStatus_Ready;
+}
+
+const char* ShaderCacheGetError(GLuint program) {
+  for (const FailedProgram& failure : failed)
+    if (failure.program == program)
+      return failure.error.c_str();
+  return NULL;
+}
+
+void ShaderCacheDeleteProgram(GLuint program) {
+  for (size_t i = 0; i < pending.size(); i++) {
+    if (pending[i].program == program) {
+      glDeleteShader(pending[i].vertex);
+      glDeleteShader(pending[i].fragment);
+      pending.erase(pending.begin() + i);
+      break;
+    }
+  }
+  for (size_t i = 0; i < failed.size(); i++) {
+    if (failed[i].program == program) {
+      failed.erase(failed.begin() + i);
+      break;
+    }
+  }
+  glDeleteProgram(program);
+}
+
+void ShaderCacheUpdate() {
+  for (size_t i = 0; i < pending.size(); ) {
+    if (IsComplete(pending[i])) {
+      Finish(pending[i]);
+      pending.erase(pending.begin() + i);
+    } else {
+      pending[i].frames++;
+      i++;
+    }
+  }
+}
+
+const ShaderCacheStats& ShaderCacheGetStats() {
+  return stats;
+}
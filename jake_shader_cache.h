@@ -0,0 +1,73 @@
+#pragma once
+
+#include <GL/glew.h>
+
+/**
+   Shader program manager with an on-disk program binary cache.
+
+   Programs are keyed by a hash of their sources, attribute bindings and
+   the GL vendor/renderer/version strings. A hit loads the binary with
+   `glProgramBinary` and skips the compiler entirely. A miss compiles and
+   links with `KHR_parallel_shader_compile` when the driver has it, so the
+   calls return right away and the work happens on the driver's threads;
+   once the link is done the binary is written to the cache.
+
+   `ShaderCacheCreateProgram` never blocks. Poll `ShaderCacheGetStatus`
+   before drawing with the program (anything that queries the program, like
+   `glGetUniformLocation`, waits for it).
+
+   Without `KHR_parallel_shader_compile` a program only reports ready a
+   couple of `ShaderCacheUpdate` calls after it was created, and then its
+   link status is read. Drivers that compile on their own threads are done
+   by then; the others compiled inside the GL calls, so a hot reload still
+   costs the render thread one compile and link.
+ */
+
+struct ShaderProgramDesc {
+  const char* name;                 // for logs
+  const char* vertex_source;        // complete, including the #version line
+  const char* fragment_source;
+  const char* const* attributes;    // bound to locations 0..attribute_count-1
+  int attribute_count;
+};
+
+enum ShaderProgramStatus {
+  ShaderProgramStatus_Pending,
+  ShaderProgramStatus_Ready,
+  ShaderProgramStatus_Failed
+};
+
+struct ShaderCacheStats {
+  int hits;
+  int misses;
+  int stored;
+  int rejected;   // binaries cut short or refused by the driver, e.g. after a driver update
+};
+
+/**
+   Call once the GL context is current and GLEW is initialised. `directory`
+   is created if needed; NULL disables the disk cache.
+ */
+void ShaderCacheInit(const char* directory);
+void ShaderCacheShutdown();
+
+GLuint ShaderCacheCreateProgram(const ShaderProgramDesc& desc);
+ShaderProgramStatus ShaderCacheGetStatus(GLuint program);
+
+/**
+   The compiler/linker log of a failed program, NULL otherwise.
+ */
+const char* ShaderCacheGetError(GLuint program);
+
+/**
+   Delete a program made by `ShaderCacheCreateProgram`, linked or not.
+ */
+void ShaderCacheDeleteProgram(GLuint program);
+
+/**
+   Finish off the programs whose link completed: report errors, store
+   binaries. Call once per frame.
+ */
+void ShaderCacheUpdate();
+
+const ShaderCacheStats& ShaderCacheGetStats();
@@ -0,0 +1,144 @@
+#include <SDL.h>
+#include "imgui.h"
+#include "jake_simulation.h"
+#include "jake_jobs.h"
+#include "jake_profiler.h"
+
+#include <math.h>
+#include <string.h>
+
+const float SIMULATION_BOUNDS = 0.5f;
+const float TWO_PI = 6.28318530718f;
+const int UNIVERSE_BATCHES_PER_THREAD = 8;
+const int MIN_UNIVERSES_PER_JOB = 64;
+
+static Uint32 HashBytes(Uint32 hash, const void* data, size_t size) {
+  const unsigned char* bytes = (const unsigned char*)data;
+  for (size_t i = 0; i < size; i++)
+    hash = (hash ^ bytes[i]) * 16777619u;
+  return hash;
+}
+
+void SimulationStep(SimulationState& state, double dt) {
+  for (int axis = 0; axis < 2; axis++) {
+    state.position[axis] += state.velocity[axis] * (float)dt;
+    if (fabsf(state.position[axis]) > SIMULATION_BOUNDS) {
+      state.position[axis] = copysignf(SIMULATION_BOUNDS, state.position[axis]);
+      state.velocity[axis] = -state.velocity[axis];
+    }
+  }
+  state.angle = fmodf(state.angle + state.angular_velocity * (float)dt, TWO_PI);
+  state.tick++;
+
+  state.checksum = HashBytes(state.checksum, state.position, sizeof(state.position));
+  state.checksum = HashBytes(state.checksum, &state.angle, sizeof(state.angle));
+}
+
+SimulationState SimulationInterpolate(const SimulationState& a, const SimulationState& b, float alpha) {
+  SimulationState state = b;
+  for (int axis = 0; axis < 2; axis++) {
+    // Lerping across a bounce would cut the corner, snap to the newer state
+    if ((a.velocity[axis] < 0.0f) != (b.velocity[axis] < 0.0f))
+      continue;
+    state.position[axis] = a.position[axis] + (b.position[axis] - a.position[axis]) * alpha;
+  }
+
+  float delta = b.angle - a.angle;
+  if (delta > TWO_PI * 0.5f)
+    delta -= TWO_PI;
+  else if (delta < -TWO_PI * 0.5f)
+    delta += TWO_PI;
+  state.angle = a.angle + delta * alpha;
+  return state;
+}
+
+int FixedTimestepUpdate(FixedTimestep& timestep) {
+  Uint64 now = SDL_GetPerformanceCounter();
+  if (timestep.last_time == 0)
+    timestep.last_time = now;
+  timestep.accumulator_s += (now - timestep.last_time) / (double)SDL_GetPerformanceFrequency();
+  timestep.last_time = now;
+
+  const double dt = 1.0 / timestep.tick_rate;
+  int ticks = 0;
+  while (timestep.accumulator_s >= dt && ticks < timestep.max_catch_up_ticks) {
+    PROFILE_SCOPE("SimulationStep");
+    timestep.previous = timestep.current;
+    SimulationStep(timestep.current, dt);
+    timestep.accumulator_s -= dt;
+    ticks++;
+  }
+
+  // Fell behind by more than the cap: drop the backlog, keep the fraction
+  if (timestep.accumulator_s >= dt) {
+    Uint64 backlog = (Uint64)(timestep.accumulator_s / dt);
+    timestep.dropped_ticks += backlog;
+    timestep.accumulator_s -= backlog * dt;
+  }
+
+  Uint64 elapsed = SDL_GetPerformanceCounter() - now;
+  timestep.ticks_last_frame = ticks;
+  timestep.tick_ms = ticks > 0 ? (float)(elapsed * 1000.0 / SDL_GetPerformanceFrequency() / ticks) : 0.0f;
+  return ticks;
+}
+
+float FixedTimestepAlpha(const FixedTimestep& timestep) {
+  return (float)(timestep.accumulator_s * timestep.tick_rate);
+}
+
+SimulationState FixedTimestepRenderState(const FixedTimestep& timestep) {
+  return SimulationInterpolate(timestep.previous, timestep.current, FixedTimestepAlpha(timestep));
+}
+
+void SimulationRunTicks(SimulationState& state, Uint64 ticks, int tick_rate) {
+  const double dt = 1.0 / tick_rate;
+  for (Uint64 i = 0; i < ticks; i++)
+    SimulationStep(state, dt);
+}
+
+void MultiverseInit(Multiverse& multiverse, int universe_count) {
+  IM_ASSERT(multiverse.pending == NULL);
+  multiverse.universes.assign(universe_count, SimulationState());
+  for (int i = 0; i < universe_count; i++) {
+    SimulationState& universe = multiverse.universes[i];
+    universe.velocity[0] += i * 0.0011f;
+    universe.velocity[1] -= i * 0.0007f;
+    universe.angular_velocity += i * 0.0003f;
+  }
+  multiverse.checksum = 0;
+}
+
+static void AdvanceUniverses(int begin, int end, void* user_data) {
+  PROFILE_SCOPE("AdvanceUniverses");
+  Multiverse& multiverse = *(Multiverse*)user_data;
+  for (int i = begin; i < end; i++)
+    SimulationRunTicks(multiverse.universes[i], multiverse.pending_ticks, multiverse.tick_rate);
+}
+
+void MultiverseAdvance(Multiverse& multiverse, int ticks, int tick_rate) {
+  IM_ASSERT(multiverse.pending == NULL && "MultiverseWait() must come before the next MultiverseAdvance()");
+  if (ticks <= 0 || multiverse.universes.empty())
+    return;
+  multiverse.pending_ticks = ticks;
+  multiverse.tick_rate = tick_rate;
+  // A few batches per thread whatever the universe count, so a huge
+  // multiverse does not go round the job ring
+  int count = (int)multiverse.universes.size();
+  int batches = JobSystemThreadCount() * UNIVERSE_BATCHES_PER_THREAD;
+  int batch_size = (count + batches - 1) / batches;
+  if (batch_size < MIN_UNIVERSES_PER_JOB)
+    batch_size = MIN_UNIVERSES_PER_JOB;
+  multiverse.pending = JobParallelFor(count, batch_size, AdvanceUniverses, &multiverse);
+}
+
+void MultiverseWait(Multiverse& multiverse) {
+  if (multiverse.pending == NULL)
+    return;
+  JobWait(multiverse.pending);
+  multiverse.pending = NULL;
+
+  Uint32 checksum = 2166136261u;
+  for (const SimulationState& universe : multiverse.universes)
+    checksum = HashBytes(checksum, &universe.checksum, sizeof(universe.checksum));
+  multiverse.checksum = checksum;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <SDL.h>
+#include <vector>
+
+struct Job;
+
+/**
+   The simulated universe, advanced in fixed ticks independently of the
+   render rate. Everything here is plain data so two states can be blended
+   for rendering and compared between runs.
+ */
+struct SimulationState {
+  Uint64 tick = 0;
+  float position[2] = {0.0f, 0.0f};
+  float velocity[2] = {0.31f, 0.17f};   // units per second
+  float angle = 0.0f;                   // radians
+  float angular_velocity = 1.0f;        // radians per second
+  Uint32 checksum = 2166136261u;        // running hash of every state so far
+};
+
+/**
+   Fixed timestep driver: real time goes into an accumulator and comes out
+   as whole ticks of `1 / tick_rate` seconds. After a stall at most
+   `max_catch_up_ticks` run per frame, the rest of the backlog is dropped.
+ */
+struct FixedTimestep {
+  int tick_rate = 60;
+  int max_catch_up_ticks = 5;
+
+  double accumulator_s = 0.0;
+  Uint64 last_time = 0;
+
+  SimulationState previous;
+  SimulationState current;
+
+  int ticks_last_frame = 0;
+  float tick_ms = 0.0f;       // average cost of one tick during the last frame
+  Uint64 dropped_ticks = 0;   // in total
+};
+
+void SimulationStep(SimulationState& state, double dt);
+
+/**
+   Blend of two consecutive states, `alpha` in [0, 1] from `a` to `b`.
+ */
+SimulationState SimulationInterpolate(const SimulationState& a, const SimulationState& b, float alpha);
+
+/**
+   Run as many ticks as the time since the last call asks for, capped.
+   Returns the number of ticks run.
+ */
+int FixedTimestepUpdate(FixedTimestep& timestep);
+
+/**
+   How far the render time is between `previous` and `current`.
+ */
+float FixedTimestepAlpha(const FixedTimestep& timestep);
+
+/**
+   The state to render this frame.
+ */
+SimulationState FixedTimestepRenderState(const FixedTimestep& timestep);
+
+/**
+   Run `ticks` ticks back to back, as fast as possible, without looking at
+   the clock. For headless validation runs.
+ */
+void SimulationRunTicks(SimulationState& state, Uint64 ticks, int tick_rate);
+
+/**
+   Many independent universes, each a `SimulationState` with its own start
+   conditions, advanced in parallel on the job system. Universe 0 starts
+   like the one that is rendered.
+ */
+struct Multiverse {
+  std::vector<SimulationState> universes;
+  Uint32 checksum = 0;    // of all universe checksums, in order
+
+  Job* pending = NULL;
+  int pending_ticks = 0;
+  int tick_rate = 60;
+};
+
+void MultiverseInit(Multiverse& multiverse, int universe_count);
+
+/**
+   Start advancing every universe by `ticks` ticks and return right away.
+   The universes must not be touched until `MultiverseWait`.
+ */
+void MultiverseAdvance(Multiverse& multiverse, int ticks, int tick_rate);
+void MultiverseWait(Multiverse& multiverse);
@@ -0,0 +1,308 @@
+#include <SDL.h>
+#include "jake_text_viewer.h"
+#include "jake_jobs.h"
+#include "jake_profiler.h"
+
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+
+const size_t SCAN_CHUNK_SIZE = 1 << 20;
+
+// memchr is vectorised, lines are far longer than the call
+static void ScanNewlines(const char* text, size_t begin, size_t end, std::vector<size_t>& line_offsets) {
+  const char* p = text + begin;
+  const char* p_end = text + end;
+  while ((p = (const char*)memchr(p, '\n', p_end - p)) != NULL) {
+    p++;
+    line_offsets.push_back((size_t)(p - text));
+  }
+}
+
+struct NewlineScan {
+  const char* text;
+  size_t begin;
+  size_t end;
+  std::vector<std::vector<size_t>> chunks;
+};
+
+static void ScanChunks(int begin, int end, void* user_data) {
+  PROFILE_SCOPE("ScanNewlines");
+  NewlineScan& scan = *(NewlineScan*)user_data;
+  for (int i = begin; i < end; i++) {
+    size_t chunk_begin = scan.begin + i * SCAN_CHUNK_SIZE;
+    size_t chunk_end = chunk_begin + SCAN_CHUNK_SIZE < scan.end ? chunk_begin + SCAN_CHUNK_SIZE : scan.end;
+    ScanNewlines(scan.text, chunk_begin, chunk_end, scan.chunks[i]);
+  }
+}
+
+// Index the lines starting in text[begin, end)
+static void IndexLines(TextViewer& viewer, size_t begin) {
+  size_t end = viewer.text.size();
+  if (end - begin < TEXT_VIEWER_PARALLEL_SCAN || JobSystemThreadCount() <= 1) {
+    ScanNewlines(viewer.text.data(), begin, end, viewer.line_offsets);
+    return;
+  }
+
+  NewlineScan scan;
+  scan.text = viewer.text.data();
+  scan.begin = begin;
+  scan.end = end;
+  scan.chunks.resize((end - begin + SCAN_CHUNK_SIZE - 1) / SCAN_CHUNK_SIZE);
+  JobParallelForWait((int)scan.chunks.size(), ScanChunks, &scan);
+
+  size_t count = viewer.line_offsets.size();
+  for (const std::vector<size_t>& chunk : scan.chunks)
+    count += chunk.size();
+  viewer.line_offsets.reserve(count);
+  for (const std::vector<size_t>& chunk : scan.chunks)
+    viewer.line_offsets.insert(viewer.line_offsets.end(), chunk.begin(), chunk.end());
+}
+
+// SDL_Log may be called from any thread, lines wait here for the main one
+static std::mutex log_mutex;
+static std::vector<char> log_text;
+static TextViewer* log_viewer = NULL;
+static SDL_LogOutputFunction log_next_output = NULL;
+static void* log_next_userdata = NULL;
+
+static void LogOutput(void* userdata, int category, SDL_LogPriority priority, const char* message) {
+  static const char* const priority_names[SDL_NUM_LOG_PRIORITIES] = {
+    NULL, "VERBOSE", "DEBUG", "INFO", "WARN", "ERROR", "CRITICAL"
+  };
+  {
+    std::lock_guard<std::mutex> lock(log_mutex);
+    const char* name = priority_names[priority];
+    log_text.insert(log_text.end(), name, name + strlen(name));
+    log_text.push_back(':');
+    log_text.push_back(' ');
+    log_text.insert(log_text.end(), message, message + strlen(message));
+    log_text.push_back('\n');
+  }
+  if (log_next_output != NULL)
+    log_next_output(log_next_userdata, category, priority, message);
+}
+
+static void AppendNow(TextViewer& viewer, const char* text, const char* text_end) {
+  PROFILE_SCOPE("TextViewerAppend");
+  size_t begin = viewer.text.size();
+  viewer.text.insert(viewer.text.end(), text, text_end);
+  IndexLines(viewer, begin);
+}
+
+// Complete lines only: [begin, end) all have a line after them
+static void FilterLines(const TextViewer& viewer, const ImGuiTextFilter& filter, int begin, int end,
+                        std::vector<int>& out) {
+  const char* text = viewer.text.data();
+  const size_t* line_offsets = viewer.line_offsets.data();
+  for (int line = begin; line < end; line++) {
+    if ((line & 1023) == 0 && viewer.job_cancel.load(std::memory_order_relaxed))
+      return;
+    if (filter.PassFilter(text + line_offsets[line], text + line_offsets[line + 1] - 1))
+      out.push_back(line);
+  }
+}
+
+struct FilterBatchData {
+  TextViewer* viewer;
+  int index;
+};
+
+static void FilterBatch(Job*, const void* data) {
+  PROFILE_SCOPE("FilterLines");
+  const FilterBatchData& batch = *(const FilterBatchData*)data;
+  TextViewer& viewer = *batch.viewer;
+  int begin = viewer.job_begin + batch.index * viewer.job_batch_size;
+  int end = begin + viewer.job_batch_size < viewer.job_end ? begin + viewer.job_batch_size : viewer.job_end;
+  FilterLines(viewer, viewer.job_filter, begin, end, viewer.job_results[batch.index]);
+  viewer.job_lines_done.fetch_add(end - begin, std::memory_order_relaxed);
+  // Last touch of the viewer, the main thread may take the results now
+  viewer.job_batches_left.fetch_sub(1, std::memory_order_release);
+}
+
+static bool FilterJobIsDone(const TextViewer& viewer) {
+  return viewer.job_batches_left.load(std::memory_order_acquire) == 0;
+}
+
+static void StartFilterJob(TextViewer& viewer, int begin, int end) {
+  IM_ASSERT(!viewer.job_running);
+  // InputBuf is rebuilt rather than the struct copied: Filters point into it
+  memcpy(viewer.job_filter.InputBuf, viewer.filter.InputBuf, sizeof(viewer.job_filter.InputBuf));
+  viewer.job_filter.Build();
+
+  int count = end - begin;
+  int batch_size = count / (JobSystemThreadCount() * 8);
+  if (batch_size < TEXT_VIEWER_FILTER_BATCH)
+    batch_size = TEXT_VIEWER_FILTER_BATCH;
+  viewer.job_begin = begin;
+  viewer.job_end = end;
+  viewer.job_batch_size = batch_size;
+  int batches = (count + batch_size - 1) / batch_size;
+  viewer.job_results.assign(batches, std::vector<int>());
+  viewer.job_lines_done = 0;
+  viewer.job_batches_left = batches;
+  viewer.job_running = true;
+  for (int i = 0; i < batches; i++) {
+    FilterBatchData batch = {&viewer, i};
+    JobRun(JobCreate(FilterBatch, &batch, sizeof(batch)));
+  }
+}
+
+static void FinishFilterJob(TextViewer& viewer) {
+  viewer.job_running = false;
+  // Cancelled when the filter changed under it, the results are for the old one
+  if (!viewer.job_cancel.exchange(false)) {
+    IM_ASSERT(viewer.job_begin == viewer.filtered_count);
+    for (const std::vector<int>& batch : viewer.job_results)
+      viewer.filtered_lines.insert(viewer.filtered_lines.end(), batch.begin(), batch.end());
+    viewer.filtered_count = viewer.job_end;
+  }
+  viewer.job_results.clear();
+}
+
+static void RestartFilter(TextViewer& viewer) {
+  if (viewer.job_running)
+    viewer.job_cancel = true;
+  viewer.filtered_lines.clear();
+  viewer.filtered_count = 0;
+}
+
+void TextViewerAppend(TextViewer& viewer, const char* text, const char* text_end) {
+  if (text_end == NULL)
+    text_end = text + strlen(text);
+  if (viewer.job_running)
+    viewer.pending_text.insert(viewer.pending_text.end(), text, text_end);
+  else
+    AppendNow(viewer, text, text_end);
+}
+
+void TextViewerClear(TextViewer& viewer) {
+  if (viewer.job_running) {
+    viewer.job_cancel = true;
+    JobWaitCounter(viewer.job_batches_left);
+    FinishFilterJob(viewer);
+  }
+  viewer.text.clear();
+  viewer.line_offsets.assign(1, 0);
+  viewer.filtered_lines.clear();
+  viewer.filtered_count = 0;
+  viewer.pending_text.clear();
+}
+
+void TextViewerSetFilter(TextViewer& viewer, const char* filter) {
+  snprintf(viewer.filter.InputBuf, sizeof(viewer.filter.InputBuf), "%s", filter);
+  viewer.filter.Build();
+  RestartFilter(viewer);
+}
+
+void TextViewerUpdate(TextViewer& viewer) {
+  if (viewer.job_running) {
+    if (!FilterJobIsDone(viewer))
+      return;
+    FinishFilterJob(viewer);
+  }
+  if (&viewer == log_viewer) {
+    std::lock_guard<std::mutex> lock(log_mutex);
+    viewer.pending_text.insert(viewer.pending_text.end(), log_text.begin(), log_text.end());
+    log_text.clear();
+  }
+  if (!viewer.pending_text.empty()) {
+    AppendNow(viewer, viewer.pending_text.data(), viewer.pending_text.data() + viewer.pending_text.size());
+    viewer.pending_text.clear();
+  }
+  if (!viewer.filter.IsActive())
+    return;
+
+  // A few new lines are filtered right here, a bulk load or a new filter
+  // goes to the workers. Without any, one batch a frame keeps the UI going.
+  int complete = (int)viewer.line_offsets.size() - 1;
+  int remaining = complete - viewer.filtered_count;
+  if (remaining > TEXT_VIEWER_FILTER_BATCH && JobSystemThreadCount() > 1) {
+    StartFilterJob(viewer, viewer.filtered_count, complete);
+  } else if (remaining > 0) {
+    int end = viewer.filtered_count + (remaining < TEXT_VIEWER_FILTER_BATCH ? remaining : TEXT_VIEWER_FILTER_BATCH);
+    FilterLines(viewer, viewer.filter, viewer.filtered_count, end, viewer.filtered_lines);
+    viewer.filtered_count = end;
+  }
+}
+
+bool TextViewerIsFiltering(const TextViewer& viewer) {
+  if (viewer.job_running)
+    return true;
+  return viewer.filter.IsActive() && viewer.filtered_count < (int)viewer.line_offsets.size() - 1;
+}
+
+void TextViewerCaptureLog(TextViewer* viewer) {
+  if (viewer != NULL && log_viewer == NULL) {
+    SDL_LogGetOutputFunction(&log_next_output, &log_next_userdata);
+    SDL_LogSetOutputFunction(LogOutput, NULL);
+  } else if (viewer == NULL && log_viewer != NULL) {
+    SDL_LogSetOutputFunction(log_next_output, log_next_userdata);
+  }
+  std::lock_guard<std::mutex> lock(log_mutex);
+  log_viewer = viewer;
+  log_text.clear();
+}
+
+int TextViewerLineCount(const TextViewer& viewer) {
+  int count = (int)viewer.line_offsets.size();
+  // Nothing after the last newline yet
+  if (viewer.line_offsets.back() == viewer.text.size())
+    count--;
+  return count;
+}
+
+const char* TextViewerLineBegin(const TextViewer& viewer, int line) {
+  return viewer.text.data() + viewer.line_offsets[line];
+}
+
+const char* TextViewerLineEnd(const TextViewer& viewer, int line) {
+  if (line + 1 < (int)viewer.line_offsets.size())
+    return viewer.text.data() + viewer.line_offsets[line + 1] - 1;
+  return viewer.text.data() + viewer.text.size();
+}
+
+void ShowTextViewer(TextViewer& viewer, const char* id, const ImVec2& size) {
+  PROFILE_SCOPE("ShowTextViewer");
+  TextViewerUpdate(viewer);
+
+  ImGui::PushID(id);
+  if (viewer.filter.Draw("Filter (inc,-exc)", ImGui::GetFontSize() * 16.0f))
+    RestartFilter(viewer);
+  ImGui::SameLine();
+  ImGui::Checkbox("Auto-scroll", &viewer.auto_scroll);
+
+  int line_count = TextViewerLineCount(viewer);
+  bool filtering = viewer.filter.IsActive();
+  // The last line is not indexed for the filter until it is complete
+  int last_line = (int)viewer.line_offsets.size() - 1;
+  bool show_last_line = filtering && last_line < line_count
+                        && viewer.filter.PassFilter(TextViewerLineBegin(viewer, last_line), TextViewerLineEnd(viewer, last_line));
+  int row_count = filtering ? (int)viewer.filtered_lines.size() + (show_last_line ? 1 : 0) : line_count;
+
+  ImGui::SameLine();
+  if (!filtering)
+    ImGui::Text("%d lines", line_count);
+  else if (viewer.job_running)
+    ImGui::Text("%d of %d lines, filtering %d%%", row_count, line_count,
+                (int)(viewer.job_lines_done.load(std::memory_order_relaxed) * 100LL / (viewer.job_end - viewer.job_begin)));
+  else
+    ImGui::Text("%d of %d lines", row_count, line_count);
+
+  ImGui::BeginChild(id, size, true, ImGuiWindowFlags_HorizontalScrollbar);
+  ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0.0f, 0.0f));
+  ImGuiListClipper clipper(row_count, ImGui::GetTextLineHeight());
+  while (clipper.Step()) {
+    for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+      int line = row;
+      if (filtering)
+        line = row < (int)viewer.filtered_lines.size() ? viewer.filtered_lines[row] : last_line;
+      ImGui::TextUnformatted(TextViewerLineBegin(viewer, line), TextViewerLineEnd(viewer, line));
+    }
+  }
+  ImGui::PopStyleVar();
+  if (viewer.auto_scroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY())
+    ImGui::SetScrollHereY(1.0f);
+  ImGui::EndChild();
+  ImGui::PopID();
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <stddef.h>
+#include <atomic>
+#include <vector>
+#include "imgui.h"
+
+/**
+   Read-only view of a large, append-only text such as a validation log.
+
+   Appending indexes the new line starts once (bulk appends scan for
+   newlines in parallel on the job system), so drawing goes straight to
+   the lines in view through `ImGuiListClipper`: a frame costs the same
+   for a hundred lines or ten million, instead of `TextUnformatted`
+   walking and measuring the whole text.
+
+   The filter runs on the job system, over the complete lines indexed so
+   far; lines appended later are filtered as they come in. While a filter
+   job reads the text, appends are held back and land once it is done.
+   The last line, until its newline arrives, is filtered when drawn.
+
+   ImGui scrolls in floats, so past a million lines or so the scroll
+   position is no longer exact to the pixel.
+ */
+
+const size_t TEXT_VIEWER_PARALLEL_SCAN = 4 << 20;  // bytes appended at once before the newline scan is split up
+const int TEXT_VIEWER_FILTER_BATCH = 16384;         // lines per filter job, and the most filtered inline
+
+struct TextViewer {
+  std::vector<char> text;
+  std::vector<size_t> line_offsets{0};  // start of every line, the last one may still be growing
+
+  ImGuiTextFilter filter;
+  std::vector<int> filtered_lines;      // passing the filter, among the first `filtered_count` lines
+  int filtered_count = 0;
+
+  // Filter job, over lines [job_begin, job_end). It can run for many
+  // frames, so its batches count down `job_batches_left` rather than
+  // finish a `Job*` the job ring would hand out again meanwhile.
+  // `job_filter` is a copy of `filter` the UI cannot edit under it.
+  bool job_running = false;
+  std::atomic<int> job_batches_left{0};
+  ImGuiTextFilter job_filter;
+  int job_begin = 0;
+  int job_end = 0;
+  int job_batch_size = 0;
+  std::vector<std::vector<int>> job_results;  // per batch
+  std::atomic<bool> job_cancel{false};
+  std::atomic<int> job_lines_done{0};
+
+  std::vector<char> pending_text;       // appended while a job was reading `text`
+  bool auto_scroll = true;
+};
+
+/**
+   `text_end` NULL for a zero-terminated `text`. Call from the main thread.
+ */
+void TextViewerAppend(TextViewer& viewer, const char* text, const char* text_end = NULL);
+
+/**
+   Waits for a running filter job. Call before `JobSystemShutdown`.
+ */
+void TextViewerClear(TextViewer& viewer);
+
+/**
+   Same as typing `filter` in the filter box.
+ */
+void TextViewerSetFilter(TextViewer& viewer, const char* filter);
+
+/**
+   Collect a finished filter job, land held back appends and filter new
+   lines. `ShowTextViewer` calls it, and so must anything reading
+   `filtered_lines` without drawing.
+ */
+void TextViewerUpdate(TextViewer& viewer);
+
+/**
+   Whether lines are still waiting for the filter.
+ */
+bool TextViewerIsFiltering(const TextViewer& viewer);
+
+/**
+   Route `SDL_Log` output into `viewer` as well as where it went before,
+   NULL to stop. Any thread may log, the lines land in `TextViewerUpdate`.
+ */
+void TextViewerCaptureLog(TextViewer* viewer);
+
+int TextViewerLineCount(const TextViewer& viewer);
+const char* TextViewerLineBegin(const TextViewer& viewer, int line);
+const char* TextViewerLineEnd(const TextViewer& viewer, int line);  // before the newline
+
+/**
+   Filter box, line count and the text in a scrolling child of `size`,
+   drawn into the current window.
+ */
+void ShowTextViewer(TextViewer& viewer, const char* id, const ImVec2& size = ImVec2(0.0f, 0.0f));
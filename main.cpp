@@ -13,6 +13,12 @@
 #include <SDL_opengl.h>
 #include "jake.h"
 #include "jake_lib.h"
+#include "jake_gpu_timer.h"
+#include "jake_headless.h"
+#include "jake_jobs.h"
+#include "jake_gl_state.h"
+#include "jake_shader_cache.h"
+#include "jake_font_cache.h"
 #include "imgui.h"
 #include "imgui_impl_sdl.h"
 #include "imgui_impl_opengl3.h"
@@ -21,7 +27,10 @@
 
 void Cleanup(SDL_Window* window, SDL_GLContext gl_context) {
 
+  JobSystemShutdown();
+  GpuTimerShutdown();
   ImGui_ImplOpenGL3_Shutdown();
+  ShaderCacheShutdown();
   ImGui_ImplSDL2_Shutdown();
   ImGui::DestroyContext();
 
@@ -29,14 +38,23 @@ void Cleanup(SDL_Window* window, SDL_GLContext gl_context) {
   shader.CleanUp();
 
   glDisableVertexAttribArray(0);
-  glDeleteBuffers(1, vbo);
-  glDeleteVertexArrays(1, vao);
+  GlStateDeleteBuffers(2, vbo);
+  GlStateDeleteVertexArrays(1, vao);
 
   SDL_GL_DeleteContext(gl_context);
   SDL_DestroyWindow(window);
   SDL_Quit();
 }
 
+// The ImGui shaders go through the shader cache too. Both programs (regular and
+// distance field fonts) need the same attribute locations.
+static unsigned int
+CreateImGuiProgram(const char* vertex_shader, const char* fragment_shader) {
+  static const char* const attributes[] = { "Position", "UV", "Color" };
+  ShaderProgramDesc desc = { "imgui", vertex_shader, fragment_shader, attributes, 3 };
+  return ShaderCacheCreateProgram(desc);
+}
+
 void
 printInfo() {
   int glmaj, glmin;
@@ -46,7 +64,19 @@ printInfo() {
 };
 
 int
-main(int, char**) {
+main(int argc, char** argv) {
+  HeadlessOptions headless;
+  if (!ParseHeadlessOptions(argc, argv, headless))
+    return -1;
+
+  // Batch validation run: no window, no GL context
+  if (headless.enabled) {
+    SDL_CHECK_ZERO_FATAL(SDL_Init(SDL_INIT_TIMER));
+    int result = RunHeadless(headless);
+    SDL_Quit();
+    return result;
+  }
+
   SDL_CHECK_ZERO_FATAL(SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER));
 
   SDL_CHECK_ZERO(SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, 0));
@@ -92,8 +122,14 @@ main(int, char**) {
   //     return -1;
   // }
 
+  // From here on GL state changes go through the state cache
+  GlStateInit();
+  ShaderCacheInit("shader_cache");
   SetupBufferObjects();
 
+  if (!GpuTimerInit())
+    SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "GL timer queries not supported, GPU timings disabled");
+
   // Setup Dear ImGui context
   IMGUI_CHECKVERSION();
   ImGui::CreateContext();
@@ -102,6 +138,7 @@ main(int, char**) {
 
   // Setup Platform/Renderer bindings
   ImGui_ImplSDL2_InitForOpenGL(window, gl_context);
+  ImGui_ImplOpenGL3_SetCreateProgramFn(CreateImGuiProgram, ShaderCacheDeleteProgram);
   ImGui_ImplOpenGL3_Init();
 
   // Setup Style
@@ -131,93 +168,222 @@ main(int, char**) {
   // GameWorld - the one and only
   static GameWorld world;
 
+  TextViewerCaptureLog(&world.log);
+
+  // The main thread only handles events and rendering, the multiverse runs on the workers
+  JobSystemInit();
+  MultiverseInit(world.multiverse, world.universe_count);
+
+  // Load the atlas from the font cache, or build it with the glyphs rasterized on the workers.
+  // Characters outside the default ranges are rasterized the first time they're drawn.
+  io.Fonts->ParallelFor = JobParallelForWait;
+  io.Fonts->Flags |= ImFontAtlasFlags_DynamicGlyphs;
+  FontCacheLoadAtlas(io.Fonts, "font_cache");
+
+  // Edit the shaders while running, no restart needed
+  if (FileWatchInit(world.shader_watch)) {
+    FileWatchAdd(world.shader_watch, "tutorial2.vert");
+    FileWatchAdd(world.shader_watch, "tutorial2.frag");
+  }
+  std::vector<std::string> changed_files;
+
   printInfo();
 
   // Main loop
   while (world.do_run) {
+    ProfilerBeginFrame();
+    FramePacerBeginFrame(world.pacer, world.target_framerate);
+    GpuTimerBeginFrame();
+
+    // Frame boundary: nothing is drawing, a rebuilt program can take over
+    {
+      PROFILE_SCOPE("Shaders");
+      if (FileWatchPoll(world.shader_watch, changed_files)) {
+        for (const std::string& path : changed_files)
+          SDL_Log("%s changed, reloading shaders", path.c_str());
+        shader.Reload();
+      }
+      ShaderCacheUpdate();
+      shader.Update();
+    }
+
     // Poll and handle events (inputs, window resize, etc.)
     // You can read the io.WantCaptureMouse, io.WantCaptureKeyboard flags to tell if dear imgui wants to use your inputs.
     // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application.
     // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main application.
     // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
     SDL_Event event;
-    while (SDL_PollEvent(&event) != 0) {
+    {
+      PROFILE_SCOPE("PollEvents");
+      while (SDL_PollEvent(&event) != 0) {
 
-      ImGui_ImplSDL2_ProcessEvent(&event);
+        ImGui_ImplSDL2_ProcessEvent(&event);
 
-      switch (event.type) {
-      case SDL_QUIT: world.do_run = false; break;
-      case SDL_MOUSEMOTION:
-        if (!io.WantCaptureMouse) {
-        }
-      case SDL_MOUSEWHEEL:
-        if (!io.WantCaptureMouse) {
-        }
-      case SDL_MOUSEBUTTONDOWN:
-        if (!io.WantCaptureMouse) {
-        }
-      case SDL_KEYDOWN:
-        if (!io.WantCaptureKeyboard) {
-          switch (event.key.keysym.sym) {
-          case SDLK_q: world.do_run = false; break;
+        switch (event.type) {
+        case SDL_QUIT: world.do_run = false; break;
+        case SDL_MOUSEMOTION:
+          if (!io.WantCaptureMouse) {
+          }
+        case SDL_MOUSEWHEEL:
+          if (!io.WantCaptureMouse) {
+          }
+        case SDL_MOUSEBUTTONDOWN:
+          if (!io.WantCaptureMouse) {
+          }
+        case SDL_KEYDOWN:
+          if (!io.WantCaptureKeyboard) {
+            switch (event.key.keysym.sym) {
+            case SDLK_q: world.do_run = false; break;
+            }
           }
         }
       }
     }
 
-    // Start the Dear ImGui frame
-    ImGui_ImplOpenGL3_NewFrame();
-    ImGui_ImplSDL2_NewFrame(window);
-    ImGui::NewFrame();
+    // Advance the simulation by whole ticks, independent of the render rate
+    {
+      PROFILE_SCOPE("Simulation");
+      FixedTimestepUpdate(world.timestep);
+      MultiverseAdvance(world.multiverse, world.timestep.ticks_last_frame, world.timestep.tick_rate);
+    }
 
-    // 1. Show the big demo window (Most of the sample code is in ImGui::ShowDemoWindow()! You can browse its code to learn more about Dear ImGui!).
-    if (world.ui.show_demo_window)
-      ImGui::ShowDemoWindow(&world.ui.show_demo_window);
+    // Start the Dear ImGui frame
+    {
+      PROFILE_SCOPE("ImGui::NewFrame");
+      ImGui_ImplOpenGL3_NewFrame();
+      ImGui_ImplSDL2_NewFrame(window);
+      ImGui::NewFrame();
+    }
 
-    // 2. Show a simple window that we create ourselves. We use a Begin/End pair to created a named window.
     {
-      ImGui::Begin("DevInfo");
-
-      // Display some text (you can use a format strings too)
-      // ImGui::Text("This is some useful text.");
-      // Edit bools storing our window open/close state
-      ImGui::Checkbox("Demo Window", &world.ui.show_demo_window);
-
-      // Edit 1 float using a slider from 0.0f to 1.0f
-      ImGui::ColorEdit4("clear color", (float*)&world.ui.clear_color);
-
-      // Buttons return true when clicked (most widgets return true when edited/activated)
-      // if (ImGui::Button("Button"))
-      // ImGui::SameLine();
-      // ImGui::Text("counter = %d", counter);
-
-      // world.debug_info.framerate = ImGui::GetIO().Framerate;
-      world.debug_info.framerate = io.Framerate;
-      world.debug_info.frame_length = 1000.0f / world.debug_info.framerate;
-      ImGui::Text("Average %.1f ms/frame (%.1f FPS)",
-                  world.debug_info.frame_length, world.debug_info.framerate);
-
-      ImGui::Text("Delay (wanted/actual): %d ms/%.3f s",
-                  world.frame_delay, world.debug_info.actual_delay_s);
-
-      world.debug_info.imgui_draw_time_s = (float)world.debug_info.imgui_draw_time_perf / performance_frequency;
-      ImGui::Text("ImGui draw time: %.3f s",
-                  world.debug_info.imgui_draw_time_s);
-      ImGui::End();
+      PROFILE_SCOPE("UI");
+
+      // 1. Show the big demo window (Most of the sample code is in ImGui::ShowDemoWindow()! You can browse its code to learn more about Dear ImGui!).
+      if (world.ui.show_demo_window)
+        ImGui::ShowDemoWindow(&world.ui.show_demo_window);
+
+      // 2. Show a simple window that we create ourselves. We use a Begin/End pair to created a named window.
+      {
+        ImGui::Begin("DevInfo");
+
+        // Display some text (you can use a format strings too)
+        // ImGui::Text("This is some useful text.");
+        // Edit bools storing our window open/close state
+        ImGui::Checkbox("Demo Window", &world.ui.show_demo_window);
+        ImGui::Checkbox("Profiler", &world.ui.show_profiler_window);
+        ImGui::SameLine();
+        ImGui::Checkbox("GPU Timings", &world.ui.show_gpu_timer_window);
+        ImGui::SameLine();
+        ImGui::Checkbox("Log", &world.ui.show_log_window);
+
+        // Edit 1 float using a slider from 0.0f to 1.0f
+        ImGui::ColorEdit4("clear color", (float*)&world.ui.clear_color);
+
+        // Buttons return true when clicked (most widgets return true when edited/activated)
+        // if (ImGui::Button("Button"))
+        // ImGui::SameLine();
+        // ImGui::Text("counter = %d", counter);
+
+        // world.debug_info.framerate = ImGui::GetIO().Framerate;
+        world.debug_info.framerate = io.Framerate;
+        world.debug_info.frame_length = 1000.0f / world.debug_info.framerate;
+        ImGui::Text("Average %.1f ms/frame (%.1f FPS)",
+                    world.debug_info.frame_length, world.debug_info.framerate);
+
+        int pacing_mode = world.pacer.mode;
+        auto pacing_mode_name = [](void*, int mode, const char** out_text) {
+          *out_text = FramePacingModeName((FramePacingMode)mode);
+          return true;
+        };
+        if (ImGui::Combo("Frame pacing", &pacing_mode, pacing_mode_name, NULL, FramePacingMode_COUNT)) {
+          world.pacer.mode = (FramePacingMode)pacing_mode;
+          SDL_CHECK_ZERO(SDL_GL_SetSwapInterval(world.pacer.mode == FramePacingMode_Uncapped ? 0 : 1));
+        }
+        ImGui::SliderInt("Target framerate", &world.target_framerate, 10, 240);
+
+        const FramePacerStats& pacing = world.debug_info.pacing;
+        ImGui::Text("Frame interval %.2f ms, jitter %.2f ms",
+                    pacing.frame_interval_ms, pacing.jitter_ms);
+        ImGui::Text("Work %.2f ms, wait %.2f ms (spin %.2f ms)",
+                    pacing.work_ms, pacing.wait_ms, pacing.spin_margin_ms);
+        ImGui::Text("Missed deadlines: %d", pacing.missed_deadlines);
+
+        ImGui::SliderInt("Tick rate", &world.timestep.tick_rate, 1, 1000);
+        ImGui::SliderInt("Max catch-up ticks", &world.timestep.max_catch_up_ticks, 1, 32);
+        ImGui::Text("Tick %llu, %d ticks/frame at %.3f ms/tick, %llu dropped",
+                    (unsigned long long)world.timestep.current.tick, world.timestep.ticks_last_frame,
+                    world.timestep.tick_ms, (unsigned long long)world.timestep.dropped_ticks);
+
+        if (ImGui::CollapsingHeader("Multiverse")) {
+          ImGui::Text("%d universes, checksum 0x%08x",
+                      (int)world.multiverse.universes.size(), (unsigned)world.multiverse.checksum);
+          ShowJobSystemStats();
+        }
+        if (ImGui::CollapsingHeader("GL state")) {
+          const GlStateStats& gl_state = GlStateGetFrameStats();
+          ImGui::Text("%d calls, %d redundant ones avoided", gl_state.calls, gl_state.avoided);
+        }
+        if (ImGui::CollapsingHeader("Shader cache")) {
+          const ShaderCacheStats& shader_cache = ShaderCacheGetStats();
+          ImGui::Text("%d hits, %d misses, %d stored, %d rejected", shader_cache.hits, shader_cache.misses,
+                      shader_cache.stored, shader_cache.rejected);
+        }
+        if (ImGui::CollapsingHeader("Font cache")) {
+          const FontCacheStats& font_cache = FontCacheGetStats();
+          ImGui::Text("%d hits, %d misses, %d stored, %.1f ms at startup", font_cache.hits, font_cache.misses,
+                      font_cache.stored, font_cache.ms);
+        }
+        ImGui::End();
+      }
+
+      // 3. Frame timings, per zone
+      if (world.ui.show_profiler_window)
+        ShowProfilerWindow(&world.ui.show_profiler_window);
+      if (world.ui.show_gpu_timer_window)
+        ShowGpuTimerWindow(&world.ui.show_gpu_timer_window);
+      if (world.ui.show_log_window) {
+        ImGui::Begin("Log", &world.ui.show_log_window);
+        ShowTextViewer(world.log, "log");
+        ImGui::End();
+      } else {
+        TextViewerUpdate(world.log);
+      }
+
+      // 4. Shader errors, until the next save compiles
+      if (!shader.error.empty()) {
+        ImGui::SetNextWindowPos(ImVec2(10.0f, 10.0f));
+        ImGui::SetNextWindowBgAlpha(0.85f);
+        // Only changes with the error, so ImGui keeps last frame's vertices while it stays up
+        ImGui::SetNextWindowContentVersion((ImU32)std::hash<std::string>()(shader.error));
+        ImGui::Begin("Shader error", NULL, ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize
+                     | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoMove
+                     | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing);
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "tutorial2 shaders failed, still using the last good build");
+        ImGui::Separator();
+        ImGui::TextUnformatted(shader.error.c_str());
+        ImGui::End();
+      }
     }
 
     // Rendering
-    COUNT_PERFORMANCE(world.debug_info.imgui_draw_time_perf, {
-            SDL_GL_MakeCurrent(window, gl_context);
-            ImGui::Render();
-            glViewport(0, 0, (int)io.DisplaySize.x, (int)io.DisplaySize.y);
-            auto clear_color = world.ui.clear_color;
-            glClearColor(clear_color.x, clear_color.y, clear_color.z, clear_color.w);
-            glClear(GL_COLOR_BUFFER_BIT);
-            Render(window);
-            // glUseProgram(0); // You may want this if using this code in an OpenGL 3+ context where shaders may be bound
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-      });
+    {
+      PROFILE_SCOPE("ImGui::Render");
+      SDL_GL_MakeCurrent(window, gl_context);
+      ImGui::Render();
+    }
+    {
+      PROFILE_GPU_SCOPE("Render");
+      GlStateViewport(0, 0, (int)io.DisplaySize.x, (int)io.DisplaySize.y);
+      auto clear_color = world.ui.clear_color;
+      GlStateClearColor(clear_color.x, clear_color.y, clear_color.z, clear_color.w);
+      glClear(GL_COLOR_BUFFER_BIT);
+      Render(window, FixedTimestepRenderState(world.timestep));
+    }
+    {
+      PROFILE_GPU_SCOPE("ImGui_ImplOpenGL3_RenderDrawData");
+      // glUseProgram(0); // You may want this if using this code in an OpenGL 3+ context where shaders may be bound
+      ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    }
 
     /** nogo
     SDL_Rect rect = {10, 10, 10, 10};
@@ -226,12 +392,27 @@ main(int, char**) {
 
     SDL_RenderPresent(renderer);
     */
-    SDL_GL_SwapWindow(window);
+    {
+      PROFILE_SCOPE("SwapWindow");
+      SDL_GL_SwapWindow(window);
+    }
+    FramePacerEndFrame(world.pacer, world.target_framerate);
+    world.debug_info.pacing = world.pacer.stats;
+
+    // The universes keep advancing on the workers through the pacing wait
+    {
+      PROFILE_SCOPE("Multiverse");
+      MultiverseWait(world.multiverse);
+    }
 
-    COUNT_PERFORMANCE(world.debug_info.actual_delay_perf, SDL_Delay(world.frame_delay));
-    world.debug_info.actual_delay_s = (float)world.debug_info.actual_delay_perf / performance_frequency;
+    JobSystemEndFrame();
+    GlStateEndFrame();
+    ProfilerEndFrame();
   }
 
+  FileWatchShutdown(world.shader_watch);
+  TextViewerCaptureLog(NULL);
+  TextViewerClear(world.log);
   Cleanup(window, gl_context);
 
   return 0;
@@ -0,0 +1,1365 @@
+#include "imgui.h"
+#include "imgui_internal.h"
+#include "jake_fixtures.h"
+#include "jake_font_cache.h"
+#include "jake_frame_pacer.h"
+#include "jake_jobs.h"
+#include "jake_profiler.h"
+#include "jake_text_viewer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <dirent.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+/**
+   Correctness tests for the hot paths the benchmarks time, without a
+   window. Run from the repository root, they load the fonts under
+   ./imgui/misc/fonts:
+
+     tests/jake_tests            every test
+     tests/jake_tests hash text  only these
+     tests/jake_tests --print    also print the golden values
+
+   tests/compact/jake_tests_compact is the same, with everything built for
+   the 12 byte ImDrawVert (IMGUI_USE_COMPACT_DRAWVERT) and its range check.
+
+   The scenes and inputs come from jake_fixtures.h, the same the
+   benchmarks time.
+
+   Output of code we rewrote for speed is compared against golden hashes
+   taken from the code it replaced. When an output change is intended,
+   check it by eye and pin the values --print gives.
+ */
+
+static int failures = 0;
+static bool print_golden = false;
+
+static bool Check(bool ok, const char* expression, const char* file, int line) {
+  if (!ok) {
+    printf("%s:%d: CHECK(%s) failed\n", file, line, expression);
+    failures++;
+  }
+  return ok;
+}
+
+#define CHECK(EXPRESSION) Check((EXPRESSION), #EXPRESSION, __FILE__, __LINE__)
+
+// The golden hashes are of the default 20 byte ImDrawVert and 16-bit indices, other layouts only print theirs
+static void CheckGolden(const char* name, ImU32 hash, ImU32 golden) {
+  if (print_golden)
+    printf("  %-28s 0x%08X\n", name, hash);
+#ifndef IMGUI_USE_COMPACT_DRAWVERT
+  if (sizeof(ImDrawIdx) == 2 && hash != golden) {
+    printf("  %s: 0x%08X, golden 0x%08X\n", name, hash, golden);
+    failures++;
+  }
+#endif
+}
+
+// Everything a renderer sees of a draw list
+static ImU32 HashDrawList(const ImDrawList& list, ImU32 hash) {
+  for (const ImDrawCmd& cmd : list.CmdBuffer) {
+    hash = ImHashCrc32Table(&cmd.ElemCount, sizeof(cmd.ElemCount), hash);
+    hash = ImHashCrc32Table(&cmd.ClipRect, sizeof(cmd.ClipRect), hash);
+    hash = ImHashCrc32Table(&cmd.TextureId, sizeof(cmd.TextureId), hash);
+  }
+  hash = ImHashCrc32Table(list.VtxBuffer.Data, list.VtxBuffer.Size * (int)sizeof(ImDrawVert), hash);
+  return ImHashCrc32Table(list.IdxBuffer.Data, list.IdxBuffer.Size * (int)sizeof(ImDrawIdx), hash);
+}
+
+static ImU32 HashDrawData(const ImDrawData* draw_data, ImU32 hash) {
+  for (int n = 0; n < draw_data->CmdListsCount; n++)
+    hash = HashDrawList(*draw_data->CmdLists[n], hash);
+  return hash;
+}
+
+static void TestHash() {
+  // Known answers for "123456789"
+  CHECK(ImHashCrc32Table("123456789", 9, 0) == 0xCBF43926u);
+  CHECK(ImHashCrc32c("123456789", 9, 0) == 0xE3069283u);
+
+  const ImHashFunction FUNCTIONS[] = {ImHashCrc32Table, ImHashCrc32c, ImHashWords};
+  for (ImHashFunction fn : FUNCTIONS) {
+    ImHashSetFunction(fn);
+    // "###" resets the hash, "label###id" and "other###id" must be the same ID
+    CHECK(ImHash("Label###id", 0, 42) == ImHash("Other label###id", 0, 42));
+    CHECK(ImHash("a####x", 0, 42) == ImHash("###x", 0, 42));
+    CHECK(ImHash("Label##id", 0, 42) != ImHash("Other##id", 0, 42));
+    CHECK(ImHash("", 0, 42) == 42);
+    // Strings hash the same as their bytes
+    CHECK(ImHash("Universe 17", 0, 7) == fn("Universe 17", 11, 7));
+    CHECK(ImHash("Universe 17", 0, 7) != ImHash("Universe 17", 0, 8));
+    // Every alignment and length around the 16 byte blocks of the string scan
+    char buffer[80];
+    for (int align = 0; align < 16; align++) {
+      for (int length = 1; length < 48; length++) {
+        char* str = buffer + align;
+        for (int i = 0; i < length; i++)
+          str[i] = (char)('a' + (i * 7 + align) % 26);
+        str[length] = '\0';
+        CHECK(ImHash(str, 0, 3) == fn(str, length, 3));
+        if (length > 4) {
+          memcpy(str + length - 4, "###z", 4);
+          CHECK(ImHash(str, 0, 3) == fn("###z", 4, 3));
+        }
+      }
+    }
+  }
+  ImHashSetFunction(NULL);
+}
+
+// Against a std::unordered_map doing the same
+static void TestStorage() {
+  for (int pattern = 0; pattern < 2; pattern++) {
+    ImGuiStorage storage;
+    std::unordered_map<ImGuiID, int> expected;
+    ImU32 rng = 12345;
+    bool ok = true;
+    for (int i = 0; i < 50000; i++) {
+      rng = rng * 1664525u + 1013904223u;
+      // Random IDs, then small sequential ones to check they spread
+      ImGuiID key = pattern == 0 ? rng >> (rng & 15) : (ImGuiID)(i % 3000);
+      if (rng & 0x10000) {
+        storage.SetInt(key, i);
+        expected[key] = i;
+      } else if (rng & 0x20000) {
+        int* value = storage.GetIntRef(key, -7);
+        std::unordered_map<ImGuiID, int>::iterator it = expected.find(key);
+        ok &= *value == (it == expected.end() ? -7 : it->second);
+        *value = i;
+        expected[key] = i;
+      } else {
+        std::unordered_map<ImGuiID, int>::iterator it = expected.find(key);
+        ok &= storage.GetInt(key, -1) == (it == expected.end() ? -1 : it->second);
+      }
+    }
+    CHECK(ok);
+    CHECK(storage.Count == (int)expected.size());
+    for (const std::pair<const ImGuiID, int>& pair : expected)
+      ok &= storage.GetInt(pair.first, -1) == pair.second;
+    CHECK(ok);
+  }
+
+  // Every type, key 0, and the default values of missing keys
+  ImGuiStorage storage;
+  int dummy;
+  storage.SetFloat(1, 0.5f);
+  storage.SetVoidPtr(2, &dummy);
+  storage.SetBool(0, true);
+  CHECK(storage.GetFloat(1) == 0.5f && storage.GetVoidPtr(2) == &dummy && storage.GetBool(0));
+  CHECK(storage.GetInt(3, 9) == 9 && storage.GetVoidPtr(3) == NULL && *storage.GetFloatRef(4, 2.0f) == 2.0f);
+  CHECK(*storage.GetVoidPtrRef(5) == NULL && *storage.GetBoolRef(6, true) && storage.Count == 6);
+
+  // The same keys in the same order always give the same layout, and SetAllInt sees all of them
+  ImGuiStorage a, b, reserved;
+  reserved.Reserve(10000);
+  for (int i = 0; i < 10000; i++) {
+    a.SetInt(StorageKey(i), i);
+    b.SetInt(StorageKey(i), i);
+    reserved.SetInt(StorageKey(i), i);
+  }
+  CHECK(reserved.Keys.Size == 16384);
+  ImGuiStorage c = a;
+  c.SetAllInt(-3);
+  bool ok = true;
+  for (int i = 0; i < 10000; i++)
+    ok &= c.GetInt(StorageKey(i)) == -3 && a.GetInt(StorageKey(i)) == i && reserved.GetInt(StorageKey(i)) == i;
+  CHECK(ok);
+  CHECK(a.Keys.Size == b.Keys.Size && memcmp(a.Keys.Data, b.Keys.Data, a.Keys.Size * sizeof(ImGuiID)) == 0);
+}
+
+struct TextCase {
+  float size;
+  ImVec2 pos;
+  ImVec4 clip_rect;
+  float wrap_width;
+  bool cpu_fine_clip;
+  ImU32 golden;     // of the scalar RenderText the ASCII fast path replaced
+};
+
+static void TestRenderText() {
+  CreateFixtureContext();
+  ImGui::NewFrame();
+  const ImFont* font = ImGui::GetFont();
+  ImDrawList draw_list(ImGui::GetDrawListSharedData());
+
+  // Scales, fractional positions, clipping on every side, wrapping, and text long enough for the >10000 bytes scan
+  const TextCase cases[] = {
+    {13.0f, ImVec2(10.0f, 10.0f), ImVec4(0.0f, 0.0f, 1280.0f, 720.0f), 0.0f, false, 0x4B0DD0C9u},
+    {13.0f, ImVec2(10.5f, 3.25f), ImVec4(40.0f, 30.0f, 300.0f, 200.0f), 0.0f, true, 0x9F226FB4u},
+    {13.0f, ImVec2(10.0f, -500.0f), ImVec4(40.0f, 30.0f, 300.0f, 200.0f), 0.0f, false, 0x1E3D97F0u},
+    {20.0f, ImVec2(-7.75f, 0.0f), ImVec4(0.0f, 0.0f, 1280.0f, 720.0f), 0.0f, true, 0x96867203u},
+    {9.5f, ImVec2(0.0f, 0.0f), ImVec4(3.0f, 5.5f, 1000.0f, 700.25f), 0.0f, true, 0xFE6DDDC4u},
+    {13.0f, ImVec2(5.0f, 5.0f), ImVec4(0.0f, 0.0f, 1280.0f, 720.0f), 250.0f, false, 0x153EC7E8u},
+    {16.0f, ImVec2(5.0f, 5.0f), ImVec4(20.0f, 0.0f, 200.0f, 400.0f), 120.0f, true, 0x97AF849Du},
+    {13.0f, ImVec2(5.0f, 5.0f), ImVec4(0.0f, 0.0f, 1280.0f, 720.0f), 3.0f, false, 0x21ED6F50u},
+  };
+  for (int n = 0; n < IM_ARRAYSIZE(cases); n++) {
+    const TextCase& c = cases[n];
+    ImU32 hash = 0;
+    for (int unicode = 0; unicode < 2; unicode++) {
+      for (int lines : {1, 3, 40, 400}) {
+        const std::string text = MakeLogText(lines, unicode != 0);
+        for (size_t length : {text.size(), text.size() / 2, text.size() / 3 + 1}) {
+          draw_list.Clear();
+          draw_list.PushClipRectFullScreen();
+          draw_list.PushTextureID(font->ContainerAtlas->TexID);
+          font->RenderText(&draw_list, c.size, c.pos, IM_COL32(200, 255, 100, 255), c.clip_rect, text.c_str(),
+                           text.c_str() + length, c.wrap_width, c.cpu_fine_clip);
+          hash = HashDrawList(draw_list, hash);
+        }
+      }
+    }
+    char name[32];
+    snprintf(name, sizeof(name), "case %d", n);
+    CheckGolden(name, hash, c.golden);
+  }
+
+  ImGui::EndFrame();
+  ImGui::DestroyContext();
+}
+
+// The vertices and indices of the last of `frames` inspector frames
+static void RunInspectorFrames(bool cache_enabled, const char* font_path, int frames, std::vector<ImDrawVert>& vertices,
+                               std::vector<ImDrawIdx>& indices) {
+  CreateFixtureContext(font_path, 15.0f);
+  ImGuiContext& g = *ImGui::GetCurrentContext();
+  g.TextCache.Enabled = cache_enabled;
+  for (int frame = 0; frame < frames; frame++) {
+    ImGui::NewFrame();
+    ShowInspectorScreen(frame);
+    ImGui::Render();
+  }
+  CHECK(!cache_enabled || g.TextCache.Hits > 0);
+  const ImDrawData* draw_data = ImGui::GetDrawData();
+  for (int i = 0; i < draw_data->CmdListsCount; i++) {
+    const ImDrawList* list = draw_data->CmdLists[i];
+    vertices.insert(vertices.end(), list->VtxBuffer.Data, list->VtxBuffer.Data + list->VtxBuffer.Size);
+    indices.insert(indices.end(), list->IdxBuffer.Data, list->IdxBuffer.Data + list->IdxBuffer.Size);
+  }
+  ImGui::DestroyContext();
+}
+
+// The default font, then the one the app uses, which has fractional advances
+static void TestTextCache() {
+  const char* FONTS[] = {NULL, "./imgui/misc/fonts/Cousine-Regular.ttf"};
+  CHECK(FileExists(FONTS[1]));
+  for (const char* font : FONTS) {
+    if (font != NULL && !FileExists(font))
+      continue;
+    std::vector<ImDrawVert> off_vertices, on_vertices;
+    std::vector<ImDrawIdx> off_indices, on_indices;
+    RunInspectorFrames(false, font, 20, off_vertices, off_indices);
+    RunInspectorFrames(true, font, 20, on_vertices, on_indices);
+    if (!CHECK(off_vertices.size() == on_vertices.size() && off_indices == on_indices))
+      continue;
+
+    // Same quads moved by whole pixels: identical with integer metrics, otherwise the pen position rounds differently
+    // when summed from 0 instead of from the text position. Well under the 1/256 pixel rasterizers resolve, or one step
+    // of the compact vertices' fixed point, which the difference can tip over
+    bool same_uv_col = true;
+    float max_error = 0.0f;
+    for (size_t i = 0; i < off_vertices.size(); i++) {
+      const ImDrawVert& a = off_vertices[i];
+      const ImDrawVert& b = on_vertices[i];
+      const ImVec2 a_pos = a.pos, b_pos = b.pos, a_uv = a.uv, b_uv = b.uv;
+      same_uv_col &= a.col == b.col && a_uv.x == b_uv.x && a_uv.y == b_uv.y;
+      max_error = std::max(max_error, std::max(fabsf(a_pos.x - b_pos.x), fabsf(a_pos.y - b_pos.y)));
+    }
+    CHECK(same_uv_col);
+#ifdef IMGUI_USE_COMPACT_DRAWVERT
+    CHECK(max_error <= 1.0f / IM_DRAWVERT_POS_SCALE);
+#else
+    CHECK(max_error < 1.0f / 256.0f);
+#endif
+    if (font == NULL)
+      CHECK(max_error == 0.0f);
+  }
+
+  // A label is looked up for its size and again to draw it, that's one miss, then one hit a frame
+  CreateFixtureContext();
+  ImFontTextCache& cache = ImGui::GetCurrentContext()->TextCache;
+  const ImFont* font = ImGui::GetIO().Fonts->Fonts[0];
+  const char* label = "Select";
+  for (int frame = 0; frame < 3; frame++) {
+    cache.NewFrame();
+    bool found;
+    cache.CalcTextSize(font, font->FontSize, 0.0f, label, label + strlen(label));
+    cache.Find(font, font->FontSize, 0.0f, label, label + strlen(label), &found);
+    CHECK(found);
+    CHECK(cache.Hits == (frame > 0 ? 1 : 0) && cache.Misses == (frame > 0 ? 0 : 1));
+  }
+  ImGui::DestroyContext();
+}
+
+// Field by field, the struct has padding after the codepoint
+static bool SameGlyph(const ImFontGlyph& a, const ImFontGlyph& b) {
+  return a.Codepoint == b.Codepoint && a.AdvanceX == b.AdvanceX
+    && a.X0 == b.X0 && a.Y0 == b.Y0 && a.X1 == b.X1 && a.Y1 == b.Y1
+    && a.U0 == b.U0 && a.V0 == b.V0 && a.U1 == b.U1 && a.V1 == b.V1;
+}
+
+static void BuildFontAtlas(ImFontAtlas& atlas, const char* font_path, float font_size, const ImWchar* ranges, bool parallel) {
+  AddFontOrDefault(atlas, font_path, font_size, ranges);
+  atlas.ParallelFor = parallel ? JobParallelForWait : NULL;
+  atlas.Build();
+}
+
+// Glyphs rasterized on the job system land where the serial build puts them
+static void TestFontAtlas() {
+  struct AtlasCase {
+    const char* font_path;
+    float font_size;
+    bool cyrillic;
+  };
+  const AtlasCase cases[] = {
+    {NULL, 13.0f, false},
+    {"./imgui/misc/fonts/Cousine-Regular.ttf", 15.0f, false},
+    {"./imgui/misc/fonts/DroidSans.ttf", 18.0f, true},
+  };
+  // Workers even on a small box, so the glyphs do run in parallel
+  JobSystemInit(3);
+  for (const AtlasCase& c : cases) {
+    if (!CHECK(c.font_path == NULL || FileExists(c.font_path)))
+      continue;
+    ImFontAtlas serial, parallel;
+    BuildFontAtlas(serial, c.font_path, c.font_size, c.cyrillic ? serial.GetGlyphRangesCyrillic() : NULL, false);
+    BuildFontAtlas(parallel, c.font_path, c.font_size, c.cyrillic ? parallel.GetGlyphRangesCyrillic() : NULL, true);
+    if (!CHECK(serial.TexWidth == parallel.TexWidth && serial.TexHeight == parallel.TexHeight))
+      continue;
+    CHECK(memcmp(serial.TexPixelsAlpha8, parallel.TexPixelsAlpha8, serial.TexWidth * serial.TexHeight) == 0);
+    const ImVector<ImFontGlyph>& a = serial.Fonts[0]->Glyphs;
+    const ImVector<ImFontGlyph>& b = parallel.Fonts[0]->Glyphs;
+    bool same = a.Size == b.Size;
+    for (int i = 0; same && i < a.Size; i++)
+      same = SameGlyph(a[i], b[i]);
+    CHECK(same);
+  }
+  JobSystemShutdown();
+}
+
+static bool SameAtlas(const ImFontAtlas& a, const ImFontAtlas& b) {
+  if (a.TexWidth != b.TexWidth || a.TexHeight != b.TexHeight || a.Fonts.Size != b.Fonts.Size
+      || a.CustomRects.Size != b.CustomRects.Size || a.TexUvWhitePixel.x != b.TexUvWhitePixel.x
+      || a.TexUvWhitePixel.y != b.TexUvWhitePixel.y
+      || memcmp(a.TexPixelsAlpha8, b.TexPixelsAlpha8, a.TexWidth * a.TexHeight) != 0)
+    return false;
+  for (int i = 0; i < a.CustomRects.Size; i++)
+    if (a.CustomRects[i].X != b.CustomRects[i].X || a.CustomRects[i].Y != b.CustomRects[i].Y)
+      return false;
+  for (int i = 0; i < a.Fonts.Size; i++) {
+    const ImFont& fa = *a.Fonts[i];
+    const ImFont& fb = *b.Fonts[i];
+    if (fa.FontSize != fb.FontSize || fa.Ascent != fb.Ascent || fa.Descent != fb.Descent
+        || fa.ConfigDataCount != fb.ConfigDataCount || fa.FallbackAdvanceX != fb.FallbackAdvanceX
+        || fa.Glyphs.Size != fb.Glyphs.Size || fa.IndexAdvanceX.Size != fb.IndexAdvanceX.Size
+        || memcmp(fa.IndexAdvanceX.Data, fb.IndexAdvanceX.Data, fa.IndexAdvanceX.Size * sizeof(float)) != 0
+        || (fa.FallbackGlyph == NULL) != (fb.FallbackGlyph == NULL))
+      return false;
+    for (int glyph = 0; glyph < fa.Glyphs.Size; glyph++)
+      if (!SameGlyph(fa.Glyphs[glyph], fb.Glyphs[glyph]))
+        return false;
+  }
+  return true;
+}
+
+// A few fonts and sizes, one of them merging in a second font
+static void AddFontCacheTestFonts(ImFontAtlas& atlas) {
+  atlas.AddFontFromFileTTF("./imgui/misc/fonts/Cousine-Regular.ttf", 15.0f, NULL, atlas.GetGlyphRangesCyrillic());
+  atlas.AddFontFromFileTTF("./imgui/misc/fonts/DroidSans.ttf", 19.5f, NULL, atlas.GetGlyphRangesCyrillic());
+  ImFontConfig merge;
+  merge.MergeMode = true;
+  atlas.AddFontFromFileTTF("./imgui/misc/fonts/ProggyClean.ttf", 13.0f, &merge, atlas.GetGlyphRangesDefault());
+}
+
+// A miss stores the atlas, hits load the same atlas the build makes
+static void TestFontCache() {
+  if (!CHECK(FileExists("./imgui/misc/fonts/Cousine-Regular.ttf")))
+    return;
+  char directory[] = "/tmp/jake_tests_XXXXXX";
+  if (!CHECK(mkdtemp(directory) != NULL))
+    return;
+
+  ImFontAtlas built;
+  AddFontCacheTestFonts(built);
+  built.Build();
+  const FontCacheStats& stats = FontCacheGetStats();
+  const int misses = stats.misses, hits = stats.hits;
+  for (int round = 0; round < 3; round++) {
+    ImFontAtlas atlas;
+    AddFontCacheTestFonts(atlas);
+    CHECK(FontCacheLoadAtlas(&atlas, directory));
+    CHECK(SameAtlas(built, atlas));
+  }
+  CHECK(stats.misses == misses + 1 && stats.hits == hits + 2);
+
+  // What the cache stored
+  if (DIR* dir = opendir(directory)) {
+    while (dirent* entry = readdir(dir))
+      if (entry->d_name[0] != '.')
+        unlink((std::string(directory) + "/" + entry->d_name).c_str());
+    closedir(dir);
+  }
+  rmdir(directory);
+}
+
+// Same metrics and the same pixels, wherever each atlas packed the glyph
+static bool SameGlyphImage(const ImFontAtlas& a, const ImFontGlyph& ga, const ImFontAtlas& b, const ImFontGlyph& gb) {
+  if (ga.Codepoint != gb.Codepoint || ga.AdvanceX != gb.AdvanceX
+      || ga.X0 != gb.X0 || ga.Y0 != gb.Y0 || ga.X1 != gb.X1 || ga.Y1 != gb.Y1)
+    return false;
+  int ax = (int)(ga.U0 * a.TexWidth + 0.5f), ay = (int)(ga.V0 * a.TexHeight + 0.5f);
+  int bx = (int)(gb.U0 * b.TexWidth + 0.5f), by = (int)(gb.V0 * b.TexHeight + 0.5f);
+  int w = (int)(ga.U1 * a.TexWidth + 0.5f) - ax, h = (int)(ga.V1 * a.TexHeight + 0.5f) - ay;
+  if (w != (int)(gb.U1 * b.TexWidth + 0.5f) - bx || h != (int)(gb.V1 * b.TexHeight + 0.5f) - by)
+    return false;
+  for (int y = 0; y < h; y++)
+    if (memcmp(a.TexPixelsAlpha8 + ax + (ay + y) * a.TexWidth, b.TexPixelsAlpha8 + bx + (by + y) * b.TexWidth, w) != 0)
+      return false;
+  return true;
+}
+
+// Dynamic glyphs must come out as if they had been baked; missing ones fall back in both
+static bool SameAsBaked(const ImFontAtlas& baked, const ImFontAtlas& dynamic, ImWchar c, const ImFontGlyph* glyph) {
+  const ImFontGlyph* reference = baked.Fonts[0]->FindGlyphNoFallback(c);
+  if (reference == NULL)
+    return glyph == dynamic.Fonts[0]->FallbackGlyph;
+  return SameGlyphImage(baked, *reference, dynamic, *glyph);
+}
+
+static void TestDynamicAtlas() {
+  // Cousine has no Cyrillic, DroidSans does
+  const char* FONT = "./imgui/misc/fonts/DroidSans.ttf";
+  const float SIZE = 16.0f;
+  if (!CHECK(FileExists(FONT)))
+    return;
+  ImFontAtlas ranges;   // only for the glyph range tables
+  const ImWchar* cyrillic = ranges.GetGlyphRangesCyrillic();
+  std::vector<ImWchar> codepoints;
+  for (const ImWchar* range = cyrillic; range[0] && range[1]; range += 2)
+    for (int c = range[0]; c <= range[1]; c++)
+      if (c > 0xFF)
+        codepoints.push_back((ImWchar)c);
+
+  // Default ranges baked, Cyrillic on first use, against everything baked
+  ImFontAtlas baked;
+  baked.AddFontFromFileTTF(FONT, SIZE, NULL, cyrillic);
+  baked.Build();
+  ImFontAtlas dynamic;
+  BuildDynamicAtlas(dynamic, FONT, SIZE, 512);
+  bool same = true;
+  for (ImWchar c : codepoints)
+    same &= SameAsBaked(baked, dynamic, c, dynamic.Fonts[0]->FindGlyph(c));
+  CHECK(same);
+  CHECK(DynamicGlyphCount(dynamic) > 0);
+  int x, y, w, h;
+  CHECK(dynamic.TakeTexDirtyRect(&x, &y, &w, &h) && !dynamic.TakeTexDirtyRect(&x, &y, &w, &h));
+
+  // Text measured before the glyphs exist: the advances come from the same place
+  std::vector<ImWchar> wide(codepoints);
+  wide.push_back(0);
+  std::string text(wide.size() * 3, '\0');
+  text.resize(ImTextStrToUtf8(&text[0], (int)text.size(), wide.data(), NULL));
+  ImFontAtlas measured;
+  BuildDynamicAtlas(measured, FONT, SIZE, 512);
+  ImVec2 baked_size = baked.Fonts[0]->CalcTextSizeA(SIZE, FLT_MAX, 200.0f, text.c_str());
+  ImVec2 dynamic_size = measured.Fonts[0]->CalcTextSizeA(SIZE, FLT_MAX, 200.0f, text.c_str());
+  CHECK(baked_size.x == dynamic_size.x && baked_size.y == dynamic_size.y);
+
+  // Room for a few dozen glyphs, a window sliding through all of them: frames evict and repack, and what's drawn still
+  // matches. A glyph that doesn't fit this frame falls back until the next
+  ImFontAtlas small;
+  BuildDynamicAtlas(small, FONT, SIZE, 24);
+  int evictions = 0;
+  same = true;
+  for (int frame = 0; frame < 400; frame++) {
+    int before = DynamicGlyphCount(small);
+    ImFontAtlasDynamicNewFrame(&small);
+    if (DynamicGlyphCount(small) < before)
+      evictions++;
+    for (int i = 0; i < 24; i++) {
+      ImWchar c = codepoints[(frame * 5 + i) % codepoints.size()];
+      const ImFontGlyph* glyph = small.Fonts[0]->FindGlyph(c);
+      if (glyph != small.Fonts[0]->FallbackGlyph || baked.Fonts[0]->FindGlyphNoFallback(c) == NULL)
+        same &= SameAsBaked(baked, small, c, glyph);
+    }
+  }
+  CHECK(same);
+  CHECK(evictions > 0);
+
+  // Every range of the font, a few hundred of its glyphs on demand
+  static const ImWchar ALL_RANGES[] = {0x0020, 0xFFFF, 0};
+  ImFontAtlas everything;
+  everything.AddFontFromFileTTF(FONT, SIZE, NULL, ALL_RANGES);
+  everything.Build();
+  const ImVector<ImFontGlyph>& all_glyphs = everything.Fonts[0]->Glyphs;
+  ImFontAtlas page;
+  BuildDynamicAtlas(page, FONT, SIZE, 1024);
+  same = true;
+  for (int i = 0; i < 300; i++) {
+    ImWchar c = all_glyphs[(int)((long long)i * all_glyphs.Size / 300)].Codepoint;
+    same &= SameAsBaked(everything, page, c, page.Fonts[0]->FindGlyph(c));
+  }
+  CHECK(same);
+}
+
+static void TestSdfAtlas() {
+  const char* FONT = "./imgui/misc/fonts/DroidSans.ttf";
+  const float SDF_SIZE = 32.0f;
+  if (!CHECK(FileExists(FONT)))
+    return;
+  ImFontAtlas ranges;   // only for the glyph range tables
+  const ImWchar* cyrillic = ranges.GetGlyphRangesCyrillic();
+
+  // Serial and parallel builds, as for the coverage atlases
+  ImFontAtlas sdf, parallel;
+  AddSdfFont(sdf, FONT, SDF_SIZE, cyrillic);
+  sdf.Build();
+  JobSystemInit(3);
+  AddSdfFont(parallel, FONT, SDF_SIZE, cyrillic);
+  parallel.ParallelFor = JobParallelForWait;
+  parallel.Build();
+  JobSystemShutdown();
+  CHECK(sdf.TexWidth == parallel.TexWidth && sdf.TexHeight == parallel.TexHeight
+        && memcmp(sdf.TexPixelsAlpha8, parallel.TexPixelsAlpha8, sdf.TexWidth * sdf.TexHeight) == 0);
+
+  // Against coverage at the same size without oversampling: the field's quads are the bitmap's grown by the padding,
+  // and the field crosses 0.5 where the coverage does
+  ImFontAtlas coverage;
+  ImFontConfig config;
+  config.OversampleH = 1;
+  coverage.AddFontFromFileTTF(FONT, SDF_SIZE, &config, cyrillic);
+  coverage.Build();
+  const ImFont* sdf_font = sdf.Fonts[0];
+  const ImFont* coverage_font = coverage.Fonts[0];
+  const float pad = (float)sdf_font->ConfigData->SdfPadding;
+  if (!CHECK(sdf_font->Glyphs.Size == coverage_font->Glyphs.Size))
+    return;
+  bool same_metrics = true;
+  int pixels = 0, agree = 0;
+  for (int i = 0; i < sdf_font->Glyphs.Size; i++) {
+    const ImFontGlyph& a = sdf_font->Glyphs[i];
+    const ImFontGlyph& b = coverage_font->Glyphs[i];
+    same_metrics &= a.Codepoint == b.Codepoint && a.AdvanceX == b.AdvanceX;
+    if (b.X0 == b.X1 || b.Y0 == b.Y1)
+      continue;
+    same_metrics &= a.X0 == b.X0 - pad && a.Y0 == b.Y0 - pad && a.X1 == b.X1 + pad && a.Y1 == b.Y1 + pad;
+    int ax = (int)(a.U0 * sdf.TexWidth + 0.5f) + (int)pad, ay = (int)(a.V0 * sdf.TexHeight + 0.5f) + (int)pad;
+    int bx = (int)(b.U0 * coverage.TexWidth + 0.5f), by = (int)(b.V0 * coverage.TexHeight + 0.5f);
+    int w = (int)(b.X1 - b.X0), h = (int)(b.Y1 - b.Y0);
+    for (int y = 0; y < h; y++)
+      for (int x = 0; x < w; x++) {
+        bool inside_sdf = sdf.TexPixelsAlpha8[ax + x + (ay + y) * sdf.TexWidth] >= 128;
+        bool inside_coverage = coverage.TexPixelsAlpha8[bx + x + (by + y) * coverage.TexWidth] >= 128;
+        pixels++;
+        agree += inside_sdf == inside_coverage;
+      }
+  }
+  CHECK(same_metrics);
+  CHECK(pixels > 0 && agree >= pixels * 0.97);
+
+  // Glyphs rasterized on demand are the same fields
+  ImFontAtlas dynamic;
+  dynamic.Flags |= ImFontAtlasFlags_DynamicGlyphs;
+  AddSdfFont(dynamic, FONT, SDF_SIZE, NULL);
+  dynamic.Build();
+  bool same = true;
+  for (const ImFontGlyph& glyph : sdf_font->Glyphs)
+    same &= SameAsBaked(sdf, dynamic, glyph.Codepoint, dynamic.Fonts[0]->FindGlyph(glyph.Codepoint));
+  CHECK(same);
+
+  // Text in the field font gets commands of its own, flagged for the distance field shader, on the same texture.
+  // An image of the atlas drawn under that font is not flagged
+  CreateFixtureContext();
+  ImGuiIO& io = ImGui::GetIO();
+  AddSdfFont(*io.Fonts, FONT, SDF_SIZE, NULL);
+  unsigned char* tex_pixels;
+  int tex_width, tex_height;
+  io.Fonts->GetTexDataAsRGBA32(&tex_pixels, &tex_width, &tex_height);
+  io.Fonts->TexID = (ImTextureID)1;
+  const ImDrawList* draw_list = NULL;
+  for (int frame = 0; frame < 2; frame++) {   // new windows skip their first frame
+    ImGui::NewFrame();
+    ImGui::Begin("sdf");
+    ImGui::Text("coverage");
+    ImGui::PushFont(io.Fonts->Fonts[1]);
+    ImGui::Text("field");
+    ImGui::Image(io.Fonts->TexID, ImVec2(16, 16));
+    ImGui::PopFont();
+    ImGui::Text("coverage");
+    draw_list = ImGui::GetWindowDrawList();
+    ImGui::End();
+    ImGui::Render();
+  }
+  int flags = 0;
+  bool same_texture = true;
+  for (const ImDrawCmd& cmd : draw_list->CmdBuffer) {
+    if (cmd.ElemCount == 0)
+      continue;
+    same_texture &= cmd.TextureId == io.Fonts->TexID;
+    flags = flags * 2 + cmd.DistanceField;
+  }
+  CHECK(same_texture);
+  CHECK(flags == 0x2);   // title bar, coverage, field, image and coverage
+  ImGui::DestroyContext();
+}
+
+// The hash of every frame's draw data past the warm up. Counts how often a panel's draw list got a new version
+static ImU32 RunDashboardFrames(bool versions, int& version_changes) {
+  CreateFixtureContext();
+  std::unordered_map<const ImDrawList*, unsigned int> last_versions;
+  ImU32 hash = 0;
+  version_changes = 0;
+  const int WARMUP = 5;
+  for (int frame = 0; frame < WARMUP + 400; frame++) {
+    ImGui::NewFrame();
+    ShowDashboardScreen(frame, versions);
+    ImGui::Render();
+    if (frame < WARMUP)
+      continue;
+    const ImDrawData* draw_data = ImGui::GetDrawData();
+    hash = HashDrawData(draw_data, hash);
+    for (int n = 0; n < draw_data->CmdListsCount; n++) {
+      const ImDrawList* list = draw_data->CmdLists[n];
+      if (!IsDashboardPanel(*list))
+        continue;
+      auto last = last_versions.find(list);
+      version_changes += last != last_versions.end() && last->second != list->Version;
+      last_versions[list] = list->Version;
+    }
+  }
+  ImGui::DestroyContext();
+  return hash;
+}
+
+// The same frames either way, and a panel's list only gets a new version when the panel updates: 8 times in the 400
+// frames, one panel each
+static void TestRetained() {
+  int redrawn_changes, retained_changes;
+  ImU32 redrawn = RunDashboardFrames(false, redrawn_changes);
+  ImU32 retained = RunDashboardFrames(true, retained_changes);
+  CHECK(redrawn == retained);
+  CHECK(retained_changes == 8);
+}
+
+// Edits at random places of a large multi-line InputText end up in the buffer, at the right places
+static void TestInputText() {
+  CreateFixtureContext();
+  ImGuiContext& g = *ImGui::GetCurrentContext();
+
+  // ASCII, so positions in the expected text and in the widget are the same
+  std::string expected = MakeLogText(20000, false);
+  std::vector<char> buf(expected.begin(), expected.end());
+  buf.resize(expected.size() + (1 << 16), 0);
+
+  // SetKeyboardFocusHere() activates on the next frame
+  InputTextFrame(buf, true);
+  InputTextFrame(buf, false);
+  CHECK(g.ActiveId != 0);
+  ImU32 rng = 1;
+  for (int i = 0; i < 300; i++) {
+    // Jump somewhere and type a character, a new line, or erase one
+    rng = rng * 1664525u + 1013904223u;
+    int pos = (int)((rng >> 8) % expected.size());
+    char edit = QueueInputTextEdit(i, pos);
+    if (edit == '\b')
+      expected.erase(pos - 1, 1);
+    else
+      expected.insert(pos, 1, edit);
+    InputTextFrame(buf, false);
+    PressKey(ImGuiKey_Backspace, false);
+    PressKey(ImGuiKey_Enter, false);
+  }
+
+  CHECK(strcmp(buf.data(), expected.c_str()) == 0);
+  CHECK(g.InputTextState.Text.GetLineCount() == (int)std::count(expected.begin(), expected.end(), '\n') + 1);
+  ImGui::DestroyContext();
+}
+
+// Every line, and the filtered ones, against the text itself
+static bool SameLines(const TextViewer& viewer, const std::string& text) {
+  std::vector<int> filtered;
+  int line = 0;
+  for (size_t begin = 0; begin < text.size(); line++) {
+    size_t end = text.find('\n', begin);
+    if (end == std::string::npos)
+      end = text.size();
+    if (line >= TextViewerLineCount(viewer))
+      return false;
+    if (std::string(TextViewerLineBegin(viewer, line), TextViewerLineEnd(viewer, line)) != text.substr(begin, end - begin))
+      return false;
+    if (viewer.filter.PassFilter(text.c_str() + begin, text.c_str() + end))
+      filtered.push_back(line);
+    begin = end + 1;
+  }
+  if (line != TextViewerLineCount(viewer))
+    return false;
+  return !viewer.filter.IsActive() || filtered == viewer.filtered_lines;
+}
+
+static void TestTextViewer() {
+  JobSystemInit(3);
+  TextViewer viewer;
+
+  // Big enough for the parallel newline scan and a few filter batches
+  std::string text = MakeLogText(100000, false);
+  TextViewerAppend(viewer, text.c_str(), text.c_str() + text.size());
+  CHECK(SameLines(viewer, text));
+
+  // Lines coming in while the filter job reads the text, one of them in two halves. A fixed number of times: appending
+  // for as long as it filters can outrun the workers on a busy machine and never end
+  TextViewerSetFilter(viewer, "WARN");
+  const std::string new_lines = MakeLogText(100, false);
+  for (int i = 0; i < 3; i++) {
+    TextViewerAppend(viewer, new_lines.c_str());
+    TextViewerAppend(viewer, "WARN half a ");
+    TextViewerAppend(viewer, "line\n");
+    text += new_lines + "WARN half a line\n";
+    TextViewerUpdate(viewer);
+  }
+  while (TextViewerIsFiltering(viewer))
+    TextViewerUpdate(viewer);
+  CHECK(SameLines(viewer, text));
+
+  // A different filter over everything, then none
+  TextViewerSetFilter(viewer, "universe 3:,-INFO");
+  while (TextViewerIsFiltering(viewer))
+    TextViewerUpdate(viewer);
+  CHECK(SameLines(viewer, text));
+  CHECK(!viewer.filtered_lines.empty());
+  TextViewerSetFilter(viewer, "");
+  TextViewerUpdate(viewer);
+  CHECK(SameLines(viewer, text));
+
+  TextViewerClear(viewer);
+  CHECK(TextViewerLineCount(viewer) == 0);
+  JobSystemShutdown();
+}
+
+// Once every row was measured, clipped frames draw the same as with every row submitted. At whole pixel scroll positions:
+// otherwise the rows submitted one after the other round in screen space differently from the clipper's one seek
+static void TestVariableClipper() {
+  const int ROWS = 10000;
+  const float POSITIONS[] = {0.0f, 0.1f, 0.35f, 0.6f, 0.85f, 1.0f};
+
+  // The content size is known from the second frame on
+  CreateFixtureContext();
+  ShowMixedList(ROWS, false, -1.0f);
+  float full_max_y = ShowMixedList(ROWS, false, -1.0f);
+  ImU32 full_hashes[IM_ARRAYSIZE(POSITIONS)];
+  for (int n = 0; n < IM_ARRAYSIZE(POSITIONS); n++) {
+    ShowMixedList(ROWS, false, ImFloor(POSITIONS[n] * full_max_y));
+    ShowMixedList(ROWS, false, -1.0f);
+    full_hashes[n] = HashDrawData(ImGui::GetDrawData(), 0);
+  }
+  ImGui::DestroyContext();
+
+  // A first pass down the list measures every row
+  CreateFixtureContext();
+  ShowMixedList(ROWS, true, -1.0f);
+  float scroll_max_y = ShowMixedList(ROWS, true, -1.0f);
+  for (float y = 0.0f; y <= scroll_max_y + 720.0f; y += 360.0f)
+    scroll_max_y = ShowMixedList(ROWS, true, y);
+  ShowMixedList(ROWS, true, -1.0f);   // SetScrollY() lands on the next frame
+  for (int n = 0; n < IM_ARRAYSIZE(POSITIONS); n++) {
+    ShowMixedList(ROWS, true, ImFloor(POSITIONS[n] * full_max_y));
+    scroll_max_y = ShowMixedList(ROWS, true, -1.0f);
+    CHECK(HashDrawData(ImGui::GetDrawData(), 0) == full_hashes[n]);
+  }
+  CHECK(scroll_max_y == full_max_y);
+  ImGui::DestroyContext();
+}
+
+// A list of its own in every row, under an ID per row
+static void ShowNestedRow(int row, bool clip) {
+  ImGui::PushID(row);
+  if (clip) {
+    ImGuiVariableListClipper clipper("##items", row % 4 + 1);
+    while (clipper.Step())
+      ImGui::Text("Row %d, item %d", row, clipper.DisplayStart);
+  } else {
+    for (int i = 0; i < row % 4 + 1; i++)
+      ImGui::Text("Row %d, item %d", row, i);
+  }
+  ImGui::PopID();
+}
+
+static float ShowNestedList(int rows, bool clip, float scroll_y) {
+  ImGui::NewFrame();
+  ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
+  ImGui::SetNextWindowSize(ImVec2(640.0f, 480.0f));
+  ImGui::Begin("Nested lists");
+  if (scroll_y >= 0.0f)
+    ImGui::SetScrollY(scroll_y);
+  if (clip) {
+    ImGuiVariableListClipper clipper("##rows", rows);
+    while (clipper.Step())
+      ShowNestedRow(clipper.DisplayStart, true);
+  } else {
+    for (int i = 0; i < rows; i++)
+      ShowNestedRow(i, false);
+  }
+  float scroll_max_y = ImGui::GetScrollMaxY();
+  ImGui::End();
+  ImGui::Render();
+  return scroll_max_y;
+}
+
+// The rows of a clipper add to the window's heights storage while it runs; and the storage only keeps the lists shown the
+// last time, not every row scrolled past
+static void TestNestedClipper() {
+  const int ROWS = 2000;
+
+  CreateFixtureContext();
+  ShowNestedList(ROWS, false, -1.0f);
+  float full_max_y = ShowNestedList(ROWS, false, -1.0f);
+  ImGui::DestroyContext();
+
+  CreateFixtureContext();
+  ShowNestedList(ROWS, true, -1.0f);
+  float scroll_max_y = ShowNestedList(ROWS, true, -1.0f);
+  for (float y = 0.0f; y <= scroll_max_y + 480.0f; y += 240.0f)
+    scroll_max_y = ShowNestedList(ROWS, true, y);
+  // Down to the last row, the range grows as the rows get measured
+  for (int i = 0; i < 3; i++)
+    scroll_max_y = ShowNestedList(ROWS, true, full_max_y);
+  CHECK(scroll_max_y == full_max_y);
+
+  // Back at the top: the frame after, the rows at the bottom are gone
+  const ImVector<ImGuiListClipperHeights>& storage = ImGui::FindWindowByName("Nested lists")->ListClipperHeightsStorage;
+  ShowNestedList(ROWS, true, 0.0f);
+  ShowNestedList(ROWS, true, -1.0f);
+  ShowNestedList(ROWS, true, -1.0f);
+  CHECK(storage.Size > 1 && storage.Size < 100);
+  bool used = true;
+  for (const ImGuiListClipperHeights& heights : storage)
+    used &= heights.LastFrameUsed == ImGui::GetFrameCount();
+  CHECK(used);
+  ImGui::DestroyContext();
+}
+
+// Every single value spike reaches the top of its pixel column, and the three sources draw the same
+static void TestPlot() {
+  const int VALUES = 1000000;
+  const int WRAPPED = 250000;     // pushed past capacity, so the plot starts mid-buffer
+  const float SPIKE = 100.0f;
+
+  ImGuiPlotHistory history;
+  history.Init(VALUES);
+  std::vector<float> values(VALUES + WRAPPED);
+  ImU32 rng = 1;
+  for (float& v : values) {
+    rng = rng * 1664525u + 1013904223u;
+    v = 16.0f + (float)(rng >> 22) * 0.001f;
+  }
+  for (int i = 0; i < 8; i++) {
+    rng = rng * 1664525u + 1013904223u;
+    values[WRAPPED + (int)(rng % VALUES)] = SPIKE;
+  }
+  // One at a time and in batches
+  for (int i = 0; i < VALUES / 10; i++)
+    history.Push(values[i]);
+  history.Push(values.data() + VALUES / 10, (int)values.size() - VALUES / 10);
+
+  CreateFixtureContext();
+  for (ImGuiPlotType type : {ImGuiPlotType_Lines, ImGuiPlotType_Histogram}) {
+    ImU32 hash = 0;
+    for (PlotSource source : {PLOT_CALLBACK, PLOT_ARRAY, PLOT_HISTORY}) {
+      ShowPlotFrame(history, source, type);
+      ShowPlotFrame(history, source, type);
+      const ImVector<ImVec2>& columns = ImGui::GetCurrentContext()->PlotColumns;
+      int spike_columns = 0, expected = 0;
+      for (int n = 0; n < columns.Size; n++) {
+        spike_columns += columns[n].y == SPIKE;
+        int idx_begin = (int)((ImS64)n * VALUES / columns.Size);
+        int idx_end = (int)((ImS64)(n + 1) * VALUES / columns.Size);
+        expected += std::find(values.begin() + WRAPPED + idx_begin, values.begin() + WRAPPED + idx_end, SPIKE) != values.begin() + WRAPPED + idx_end;
+      }
+      CHECK(expected > 0 && spike_columns == expected);
+      ImU32 frame_hash = HashDrawData(ImGui::GetDrawData(), 0);
+      if (source == PLOT_CALLBACK)
+        hash = frame_hash;
+      else
+        CHECK(frame_hash == hash);
+    }
+  }
+  ImGui::DestroyContext();
+}
+
+// Draws `polyline.shapes` and hashes every list, cleared whenever it has `shapes_per_list` of them
+static ImU32 HashPolylineCase(ImDrawList& draw_list, const PolylineCase& polyline, const std::vector<ImVec2>& points) {
+  ImU32 hash = 0;
+  for (int shape = 0; shape < polyline.shapes; shape++) {
+    if (shape % polyline.shapes_per_list == 0) {
+      if (shape > 0)
+        hash = HashDrawList(draw_list, hash);
+      draw_list.Clear();
+      draw_list.PushClipRectFullScreen();
+      draw_list.PushTextureID(ImGui::GetIO().Fonts->TexID);
+    }
+    DrawPolylineShape(draw_list, polyline, points, shape);
+  }
+  CHECK(draw_list._VtxCurrentIdx < (1 << 16));
+  return HashDrawList(draw_list, hash);
+}
+
+static void TestPolyline() {
+  CreateFixtureContext();
+  ImGui::NewFrame();
+  ImDrawList draw_list(ImGui::GetDrawListSharedData());
+
+  // Noisy graphs, and rings with and without cached arcs. Thin and thick, every point count around the 4 at a time loop
+  // The goldens are of the scalar tessellation and the arcs before the arc cache
+  struct PolylineTest {
+    PolylineCase polyline;
+    ImU32 golden;
+  };
+  const PolylineTest cases[] = {
+    {{"graphs, 1 px", POLYLINE_OPEN, 1.0f, 20, 1000, 20}, 0x8A27A774u},
+    {{"graphs, 2 px", POLYLINE_OPEN, 2.0f, 20, 1000, 15}, 0xE8B6B946u},
+    {{"short lines, 1 px", POLYLINE_OPEN, 1.0f, 200, 5, 200}, 0x84CFB00Eu},
+    {{"short lines, 3 px", POLYLINE_OPEN, 3.0f, 200, 6, 200}, 0x19E65584u},
+    {{"AddCircle, 32 segments", POLYLINE_CIRCLE, 1.0f, 1000, 32, 600}, 0x3B111FA1u},
+    {{"AddCircle, 3 px, 13 segments", POLYLINE_CIRCLE, 3.0f, 1000, 13, 600}, 0xD3CBD738u},
+    {{"AddCircle, 600 segments", POLYLINE_CIRCLE, 1.0f, 20, 600, 20}, 0x41C731DAu},
+    {{"AddCircleFilled, 32 segments", POLYLINE_CIRCLE_FILLED, 1.0f, 1000, 32, 900}, 0x5B7264BBu},
+    {{"AddCircleFilled, 7 segments", POLYLINE_CIRCLE_FILLED, 1.0f, 1000, 7, 900}, 0x8FBBBC20u},
+  };
+  const std::vector<ImVec2> points = MakeGraphPoints(20, 1000);
+  for (const PolylineTest& test : cases) {
+    // Twice: the second time the arcs come from the cache
+    ImU32 hash = HashPolylineCase(draw_list, test.polyline, points);
+    CHECK(HashPolylineCase(draw_list, test.polyline, points) == hash);
+    CheckGolden(test.polyline.name, hash, test.golden);
+  }
+
+  ImGui::EndFrame();
+  ImGui::DestroyContext();
+}
+
+struct ParallelForHits {
+  std::vector<std::atomic<int>> hits;
+  std::atomic<int> bad_ranges{0};
+};
+
+static void CountRange(int begin, int end, void* user_data) {
+  ParallelForHits* data = (ParallelForHits*)user_data;
+  if (begin >= end || begin < 0 || end > (int)data->hits.size())
+    data->bad_ranges++;
+  for (int i = begin; i < end && i < (int)data->hits.size(); i++)
+    data->hits[i]++;
+}
+
+static bool HitOnce(const ParallelForHits& data) {
+  for (const std::atomic<int>& hits : data.hits)
+    if (hits.load() != 1)
+      return false;
+  return data.bad_ranges.load() == 0;
+}
+
+// Every index runs exactly once, also with more batches than fit the job ring
+static void TestParallelFor() {
+  const int COUNTS[] = {0, 1, 7, 1000, 100003};
+  const int BATCH_SIZES[] = {1, 3, 64, 100000};
+  JobSystemInit(3);
+  for (int count : COUNTS) {
+    for (int batch_size : BATCH_SIZES) {
+      ParallelForHits data;
+      data.hits = std::vector<std::atomic<int>>(count);
+      JobWait(JobParallelFor(count, batch_size, CountRange, &data));
+      CHECK(HitOnce(data));
+    }
+    ParallelForHits data;
+    data.hits = std::vector<std::atomic<int>>(count);
+    JobParallelForWait(count, CountRange, &data);
+    CHECK(HitOnce(data));
+  }
+  JobSystemShutdown();
+}
+
+struct NestedJobs {
+  std::atomic<int> counter;
+  std::vector<std::atomic<int>> hits;
+  int children;
+};
+
+struct NestedJob {
+  NestedJobs* jobs;
+  int index;
+};
+
+static void RunNestedChild(Job*, const void* data) {
+  const NestedJob* job = (const NestedJob*)data;
+  job->jobs->hits[job->index]++;
+  job->jobs->counter.fetch_sub(1, std::memory_order_release);
+}
+
+// Queues its children from inside the job, and is done before they are
+static void RunNestedParent(Job*, const void* data) {
+  const NestedJob* job = (const NestedJob*)data;
+  NestedJobs* jobs = job->jobs;
+  for (int i = 0; i < jobs->children; i++) {
+    NestedJob child = {jobs, job->index * jobs->children + i};
+    JobRun(JobCreate(RunNestedChild, &child, sizeof(child)));
+  }
+  jobs->counter.fetch_sub(1, std::memory_order_release);
+}
+
+// The counter covers the children the jobs queue themselves, on whichever thread
+static void TestJobCounter() {
+  const int PARENTS = 64;
+  const int CHILDREN = 48;
+  JobSystemInit(3);
+  for (int round = 0; round < 20; round++) {
+    NestedJobs jobs;
+    jobs.counter = PARENTS + PARENTS * CHILDREN;
+    jobs.hits = std::vector<std::atomic<int>>(PARENTS * CHILDREN);
+    jobs.children = CHILDREN;
+    for (int i = 0; i < PARENTS; i++) {
+      NestedJob parent = {&jobs, i};
+      JobRun(JobCreate(RunNestedParent, &parent, sizeof(parent)));
+    }
+    JobWaitCounter(jobs.counter);
+    bool once = true;
+    for (const std::atomic<int>& hits : jobs.hits)
+      once &= hits.load() == 1;
+    CHECK(once);
+    CHECK(jobs.counter.load() == 0);
+  }
+  JobSystemShutdown();
+}
+
+struct StealRound {
+  std::vector<std::atomic<int>> hits;
+  std::atomic<int> stolen{0};
+  std::atomic<int> counter;
+  std::thread::id main_thread;
+};
+
+struct StealJob {
+  StealRound* round;
+  int index;
+  bool gate;
+};
+
+static void RunStealJob(Job*, const void* data) {
+  const StealJob* job = (const StealJob*)data;
+  StealRound* round = job->round;
+  // The main thread pops this one first: hold it until a worker took a
+  // job off the other end, so every round steals whatever the core count
+  Uint64 timeout = SDL_GetPerformanceCounter() + SDL_GetPerformanceFrequency();
+  while (job->gate && round->stolen.load() == 0 && SDL_GetPerformanceCounter() < timeout)
+    std::this_thread::yield();
+  if (std::this_thread::get_id() != round->main_thread)
+    round->stolen++;
+  round->hits[job->index]++;
+  round->counter.fetch_sub(1, std::memory_order_release);
+}
+
+// The owner pops from the bottom while three thieves take from the top, down to the last job: each runs once, and the
+// steals counted are the jobs the workers ran (their own deques stay empty, and a counter instead of a parent job
+// keeps the main thread's deque to these)
+static void TestJobSteal() {
+  const int ROUNDS = 200;
+  const int JOBS = 64;
+  JobSystemInit(3);
+  JobSystemEndFrame();
+  int stolen = 0;
+  bool once = true;
+  for (int r = 0; r < ROUNDS; r++) {
+    StealRound round;
+    round.hits = std::vector<std::atomic<int>>(JOBS);
+    round.counter = JOBS;
+    round.main_thread = std::this_thread::get_id();
+    for (int i = 0; i < JOBS; i++) {
+      StealJob job = {&round, i, i == JOBS - 1};
+      JobRun(JobCreate(RunStealJob, &job, sizeof(job)));
+    }
+    JobWaitCounter(round.counter);
+    for (const std::atomic<int>& hits : round.hits)
+      once &= hits.load() == 1;
+    stolen += round.stolen.load();
+  }
+  JobSystemEndFrame();
+  CHECK(once);
+  CHECK(stolen >= ROUNDS);
+
+  Uint64 steals = 0, steal_attempts = 0;
+  for (int i = 0; i < JobSystemThreadCount(); i++) {
+    steals += JobGetWorkerStats(i).steals;
+    steal_attempts += JobGetWorkerStats(i).steal_attempts;
+  }
+  CHECK(steals == (Uint64)stolen);
+  CHECK(steal_attempts >= steals);
+  JobSystemShutdown();
+}
+
+static const ProfilerThreadFrame* FindProfilerThread(const char* name) {
+  for (const ProfilerThreadFrame& thread : ProfilerGetLastFrame().threads)
+    if (strcmp(thread.thread_name, name) == 0)
+      return &thread;
+  return NULL;
+}
+
+static int FindProfilerNode(const ProfilerThreadFrame& thread, int first, const char* name) {
+  for (int i = first; i != -1; i = thread.nodes[i].next_sibling)
+    if (strcmp(thread.nodes[i].name, name) == 0)
+      return i;
+  return -1;
+}
+
+static void RecordProfilerZones(int count) {
+  for (int i = 0; i < count; i++) {
+    PROFILE_SCOPE("zone");
+  }
+}
+
+static void RecordProfilerTree() {
+  {
+    PROFILE_SCOPE("update");
+    for (int i = 0; i < 2; i++) {
+      PROFILE_SCOPE("physics");
+      PROFILE_SCOPE("collide");
+    }
+    PROFILE_SCOPE("animate");
+  }
+  {
+    PROFILE_SCOPE("update");
+  }
+  PROFILE_SCOPE("render");
+}
+
+// Zones fold into one node per call path, children in call order; and a thread that laps its ring in a frame keeps
+// the newest events, dropping the rest
+static void TestProfiler() {
+  // Drains whatever earlier tests recorded (JobWait has a zone)
+  ProfilerBeginFrame();
+  ProfilerEndFrame();
+
+  ProfilerBeginFrame();
+  RecordProfilerTree();
+  std::thread worker([] {
+    ProfilerSetThreadName("profiler test");
+    RecordProfilerTree();
+  });
+  worker.join();
+  ProfilerEndFrame();
+
+  const ProfilerFrame& frame = ProfilerGetLastFrame();
+  CHECK(frame.dropped_events == 0);
+  CHECK(frame.threads.size() >= 2 && strcmp(frame.threads[0].thread_name, "main") == 0);
+  const ProfilerThreadFrame* worker_thread = FindProfilerThread("profiler test");
+  for (const ProfilerThreadFrame* thread : {&frame.threads[0], worker_thread}) {
+    if (!CHECK(thread != NULL && thread->events.size() == 8 && thread->nodes.size() == 5))
+      continue;
+    const std::vector<ProfilerNode>& nodes = thread->nodes;
+    int update = thread->first_root;
+    if (!CHECK(update != -1 && strcmp(nodes[update].name, "update") == 0))
+      continue;
+    int render = nodes[update].next_sibling;
+    CHECK(render != -1 && strcmp(nodes[render].name, "render") == 0 && nodes[render].next_sibling == -1);
+    int physics = nodes[update].first_child;
+    if (!CHECK(physics != -1 && strcmp(nodes[physics].name, "physics") == 0))
+      continue;
+    int animate = nodes[physics].next_sibling;
+    CHECK(animate != -1 && strcmp(nodes[animate].name, "animate") == 0 && nodes[animate].first_child == -1);
+    int collide = FindProfilerNode(*thread, nodes[physics].first_child, "collide");
+    CHECK(collide != -1 && nodes[collide].parent == physics && nodes[collide].depth == 2);
+    CHECK(nodes[update].calls == 2 && nodes[physics].calls == 2 && nodes[render].calls == 1);
+    CHECK(collide == -1 || nodes[collide].calls == 2);
+    CHECK(nodes[update].ticks >= nodes[physics].ticks + (animate != -1 ? nodes[animate].ticks : 0));
+    CHECK(thread->max_depth == 2);
+  }
+
+  // Filled up to the brim: nothing dropped
+  ProfilerBeginFrame();
+  RecordProfilerZones(PROFILER_RING_SIZE);
+  ProfilerEndFrame();
+  CHECK(frame.dropped_events == 0 && (int)frame.threads[0].events.size() == PROFILER_RING_SIZE);
+
+  // Lapped, not on a ring boundary any more
+  const int EXTRA = 1000;
+  ProfilerBeginFrame();
+  RecordProfilerZones(PROFILER_RING_SIZE + EXTRA);
+  ProfilerEndFrame();
+  CHECK(frame.dropped_events == EXTRA && (int)frame.threads[0].events.size() == PROFILER_RING_SIZE);
+  const ProfilerThreadFrame& main_thread = frame.threads[0];
+  CHECK(main_thread.nodes.size() == 1 && main_thread.nodes[0].calls == PROFILER_RING_SIZE);
+  bool ordered = true;
+  for (size_t i = 1; i < main_thread.events.size(); i++)
+    ordered &= main_thread.events[i - 1].end <= main_thread.events[i].begin;
+  CHECK(ordered);
+
+  // And picks up after the lap
+  ProfilerBeginFrame();
+  RecordProfilerTree();
+  ProfilerEndFrame();
+  CHECK(frame.dropped_events == 0 && frame.threads[0].events.size() == 8 && frame.threads[0].nodes.size() == 5);
+}
+
+static Uint64 PacerTicks(double ms) {
+  return (Uint64)(ms * (double)SDL_GetPerformanceFrequency() / 1000.0 + 0.5);
+}
+
+static bool Near(float a, float b) {
+  return fabsf(a - b) < 1e-3f;
+}
+
+// Intervals between made-up presents: the first present only anchors, the average and the spread cover the last
+// FRAME_PACER_HISTORY_SIZE of them
+static void TestFramePacer() {
+  FramePacer pacer;
+  Uint64 now = PacerTicks(1000.0);
+  FramePacerRecordPresent(pacer, now, PacerTicks(5.0));
+  CHECK(pacer.history_count == 0 && pacer.stats.frame_interval_ms == 0.0f && Near(pacer.stats.work_ms, 5.0f));
+
+  // Steady 60 Hz
+  for (int i = 0; i < 10; i++)
+    FramePacerRecordPresent(pacer, now += PacerTicks(16.0), PacerTicks(4.0));
+  CHECK(pacer.history_count == 10);
+  CHECK(Near(pacer.stats.frame_interval_ms, 16.0f) && Near(pacer.stats.jitter_ms, 0.0f));
+  CHECK(Near(pacer.stats.work_ms, 4.0f) && Near(pacer.work_ms[pacer.history_offset], 4.0f));
+
+  // Past the history, and alternating between 10 and 20 ms: only these count
+  for (int i = 0; i < FRAME_PACER_HISTORY_SIZE * 3 / 2; i++)
+    FramePacerRecordPresent(pacer, now += PacerTicks(i % 2 ? 20.0 : 10.0), PacerTicks(i % 2 ? 9.0 : 3.0));
+  CHECK(pacer.history_count == FRAME_PACER_HISTORY_SIZE);
+  CHECK(Near(pacer.stats.frame_interval_ms, 15.0f) && Near(pacer.stats.jitter_ms, 5.0f));
+  CHECK(Near(pacer.stats.work_ms, 9.0f));
+  CHECK(pacer.stats.missed_deadlines == 0);
+
+  // One long hitch among steady frames
+  for (int i = 0; i < FRAME_PACER_HISTORY_SIZE - 1; i++)
+    FramePacerRecordPresent(pacer, now += PacerTicks(10.0), PacerTicks(2.0));
+  FramePacerRecordPresent(pacer, now += PacerTicks(130.0), PacerTicks(2.0));
+  float mean = (10.0f * (FRAME_PACER_HISTORY_SIZE - 1) + 130.0f) / FRAME_PACER_HISTORY_SIZE;
+  float spread = sqrtf((FRAME_PACER_HISTORY_SIZE - 1) * (10.0f - mean) * (10.0f - mean) + (130.0f - mean) * (130.0f - mean));
+  CHECK(Near(pacer.stats.frame_interval_ms, mean));
+  CHECK(Near(pacer.stats.jitter_ms, spread / sqrtf((float)FRAME_PACER_HISTORY_SIZE)));
+  CHECK(Near(pacer.interval_ms[pacer.history_offset], 130.0f));
+}
+
+#ifdef IMGUI_USE_COMPACT_DRAWVERT
+static ImVec2 CompactPos(const ImVec2& p) {
+  ImDrawVertPos pos;
+  pos = p;
+  return pos;
+}
+
+static ImVec2 CompactUV(const ImVec2& uv) {
+  ImDrawVertUV compact;
+  compact = uv;
+  return compact;
+}
+
+// Fixed-point positions keep every step of 1/IM_DRAWVERT_POS_SCALE and round half up (so whole pixel moves commute with
+// quantizing), UVs come back within half a step, and PrimRect() clips rather than clamps past the range
+static void TestCompactDrawVert() {
+  const float STEP = 1.0f / IM_DRAWVERT_POS_SCALE;
+  const float RANGE = (float)(32767 / IM_DRAWVERT_POS_SCALE);
+  bool exact = true, shifts = true;
+  for (int i = -32767; i <= 32767; i++) {
+    const float v = i * STEP;
+    const ImVec2 p = CompactPos(ImVec2(v, -v));
+    exact &= p.x == v && p.y == -v;
+    // Half a step up, and then whole pixels either side
+    const float half = v + STEP * 0.5f;
+    if (fabsf(half) < RANGE - 2.0f)
+      shifts &= CompactPos(ImVec2(half, 0.0f)).x == v + STEP
+        && CompactPos(ImVec2(half + 1.0f, 0.0f)).x == CompactPos(ImVec2(half, 0.0f)).x + 1.0f;
+  }
+  CHECK(exact);
+  CHECK(shifts);
+  CHECK(CompactPos(ImVec2(1e6f, -1e6f)).x == 32767 * STEP && CompactPos(ImVec2(1e6f, -1e6f)).y == -32768 * STEP);
+
+  float max_uv_error = 0.0f;
+  for (int i = 0; i <= 100000; i++) {
+    const float t = i / 100000.0f;
+    const ImVec2 uv = CompactUV(ImVec2(t, 1.0f - t));
+    max_uv_error = std::max(max_uv_error, std::max(fabsf(uv.x - t), fabsf(uv.y - (1.0f - t))));
+  }
+  CHECK(max_uv_error <= 0.5f / 65535.0f + 1e-7f);
+  CHECK(CompactUV(ImVec2(0.0f, 1.0f)).x == 0.0f && CompactUV(ImVec2(0.0f, 1.0f)).y == 1.0f);
+  CHECK(CompactUV(ImVec2(-0.5f, 1.5f)).x == 0.0f && CompactUV(ImVec2(-0.5f, 1.5f)).y == 1.0f);
+
+  // A rectangle past the range on both sides stays a rectangle, on the edge of the range
+  CreateFixtureContext();
+  ImDrawList draw_list(ImGui::GetDrawListSharedData());
+  draw_list.Clear();
+  draw_list.PushClipRectFullScreen();
+  draw_list.PrimReserve(6, 4);
+  draw_list.PrimRect(ImVec2(-10000.0f, 10.0f), ImVec2(10000.0f, 20.0f), IM_COL32_WHITE);
+  const ImVec2 a = draw_list.VtxBuffer[0].pos, b = draw_list.VtxBuffer[1].pos;
+  const ImVec2 c = draw_list.VtxBuffer[2].pos, d = draw_list.VtxBuffer[3].pos;
+  CHECK(a.x == -RANGE && a.y == 10.0f && c.x == RANGE && c.y == 20.0f);
+  CHECK(b.x == c.x && b.y == a.y && d.x == a.x && d.y == c.y);
+  bool inside = true;
+  for (const ImDrawVert& vertex : draw_list.VtxBuffer)
+    inside &= vertex.pos.x != -32768 && vertex.pos.x != 32767 && vertex.pos.y != -32768 && vertex.pos.y != 32767;
+  CHECK(inside);
+  ImGui::DestroyContext();
+}
+#endif
+
+struct Test {
+  const char* name;
+  void (*run)();
+};
+
+static const Test tests[] = {
+  {"hash", TestHash},
+  {"storage", TestStorage},
+  {"text", TestRenderText},
+  {"textcache", TestTextCache},
+  {"fontatlas", TestFontAtlas},
+  {"fontcache", TestFontCache},
+  {"dynamicatlas", TestDynamicAtlas},
+  {"sdfatlas", TestSdfAtlas},
+  {"retained", TestRetained},
+  {"inputtext", TestInputText},
+  {"textviewer", TestTextViewer},
+  {"varclipper", TestVariableClipper},
+  {"nestedclipper", TestNestedClipper},
+  {"plot", TestPlot},
+  {"polyline", TestPolyline},
+  {"parallelfor", TestParallelFor},
+  {"jobcounter", TestJobCounter},
+  {"jobsteal", TestJobSteal},
+  {"profiler", TestProfiler},
+  {"framepacer", TestFramePacer},
+#ifdef IMGUI_USE_COMPACT_DRAWVERT
+  {"compactvert", TestCompactDrawVert},
+#endif
+};
+
+int main(int argc, char** argv) {
+  bool all = true;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--print") == 0)
+      print_golden = true;
+    else
+      all = false;
+  }
+
+  int failed = 0;
+  for (const Test& test : tests) {
+    bool run = all;
+    for (int i = 1; i < argc; i++)
+      run |= strcmp(argv[i], test.name) == 0;
+    if (!run)
+      continue;
+    int before = failures;
+    test.run();
+    printf("%-14s %s\n", test.name, failures == before ? "ok" : "FAILED");
+    failed += failures != before;
+  }
+  return failed != 0 ? 1 : 0;
+}
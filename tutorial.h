@@ -8,6 +8,10 @@
 #include <fstream>
 #include <iostream>
 
+#include "jake_gl_state.h"
+#include "jake_shader_cache.h"
+#include "jake_simulation.h"
+
 class Shader
 {
 public:
@@ -26,184 +30,102 @@ public:
     return fileContent;
   }
 
-  void BindAttributeLocation(int index, const std::string &attribute)
-  {
-    // Bind attribute index 0 (coordinates) to in_Position and attribute index 1 (color) to in_Color
-    // Attribute locations must be setup before calling glLinkProgram
-    glBindAttribLocation(shaderProgram, index, attribute.c_str());
-  }
-
   void UseProgram()
   {
     // Load the shader into the rendering pipeline
-    glUseProgram(shaderProgram);
+    GlStateUseProgram(shaderProgram);
   }
 
   bool Init()
   {
-    // Generate our shader. This is similar to glGenBuffers() and glGenVertexArray(), except that this returns the ID
-    shaderProgram = glCreateProgram();
-
-    // Bind the location of our attributes
-    BindAttributeLocation(0, "in_Position");
-    BindAttributeLocation(1, "in_Color");
-
-    if (!LoadVertexShader("tutorial2.vert"))
-      return false;
-
-    if (!LoadFragmentShader("tutorial2.frag"))
-      return false;
-
-    // All shaders has been create, now we must put them together into one large object
-    return LinkShaders();
-  }
-
-
-  bool LoadVertexShader(const std::string &filename)
-  {
-    std::cout << "Linking Vertex shader" << std::endl;
-
-    // Read file as std::string
-    std::string str = ReadFile(filename.c_str());
-
-     // c_str() gives us a const char*, but we need a non-const one
-    char* src = const_cast<char*>( str.c_str());
-    int32_t size = str.length();
-
-    // Create an empty vertex shader handle
-    vertexshader = glCreateShader(GL_VERTEX_SHADER);
-
-    // Send the vertex shader source code to OpenGL
-    glShaderSource(vertexshader, 1, &src, &size);
-
-    // Compile the vertex shader
-    glCompileShader(vertexshader);
-
-    int wasCompiled = 0;
-    glGetShaderiv(vertexshader, GL_COMPILE_STATUS, &wasCompiled );
-
-    if (wasCompiled == 0)
-    {
-      PrintShaderCompilationErrorInfo(vertexshader);
-      return false;
-    }
-
-    glAttachShader(shaderProgram, vertexshader);
-    return true;
+    return Reload();
   }
 
-  bool LoadFragmentShader(const std::string &filename)
+  // Start building a new program from the files on disk. The one in use stays until the new one is linked
+  bool Reload()
   {
-    std::cout << "Loading Fragment Shader" << std::endl;
-
-    // Read file as std::string
-    std::string str = ReadFile(filename.c_str());
-
-     // c_str() gives us a const char*, but we need a non-const one
-    char* src = const_cast<char*>( str.c_str());
-    int32_t size = str.length();
-
-    // Create an empty vertex shader handle
-    fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-
-    // Send the vertex shader source code to OpenGL
-    glShaderSource(fragmentShader, 1, &src, &size);
-
-    // Compile the vertex shader
-    glCompileShader(fragmentShader);
-
-    int wasCompiled = 0;
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &wasCompiled );
-
-    if (wasCompiled == false)
+    // Read both sources as std::string
+    std::string vertexSource = ReadFile("tutorial2.vert");
+    std::string fragmentSource = ReadFile("tutorial2.frag");
+    if (vertexSource.empty() || fragmentSource.empty())
     {
-      PrintShaderCompilationErrorInfo(fragmentShader);
+      error = "Can't read tutorial2.vert/tutorial2.frag";
+      std::cout << error << std::endl;
       return false;
     }
 
-    glAttachShader(shaderProgram, fragmentShader);
-    return true;
-  }
-
-  bool LinkShaders()
-  {
-    // Link. At this point, our shaders will be inspected/optized and the binary code generated
-    // The binary code will then be uploaded to the GPU
-    glLinkProgram(shaderProgram);
-
-    // Verify that the linking succeeded
-    int isLinked;
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, (int *)&isLinked);
+    // Attribute index 0 (coordinates) goes to in_Position and attribute index 1 (color) to in_Color
+    const char* attributes[] = { "in_Position", "in_Color" };
 
-    if (isLinked == false)
-      PrintShaderLinkingError(shaderProgram);
+    // Saved again before the last reload finished: that one is stale already
+    if (pendingProgram != 0)
+      ShaderCacheDeleteProgram(pendingProgram);
 
-    return isLinked != 0;
+    // The shader cache either loads the linked program from disk or starts compiling it in the background
+    // Either way this returns right away, see Update(). Without KHR_parallel_shader_compile the link status
+    // is only read a couple of frames later, the driver may still compile inside these calls though
+    ShaderProgramDesc desc = { "tutorial2", vertexSource.c_str(), fragmentSource.c_str(), attributes, 2 };
+    pendingProgram = ShaderCacheCreateProgram(desc);
+    return pendingProgram != 0;
   }
 
-  void PrintShaderLinkingError(int32_t shaderId)
+  // Once a frame, between frames: swap in the new program if it's done linking
+  void Update()
   {
-    std::cout << "=======================================\n";
-    std::cout << "Shader linking failed : " << std::endl;
-
-    // Find length of shader info log
-    int maxLength;
-    glGetProgramiv(shaderId, GL_INFO_LOG_LENGTH, &maxLength);
-
-    std::cout << "Info Length : " << maxLength << std::endl;
-
-    // Get shader info log
-    char* shaderProgramInfoLog = new char[maxLength];
-    glGetProgramInfoLog(shaderProgram, maxLength, &maxLength, shaderProgramInfoLog);
+    if (pendingProgram == 0)
+      return;
 
-    std::cout << "Linker error message : " << shaderProgramInfoLog << std::endl;
-
-    /* Handle the error in an appropriate way such as displaying a message or writing to a log file. */
-    /* In this simple program, we'll just leave */
-    delete[] shaderProgramInfoLog;
-    return;
+    switch (ShaderCacheGetStatus(pendingProgram))
+    {
+    case ShaderProgramStatus_Pending:
+      break;
+    case ShaderProgramStatus_Ready:
+      if (shaderProgram != 0)
+        ShaderCacheDeleteProgram(shaderProgram);
+      shaderProgram = pendingProgram;
+      pendingProgram = 0;
+      offsetLocation = glGetUniformLocation(shaderProgram, "in_Offset");
+      angleLocation = glGetUniformLocation(shaderProgram, "in_Angle");
+      error.clear();
+      break;
+    case ShaderProgramStatus_Failed:
+      // Keep drawing with the last good program
+      error = ShaderCacheGetError(pendingProgram);
+      ShaderCacheDeleteProgram(pendingProgram);
+      pendingProgram = 0;
+      break;
+    }
   }
 
-  // If something went wrong whil compiling the shaders, we'll use this function to find the error
-  void PrintShaderCompilationErrorInfo(int32_t shaderId)
+  // The first program may still be compiling, don't draw until it's done
+  bool IsReady()
   {
-    std::cout << "=======================================\n";
-    std::cout << "Shader compilation failed : " << std::endl;
-
-    // Find length of shader info log
-    int maxLength;
-    glGetShaderiv(shaderId, GL_INFO_LOG_LENGTH, &maxLength);
-
-    // Get shader info log
-    char* shaderInfoLog = new char[maxLength];
-    glGetShaderInfoLog(shaderId, maxLength, &maxLength, shaderInfoLog );
-
-    // Print shader info log
-    std::cout << "\tError info : " << shaderInfoLog << std::endl;
-
-    std::cout << "=======================================\n\n";
-    delete[] shaderInfoLog;
+    return shaderProgram != 0;
   }
 
   void CleanUp()
   {
     /* Cleanup all the things we bound and allocated */
-    glUseProgram(0);
-    glDetachShader(shaderProgram, vertexshader);
-    glDetachShader(shaderProgram, fragmentShader);
-
-    glDeleteProgram(shaderProgram);
+    /* The individual shaders belong to the shader cache, which lets go of them once the program is linked */
+    GlStateUseProgram(0);
+    if (pendingProgram != 0)
+      ShaderCacheDeleteProgram(pendingProgram);
+    if (shaderProgram != 0)
+      ShaderCacheDeleteProgram(shaderProgram);
+    pendingProgram = shaderProgram = 0;
+  }
 
+  // The handle to our shader program, 0 until the first one linked
+  GLuint shaderProgram = 0;
 
-    glDeleteShader(vertexshader);
-    glDeleteShader(fragmentShader);
-  }
+  // The program being built by the last Reload(), 0 if none
+  GLuint pendingProgram = 0;
 
-  // The handle to our shader program
-  GLuint shaderProgram;
+  // Why the last Reload() failed, empty if it didn't
+  std::string error;
 
-  // The handles to the induvidual shader
-  GLuint vertexshader, fragmentShader;
+  // Uniforms placing the object
+  GLint offsetLocation, angleLocation;
 
 };
 
@@ -253,12 +175,12 @@ bool SetupBufferObjects()
   std::cout << "=== [ HERE ] ===" << std::endl;
 
   // Bind our Vertex Array Object as the current used object
-  glBindVertexArray(vao[0]);
+  GlStateBindVertexArray(vao[0]);
 
   // Positions
   // ===================
   // Bind our first VBO as being the active buffer and storing vertex attributes (coordinates)
-  glBindBuffer(GL_ARRAY_BUFFER, vbo[0]);
+  GlStateBindBuffer(GL_ARRAY_BUFFER, vbo[0]);
 
   // Copy the vertex data from diamond to our buffer
   glBufferData(GL_ARRAY_BUFFER, ( points * floatsPerPoint) * sizeof(GLfloat), diamond, GL_STATIC_DRAW);
@@ -271,7 +193,7 @@ bool SetupBufferObjects()
 
   // Colors
   // =======================
-  glBindBuffer(GL_ARRAY_BUFFER, vbo[1]);
+  GlStateBindBuffer(GL_ARRAY_BUFFER, vbo[1]);
 
   // Copy the vertex data from diamond to our buffer
   glBufferData(GL_ARRAY_BUFFER, ( points * floatsPerColor) * sizeof(GLfloat), colors, GL_STATIC_DRAW);
@@ -286,15 +208,23 @@ bool SetupBufferObjects()
   if (!shader.Init())
     return false;
 
-  shader.UseProgram();
-
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  GlStateBindBuffer(GL_ARRAY_BUFFER, 0);
 
   return true;
 }
 
-void Render(SDL_Window *mainWindow)
+void Render(SDL_Window *mainWindow, const SimulationState &state)
 {
+  // Nothing to draw with until the shader is linked
+  if (!shader.IsReady())
+    return;
+
+  // Place the object where the (interpolated) simulation says it is
+  shader.UseProgram();
+  GlStateBindVertexArray(vao[0]);
+  glUniform2f(shader.offsetLocation, state.position[0], state.position[1]);
+  glUniform1f(shader.angleLocation, state.angle);
+
   // First, render a square without any colors ( all vertexes will be black )
   // ===================
   // Make our background grey
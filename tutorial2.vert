@@ -7,13 +7,20 @@
 attribute vec3 in_Position;
 attribute vec4 in_Color;
 
+// Placement of the object, interpolated from the simulation state
+uniform vec2 in_Offset;
+uniform float in_Angle;
+
 // We output the ex_Color variable to the next shader in the chain
 out vec4 ex_Color;
 
 void main(void) {
     // Since we are using flat lines, our input only had two points: x and y.
     // Set the Z coordinate to 0 and W coordinate to 1
-    gl_Position = vec4(in_Position.x, in_Position.y, in_Position.z, 1.0);
+    float c = cos(in_Angle);
+    float s = sin(in_Angle);
+    vec2 rotated = vec2(c * in_Position.x - s * in_Position.y, s * in_Position.x + c * in_Position.y);
+    gl_Position = vec4(rotated * 0.5 + in_Offset, in_Position.z, 1.0);
 
     // Pass the color on to the fragment shader
     ex_Color = in_Color;